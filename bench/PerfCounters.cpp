@@ -0,0 +1,94 @@
+#include "bench/PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+NAMESPACE_BENCHMARK_BEGIN
+
+#ifdef __linux__
+
+static int openEvent(const uint64_t config) {
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(perf_event_attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+PerfCounters::PerfCounters() {
+    fds[CYCLES] = openEvent(PERF_COUNT_HW_CPU_CYCLES);
+    fds[INSTRUCTIONS] = openEvent(PERF_COUNT_HW_INSTRUCTIONS);
+    fds[CACHE_MISSES] = openEvent(PERF_COUNT_HW_CACHE_MISSES);
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds) {
+        if (fd < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PerfCounters::restart() {
+    if (!this->available()) {
+        return;
+    }
+    for (int fd : fds) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+Optional<PerfCounters::Values> PerfCounters::read() const {
+    if (!this->available()) {
+        return NOTHING;
+    }
+    uint64_t values[COUNTER_CNT];
+    for (int i = 0; i < COUNTER_CNT; ++i) {
+        if (::read(fds[i], &values[i], sizeof(uint64_t)) != sizeof(uint64_t)) {
+            return NOTHING;
+        }
+    }
+    return Values{ values[CYCLES], values[INSTRUCTIONS], values[CACHE_MISSES] };
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    for (int& fd : fds) {
+        fd = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() = default;
+
+bool PerfCounters::available() const {
+    return false;
+}
+
+void PerfCounters::restart() {}
+
+Optional<PerfCounters::Values> PerfCounters::read() const {
+    return NOTHING;
+}
+
+#endif
+
+NAMESPACE_BENCHMARK_END
@@ -0,0 +1,49 @@
+#pragma once
+
+/// \file PerfCounters.h
+/// \brief Hardware performance counters
+/// \author Pavel Sevecek (sevecek at sirrah.troja.mff.cuni.cz)
+/// \date 2016-2021
+
+#include "bench/Common.h"
+#include "objects/Object.h"
+#include "objects/wrappers/Optional.h"
+
+NAMESPACE_BENCHMARK_BEGIN
+
+/// \brief Hardware performance counters, measured using perf_event_open.
+///
+/// Only available on Linux; the counters might also be unavailable if the access to performance events is
+/// restricted by the kernel, see /proc/sys/kernel/perf_event_paranoid. Events are counted in user space for
+/// the calling thread and for threads it creates after the counters are opened. Note that events of the
+/// created threads are only included once the threads exit, so that threads of the global thread pool are
+/// never counted.
+class PerfCounters : public Noncopyable {
+private:
+    enum Counter { CYCLES, INSTRUCTIONS, CACHE_MISSES, COUNTER_CNT };
+
+    /// File descriptors of individual events, -1 if the event is not available
+    int fds[COUNTER_CNT];
+
+public:
+    struct Values {
+        uint64_t cycles;
+        uint64_t instructions;
+        uint64_t cacheMisses;
+    };
+
+    PerfCounters();
+
+    ~PerfCounters();
+
+    /// \brief Checks if the counters are available on this system.
+    bool available() const;
+
+    /// \brief Sets all counters to zero and starts counting.
+    void restart();
+
+    /// \brief Returns the current values of the counters or NOTHING if they are not available.
+    Optional<Values> read() const;
+};
+
+NAMESPACE_BENCHMARK_END
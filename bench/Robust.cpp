@@ -0,0 +1,120 @@
+#include "bench/Robust.h"
+#include "math/rng/Rng.h"
+#include <algorithm>
+
+NAMESPACE_BENCHMARK_BEGIN
+
+Float median(ArrayView<const Float> values) {
+    SPH_ASSERT(!values.empty());
+    Array<Float> sorted;
+    sorted.pushAll(values.begin(), values.end());
+    const Size mid = sorted.size() / 2;
+    std::nth_element(sorted.begin(), sorted.begin() + mid, sorted.end());
+    if (sorted.size() % 2 == 1) {
+        return sorted[mid];
+    }
+    const Float upper = sorted[mid];
+    const Float lower = *std::max_element(sorted.begin(), sorted.begin() + mid);
+    return 0.5_f * (lower + upper);
+}
+
+Array<Float> rejectOutliers(ArrayView<const Float> samples, const Float madFactor) {
+    Array<Float> result;
+    if (samples.empty()) {
+        return result;
+    }
+    const Float center = median(samples);
+    Array<Float> deviations;
+    for (Float sample : samples) {
+        deviations.push(abs(sample - center));
+    }
+    // scale factor of MAD for normally distributed values
+    const Float sigma = 1.4826_f * median(deviations);
+    for (Float sample : samples) {
+        if (sigma == 0._f || abs(sample - center) <= madFactor * sigma) {
+            result.push(sample);
+        }
+    }
+    return result;
+}
+
+Float mannWhitneyTest(ArrayView<const Float> samples1, ArrayView<const Float> samples2) {
+    const Size n1 = samples1.size();
+    const Size n2 = samples2.size();
+    if (n1 == 0 || n2 == 0) {
+        return 1._f;
+    }
+    struct Sample {
+        Float value;
+        bool first;
+    };
+    Array<Sample> all;
+    for (Float value : samples1) {
+        all.push(Sample{ value, true });
+    }
+    for (Float value : samples2) {
+        all.push(Sample{ value, false });
+    }
+    std::sort(all.begin(), all.end(), [](const Sample& s1, const Sample& s2) { return s1.value < s2.value; });
+
+    // sum of ranks of the first set, tied values get the average rank
+    Float rankSum = 0._f;
+    Float tieCorrection = 0._f;
+    for (Size i = 0; i < all.size();) {
+        Size j = i;
+        while (j < all.size() && all[j].value == all[i].value) {
+            ++j;
+        }
+        const Float rank = 0.5_f * (i + 1 + j);
+        for (Size k = i; k < j; ++k) {
+            if (all[k].first) {
+                rankSum += rank;
+            }
+        }
+        const Float tieCnt = Float(j - i);
+        tieCorrection += pow<3>(tieCnt) - tieCnt;
+        i = j;
+    }
+
+    const Float n = Float(n1 + n2);
+    const Float u = rankSum - 0.5_f * n1 * (n1 + 1);
+    const Float mu = 0.5_f * n1 * n2;
+    const Float sigmaSqr = n1 * n2 / 12._f * ((n + 1._f) - tieCorrection / (n * (n - 1._f)));
+    if (sigmaSqr <= 0._f) {
+        return 1._f;
+    }
+    // continuity correction
+    const Float z = max(abs(u - mu) - 0.5_f, 0._f) / sqrt(sigmaSqr);
+    return std::erfc(z / sqrt(2._f));
+}
+
+Interval bootstrapMedianRatio(ArrayView<const Float> samples1,
+    ArrayView<const Float> samples2,
+    const Float confidence,
+    const Size resampleCnt) {
+    SPH_ASSERT(!samples1.empty() && !samples2.empty());
+    SPH_ASSERT(confidence > 0._f && confidence < 1._f);
+    UniformRng rng;
+    auto resample = [&rng](ArrayView<const Float> samples, Array<Float>& buffer) {
+        for (Size i = 0; i < samples.size(); ++i) {
+            buffer[i] = samples[min(Size(rng() * samples.size()), samples.size() - 1)];
+        }
+        return median(buffer);
+    };
+
+    Array<Float> buffer1(samples1.size());
+    Array<Float> buffer2(samples2.size());
+    Array<Float> ratios(resampleCnt);
+    for (Size i = 0; i < resampleCnt; ++i) {
+        const Float median1 = resample(samples1, buffer1);
+        const Float median2 = resample(samples2, buffer2);
+        ratios[i] = median2 / median1;
+    }
+    std::sort(ratios.begin(), ratios.end());
+    const Float tail = 0.5_f * (1._f - confidence);
+    const Size lower = min(Size(tail * resampleCnt), resampleCnt - 1);
+    const Size upper = min(Size((1._f - tail) * resampleCnt), resampleCnt - 1);
+    return Interval(ratios[lower], ratios[upper]);
+}
+
+NAMESPACE_BENCHMARK_END
@@ -0,0 +1,43 @@
+#pragma once
+
+/// \file Robust.h
+/// \brief Robust statistics for comparing benchmark results
+/// \author Pavel Sevecek (sevecek at sirrah.troja.mff.cuni.cz)
+/// \date 2016-2021
+
+#include "bench/Common.h"
+#include "objects/containers/Array.h"
+#include "objects/wrappers/Interval.h"
+
+NAMESPACE_BENCHMARK_BEGIN
+
+/// \brief Returns the median of given values.
+///
+/// Values must not be empty.
+Float median(ArrayView<const Float> values);
+
+/// \brief Returns the samples with outliers removed.
+///
+/// A sample is considered to be an outlier if its distance from the median is larger than given multiple of
+/// the median absolute deviation, scaled to match the standard deviation of the normal distribution.
+/// Samples are kept unchanged if the median absolute deviation is zero.
+Array<Float> rejectOutliers(ArrayView<const Float> samples, const Float madFactor);
+
+/// \brief Returns the two-sided p-value of the Mann-Whitney U test of two sets of samples.
+///
+/// The test does not assume the samples are normally distributed, only that they are independent. The
+/// p-value is computed from the normal approximation of the U statistic with the correction for ties, so it
+/// is only accurate for sample counts larger than about 10.
+Float mannWhitneyTest(ArrayView<const Float> samples1, ArrayView<const Float> samples2);
+
+/// \brief Returns the bootstrap confidence interval of the ratio of medians of two sets of samples.
+///
+/// The ratio is median(samples2) / median(samples1), the interval is computed using the percentile method.
+/// Resampling is deterministic, the same samples always yield the same interval.
+/// \param confidence Confidence level of the interval, for example 0.95.
+Interval bootstrapMedianRatio(ArrayView<const Float> samples1,
+    ArrayView<const Float> samples2,
+    const Float confidence,
+    const Size resampleCnt = 1000);
+
+NAMESPACE_BENCHMARK_END
@@ -1,8 +1,14 @@
 #include "bench/Session.h"
+#include "bench/Robust.h"
 #include "io/FileSystem.h"
 #include "io/Logger.h"
 #include "system/Platform.h"
 #include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 NAMESPACE_BENCHMARK_BEGIN
 
@@ -35,18 +41,50 @@ void Session::registerBenchmark(const SharedPtr<Unit>& benchmark, const String&
     group.addBenchmark(benchmark);
 }
 
-void Session::run(int argc, char* argv[]) {
+/// Pins the calling thread to given range of logical CPUs; threads created afterwards inherit the affinity.
+static bool pinToCpus(const Interval& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu = int(cpus.lower()); cpu <= int(cpus.upper()); ++cpu) {
+        CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(cpu_set_t), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+int Session::run(int argc, char* argv[]) {
     Outcome result = this->parseArgs(argc, argv);
     if (!result) {
         this->logError(result.error());
-        return;
+        return -1;
     }
 #ifdef SPH_DEBUG
     this->log("Warning: running benchmark in debugging build");
 #endif
     if (!status) {
         this->logError(status.error());
-        return;
+        return -1;
+    }
+    if (!params.pinnedCpus.empty() && !pinToCpus(params.pinnedCpus)) {
+        this->logError("Cannot pin the benchmark to CPUs ", params.pinnedCpus);
+        return -1;
+    }
+
+    const bool robust = params.flags.has(Flag::ROBUST);
+    // robust statistics need enough samples after the warmup
+    const Size minIterateCnt = robust ? params.robust.warmupCnt + params.robust.minSampleCnt : 1;
+    AutoPtr<PerfCounters> counters;
+    if (robust) {
+        params.target.warmupCnt = params.robust.warmupCnt;
+        params.target.iterateCnt = max(params.target.iterateCnt, minIterateCnt);
+        counters = makeAuto<PerfCounters>();
+        if (!counters->available()) {
+            this->log("Warning: hardware performance counters are not available");
+        }
     }
 
     Baseline baseline;
@@ -58,10 +96,13 @@ void Session::run(int argc, char* argv[]) {
         params.target.mode = Mode::RUN_AGAINST_BASELINE;
         if (!baseline.parse(this->getBaselinePath())) {
             this->logError("Invalid baseline format");
-            return;
+            return -1;
         }
     }
 
+    Array<ScalingSample> scalingSamples;
+    Array<String> jsonRecords;
+    int regressionCnt = 0;
     for (SharedPtr<Unit>& b : benchmarks) {
         if (!params.benchmarksToRun.empty()) {
             // check if we want to run the benchmark
@@ -74,25 +115,34 @@ void Session::run(int argc, char* argv[]) {
         try {
             if (params.flags.has(Flag::RUN_AGAINST_BASELINE)) {
                 if (!baseline.isRecorded(b->getName())) {
-                    params.target.iterateCnt = 1;
+                    params.target.iterateCnt = minIterateCnt;
                 } else {
                     params.target.iterateCnt = baseline[b->getName()].iterateCnt;
                 }
             }
-            Expected<Result> act = b->run(params.target);
+            Expected<Result> act = b->run(params.target, counters.get());
             if (!act) {
                 this->logError("Fail");
             } else {
+                const Size outlierCnt = robust ? this->rejectOutliers(act.value()) : 0;
                 if (act->duration > params.maxAllowedDuration) {
                     this->log(
                         "Warning: benchmark ", b->getName(), " is takes too much time, t = ", act->duration);
                 }
+                Optional<Comparison> comparison;
                 if (params.flags.has(Flag::RUN_AGAINST_BASELINE)) {
                     if (baseline.isRecorded(b->getName())) {
-                        Result result = baseline[b->getName()];
+                        const Result& result = baseline[b->getName()];
                         SPH_ASSERT(result.iterateCnt == act->iterateCnt, result.iterateCnt, act->iterateCnt);
                         this->log(b->getName() + " ran " + toString(act->iterateCnt) + " iterations");
-                        this->compareResults(act.value(), result);
+                        if (robust && !result.samples.empty() && !act->samples.empty()) {
+                            comparison = this->compareRobust(act.value(), result);
+                        } else {
+                            comparison = this->compareResults(act.value(), result);
+                        }
+                        if (comparison->verdict == Verdict::REGRESSION) {
+                            ++regressionCnt;
+                        }
                     } else {
                         this->log(b->getName() + " not recorded in the baseline");
                     }
@@ -112,16 +162,58 @@ void Session::run(int argc, char* argv[]) {
                         ", max. ",
                         act->max,
                         ")");
+                    if (!act->phases.empty()) {
+                        String phases;
+                        for (const auto& phase : act->phases) {
+                            if (!phases.empty()) {
+                                phases += ", ";
+                            }
+                            phases += phase.first + " " + toString(phase.second) + " ms";
+                        }
+                        this->log("   phases: ", phases);
+                    }
                     if (params.flags.has(Flag::MAKE_BASELINE)) {
                         this->writeBaseline(b->getName(), act.value());
                     }
                 }
+                if (outlierCnt > 0) {
+                    this->log("   rejected ", outlierCnt, " outliers");
+                }
+                if (act->counters && act->iterateCnt > params.target.warmupCnt) {
+                    // counters are restarted together with the timer, so they include all measured iterations
+                    const PerfCounters::Values& values = act->counters.value();
+                    const Float iterCnt = Float(act->iterateCnt - params.target.warmupCnt);
+                    this->log("   cycles/iter ",
+                        values.cycles / iterCnt,
+                        ", IPC ",
+                        Float(values.instructions) / max(values.cycles, uint64_t(1)),
+                        ", cache misses/iter ",
+                        values.cacheMisses / iterCnt);
+                }
+                if (const Optional<ScalingPoint>& point = b->getScalingPoint()) {
+                    Optional<Float> baselineMean;
+                    if (baseline.isRecorded(b->getName())) {
+                        baselineMean = baseline[b->getName()].mean;
+                    }
+                    scalingSamples.push(ScalingSample{ point.value(), act->mean, baselineMean });
+                }
+                if (!params.jsonPath.empty()) {
+                    jsonRecords.push(this->toJson(b->getName(), act.value(), comparison));
+                }
             }
         } catch (const std::exception& e) {
             this->logError("Exception caught in benchmark " + b->getName() + ":\n" + exceptionMessage(e));
-            return;
+            return -1;
         }
     }
+
+    if (!scalingSamples.empty()) {
+        this->reportScaling(scalingSamples);
+    }
+    if (!params.jsonPath.empty()) {
+        this->writeJson(jsonRecords);
+    }
+    return regressionCnt;
 }
 
 Path Session::getBaselinePath() {
@@ -138,23 +230,235 @@ Path Session::getBaselinePath() {
 void Session::writeBaseline(const String& name, const Result& measured) {
     FileLogger logger(params.baseline.path, FileLogger::Options::APPEND);
     // clang-format off
+    String samples;
+    if (params.flags.has(Flag::ROBUST)) {
+        // store the individual samples, needed by the non-parametric comparison
+        for (Float sample : measured.samples) {
+            samples += ", " + toString(sample);
+        }
+    }
     logger.write(name, ", ", measured.duration, ", ", measured.iterateCnt, ", ",
-        measured.mean, ", ", measured.variance, ", ", measured.min, ", ", measured.max);
+        measured.mean, ", ", measured.variance, ", ", measured.min, ", ", measured.max, samples);
     // clang-format on
 }
 
-void Session::compareResults(const Result& measured, const Result& baseline) {
+Session::Comparison Session::compareResults(const Result& measured, const Result& baseline) {
     const Float diff = measured.mean - baseline.mean;
     const Float sigma = params.confidence * sqrt(measured.variance + baseline.variance);
+    const Float ratio = measured.mean / baseline.mean;
     if (diff < -sigma) {
         ScopedConsole color(Console::Foreground::GREEN);
         this->log(measured.duration, " < ", baseline.duration);
+        return Comparison{ Verdict::IMPROVEMENT, ratio, NOTHING, NOTHING };
     } else if (diff > sigma) {
         ScopedConsole color(Console::Foreground::RED);
         this->log(measured.duration, " > ", baseline.duration);
+        return Comparison{ Verdict::REGRESSION, ratio, NOTHING, NOTHING };
     } else {
         ScopedConsole color(Console::Foreground::LIGHT_GRAY);
         this->log(measured.duration, " == ", baseline.duration);
+        return Comparison{ Verdict::SAME, ratio, NOTHING, NOTHING };
+    }
+}
+
+Session::Comparison Session::compareRobust(const Result& measured, const Result& baseline) {
+    const Float ratio = median(measured.samples) / median(baseline.samples);
+    const Float pValue = mannWhitneyTest(baseline.samples, measured.samples);
+    const Interval interval =
+        bootstrapMedianRatio(baseline.samples, measured.samples, params.robust.intervalConfidence);
+
+    // the difference has to be both statistically significant and larger than the threshold
+    Verdict verdict = Verdict::SAME;
+    if (pValue < params.robust.alpha) {
+        if (ratio > 1._f + params.robust.threshold) {
+            verdict = Verdict::REGRESSION;
+        } else if (ratio < 1._f - params.robust.threshold) {
+            verdict = Verdict::IMPROVEMENT;
+        }
+    }
+    Console::Foreground color = Console::Foreground::LIGHT_GRAY;
+    if (verdict == Verdict::REGRESSION) {
+        color = Console::Foreground::RED;
+    } else if (verdict == Verdict::IMPROVEMENT) {
+        color = Console::Foreground::GREEN;
+    }
+    ScopedConsole scoped(color);
+    this->log("   median ratio ", ratio, " (", interval.lower(), " - ", interval.upper(), "), p = ", pValue);
+    return Comparison{ verdict, ratio, interval, pValue };
+}
+
+Size Session::rejectOutliers(Result& result) {
+    const Size sampleCnt = result.samples.size();
+    result.samples = Benchmark::rejectOutliers(result.samples, params.robust.madFactor);
+    Stats stats;
+    for (Float sample : result.samples) {
+        stats.add(sample);
+    }
+    if (stats.count() > 0) {
+        result.mean = stats.mean();
+        result.variance = stats.variance();
+        result.min = stats.min();
+        result.max = stats.max();
+    }
+    return sampleCnt - result.samples.size();
+}
+
+/// Returns the string enclosed in quotes, escaping special characters.
+static String quoted(const String& s) {
+    String result = "\"";
+    for (wchar_t c : s) {
+        if (c == L'"' || c == L'\\') {
+            result += L'\\';
+        }
+        result += c;
+    }
+    return result + "\"";
+}
+
+String Session::toJson(const String& name, const Result& result, const Optional<Comparison>& comparison) {
+    String json = "    {\n";
+    json += "      \"name\": " + quoted(name) + ",\n";
+    json += "      \"iterations\": " + toString(result.iterateCnt) + ",\n";
+    json += "      \"samples\": " + toString(result.samples.size()) + ",\n";
+    json += "      \"mean\": " + toString(result.mean) + ",\n";
+    if (!result.samples.empty()) {
+        json += "      \"median\": " + toString(median(result.samples)) + ",\n";
+    }
+    json += "      \"min\": " + toString(result.min) + ",\n";
+    json += "      \"max\": " + toString(result.max) + ",\n";
+    if (result.counters) {
+        const PerfCounters::Values& values = result.counters.value();
+        json += "      \"cycles\": " + toString(values.cycles) + ",\n";
+        json += "      \"instructions\": " + toString(values.instructions) + ",\n";
+        json += "      \"cache_misses\": " + toString(values.cacheMisses) + ",\n";
+        json += "      \"ipc\": " +
+                toString(Float(values.instructions) / max(values.cycles, uint64_t(1))) + ",\n";
+    }
+    String status = "\"measured\"";
+    if (comparison) {
+        json += "      \"ratio\": " + toString(comparison->ratio) + ",\n";
+        if (comparison->interval) {
+            json += "      \"ratio_interval\": [" + toString(comparison->interval->lower()) + ", " +
+                    toString(comparison->interval->upper()) + "],\n";
+        }
+        if (comparison->pValue) {
+            json += "      \"p_value\": " + toString(comparison->pValue.value()) + ",\n";
+        }
+        switch (comparison->verdict) {
+        case Verdict::REGRESSION:
+            status = "\"fail\"";
+            break;
+        case Verdict::IMPROVEMENT:
+            status = "\"improved\"";
+            break;
+        default:
+            status = "\"pass\"";
+        }
+    } else if (params.flags.has(Flag::RUN_AGAINST_BASELINE)) {
+        status = "\"not recorded\"";
+    }
+    json += "      \"status\": " + status + "\n";
+    json += "    }";
+    return json;
+}
+
+void Session::writeJson(ArrayView<const String> records) {
+    std::ofstream ofs(params.jsonPath.native());
+    ofs << "{\n  \"benchmarks\": [\n";
+    for (Size i = 0; i < records.size(); ++i) {
+        ofs << records[i] << (i + 1 < records.size() ? ",\n" : "\n");
+    }
+    ofs << "  ]\n}\n";
+    if (!ofs) {
+        this->logError("Cannot write results to ", params.jsonPath.string());
+    }
+}
+
+void Session::reportScaling(ArrayView<const ScalingSample> samples) {
+    Array<String> scenarios;
+    for (const ScalingSample& sample : samples) {
+        if (std::find(scenarios.begin(), scenarios.end(), sample.point.scenario) == scenarios.end()) {
+            scenarios.push(sample.point.scenario);
+        }
+    }
+
+    for (const String& scenario : scenarios) {
+        Array<const ScalingSample*> points;
+        Size minThreadCnt = Size(-1);
+        for (const ScalingSample& sample : samples) {
+            if (sample.point.scenario == scenario) {
+                points.push(&sample);
+                minThreadCnt = min(minThreadCnt, sample.point.threadCnt);
+            }
+        }
+        auto find = [&points](const Size particleCnt, const Size threadCnt) -> const ScalingSample* {
+            for (const ScalingSample* sample : points) {
+                if (sample->point.particleCnt == particleCnt && sample->point.threadCnt == threadCnt) {
+                    return sample;
+                }
+            }
+            return nullptr;
+        };
+        auto getMean = [](const ScalingSample& sample, const bool useBaseline) -> Optional<Float> {
+            return useBaseline ? sample.baselineMean : Optional<Float>(sample.measuredMean);
+        };
+        // strong scaling compares the same problem size with the run using the fewest threads
+        auto strongEfficiency = [&](const ScalingSample& sample, const bool useBaseline) -> Optional<Float> {
+            const ScalingSample* reference = find(sample.point.particleCnt, minThreadCnt);
+            if (!reference) {
+                return NOTHING;
+            }
+            const Optional<Float> t1 = getMean(*reference, useBaseline);
+            const Optional<Float> tn = getMean(sample, useBaseline);
+            if (!t1 || !tn) {
+                return NOTHING;
+            }
+            return (t1.value() * minThreadCnt) / (tn.value() * sample.point.threadCnt);
+        };
+        // weak scaling compares runs with the same number of particles per thread
+        auto weakEfficiency = [&](const ScalingSample& sample, const bool useBaseline) -> Optional<Float> {
+            const Size scaledCnt = sample.point.particleCnt * minThreadCnt;
+            if (scaledCnt % sample.point.threadCnt != 0) {
+                return NOTHING;
+            }
+            const ScalingSample* reference = find(scaledCnt / sample.point.threadCnt, minThreadCnt);
+            if (!reference) {
+                return NOTHING;
+            }
+            const Optional<Float> t1 = getMean(*reference, useBaseline);
+            const Optional<Float> tn = getMean(sample, useBaseline);
+            if (!t1 || !tn) {
+                return NOTHING;
+            }
+            return t1.value() / tn.value();
+        };
+        auto formatEfficiency = [](const Optional<Float> efficiency, const Optional<Float> baseline) {
+            if (!efficiency) {
+                return String("-");
+            }
+            String result = toString(efficiency.value());
+            if (baseline) {
+                result += " (baseline " + toString(baseline.value()) + ")";
+            }
+            return result;
+        };
+
+        this->log("Scaling of ", scenario);
+        for (const ScalingSample* sample : points) {
+            const Float throughput = sample->point.particleCnt / (1.e-3_f * sample->measuredMean);
+            this->log("   N = ",
+                sample->point.particleCnt,
+                ", threads = ",
+                sample->point.threadCnt,
+                ": ",
+                sample->measuredMean,
+                " ms/step, ",
+                1.e-6_f * throughput,
+                " M particle-steps/s, strong efficiency ",
+                formatEfficiency(strongEfficiency(*sample, false), strongEfficiency(*sample, true)),
+                ", weak efficiency ",
+                formatEfficiency(weakEfficiency(*sample, false), weakEfficiency(*sample, true)));
+        }
     }
 }
 
@@ -178,9 +482,31 @@ Outcome Session::parseArgs(int argc, char* argv[]) {
         } else if (arg == "-r") {
             params.flags.set(Flag::RUN_AGAINST_BASELINE);
             if (i < argc - 1) {
-                params.baseline.commit = std::stoi(argv[i + 1]);
-                i++;
+                // optional index of the commit, the next argument can also be a benchmark name
+                if (const Optional<int> commit = fromString<int>(String::fromAscii(argv[i + 1]))) {
+                    params.baseline.commit = commit.value();
+                    i++;
+                }
             }
+        } else if (arg == "--robust") {
+            params.flags.set(Flag::ROBUST);
+        } else if (arg == "--warmup" && i < argc - 1) {
+            params.robust.warmupCnt = std::stoi(argv[++i]);
+        } else if (arg == "--outliers" && i < argc - 1) {
+            params.robust.madFactor = std::stof(argv[++i]);
+        } else if (arg == "--threshold" && i < argc - 1) {
+            params.robust.threshold = std::stof(argv[++i]);
+        } else if (arg == "--pin" && i < argc - 1) {
+            // either a single CPU or a range, for example 0-7
+            const Array<String> cpus = split(String::fromAscii(argv[++i]), '-');
+            const Optional<int> first = fromString<int>(cpus[0]);
+            const Optional<int> last = fromString<int>(cpus[cpus.size() - 1]);
+            if (!first || !last || cpus.size() > 2 || first.value() > last.value()) {
+                return makeFailed("Invalid CPU range {}", String::fromAscii(argv[i]));
+            }
+            params.pinnedCpus = Interval(first.value(), last.value());
+        } else if (arg == "--json" && i < argc - 1) {
+            params.jsonPath = Path(String::fromAscii(argv[++i]));
         } else if (arg == "--help") {
             this->printHelp();
             return Outcome(""); // empty error message to quit the program
@@ -206,7 +532,16 @@ Outcome Session::parseArgs(int argc, char* argv[]) {
 }
 
 void Session::printHelp() {
-    logger->write("Benchmark. Options:\n -b  Create baseline");
+    logger->write("Benchmark. Options:\n"
+                  " -b                 Create baseline\n"
+                  " -r [n]             Compare with baseline of n-th previous commit\n"
+                  " --robust           Reject outliers, compare using non-parametric tests and measure\n"
+                  "                    hardware counters; also stores samples when creating baseline\n"
+                  " --warmup <n>       Number of discarded startup iterations in robust mode\n"
+                  " --outliers <k>     Reject samples further than k*MAD from the median in robust mode\n"
+                  " --threshold <f>    Relative slowdown considered as a regression in robust mode\n"
+                  " --pin <cpu[-cpu]>  Pin benchmarks to given range of CPUs\n"
+                  " --json <path>      Write the results into a JSON file");
 }
 
 template <typename... TArgs>
@@ -227,4 +562,25 @@ Register::Register(const SharedPtr<Unit>& benchmark, const String& groupName) {
     Session::getInstance().registerBenchmark(benchmark, groupName);
 }
 
+RegisterScaling::RegisterScaling(const String& scenario,
+    const String& groupName,
+    std::initializer_list<Size> particleCnts,
+    std::initializer_list<Size> threadCnts,
+    const ScalingFunction func) {
+    const Size maxThreadCnt = std::thread::hardware_concurrency();
+    for (Size threadCnt : threadCnts) {
+        if (threadCnt > maxThreadCnt) {
+            continue;
+        }
+        for (Size particleCnt : particleCnts) {
+            const ScalingPoint point{ scenario, particleCnt, threadCnt };
+            const String name =
+                scenario + " N=" + toString(particleCnt) + " threads=" + toString(threadCnt);
+            Session::getInstance().registerBenchmark(
+                makeShared<Unit>(name, [func, point](Context& context) { func(context, point); }, point),
+                groupName);
+        }
+    }
+}
+
 NAMESPACE_BENCHMARK_END
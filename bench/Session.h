@@ -6,12 +6,16 @@
 /// \date 2016-2021
 
 #include "bench/Common.h"
+#include "bench/PerfCounters.h"
 #include "bench/Stats.h"
 #include "io/Logger.h"
 #include "io/Path.h"
 #include "objects/containers/Array.h"
 #include "objects/wrappers/Expected.h"
+#include "objects/wrappers/Function.h"
+#include "objects/wrappers/Optional.h"
 #include "objects/wrappers/Outcome.h"
+#include "objects/wrappers/RawPtr.h"
 #include "objects/wrappers/SharedPtr.h"
 #include "system/Timer.h"
 #include <fstream>
@@ -30,6 +34,9 @@ struct Target {
     Mode mode;
     uint64_t duration;
     Size iterateCnt;
+
+    /// Number of startup iterations excluded from the statistics
+    Size warmupCnt;
 };
 
 struct Result {
@@ -39,6 +46,25 @@ struct Result {
     Float variance;
     Float min;
     Float max;
+
+    /// Mean durations of individual phases of an iteration (in ms), if reported by the benchmark
+    std::map<String, Float> phases;
+
+    /// Durations of measured iterations (in ms)
+    Array<Float> samples;
+
+    /// Hardware counters of measured iterations, if available
+    Optional<PerfCounters::Values> counters;
+};
+
+/// Parameters of a single point of a scaling benchmark
+struct ScalingPoint {
+    /// Name of the scenario, shared by all points of the scaling curve
+    String scenario;
+
+    Size particleCnt;
+
+    Size threadCnt;
 };
 
 /// Accessible from benchmarks
@@ -56,29 +82,52 @@ private:
 
     Stats stats;
 
+    /// Durations of all measured iterations
+    Array<Float> samples;
+
+    /// Hardware counters, restarted together with the timer; may be nullptr
+    RawPtr<PerfCounters> counters;
+
+    /// Durations of phases of iterations, see \ref addPhase
+    std::map<String, Stats> phases;
+
     /// Name of the running benchmark
     String name;
 
 public:
-    Context(const Target target, const String& name)
+    Context(const Target target, const String& name, RawPtr<PerfCounters> counters = nullptr)
         : target(target)
         , timer(target.duration)
+        , counters(counters)
         , name(name) {}
 
     /// Whether to keep running or exit
     INLINE bool running() {
         state = this->shouldContinue();
-        if (iterateCnt <= 2) {
+        if (iterateCnt <= target.warmupCnt) {
             // restart to discard benchmark setup time and first few iterations (startup)
             timer.restart();
+            if (counters) {
+                counters->restart();
+            }
         } else {
-            stats.add(1.e-3_f * iterationTimer.elapsed(TimerUnit::MICROSECOND));
+            const Float duration = 1.e-3_f * iterationTimer.elapsed(TimerUnit::MICROSECOND);
+            stats.add(duration);
+            samples.push(duration);
         }
         iterationTimer.restart();
         iterateCnt++;
         return state;
     }
 
+    /// \brief Restarts the measurement of the current iteration.
+    ///
+    /// Allows to exclude the preparation of the iteration (for example resetting the state modified by the
+    /// previous iteration) from the measured duration. Hardware counters are not affected.
+    INLINE void restartIteration() {
+        iterationTimer.restart();
+    }
+
     INLINE uint64_t elapsed() const {
         return timer.elapsed(TimerUnit::MILLISECOND);
     }
@@ -91,6 +140,23 @@ public:
         return stats;
     }
 
+    INLINE const Array<Float>& getSamples() const {
+        return samples;
+    }
+
+    /// \brief Records the duration of a phase of the current iteration (in ms).
+    ///
+    /// Same as for the total duration, the startup iterations are not included in the statistics.
+    INLINE void addPhase(const String& phase, const Float duration) {
+        if (iterateCnt > target.warmupCnt) {
+            phases[phase].add(duration);
+        }
+    }
+
+    INLINE const std::map<String, Stats>& getPhases() const {
+        return phases;
+    }
+
     /// Writes given message into the logger
     template <typename... TArgs>
     INLINE void log(TArgs&&... args) {
@@ -118,28 +184,49 @@ class Unit {
 private:
     String name;
 
-    using Function = void (*)(Context&);
-    Function function;
+    Function<void(Context&)> function;
+
+    /// Set if the unit is a point of a scaling benchmark
+    Optional<ScalingPoint> point;
 
 public:
-    Unit(const String& name, const Function func)
+    Unit(const String& name, const Function<void(Context&)>& func)
         : name(name)
         , function(func) {
-        SPH_ASSERT(function != nullptr);
+        SPH_ASSERT(function);
+    }
+
+    Unit(const String& name, const Function<void(Context&)>& func, const ScalingPoint& point)
+        : Unit(name, func) {
+        this->point = point;
     }
 
     const String& getName() const {
         return name;
     }
 
-    Expected<Result> run(const Target target) {
-        Context context(target, name);
+    const Optional<ScalingPoint>& getScalingPoint() const {
+        return point;
+    }
+
+    Expected<Result> run(const Target target, RawPtr<PerfCounters> counters = nullptr) {
+        Context context(target, name, counters);
         function(context);
         uint64_t elapsed = context.elapsed();
         Stats stats = context.getStats();
-        return Result{
-            elapsed, context.iterationCnt() - 1, stats.mean(), stats.variance(), stats.min(), stats.max()
-        };
+        Result result{ elapsed,
+            context.iterationCnt() - 1,
+            stats.mean(),
+            stats.variance(),
+            stats.min(),
+            stats.max(),
+            {},
+            context.getSamples().clone(),
+            counters ? counters->read() : NOTHING };
+        for (const auto& phase : context.getPhases()) {
+            result.phases[phase.first] = phase.second.mean();
+        }
+        return result;
     }
 };
 
@@ -203,13 +290,13 @@ public:
         std::wstring wstr;
         while (std::getline(ifs, wstr)) {
             String line = String::fromWstring(wstr);
-            std::size_t n = line.findLast(L'/');
+            std::size_t n = line.find(L',');
             if (n == String::npos) {
                 return false;
             }
             const String name = line.substr(0, n).trim();
             Array<String> values = split(line.substr(n + 1), ',');
-            if (values.size() != 6) {
+            if (values.size() < 6) {
                 return false;
             }
             Result result;
@@ -219,18 +306,23 @@ public:
             result.variance = fromString<float>(values[3]).value();
             result.min = fromString<float>(values[4]).value();
             result.max = fromString<float>(values[5]).value();
+            // durations of individual iterations, stored in the robust mode
+            for (Size i = 6; i < values.size(); ++i) {
+                result.samples.push(fromString<float>(values[i]).value());
+            }
 
-            benchs[name] = result;
+            benchs[name] = std::move(result);
         }
         return true;
     }
 
-    bool isRecorded(const String& name) {
+    bool isRecorded(const String& name) const {
         return benchs.find(name) != benchs.end();
     }
 
-    INLINE Result operator[](const String& name) {
-        return benchs[name];
+    INLINE const Result& operator[](const String& name) const {
+        SPH_ASSERT(this->isRecorded(name));
+        return benchs.at(name);
     }
 };
 
@@ -257,6 +349,28 @@ private:
         MAKE_BASELINE = 1 << 1, ///< Record and cache baseline
 
         SILENT = 1 << 2, ///< Only print failed benchmarks
+
+        ROBUST = 1 << 3, ///< Use outlier rejection and non-parametric tests, measure hardware counters
+    };
+
+    /// Result of the comparison of a benchmark with the baseline
+    enum class Verdict {
+        SAME,
+        IMPROVEMENT,
+        REGRESSION,
+    };
+
+    struct Comparison {
+        Verdict verdict;
+
+        /// Ratio of measured and baseline durations
+        Float ratio;
+
+        /// Confidence interval of the ratio (robust mode only)
+        Optional<Interval> interval;
+
+        /// P-value of the test that the durations are equal (robust mode only)
+        Optional<Float> pValue;
     };
 
     struct {
@@ -272,10 +386,38 @@ private:
 
         Array<String> benchmarksToRun;
 
-        Target target{ Mode::SIMPLE, 500 /*ms*/, 10 };
+        Target target{ Mode::SIMPLE, 500 /*ms*/, 10, 2 };
 
         Float confidence = 6._f; // sigma
 
+        /// Parameters of the robust mode
+        struct {
+            /// Number of startup iterations excluded from the statistics
+            Size warmupCnt = 5;
+
+            /// Minimal number of measured iterations
+            Size minSampleCnt = 20;
+
+            /// Samples further than given multiple of the (scaled) median absolute deviation from the median
+            /// are rejected as outliers.
+            Float madFactor = 3.5_f;
+
+            /// Significance level of the Mann-Whitney test
+            Float alpha = 0.01_f;
+
+            /// Relative difference of the medians considered as a regression (or an improvement)
+            Float threshold = 0.03_f;
+
+            /// Confidence level of the bootstrap interval of the ratio of medians
+            Float intervalConfidence = 0.95_f;
+        } robust;
+
+        /// Range of logical CPUs the benchmark (and all threads it creates) are pinned to, if not empty.
+        Interval pinnedCpus;
+
+        /// If not empty, results are also written to this JSON file
+        Path jsonPath;
+
         /// Maximum allowed duration of single benchmark unit; benchmarks running longer that that will
         /// generate a warning.
         uint64_t maxAllowedDuration = 5000 /*ms*/;
@@ -289,8 +431,10 @@ public:
     /// Adds a new benchmark into the session.
     void registerBenchmark(const SharedPtr<Unit>& benchmark, const String& groupName);
 
-    /// Runs all benchmarks.
-    void run(int argc, char* argv[]);
+    /// \brief Runs all benchmarks.
+    ///
+    /// \return Number of benchmarks slower than the baseline, or -1 if the session failed.
+    int run(int argc, char* argv[]);
 
     ~Session();
 
@@ -305,7 +449,31 @@ private:
 
     Path getBaselinePath();
 
-    void compareResults(const Result& measured, const Result& baseline);
+    Comparison compareResults(const Result& measured, const Result& baseline);
+
+    /// \brief Compares results using the Mann-Whitney test and bootstrap interval of the ratio of medians.
+    Comparison compareRobust(const Result& measured, const Result& baseline);
+
+    /// \brief Removes outliers from the samples and recomputes the statistics.
+    ///
+    /// \return Number of rejected samples.
+    Size rejectOutliers(Result& result);
+
+    /// \brief Returns a JSON object with given results.
+    String toJson(const String& name, const Result& result, const Optional<Comparison>& comparison);
+
+    void writeJson(ArrayView<const String> records);
+
+    struct ScalingSample {
+        ScalingPoint point;
+        Float measuredMean;
+        Optional<Float> baselineMean;
+    };
+
+    /// \brief Prints strong and weak scaling efficiencies and throughputs of scaling benchmarks.
+    ///
+    /// If baseline results are available, efficiencies of the baseline are printed as well.
+    void reportScaling(ArrayView<const ScalingSample> samples);
 
     template <typename... TArgs>
     void log(TArgs&&... args);
@@ -323,6 +491,23 @@ public:
     Register(const SharedPtr<Unit>& benchmark, const String& groupName);
 };
 
+/// \brief Registers a scaling benchmark, consisting of units for all combinations of given particle counts
+/// and thread counts.
+///
+/// Thread counts larger than the number of hardware threads are skipped. To obtain weak scaling
+/// efficiencies, the particle counts should be multiples of the smallest one, with the same ratios as the
+/// thread counts.
+class RegisterScaling {
+public:
+    using ScalingFunction = void (*)(Context&, const ScalingPoint&);
+
+    RegisterScaling(const String& scenario,
+        const String& groupName,
+        std::initializer_list<Size> particleCnts,
+        std::initializer_list<Size> threadCnts,
+        const ScalingFunction func);
+};
+
 #define BENCHMARK_UNIQUE_NAME_IMPL(prefix, line) prefix##line
 
 #define BENCHMARK_UNIQUE_NAME(prefix, line) BENCHMARK_UNIQUE_NAME_IMPL(prefix, line)
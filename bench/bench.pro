@@ -12,15 +12,29 @@ include(../core/sharedCore.pro)
 
 SOURCES += main.cpp \
     Session.cpp \
+    Robust.cpp \
+    PerfCounters.cpp \
     ../core/objects/finders/benchmark/Finders.cpp \
     ../core/sph/kernel/benchmark/Kernel.cpp \
     ../core/gravity/benchmark/Gravity.cpp \
     ../core/gravity/benchmark/NBodySolver.cpp \
     ../core/objects/containers/benchmark/Map.cpp \
+    ../core/quantities/benchmark/Storage.cpp \
+    ../core/sph/benchmark/Materials.cpp \
     ../core/sph/solvers/benchmark/Solvers.cpp \
-    ../core/timestepping/benchmark/Timestepping.cpp
+    ../core/timestepping/benchmark/Timestepping.cpp \
+    ../core/run/benchmark/Scenarios.cpp
+
+# benchmarks of the GUI code, requires wxWidgets and the gui library
+gui {
+    include(../gui/sharedGui.pro)
+    LIBS = ../gui/libgui.a $$LIBS
+    SOURCES += ../gui/benchmark/ImageTransform.cpp
+}
 
 HEADERS += \
     Session.h \
     Stats.h \
+    Robust.h \
+    PerfCounters.h \
     Common.h
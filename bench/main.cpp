@@ -5,6 +5,6 @@
 /// Benchmark can run
 
 int main(int argc, char* argv[]) {
-    Sph::Benchmark::Session::getInstance().run(argc, argv);
-    return 0;
+    // non-zero exit code if any benchmark is slower than the baseline, so that it can be used for gating
+    return Sph::Benchmark::Session::getInstance().run(argc, argv) == 0 ? 0 : 1;
 }
@@ -0,0 +1,84 @@
+#include "bench/Robust.h"
+#include "catch.hpp"
+#include "tests/Approx.h"
+
+using namespace Sph;
+
+static Array<Float> getSequence(const Float from, const Float to, const Float step) {
+    Array<Float> values;
+    for (Float value = from; value <= to; value += step) {
+        values.push(value);
+    }
+    return values;
+}
+
+TEST_CASE("Robust median", "[robust]") {
+    REQUIRE(Benchmark::median(Array<Float>{ 3._f }) == 3._f);
+    REQUIRE(Benchmark::median(Array<Float>{ 5._f, 1._f, 3._f }) == 3._f);
+    REQUIRE(Benchmark::median(Array<Float>{ 4._f, 1._f, 3._f, 2._f }) == 2.5_f);
+}
+
+TEST_CASE("Robust rejectOutliers", "[robust]") {
+    REQUIRE(Benchmark::rejectOutliers(Array<Float>{}, 3._f).empty());
+
+    // median is 10 and MAD is 0.2, so the limit is k * 1.4826 * 0.2 from the median
+    Array<Float> samples{ 10._f, 10.1_f, 9.9_f, 10.2_f, 9.8_f, 10._f, 50._f, 10.4_f, 9.5_f };
+    REQUIRE(Benchmark::rejectOutliers(samples, 1.5_f) ==
+            Array<Float>({ 10._f, 10.1_f, 9.9_f, 10.2_f, 9.8_f, 10._f, 10.4_f }));
+    REQUIRE(Benchmark::rejectOutliers(samples, 3._f) ==
+            Array<Float>({ 10._f, 10.1_f, 9.9_f, 10.2_f, 9.8_f, 10._f, 10.4_f, 9.5_f }));
+
+    // zero MAD, samples are kept
+    samples = { 1._f, 1._f, 1._f, 2._f };
+    REQUIRE(Benchmark::rejectOutliers(samples, 3._f) == samples);
+}
+
+TEST_CASE("Robust mannWhitneyTest", "[robust]") {
+    const Array<Float> lower = getSequence(1._f, 10._f, 1._f);
+    const Array<Float> upper = getSequence(11._f, 20._f, 1._f);
+    // reference values are computed by R, using wilcox.test(x, y, exact = FALSE)
+    REQUIRE(Benchmark::mannWhitneyTest(lower, upper) == approx(1.826718e-4_f, 1.e-5_f));
+    REQUIRE(Benchmark::mannWhitneyTest(upper, lower) == approx(1.826718e-4_f, 1.e-5_f));
+
+    const Array<Float> odd = getSequence(1._f, 19._f, 2._f);
+    const Array<Float> even = getSequence(2._f, 20._f, 2._f);
+    REQUIRE(Benchmark::mannWhitneyTest(odd, even) == approx(0.7337300_f, 1.e-5_f));
+
+    // ties
+    const Array<Float> tied1{ 1._f, 1._f, 2._f, 2._f, 3._f, 3._f, 4._f, 5._f, 5._f, 6._f };
+    const Array<Float> tied2{ 2._f, 3._f, 3._f, 4._f, 5._f, 6._f, 6._f, 7._f, 7._f, 8._f };
+    REQUIRE(Benchmark::mannWhitneyTest(tied1, tied2) == approx(0.04723892_f, 1.e-5_f));
+
+    REQUIRE(Benchmark::mannWhitneyTest(lower, lower) == 1._f);
+    REQUIRE(Benchmark::mannWhitneyTest(lower, Array<Float>{}) == 1._f);
+    Array<Float> constant(10);
+    constant.fill(1._f);
+    REQUIRE(Benchmark::mannWhitneyTest(constant, constant) == 1._f);
+}
+
+TEST_CASE("Robust bootstrapMedianRatio", "[robust]") {
+    // without variance, all resampled medians are the same
+    Array<Float> samples1(15);
+    samples1.fill(2._f);
+    Array<Float> samples2(20);
+    samples2.fill(3._f);
+    REQUIRE(Benchmark::bootstrapMedianRatio(samples1, samples2, 0.95_f) == Interval(1.5_f, 1.5_f));
+
+    // resampled medians of the second set lie between 15 and 25
+    samples1.fill(10._f);
+    samples2 = getSequence(15._f, 25._f, 0.5_f);
+    const Interval interval = Benchmark::bootstrapMedianRatio(samples1, samples2, 0.95_f);
+    REQUIRE(interval.contains(2._f));
+    REQUIRE(interval.lower() >= 1.5_f);
+    REQUIRE(interval.upper() <= 2.5_f);
+    REQUIRE(interval.size() > 0._f);
+
+    // deterministic
+    REQUIRE(Benchmark::bootstrapMedianRatio(samples1, samples2, 0.95_f) == interval);
+
+    // lower confidence yields narrower interval
+    const Interval narrow = Benchmark::bootstrapMedianRatio(samples1, samples2, 0.5_f);
+    REQUIRE(narrow.lower() >= interval.lower());
+    REQUIRE(narrow.upper() <= interval.upper());
+    REQUIRE(narrow.size() < interval.size());
+}
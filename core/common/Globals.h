@@ -22,6 +22,13 @@ using Size = uint32_t;
 /// Signed integral type, used where negative numbers are necessary. Should match Size.
 using SignedSize = int32_t;
 
+/// \brief Integral type used for global particle indices and counters of interactions.
+///
+/// Indices into arrays, neighbor lists and trees always use Size, so that the memory traffic of the hot loops
+/// is not increased. Persistent particle indices and counters accumulated over all particles (or pairs of
+/// particles) can exceed the range of Size for large simulations, though; these use GlobalSize.
+using GlobalSize = uint64_t;
+
 /// Number of spatial dimensions in the code.
 constexpr int DIMENSIONS = 3;
 
@@ -15,11 +15,13 @@ SOURCES += \
     io/Logger.cpp \
     io/Output.cpp \
     io/Path.cpp \
+    io/Sequence.cpp \
     io/Vdb.cpp \
     math/Curve.cpp \
     math/Morton.cpp \
     math/SparseMatrix.cpp \
     math/rng/Rng.cpp \
+    objects/containers/BasicAllocators.cpp \
     objects/containers/String.cpp \
     objects/finders/HashMapFinder.cpp \
     objects/finders/IncrementalFinder.cpp \
@@ -55,6 +57,7 @@ SOURCES += \
     quantities/QuantityIds.cpp \
     quantities/Storage.cpp \
     quantities/Utility.cpp \
+    run/InSituAnalysis.cpp \
     run/IRun.cpp \
     run/Job.cpp \
     run/Node.cpp \
@@ -136,6 +139,7 @@ HEADERS += \
     io/Logger.h \
     io/Output.h \
     io/Path.h \
+    io/Sequence.h \
     io/Serializer.h \
     io/Table.h \
     io/Vdb.h \
@@ -262,6 +266,7 @@ HEADERS += \
     quantities/QuantityHelpers.h \
     quantities/QuantityIds.h \
     quantities/Storage.h \
+    run/InSituAnalysis.h \
     run/IRun.h \
     run/Job.h \
     run/Node.h \
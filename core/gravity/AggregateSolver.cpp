@@ -8,481 +8,436 @@
 #include "sph/Materials.h"
 #include "system/Factory.h"
 #include "system/Statistics.h"
+#include "thread/AtomicFloat.h"
 #include "thread/CheckFunction.h"
-#include <mutex>
+#include "thread/Scheduler.h"
 
 NAMESPACE_SPH_BEGIN
 
 const Vector MAX_SPIN = Vector(0.1_f);
 
-/// \brief Aggregate of particles, moving as a rigid body according to Euler's equations.
+/// \brief Holds a set of aggregates of particles, moving as rigid bodies according to Euler's equations.
 ///
-/// \todo
-/// Not owning the particles, bound to a \ref Storage object. Not compatible with mergers.
-class Aggregate : public Noncopyable {
+/// Aggregates are disjoint sets of particles, stored in a union-find structure. Each aggregate is
+/// represented by one of its particles (the root), which also holds the rotational state of the aggregate
+/// (angular frequency and phase angle). Particles of each aggregate are linked into a circular list, so that
+/// the aggregate can be traversed without scanning all particles. Integrals of aggregates (mass, center of
+/// mass, inertia tensor, angular momentum) are stored in separate arrays, indexed by the root.
+///
+/// Queries are lock-free and can be called from multiple threads concurrently; the path compression is
+/// done using atomic operations. Merging and separating of aggregates must be done from a single thread,
+/// which is the case for collision and overlap handlers. Aggregates are integrated in parallel.
+class AggregateHolder : public IAggregateObserver, public Noncopyable {
 private:
-    RawPtr<Storage> storage;
-
-    /// Indices of particles belonging to this aggregate
-    /// \todo check performance compared to std::set
-    FlatSet<Size> idxs;
-
-    /// Index of the aggregate. Does not generally correspond to the index of the aggregate in the parent \ref
-    /// AggregateHolder.
-    Size persistentId;
-
-public:
-    /// Needed due to resize
-    Aggregate() = default;
-
-    /// Single particle
-    Aggregate(Storage& storage, const Size particleIdx)
-        : storage(addressOf(storage)) {
-        idxs.insert(particleIdx);
-        persistentId = particleIdx;
-    }
+    IScheduler& scheduler;
 
-    explicit Aggregate(Storage& storage, IndexSequence seq)
-        : storage(addressOf(storage)) {
-        for (Size i : seq) {
-            idxs.insert(i);
-        }
-        persistentId = *seq.begin();
-    }
+    RawPtr<Storage> storage;
 
-    void add(const Size idx) {
-        SPH_ASSERT(!idxs.contains(idx));
-        idxs.insert(idx);
-        //        this->fixVelocities();
-    }
+    /// Parent of each particle in the union-find structure; roots are their own parents.
+    mutable Array<Atomic<Size>> parents;
 
-    void remove(const Size idx) {
-        idxs.erase(idxs.find(idx));
-    }
+    /// Next particle of the same aggregate, forming a circular list.
+    Array<Size> next;
 
-    void clear() {
-        idxs.clear();
-    }
+    /// Number of particles in the aggregate, valid only for roots.
+    Array<Size> sizes;
 
-    bool contains(const Size idx) const {
-        return idxs.find(idx) != idxs.end();
-    }
+    /// Integrals of aggregates, valid only for roots.
+    struct {
+        Array<Float> m;
+        Array<Vector> r_com;
+        Array<Vector> v_com;
+        Array<SymmetricTensor> I;
+        Array<Vector> L;
+        Array<Vector> omega;
+    } integrals;
 
-    Size getId() const {
-        return persistentId;
-    }
+    /// Number of aggregates with more than one particle, updated in \ref integrate.
+    std::atomic<Size> aggregateCnt;
 
-    /// Modifies velocities according to saved angular frequency
-    void spin() {
-        if (this->size() == 1) {
-            return;
+public:
+    AggregateHolder(IScheduler& scheduler, Storage& storage, const AggregateEnum source)
+        : scheduler(scheduler)
+        , storage(addressOf(storage)) {
+        const Size n = storage.getParticleCnt();
+        this->resize(n);
+        for (Size i = 0; i < n; ++i) {
+            parents.emplaceBack(i);
+            next[i] = i;
+            sizes[i] = 1;
         }
-
-        ArrayView<Vector> r = storage->getValue<Vector>(QuantityId::POSITION);
-        ArrayView<Vector> v = storage->getDt<Vector>(QuantityId::POSITION);
-        ArrayView<Vector> alpha = storage->getValue<Vector>(QuantityId::PHASE_ANGLE);
-        ArrayView<const Vector> w = storage->getValue<Vector>(QuantityId::ANGULAR_FREQUENCY);
-
-        ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
-        Float m_ag = 0._f;
-        Vector r_com(0._f);
-        Vector v_com(0._f);
-        for (Size i : idxs) {
-            r_com += m[i] * r[i];
-            v_com += m[i] * v[i];
-            m_ag += m[i];
+        ArrayView<const Float> m = storage.getValue<Float>(QuantityId::MASS);
+        for (Size i = 0; i < n; ++i) {
+            integrals.m[i] = m[i];
         }
-        r_com /= m_ag;
-        v_com /= m_ag;
-        SPH_ASSERT(isReal(r_com) && getLength(r_com) < LARGE, r_com);
 
-        const Vector omega = clamp(w[persistentId], -MAX_SPIN, MAX_SPIN);
-        AffineMatrix rotationMatrix = AffineMatrix::identity();
-
-        if (alpha[persistentId] != Vector(0._f)) {
-            Vector dir;
-            Float angle;
-            tieToTuple(dir, angle) = getNormalizedWithLength(alpha[persistentId]);
-            alpha[persistentId] = Vector(0._f);
-            rotationMatrix = AffineMatrix::rotateAxis(dir, angle);
+        switch (source) {
+        case AggregateEnum::PARTICLES:
+            // each particle is a separate aggregate
+            break;
+        case AggregateEnum::MATERIALS: {
+            for (Size matId = 0; matId < storage.getMaterialCnt(); ++matId) {
+                IndexSequence seq = storage.getMaterial(matId).sequence();
+                const Size root = *seq.begin();
+                for (Size i : seq) {
+                    if (i != root) {
+                        this->link(root, i);
+                    }
+                }
+            }
+            break;
         }
-
-        for (Size i : idxs) {
-            SPH_ASSERT(alpha[i] == Vector(0._f));
-            Float h = r[i][H];
-            r[i] = r_com + rotationMatrix * (r[i] - r_com);
-            v[i] += cross(omega, r[i] - r_com);
-            r[i][H] = h;
-            v[i][H] = 0._f;
+        default:
+            NOT_IMPLEMENTED;
         }
+        aggregateCnt = this->countAggregates();
     }
 
-    /// Saves angular frequency, sets velocities to COM movement
-    void integrate() {
-        SPH_ASSERT(this->size() > 0);
-        if (this->size() == 1) {
-            return;
+    /// \brief Returns the root particle of the aggregate holding the given particle.
+    Size find(const Size particleIdx) const {
+        Size idx = particleIdx;
+        while (true) {
+            Size parent = parents[idx].get();
+            if (parent == idx) {
+                return idx;
+            }
+            const Size grandparent = parents[parent].get();
+            if (grandparent != parent) {
+                // path halving; if the exchange fails, the path has been modified by other thread
+                parents[idx].compareExchange(parent, grandparent);
+            }
+            idx = grandparent;
         }
-        ArrayView<Vector> r, v, dv;
-        tie(r, v, dv) = storage->getAll<Vector>(QuantityId::POSITION);
-        ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
+    }
 
-        Float m_ag = 0._f;
-        Vector r_com(0._f);
-        Vector v_com(0._f);
-        Vector dv_com(0._f);
-        for (Size i : idxs) {
-            dv_com += m[i] * dv[i];
-            v_com += m[i] * v[i];
-            r_com += m[i] * r[i];
-            m_ag += m[i];
+    /// \brief Merges two aggregates, given by their roots.
+    ///
+    /// If the smaller aggregate is a single particle, it is added to the larger one; otherwise the smaller
+    /// aggregate is broken into separate particles. Velocities of particles are set to the bulk velocity and
+    /// rotation of the larger aggregate.
+    void merge(const Size first, const Size second) {
+        CHECK_FUNCTION(CheckFunction::NON_REENRANT);
+        SPH_ASSERT(this->isRoot(first) && this->isRoot(second));
+        if (first == second) {
+            return;
         }
-        dv_com /= m_ag;
-        v_com /= m_ag;
-        r_com /= m_ag;
-
-        Vector L(0._f);
-        SymmetricTensor I = SymmetricTensor::null(); // inertia tensor
-        Vector M(0._f);                              // torque
-        for (Size i : idxs) {
-            const Vector dr = r[i] - r_com;
-            L += m[i] * cross(dr, v[i] - v_com);
-            I += m[i] * (SymmetricTensor::identity() * getSqrLength(dr) - symmetricOuter(dr, dr));
-            M += m[i] * cross(dr, dv[i] - dv_com);
+        Size root1 = first;
+        Size root2 = second;
+        if (sizes[root1] < sizes[root2]) {
+            std::swap(root1, root2);
         }
-
-        ArrayView<Vector> w, dw;
-        tie(w, dw) = storage->getAll<Vector>(QuantityId::ANGULAR_FREQUENCY);
-
-
-        const bool singular = I.determinant() == 0._f;
-        Vector omega = Vector(0._f);
-        if (!singular) {
-
-            omega = I.inverse() * L;
-
-            // const Vector w_loc = Em.transpose() * w[index];
-
-            // compute the change of angular velocity using Euler's equations
-            // dw[index] = I_inv * (M - cross(w[index], I * w[index]));
+        if (sizes[root2] > 1) {
+            this->disband(root2);
+            this->fixVelocities(root1);
+            return;
         }
 
-
-        /*const SymmetricTensor I = Post::getInertiaTensor(m, r, r_com);
-        (void)I;*/
-
+        // the merged root becomes an ordinary member, so it cannot hold a pending rotation
         ArrayView<Vector> alpha, dalpha;
         tie(alpha, dalpha) = storage->getAll<Vector>(QuantityId::PHASE_ANGLE);
+        alpha[root2] = dalpha[root2] = Vector(0._f);
 
-        for (Size i : idxs) {
-            v[i] = v_com;
-            dv[i] = dv_com;
-            w[i] = omega;
+        parents[root2] = root1;
+        // splice the circular lists
+        std::swap(next[root1], next[root2]);
+        sizes[root1] += sizes[root2];
+        integrals.m[root1] += integrals.m[root2];
 
-            SPH_ASSERT(alpha[i] == Vector(0._f));
-        }
-        alpha[persistentId] = Vector(0._f);
-        dalpha[persistentId] = w[persistentId];
+        this->fixVelocities(root1);
     }
 
-    // replaces unordered motion with bulk velocity + rotation
-    void fixVelocities() {
-        const Integrals ag = this->getIntegrals();
-        ArrayView<Vector> r, v, dv;
-        tie(r, v, dv) = storage->getAll<Vector>(QuantityId::POSITION);
-        for (Size i : idxs) {
-            v[i] = ag.v_com + cross(ag.omega, r[i] - ag.r_com);
-            v[i][H] = 0._f;
+    /// \brief Removes a particle from its aggregate, making it a separate aggregate.
+    ///
+    /// Root particles cannot be separated; the function does nothing in such case.
+    void separate(const Size root, const Size idx) {
+        CHECK_FUNCTION(CheckFunction::NON_REENRANT);
+        SPH_ASSERT(this->isRoot(root) && this->find(idx) == root);
+        if (idx == root) {
+            return; /// \todo ?? how to do this
         }
-    }
 
-    Float mass() const {
-        ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
-        Float m_ag = 0._f;
-        for (Size i : idxs) {
-            m_ag += m[i];
+        // make sure no particle has idx as its parent and find the predecessor in the list
+        Size prev = root;
+        for (Size i = root; next[i] != root; i = next[i]) {
+            parents[next[i]] = root;
+            if (next[i] == idx) {
+                prev = i;
+            }
         }
-        return m_ag;
+        next[prev] = next[idx];
+        next[idx] = idx;
+        parents[idx] = idx;
+        sizes[root]--;
+        sizes[idx] = 1;
+        ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
+        integrals.m[root] -= m[idx];
+        integrals.m[idx] = m[idx];
+
+        this->fixVelocities(root);
     }
 
-    Vector velocity() const {
+    /// \brief Breaks the aggregate, making each of its particles a separate aggregate.
+    void disband(const Size root) {
+        CHECK_FUNCTION(CheckFunction::NON_REENRANT);
+        SPH_ASSERT(this->isRoot(root));
+        ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
+        Size i = root;
+        do {
+            const Size j = next[i];
+            parents[i] = i;
+            next[i] = i;
+            sizes[i] = 1;
+            integrals.m[i] = m[i];
+            i = j;
+        } while (i != root);
+    }
+
+    /// \brief Replaces unordered motion of particles with the bulk velocity and rotation of the aggregate.
+    void fixVelocities(const Size root) {
+        this->computeIntegrals(root);
         ArrayView<Vector> r, v, dv;
         tie(r, v, dv) = storage->getAll<Vector>(QuantityId::POSITION);
-        ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
-
-        Float m_ag = 0._f;
-        Vector v_com(0._f);
-        for (Size i : idxs) {
-            v_com += m[i] * v[i];
-            m_ag += m[i];
-        }
-        v_com /= m_ag;
-        return v_com;
+        const Vector& r_com = integrals.r_com[root];
+        const Vector& v_com = integrals.v_com[root];
+        const Vector& omega = integrals.omega[root];
+        this->forEachParticle(root, [&](const Size i) {
+            v[i] = v_com + cross(omega, r[i] - r_com);
+            v[i][H] = 0._f;
+        });
     }
 
-    void displace(const Vector& offset) {
+    /// \brief Moves all particles of the aggregate by given offset.
+    void displace(const Size root, const Vector& offset) {
         SPH_ASSERT(offset[H] == 0._f);
-
         ArrayView<Vector> r = storage->getValue<Vector>(QuantityId::POSITION);
-        for (Size i : idxs) {
-            r[i] += offset;
-        }
+        this->forEachParticle(root, [&](const Size i) { r[i] += offset; });
     }
 
-
-    Size size() const {
-        return idxs.size();
+    /// \brief Returns the total mass of the aggregate.
+    Float mass(const Size root) const {
+        SPH_ASSERT(this->isRoot(root));
+        return integrals.m[root];
     }
 
-    bool empty() const {
-        return idxs.empty();
-    }
+    /// \brief Rotates all aggregates by their accumulated phase angles and adds the rotational velocities.
+    void spin() {
+        ArrayView<Vector> r = storage->getValue<Vector>(QuantityId::POSITION);
+        ArrayView<Vector> v = storage->getDt<Vector>(QuantityId::POSITION);
+        ArrayView<Vector> alpha = storage->getValue<Vector>(QuantityId::PHASE_ANGLE);
+        ArrayView<const Vector> w = storage->getValue<Vector>(QuantityId::ANGULAR_FREQUENCY);
+        ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
 
-    auto begin() const {
-        return idxs.begin();
-    }
+        parallelFor(scheduler, 0, parents.size(), [&](const Size root) {
+            if (!this->isRoot(root) || sizes[root] == 1) {
+                return;
+            }
+            Vector r_com(0._f);
+            this->forEachParticle(root, [&](const Size i) { r_com += m[i] * r[i]; });
+            r_com /= integrals.m[root];
+            SPH_ASSERT(isReal(r_com) && getLength(r_com) < LARGE, r_com);
+
+            const Vector omega = clamp(w[root], -MAX_SPIN, MAX_SPIN);
+            AffineMatrix rotationMatrix = AffineMatrix::identity();
+            if (alpha[root] != Vector(0._f)) {
+                Vector dir;
+                Float angle;
+                tieToTuple(dir, angle) = getNormalizedWithLength(alpha[root]);
+                alpha[root] = Vector(0._f);
+                rotationMatrix = AffineMatrix::rotateAxis(dir, angle);
+            }
 
-    auto end() const {
-        return idxs.end();
+            this->forEachParticle(root, [&](const Size i) {
+                SPH_ASSERT(alpha[i] == Vector(0._f));
+                const Float h = r[i][H];
+                r[i] = r_com + rotationMatrix * (r[i] - r_com);
+                v[i] += cross(omega, r[i] - r_com);
+                r[i][H] = h;
+                v[i][H] = 0._f;
+            });
+        });
     }
 
-private:
-    struct Integrals {
-        Float m;
-        Vector r_com;
-        Vector v_com;
-        Vector omega;
-        SymmetricTensor I;
-        Vector L;
-    };
-
-    Integrals getIntegrals() const {
+    /// \brief Integrates all aggregates.
+    ///
+    /// Saves the angular frequency of each aggregate and sets velocities and accelerations of particles to
+    /// the movement of the center of mass.
+    void integrate() {
         ArrayView<Vector> r, v, dv;
         tie(r, v, dv) = storage->getAll<Vector>(QuantityId::POSITION);
+        ArrayView<Vector> w = storage->getValue<Vector>(QuantityId::ANGULAR_FREQUENCY);
+        ArrayView<Vector> alpha, dalpha;
+        tie(alpha, dalpha) = storage->getAll<Vector>(QuantityId::PHASE_ANGLE);
         ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
 
-        Float m_ag = 0._f;
-        Vector r_com(0._f);
-        Vector v_com(0._f);
-        for (Size i : idxs) {
-            v_com += m[i] * v[i];
-            r_com += m[i] * r[i];
-            m_ag += m[i];
-        }
-        v_com /= m_ag;
-        r_com /= m_ag;
-
-        Vector L(0._f);
-        SymmetricTensor I = SymmetricTensor::null(); // inertia tensor
-        for (Size i : idxs) {
-            const Vector dr = r[i] - r_com;
-            L += m[i] * cross(dr, v[i] - v_com);
-            I += m[i] * (SymmetricTensor::identity() * getSqrLength(dr) - symmetricOuter(dr, dr));
-        }
-
-        Integrals value;
-        value.m = m_ag;
-        value.r_com = r_com;
-        value.v_com = v_com;
-        value.I = I;
-        value.L = L;
-
-        if (I.determinant() != 0._f) {
-            value.omega = clamp(I.inverse() * L, -MAX_SPIN, MAX_SPIN);
-        } else {
-            value.omega = Vector(0._f);
-        }
-        return value;
-    }
-};
-
-/// \brief Holds a set of aggregates.
-///
-/// Bound to \ref Storage object. Thread-safe??
-class AggregateHolder : public IAggregateObserver, public Noncopyable {
-private:
-    /// Holds all aggregates for the storage given in constructor.
-    Array<Aggregate> aggregates;
-
-    /// Contains a pointer to aggregate containing the particle with given index.
-    ///
-    /// The array is precomputed in constructor and maintained during aggregate merging, it is necessary for
-    /// fast particle-to-aggregate queries.
-    Array<RawPtr<Aggregate>> particleToAggregate;
-
-    /// Lock needed for thread-safe access to aggregates via \ref IAggregateObserver interface.
-    mutable std::mutex mutex;
-
-public:
-    AggregateHolder(Storage& storage, const AggregateEnum source) {
-        // create an aggregate for each particle, even if its empty, so we can add particles to it later
-        // without reallocations
-        const Size n = storage.getParticleCnt();
-        aggregates.resize(n);
-
-        switch (source) {
-        case AggregateEnum::PARTICLES: {
-            for (Size i = 0; i < n; ++i) {
-                aggregates[i] = Aggregate(storage, i);
-                particleToAggregate.emplaceBack(addressOf(aggregates[i]));
+        parallelFor(scheduler, 0, parents.size(), [&](const Size root) {
+            if (!this->isRoot(root) || sizes[root] == 1) {
+                return;
             }
-            break;
-        }
-        case AggregateEnum::MATERIALS: {
-            for (Size matId = 0; matId < storage.getMaterialCnt(); ++matId) {
-                MaterialView mat = storage.getMaterial(matId);
-                IndexSequence seq = mat.sequence();
-                // need to create all aggregates to storage pointer to storage
-                for (Size i : seq) {
-                    aggregates[i] = Aggregate(storage, i);
-                    aggregates[i].clear();
-                }
+            Vector dv_com(0._f);
+            this->forEachParticle(root, [&](const Size i) { dv_com += m[i] * dv[i]; });
+            dv_com /= integrals.m[root];
 
-                const Size idx = *seq.begin();
-                aggregates[idx] = Aggregate(storage, seq);
-
-                for (Size i = 0; i < seq.size(); ++i) {
-                    particleToAggregate.emplaceBack(addressOf(aggregates[idx]));
-                }
-            }
-            break;
-        }
-        default:
-            NOT_IMPLEMENTED;
-        }
-    }
+            this->computeIntegrals(root);
+            const SymmetricTensor& I = integrals.I[root];
+            const Vector omega = I.determinant() != 0._f ? I.inverse() * integrals.L[root] : Vector(0._f);
+            const Vector v_com = integrals.v_com[root];
 
-    /// \brief Returns the aggregate holding the given particle.
-    Aggregate& getAggregate(const Size particleIdx) {
-        Aggregate& ag = *particleToAggregate[particleIdx];
-        SPH_ASSERT(ag.contains(particleIdx));
-        return ag;
-    }
+            this->forEachParticle(root, [&](const Size i) {
+                v[i] = v_com;
+                dv[i] = dv_com;
+                w[i] = omega;
+                SPH_ASSERT(alpha[i] == Vector(0._f));
+            });
+            alpha[root] = Vector(0._f);
+            dalpha[root] = w[root];
+        });
 
-    /// \copydoc getAggregate
-    const Aggregate& getAggregate(const Size particleIdx) const {
-        const Aggregate& ag = *particleToAggregate[particleIdx];
-        SPH_ASSERT(ag.contains(particleIdx));
-        return ag;
+        aggregateCnt = this->countAggregates();
     }
 
-    /// \brief Merges two aggregates.
-    /*merge(Aggregate& ag1, Aggregate& ag2) {
-         CHECK_FUNCTION(CheckFunction::NON_REENRANT);
-         std::unique_lock<std::mutex> lock(mutex);
-
-         if (ag1.size() > ag1.size()) {
-             ag1.merge(ag2);
-         } else {
-             ag2.merge(ag1);
-         }
-         // SPH_ASSERT(ag1.contains(ag1.getId()));
-         // relink pointers of ag2 particles to ag1
-         for (Size i : ag2) {
-             particleToAggregate[i] = addressOf(ag1);
-         }
-
-         // remove all particles from ag2; we actually keep the aggregate in the holder (with zero particles)
-         // for simplicity, otherwise we would have to shift the aggregates in the array, invalidating the
-         // pointers held in particleToAggregate.
-         ag2.clear();
-         SPH_ASSERT(ag2.size() == 0);
-     }*/
-
-    void merge(Aggregate& ag1, Aggregate& ag2) {
-        if (ag1.size() < ag2.size()) {
-            this->merge(ag2, ag1);
-            return;
-        }
-
-        SPH_ASSERT(ag1.size() >= ag2.size());
-        // accumulate single particle
-        if (ag2.size() == 1) {
-            const Size id = ag2.getId();
-            ag1.add(id);
-            particleToAggregate[id] = &ag1;
-            ag2.clear();
+    Optional<Size> getAggregateId(const Size particleIdx) const {
+        const Size root = this->find(particleIdx);
+        if (sizes[root] > 1) {
+            return root;
         } else {
-
-            // break the aggregate
-            this->disband(ag2);
+            return NOTHING;
         }
-
-        ag1.fixVelocities();
     }
 
-    void separate(Aggregate& ag, const Size idx) {
-
-        if (ag.getId() == idx) {
-            return; /// \todo ?? how to do this
-        }
-
-        aggregates[idx].add(idx);
-        particleToAggregate[idx] = addressOf(aggregates[idx]);
-        ag.remove(idx);
-        ag.fixVelocities();
+    virtual Size count() const override {
+        return aggregateCnt;
     }
 
-    void disband(Aggregate& ag) {
-        const Size mainId = ag.getId();
-        for (Size i : ag) {
-            // put the particle back to its original aggregate
-            if (i != mainId) {
-                aggregates[i].add(i);
-                particleToAggregate[i] = addressOf(aggregates[i]);
+    virtual void remove(ArrayView<const Size> idxs) override {
+        const Size n = parents.size();
+        Array<Size> newIdxs(n);
+        Size newCnt = 0;
+        for (Size i = 0, removedIdx = 0; i < n; ++i) {
+            if (removedIdx < idxs.size() && idxs[removedIdx] == i) {
+                newIdxs[i] = Size(-1);
+                ++removedIdx;
+            } else {
+                newIdxs[i] = newCnt++;
             }
         }
 
-        ag.clear();
-        ag.add(mainId);
-    }
-
-    void spin() {
-        // std::unique_lock<std::mutex> lock(mutex);
-        for (Aggregate& ag : aggregates) {
-            if (!ag.empty()) {
-                ag.spin();
+        // the first remaining particle of each aggregate becomes its new root
+        Array<Size> oldRoots(n);
+        Array<Size> newRoots(n);
+        newRoots.fill(Size(-1));
+        for (Size i = 0; i < n; ++i) {
+            oldRoots[i] = this->find(i);
+            if (newIdxs[i] != Size(-1) && newRoots[oldRoots[i]] == Size(-1)) {
+                newRoots[oldRoots[i]] = newIdxs[i];
             }
         }
-    }
-
-    /// \brief Integrates all aggregates
-    void integrate() {
-        // std::unique_lock<std::mutex> lock(mutex);
 
-        for (Aggregate& ag : aggregates) {
-            if (!ag.empty()) {
-                ag.integrate();
+        this->resize(newCnt);
+        // particles have been already removed from the storage
+        ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
+        SPH_ASSERT(m.size() == newCnt);
+        for (Size i = 0; i < n; ++i) {
+            const Size j = newIdxs[i];
+            if (j == Size(-1)) {
+                continue;
+            }
+            const Size root = newRoots[oldRoots[i]];
+            parents.emplaceBack(root);
+            next[j] = j;
+            sizes[j] = 1;
+            integrals.m[j] = m[j];
+            if (root != j) {
+                // roots are always processed before other particles of the aggregate
+                next[j] = next[root];
+                next[root] = j;
+                sizes[root]++;
+                integrals.m[root] += m[j];
             }
         }
+        aggregateCnt = this->countAggregates();
     }
 
-    Optional<Size> getAggregateId(const Size particleIdx) const {
-        std::unique_lock<std::mutex> lock(mutex);
-        const Aggregate& ag = getAggregate(particleIdx);
-        if (ag.size() > 1) {
-            return ag.getId();
-        } else {
-            return NOTHING;
-        }
-    }
-
-    virtual Size count() const override {
-        std::unique_lock<std::mutex> lock(mutex);
+private:
+    void resize(const Size n) {
+        parents.clear();
+        parents.reserve(n);
+        next.resize(n);
+        sizes.resize(n);
+        integrals.m.resize(n);
+        integrals.r_com.resize(n);
+        integrals.v_com.resize(n);
+        integrals.I.resize(n);
+        integrals.L.resize(n);
+        integrals.omega.resize(n);
+    }
+
+    bool isRoot(const Size idx) const {
+        return parents[idx].get() == idx;
+    }
+
+    /// Adds a single-particle aggregate into the aggregate with given root.
+    void link(const Size root, const Size idx) {
+        SPH_ASSERT(this->isRoot(idx) && sizes[idx] == 1);
+        parents[idx] = root;
+        next[idx] = next[root];
+        next[root] = idx;
+        sizes[root]++;
+        integrals.m[root] += integrals.m[idx];
+    }
+
+    template <typename TFunctor>
+    INLINE void forEachParticle(const Size root, const TFunctor& functor) const {
+        Size i = root;
+        do {
+            functor(i);
+            i = next[i];
+        } while (i != root);
+    }
+
+    Size countAggregates() const {
         Size cnt = 0;
-        for (const Aggregate& ag : aggregates) {
-            if (ag.size() > 1) {
+        for (Size i = 0; i < parents.size(); ++i) {
+            if (this->isRoot(i) && sizes[i] > 1) {
                 cnt++;
             }
         }
         return cnt;
     }
 
-    virtual void remove(ArrayView<const Size> idxs) override {
-        for (Size i : reverse(idxs)) {
-            Aggregate& ag = getAggregate(i);
-            ag.remove(i);
-            particleToAggregate.remove(i);
+    /// Computes the center of mass, inertia tensor, angular momentum and angular frequency of the aggregate.
+    void computeIntegrals(const Size root) {
+        ArrayView<const Vector> r, v, dv;
+        tie(r, v, dv) = storage->getAll<Vector>(QuantityId::POSITION);
+        ArrayView<const Float> m = storage->getValue<Float>(QuantityId::MASS);
+
+        Float m_ag = 0._f;
+        Vector r_com(0._f);
+        Vector v_com(0._f);
+        this->forEachParticle(root, [&](const Size i) {
+            v_com += m[i] * v[i];
+            r_com += m[i] * r[i];
+            m_ag += m[i];
+        });
+        v_com /= m_ag;
+        r_com /= m_ag;
+
+        Vector L(0._f);
+        SymmetricTensor I = SymmetricTensor::null();
+        this->forEachParticle(root, [&](const Size i) {
+            const Vector dr = r[i] - r_com;
+            L += m[i] * cross(dr, v[i] - v_com);
+            I += m[i] * (SymmetricTensor::identity() * getSqrLength(dr) - symmetricOuter(dr, dr));
+        });
+
+        integrals.m[root] = m_ag;
+        integrals.r_com[root] = r_com;
+        integrals.v_com[root] = v_com;
+        integrals.I[root] = I;
+        integrals.L[root] = L;
+        if (I.determinant() != 0._f) {
+            integrals.omega[root] = clamp(I.inverse() * L, -MAX_SPIN, MAX_SPIN);
+        } else {
+            integrals.omega[root] = Vector(0._f);
         }
     }
 };
@@ -521,9 +476,9 @@ public:
         // this function SHOULD be called by one thread only, so we do not need to lock here
         CHECK_FUNCTION(CheckFunction::NON_REENRANT);
 
-        Aggregate& ag_i = holder->getAggregate(i);
-        Aggregate& ag_j = holder->getAggregate(j);
-        if (addressOf(ag_i) == addressOf(ag_j)) {
+        const Size root_i = holder->find(i);
+        const Size root_j = holder->find(j);
+        if (root_i == root_j) {
             // particles belong to the same aggregate, do not process collision
             return CollisionResult::NONE;
         }
@@ -534,38 +489,18 @@ public:
         v[j] = this->reflect(v[j], v_com, dr);
         v[i][H] = v[j][H] = 0._f;
 
-        /*if (getSqrLength(v[i] - ag_i.velocity()) > sqr(MAX_STRAIN)) {
-            holder->separate(ag_i, i);
-        }
-
-        if (getSqrLength(v[j] - ag_j.velocity()) > sqr(MAX_STRAIN)) {
-            holder->separate(ag_j, j);
-        }*/
-
         // particle are moved back after collision handling, so we need to make sure they have correct
         // velocities to not move them away from the aggregate
-        ag_i.fixVelocities();
-        ag_j.fixVelocities();
-
-        /*
-                if (ag_i.size() > ag_j.size()) {
-                    holder->disband(ag_j);
-                } else {
-                    holder->disband(ag_i);
-                }*/
+        holder->fixVelocities(root_i);
+        holder->fixVelocities(root_j);
 
         // if the particles are gravitationally bound, add them to the aggregate, otherwise bounce
         if (areParticlesBound(m[i] + m[j], r[i][H] + r[j][H], v[i] - v[j], bounceLimit)) {
-            // add to aggregate
-            holder->merge(ag_i, ag_j);
-
+            holder->merge(root_i, root_j);
             return CollisionResult::NONE;
-
-
         } else {
-            holder->separate(ag_i, i);
-            holder->separate(ag_j, j);
-
+            holder->separate(root_i, i);
+            holder->separate(root_j, j);
             return CollisionResult::BOUNCE;
         }
     }
@@ -607,9 +542,7 @@ public:
 
     virtual bool overlaps(const Size i, const Size j) const override {
         // this is called from multiple threads, but we are not doing any merging here
-        const Aggregate& ag_i = holder->getAggregate(i);
-        const Aggregate& ag_j = holder->getAggregate(j);
-        if (addressOf(ag_i) == addressOf(ag_j)) {
+        if (holder->find(i) == holder->find(j)) {
             // false as in "overlap does not have to be handled"
             return false;
         }
@@ -620,12 +553,12 @@ public:
         // this function SHOULD be called by one thread only, so we do not need to lock here
         CHECK_FUNCTION(CheckFunction::NON_REENRANT);
 
-        Aggregate& ag_i = holder->getAggregate(i);
-        Aggregate& ag_j = holder->getAggregate(j);
+        const Size root_i = holder->find(i);
+        const Size root_j = holder->find(j);
 
         // even though we previously checked for this in function overlaps, the particles might have been
         // assinged to the same aggregate during collision processing, so we have to check again
-        if (addressOf(ag_i) == addressOf(ag_j)) {
+        if (root_i == root_j) {
             return;
         }
 
@@ -639,12 +572,12 @@ public:
             return;
         }
 
-        const Float m1 = ag_i.mass(); /// \todo precompute
-        const Float m2 = ag_j.mass();
+        const Float m1 = holder->mass(root_i);
+        const Float m2 = holder->mass(root_j);
         const Float x1 = (r[i][H] + r[j][H] - dist) / (1._f + m1 / m2);
         const Float x2 = m1 / m2 * x1;
-        ag_i.displace(dir * x1);
-        ag_j.displace(-dir * x2);
+        holder->displace(root_i, dir * x1);
+        holder->displace(root_j, -dir * x2);
 
         handler.collide(i, j, toRemove);
     }
@@ -655,7 +588,8 @@ AggregateSolver::AggregateSolver(IScheduler& scheduler, const RunSettings& setti
           settings,
           Factory::getGravity(settings),
           makeAuto<AggregateCollisionHandler>(settings),
-          makeAuto<AggregateOverlapHandler>(settings)) {}
+          makeAuto<AggregateOverlapHandler>(settings))
+    , scheduler(scheduler) {}
 // makeAuto<RepelHandler<AggregateCollisionHandler>>(settings)) {}
 
 
@@ -668,9 +602,9 @@ void AggregateSolver::integrate(Storage& storage, Statistics& stats) {
 
     // storage IDs and aggregate stats
     ArrayView<Size> aggregateIds = storage.getValue<Size>(QuantityId::AGGREGATE_ID);
-    for (Size i = 0; i < aggregateIds.size(); ++i) {
+    parallelFor(scheduler, 0, aggregateIds.size(), [&](const Size i) {
         aggregateIds[i] = holder->getAggregateId(i).valueOr(Size(-1));
-    }
+    });
     stats.set(StatisticsId::AGGREGATE_COUNT, int(holder->count()));
 }
 
@@ -689,7 +623,7 @@ void AggregateSolver::create(Storage& storage, IMaterial& material) const {
 }
 
 void AggregateSolver::createAggregateData(Storage& storage, const AggregateEnum source) {
-    holder = makeShared<AggregateHolder>(storage, source);
+    holder = makeShared<AggregateHolder>(scheduler, storage, source);
     storage.setUserData(holder);
 }
 
@@ -30,8 +30,14 @@ static RegisterEnum<AggregateEnum> sAggregate({
     { AggregateEnum::FLAGS, "flags", "" },
 });
 
+/// \brief Solver treating groups of particles as rigid bodies.
+///
+/// Particles are merged into aggregates on collisions if they are gravitationally bound. Aggregates are
+/// integrated in parallel; the particle-to-aggregate queries are lock-free.
 class AggregateSolver : public HardSphereSolver {
 private:
+    IScheduler& scheduler;
+
     /// Holds all aggregates in the simulation.
     ///
     /// Shared with storage.
@@ -7,6 +7,7 @@
 #include "system/Profiler.h"
 #include "system/Statistics.h"
 #include "thread/Scheduler.h"
+#include "thread/ThreadLocal.h"
 
 NAMESPACE_SPH_BEGIN
 
@@ -19,12 +20,14 @@ BarnesHut::BarnesHut(const Float theta,
     const MultipoleOrder order,
     const Size leafSize,
     const Size maxDepth,
-    const Float gravityConstant)
+    const Float gravityConstant,
+    const bool compactMoments)
     : kdTree(leafSize, maxDepth)
     , thetaInv(1._f / theta)
     , order(order)
     , maxDepth(maxDepth)
-    , G(gravityConstant) {
+    , G(gravityConstant)
+    , useCompactMoments(compactMoments) {
     // use default-constructed kernel; it works, because by default LutKernel has zero radius and functions
     // valueImpl and gradImpl are never called.
     // Check by assert to make sure this trick will work
@@ -37,13 +40,15 @@ BarnesHut::BarnesHut(const Float theta,
     GravityLutKernel&& kernel,
     const Size leafSize,
     const Size maxDepth,
-    const Float gravityConstant)
+    const Float gravityConstant,
+    const bool compactMoments)
     : kdTree(leafSize, maxDepth)
     , kernel(std::move(kernel))
     , thetaInv(1._f / theta)
     , order(order)
     , maxDepth(maxDepth)
-    , G(gravityConstant) {
+    , G(gravityConstant)
+    , useCompactMoments(compactMoments) {
     SPH_ASSERT(theta > 0._f, theta);
 }
 
@@ -63,22 +68,54 @@ void BarnesHut::build(IScheduler& scheduler, const Storage& storage) {
     kdTree.build(scheduler, r, FinderFlag::SKIP_RANK);
 
     if (SPH_UNLIKELY(r.empty())) {
+        rootMoments = MultipoleExpansion<3>();
         return;
     }
-    // constructs nodes
-    auto functor = [this](BarnesHutNode& node, BarnesHutNode* left, BarnesHutNode* right) INL {
-        if (node.isLeaf()) {
-            SPH_ASSERT(left == nullptr && right == nullptr);
-            buildLeaf(node);
-
-        } else {
-            SPH_ASSERT(left != nullptr && right != nullptr);
-            buildInner(node, *left, *right);
+    // sort the nodes by their depth; as the nodes are listed in breadth-first order, each level is a contiguous
+    // range of indices
+    Array<Size> nodeIdxs;
+    Array<Size> levelOffsets;
+    nodeIdxs.push(0);
+    levelOffsets.push(0);
+    for (Size from = 0; from < nodeIdxs.size();) {
+        const Size to = nodeIdxs.size();
+        for (Size i = from; i < to; ++i) {
+            const BarnesHutNode& node = kdTree.getNode(nodeIdxs[i]);
+            if (!node.isLeaf()) {
+                const InnerNode<BarnesHutNode>& inner = reinterpret_cast<const InnerNode<BarnesHutNode>&>(node);
+                nodeIdxs.push(inner.left);
+                nodeIdxs.push(inner.right);
+            }
         }
-        return true;
-    };
-    /// \todo sequential needed because TBB cannot wait on child tasks yet
-    iterateTree<IterateDirection::BOTTOM_UP>(kdTree, SEQUENTIAL, functor, 0, maxDepth);
+        levelOffsets.push(to);
+        from = to;
+    }
+
+    // constructs nodes; moments of inner nodes are computed from their children, so the levels are processed
+    // from the deepest one up, all nodes of the level in parallel
+    moments.resize(kdTree.getNodeCnt());
+    for (Size level = levelOffsets.size() - 1; level > 0; --level) {
+        parallelFor(scheduler, levelOffsets[level - 1], levelOffsets[level], [this, &nodeIdxs](const Size i) {
+            const Size nodeIdx = nodeIdxs[i];
+            if (kdTree.getNode(nodeIdx).isLeaf()) {
+                buildLeaf(nodeIdx);
+            } else {
+                buildInner(nodeIdx);
+            }
+        });
+    }
+
+    rootMoments = moments[0];
+    if (useCompactMoments) {
+        compactMoments.resize(kdTree.getNodeCnt());
+        parallelFor(scheduler, 0, kdTree.getNodeCnt(), [this](const Size nodeIdx) { //
+            buildCompactMoments(nodeIdx);
+        });
+        // the treewalk only reads the compact moments, do not keep both arrays in memory
+        moments = Array<MultipoleExpansion<3>>();
+    } else {
+        compactMoments.clear();
+    }
 }
 
 void BarnesHut::evalSelfGravity(IScheduler& scheduler, ArrayView<Vector> dv, Statistics& stats) const {
@@ -91,8 +128,9 @@ void BarnesHut::evalSelfGravity(IScheduler& scheduler, ArrayView<Vector> dv, Sta
     });
     rootTask->wait();
 
-    stats.set<int>(StatisticsId::GRAVITY_NODES_APPROX, result.approximatedNodes);
-    stats.set<int>(StatisticsId::GRAVITY_NODES_EXACT, result.exactNodes);
+    // the counts can exceed the range of int for large simulations
+    stats.set<GlobalSize>(StatisticsId::GRAVITY_NODES_APPROX, result.approximatedNodes);
+    stats.set<GlobalSize>(StatisticsId::GRAVITY_NODES_EXACT, result.exactNodes);
     stats.set<int>(StatisticsId::GRAVITY_NODE_COUNT, kdTree.getNodeCnt());
 }
 
@@ -125,8 +163,55 @@ Vector BarnesHut::evalAcceleration(const Vector& r0) const {
     return this->evalImpl(r0, Size(-1));
 }
 
-Float BarnesHut::evalEnergy(IScheduler& UNUSED(scheduler), Statistics& UNUSED(stats)) const {
-    NOT_IMPLEMENTED;
+Float BarnesHut::evalEnergy(IScheduler& scheduler, Statistics& UNUSED(stats)) const {
+    ThreadLocal<Float> energy(scheduler, 0._f);
+    parallelFor(scheduler, energy, 0, r.size(), [this](const Size i, Float& e) { //
+        e += m[i] * this->evalPotential(r[i], i);
+    });
+    // masses are multiplied by G, divide once to get the energy
+    return 0.5_f * energy.accumulate() / G;
+}
+
+/// Stack of nodes used by the treewalk evaluated at a single point. It is thread_local, so that the stack is
+/// allocated only once per thread rather than for each evaluated point.
+static thread_local Array<Size> pointWalkStack;
+
+Float BarnesHut::evalPotential(const Vector& r0, const Size idx) const {
+    if (SPH_UNLIKELY(r.empty())) {
+        return 0._f;
+    }
+    SymmetrizeSmoothingLengths<const GravityLutKernel&> actKernel(kernel);
+    Float phi = 0._f;
+    Array<Size>& stack = pointWalkStack;
+    stack.clear();
+    stack.push(0);
+    while (!stack.empty()) {
+        const Size nodeIdx = stack.pop();
+        const BarnesHutNode& node = kdTree.getNode(nodeIdx);
+        if (node.box == Box::EMPTY()) {
+            continue;
+        }
+        const Float boxSizeSqr = getSqrLength(node.box.size());
+        const Float boxDistSqr = getSqrLength(node.box.center() - r0);
+
+        if (!node.box.contains(r0) && boxSizeSqr > 0._f &&
+            boxSizeSqr / (boxDistSqr + EPS) < 1._f / sqr(thetaInv)) {
+            // approximate the node by the multipole expansion of the same order as the accelerations
+            phi += evaluatePotential(r0 - node.com, this->getNodeMoments(nodeIdx), order);
+        } else if (node.isLeaf()) {
+            const LeafNode<BarnesHutNode>& leaf = reinterpret_cast<const LeafNode<BarnesHutNode>&>(node);
+            for (Size i : kdTree.getLeafIndices(leaf)) {
+                if (i != idx) {
+                    phi += m[i] * actKernel.value(r[i], r0);
+                }
+            }
+        } else {
+            const InnerNode<BarnesHutNode>& inner = reinterpret_cast<const InnerNode<BarnesHutNode>&>(node);
+            stack.push(inner.right);
+            stack.push(inner.left);
+        }
+    }
+    return phi;
 }
 
 Vector BarnesHut::evalImpl(const Vector& r0, const Size idx) const {
@@ -134,12 +219,15 @@ Vector BarnesHut::evalImpl(const Vector& r0, const Size idx) const {
         return Vector(0._f);
     }
     Vector f(0._f);
-
-    auto lambda = [this, &r0, &f, idx](
-                      const BarnesHutNode& node, const BarnesHutNode*, const BarnesHutNode*) {
+    Array<Size>& stack = pointWalkStack;
+    stack.clear();
+    stack.push(0);
+    while (!stack.empty()) {
+        const Size nodeIdx = stack.pop();
+        const BarnesHutNode& node = kdTree.getNode(nodeIdx);
         if (node.box == Box::EMPTY()) {
             // no particles in this node, skip
-            return false;
+            continue;
         }
         const Float boxSizeSqr = getSqrLength(node.box.size());
         const Float boxDistSqr = getSqrLength(node.box.center() - r0);
@@ -147,24 +235,19 @@ Vector BarnesHut::evalImpl(const Vector& r0, const Size idx) const {
 
         if (!node.box.contains(r0) && boxSizeSqr > 0._f &&
             boxSizeSqr / (boxDistSqr + EPS) < 1._f / sqr(thetaInv)) {
-            // small node, use multipole approximation
-            f += evaluateGravity(r0 - node.com, node.moments, order);
-
-            // skip the children
-            return false;
+            // small node, use multipole approximation and skip the children
+            f += evaluateGravity(r0 - node.com, this->getNodeMoments(nodeIdx), order);
+        } else if (node.isLeaf()) {
+            // too large box; sum each particle of the leaf
+            const LeafNode<BarnesHutNode>& leaf = reinterpret_cast<const LeafNode<BarnesHutNode>&>(node);
+            f += this->evalExact(leaf, r0, idx);
         } else {
-            // too large box; if inner, recurse into children, otherwise sum each particle of the leaf
-            if (node.isLeaf()) {
-                const LeafNode<BarnesHutNode>& leaf = reinterpret_cast<const LeafNode<BarnesHutNode>&>(node);
-                f += this->evalExact(leaf, r0, idx);
-                return false; // return value doesn't matter here
-            } else {
-                // continue with children
-                return true;
-            }
+            // too large box; continue with children, left child first
+            const InnerNode<BarnesHutNode>& inner = reinterpret_cast<const InnerNode<BarnesHutNode>&>(node);
+            stack.push(inner.right);
+            stack.push(inner.left);
         }
-    };
-    iterateTree<IterateDirection::TOP_DOWN>(kdTree, SEQUENTIAL, lambda);
+    }
 
     return f;
 }
@@ -352,13 +435,32 @@ void BarnesHut::evalNodeList(const LeafNode<BarnesHutNode>& leaf,
     LeafIndexSequence seq1 = kdTree.getLeafIndices(leaf);
     for (Size idx : nodeList) {
         const BarnesHutNode& node = kdTree.getNode(idx);
+        const MultipoleExpansion<3> ms = this->getNodeMoments(idx);
         SPH_ASSERT(seq1.size() > 0);
         for (Size i : seq1) {
-            dv[i] += evaluateGravity(r[i] - node.com, node.moments, order);
+            dv[i] += evaluateGravity(r[i] - node.com, ms, order);
         }
     }
 }
 
+MultipoleExpansion<3> BarnesHut::getNodeMoments(const Size nodeIdx) const {
+    if (!useCompactMoments) {
+        return moments[nodeIdx];
+    }
+    const CompactMultipoleExpansion& compact = compactMoments[nodeIdx];
+    MultipoleExpansion<3> ms;
+    ms.order<0>() = compact.mass;
+    const Float f2 = compact.mass * sqr(compact.scale);
+    for (Size i = 0; i < 5; ++i) {
+        ms.order<2>()[i] = compact.q2[i] * f2;
+    }
+    const Float f3 = f2 * compact.scale;
+    for (Size i = 0; i < 7; ++i) {
+        ms.order<3>()[i] = compact.q3[i] * f3;
+    }
+    return ms;
+}
+
 Vector BarnesHut::evalExact(const LeafNode<BarnesHutNode>& leaf, const Vector& r0, const Size idx) const {
     LeafIndexSequence sequence = kdTree.getLeafIndices(leaf);
     Vector f(0._f);
@@ -371,17 +473,18 @@ Vector BarnesHut::evalExact(const LeafNode<BarnesHutNode>& leaf, const Vector& r
     return f;
 }
 
-void BarnesHut::buildLeaf(BarnesHutNode& node) {
-    LeafNode<BarnesHutNode>& leaf = (LeafNode<BarnesHutNode>&)node;
+void BarnesHut::buildLeaf(const Size nodeIdx) {
+    LeafNode<BarnesHutNode>& leaf = (LeafNode<BarnesHutNode>&)kdTree.getNode(nodeIdx);
+    MultipoleExpansion<3>& ms = moments[nodeIdx];
 
     switch (leaf.size()) {
     case 0:
         // empty leaf - set to zero to correctly compute mass and com of parent nodes
         leaf.com = Vector(0._f);
-        leaf.moments.order<0>() = 0._f;
-        leaf.moments.order<1>() = TracelessMultipole<1>(0._f);
-        leaf.moments.order<2>() = TracelessMultipole<2>(0._f);
-        leaf.moments.order<3>() = TracelessMultipole<3>(0._f);
+        ms.order<0>() = 0._f;
+        ms.order<1>() = TracelessMultipole<1>(0._f);
+        ms.order<2>() = TracelessMultipole<2>(0._f);
+        ms.order<3>() = TracelessMultipole<3>(0._f);
         leaf.r_open = 0._f;
         return;
     case 1:
@@ -389,10 +492,10 @@ void BarnesHut::buildLeaf(BarnesHutNode& node) {
         const Size i = *kdTree.getLeafIndices(leaf).begin();
         leaf.com = r[i];
         leaf.box.extend(r[i]);
-        leaf.moments.order<0>() = m[i];
-        leaf.moments.order<1>() = TracelessMultipole<1>(0._f);
-        leaf.moments.order<2>() = TracelessMultipole<2>(0._f);
-        leaf.moments.order<3>() = TracelessMultipole<3>(0._f);
+        ms.order<0>() = m[i];
+        ms.order<1>() = TracelessMultipole<1>(0._f);
+        ms.order<2>() = TracelessMultipole<2>(0._f);
+        ms.order<3>() = TracelessMultipole<3>(0._f);
         leaf.r_open = 0._f;
         return;
     }
@@ -418,24 +521,16 @@ void BarnesHut::buildLeaf(BarnesHutNode& node) {
 
     // compute gravitational moments from individual particles
     // M0 is a sum of particle masses, M1 is a dipole moment = zero around center of mass
-    Multipole<1> M_com = toMultipole(leaf.com);
-    SPH_ASSERT(computeMultipole<0>(r, m, M_com, sequence).value() == m_leaf);
-    const Multipole<2> M2 = computeMultipole<2>(r, m, M_com, sequence);
-    const Multipole<3> M3 = computeMultipole<3>(r, m, M_com, sequence);
-
-    // compute traceless tensors to reduce number of independent components
-    const TracelessMultipole<2> q2 = computeReducedMultipole(M2);
-    const TracelessMultipole<3> q3 = computeReducedMultipole(M3);
-
-    // save the moments to the leaf
-    leaf.moments.order<0>() = m_leaf;
-    leaf.moments.order<1>() = TracelessMultipole<1>(0._f);
-    leaf.moments.order<2>() = q2;
-    leaf.moments.order<3>() = q3;
+    ms = computeMultipoleExpansion(r, m, leaf.com, sequence);
+    ms.order<0>() = m_leaf;
+    ms.order<1>() = TracelessMultipole<1>(0._f);
 }
 
-void BarnesHut::buildInner(BarnesHutNode& node, BarnesHutNode& left, BarnesHutNode& right) {
-    InnerNode<BarnesHutNode>& inner = (InnerNode<BarnesHutNode>&)node;
+void BarnesHut::buildInner(const Size nodeIdx) {
+    InnerNode<BarnesHutNode>& inner = (InnerNode<BarnesHutNode>&)kdTree.getNode(nodeIdx);
+    const BarnesHutNode& left = kdTree.getNode(inner.left);
+    const BarnesHutNode& right = kdTree.getNode(inner.right);
+    MultipoleExpansion<3>& ms = moments[nodeIdx];
 
     // update bounding box
     inner.box = Box::EMPTY();
@@ -443,17 +538,17 @@ void BarnesHut::buildInner(BarnesHutNode& node, BarnesHutNode& left, BarnesHutNo
     inner.box.extend(right.box);
 
     // update center of mass
-    const Float ml = left.moments.order<0>();
-    const Float mr = right.moments.order<0>();
+    const Float ml = moments[inner.left].order<0>();
+    const Float mr = moments[inner.right].order<0>();
 
     // check for empty node
     if (ml + mr == 0._f) {
         // set to zero to correctly compute sum and com of parent nodes
         inner.com = Vector(0._f);
-        inner.moments.order<0>() = 0._f;
-        inner.moments.order<1>() = TracelessMultipole<1>(0._f);
-        inner.moments.order<2>() = TracelessMultipole<2>(0._f);
-        inner.moments.order<3>() = TracelessMultipole<3>(0._f);
+        ms.order<0>() = 0._f;
+        ms.order<1>() = TracelessMultipole<1>(0._f);
+        ms.order<2>() = TracelessMultipole<2>(0._f);
+        ms.order<3>() = TracelessMultipole<3>(0._f);
         inner.r_open = 0._f;
         return;
     }
@@ -466,29 +561,37 @@ void BarnesHut::buildInner(BarnesHutNode& node, BarnesHutNode& left, BarnesHutNo
     SPH_ASSERT(minElement(r_max) >= 0._f, r_max);
     inner.r_open = 2._f / sqrt(3._f) * thetaInv * getLength(r_max);
 
-    inner.moments.order<0>() = ml + mr;
-
     // we already computed moments of children nodes, sum up using parallel axis theorem
-    Multipole<1> d = toMultipole(left.com - inner.com);
-    TracelessMultipole<1>& Ml1 = left.moments.order<1>();
-    TracelessMultipole<2>& Ml2 = left.moments.order<2>();
-    TracelessMultipole<3>& Ml3 = left.moments.order<3>();
-    inner.moments.order<1>() = parallelAxisTheorem(Ml1, ml, d);
-    inner.moments.order<2>() = parallelAxisTheorem(Ml2, ml, d);
-    inner.moments.order<3>() = parallelAxisTheorem(Ml3, Ml2, ml, d);
-
-    d = toMultipole(right.com - inner.com);
-    TracelessMultipole<1>& Mr1 = right.moments.order<1>();
-    TracelessMultipole<2>& Mr2 = right.moments.order<2>();
-    TracelessMultipole<3>& Mr3 = right.moments.order<3>();
-    inner.moments.order<1>() += parallelAxisTheorem(Mr1, mr, d);
-    inner.moments.order<2>() += parallelAxisTheorem(Mr2, mr, d);
-    inner.moments.order<3>() += parallelAxisTheorem(Mr3, Mr2, mr, d);
+    ms = MultipoleExpansion<3>();
+    addTranslatedMoments(ms, moments[inner.left], left.com - inner.com);
+    addTranslatedMoments(ms, moments[inner.right], right.com - inner.com);
+}
+
+void BarnesHut::buildCompactMoments(const Size nodeIdx) {
+    const BarnesHutNode& node = kdTree.getNode(nodeIdx);
+    const MultipoleExpansion<3>& ms = moments[nodeIdx];
+    CompactMultipoleExpansion& compact = compactMoments[nodeIdx];
+    compact.mass = ms.order<0>();
+    // size of the node measured from the center of mass, the normalized moments are thus bounded by one;
+    // empty leaves and leaves with a single particle have zero opening radius and no higher moments
+    Float scale = 0._f;
+    if (node.r_open > 0._f) {
+        scale = getLength(max(node.com - node.box.lower(), node.box.upper() - node.com));
+    }
+    const Float f2 = compact.mass * sqr(scale);
+    const Float f3 = f2 * scale;
+    compact.scale = scale;
+    for (Size i = 0; i < 5; ++i) {
+        compact.q2[i] = f2 > 0._f ? float(ms.order<2>()[i] / f2) : 0.f;
+    }
+    for (Size i = 0; i < 7; ++i) {
+        compact.q3[i] = f3 > 0._f ? float(ms.order<3>()[i] / f3) : 0.f;
+    }
 }
 
 MultipoleExpansion<3> BarnesHut::getMoments() const {
     // masses are premultiplied by gravitational constants, so we have to divide
-    return kdTree.getNode(0).moments.multiply(1._f / G);
+    return rootMoments.multiply(1._f / G);
 }
 
 RawPtr<const IBasicFinder> BarnesHut::getFinder() const {
@@ -19,13 +19,14 @@ NAMESPACE_SPH_BEGIN
 
 enum class MultipoleOrder;
 
+/// \brief Node of the K-d tree used by \ref BarnesHut.
+///
+/// Only contains data needed to traverse the tree; gravitational moments of the node are stored separately,
+/// indexed by the node index.
 struct BarnesHutNode : public KdNode {
     /// Center of mass of contained particles
     Vector com;
 
-    /// Gravitational moments with a respect to the center of mass, using expansion to octupole order.
-    MultipoleExpansion<3> moments;
-
     /// Opening radius of the node; see Eq. (2.36) of Stadel PhD thesis
     /// \todo can be stored as 4th component of com.
     Float r_open;
@@ -39,6 +40,25 @@ struct BarnesHutNode : public KdNode {
     }
 };
 
+/// \brief Gravitational moments of a node up to octupole order, stored in single precision.
+///
+/// Quadrupole and octupole moments are divided by the mass of the node and the corresponding power of the
+/// node size, so that the stored values are of order unity in any unit system. The mass and the size are
+/// stored in double precision. The dipole moment is zero with respect to the center of mass and it is
+/// therefore not stored.
+struct CompactMultipoleExpansion {
+    /// Mass of the node (moment of zeroth order)
+    Float mass;
+
+    /// Length used to normalize the moments
+    Float scale;
+
+    /// Independent components of the normalized quadrupole moment
+    float q2[5];
+
+    /// Independent components of the normalized octupole moment
+    float q3[7];
+};
 
 /// \brief Multipole approximation of distance particle.
 class BarnesHut : public IGravity {
@@ -49,9 +69,20 @@ protected:
     /// Particle masses multiplied by gravitational constant.
     Array<Float> m;
 
-    /// K-d tree storing gravitational moments
+    /// K-d tree used to find nodes for multipole approximation
     KdTree<BarnesHutNode> kdTree;
 
+    /// Gravitational moments of tree nodes with a respect to their centers of mass, using expansion to
+    /// octupole order. If compact moments are enabled, the array is only used during the construction of
+    /// the tree and released afterwards.
+    Array<MultipoleExpansion<3>> moments;
+
+    /// Moments of tree nodes in single precision, used by the treewalk if compact moments are enabled.
+    Array<CompactMultipoleExpansion> compactMoments;
+
+    /// Moments of the root node in double precision, kept even if the full moments are released.
+    MultipoleExpansion<3> rootMoments;
+
     /// Kernel used to evaluate gravity of close particles
     GravityLutKernel kernel;
 
@@ -72,6 +103,9 @@ protected:
     /// \todo generalize
     Float G = Constants::gravity;
 
+    /// If true, the treewalk uses moments stored in single precision.
+    bool useCompactMoments;
+
 public:
     /// \brief Constructs the Barnes-Hut gravity assuming point-like particles (with zero radius).
     ///
@@ -79,11 +113,14 @@ public:
     /// \param order Order of multipole approximation
     /// \param leafSize Maximum number of particles in a leaf
     /// \param maxDepth Maximum parallel depth for tree contruction and evaluation
+    /// \param compactMoments If true, moments are stored in single precision to reduce memory traffic of the
+    ///                       treewalk; accelerations are still summed up in double precision.
     BarnesHut(const Float theta,
         const MultipoleOrder order,
         const Size leafSize = 25,
         const Size maxDepth = 50,
-        const Float gravityConstant = Constants::gravity);
+        const Float gravityConstant = Constants::gravity,
+        const bool compactMoments = false);
 
     /// \brief Constructs the Barnes-Hut gravity with given smoothing kernel
     ///
@@ -92,12 +129,15 @@ public:
     /// \param kernel Precomputed gravity smoothing kernel
     /// \param leafSize Maximum number of particles in a leaf
     /// \param maxDepth Maximum parallel depth for tree contruction and evaluation
+    /// \param compactMoments If true, moments are stored in single precision to reduce memory traffic of the
+    ///                       treewalk; accelerations are still summed up in double precision.
     BarnesHut(const Float theta,
         const MultipoleOrder order,
         GravityLutKernel&& kernel,
         const Size leafSize = 25,
         const Size maxDepth = 50,
-        const Float gravityConstant = Constants::gravity);
+        const Float gravityConstant = Constants::gravity,
+        const bool compactMoments = false);
 
     /// Masses of particles must be strictly positive, otherwise center of mass would be undefined.
     virtual void build(IScheduler& pool, const Storage& storage) override;
@@ -123,6 +163,9 @@ protected:
     /// Evaluates the gravity at a single point in space.
     Vector evalImpl(const Vector& r0, const Size idx) const;
 
+    /// Evaluates the gravitational potential (multiplied by G) at a single point in space.
+    Float evalPotential(const Vector& r0, const Size idx) const;
+
     /// Helper task for parallelization of treewalk
     class NodeTask;
 
@@ -156,10 +199,10 @@ protected:
 
     struct TreeWalkResult {
         /// Number of nodes approximated using multipole expansion
-        std::atomic_int approximatedNodes = { 0 };
+        std::atomic<GlobalSize> approximatedNodes = { 0 };
 
         /// Number of opened leafs where exact (pair-wise) solution has been used
-        std::atomic_int exactNodes = { 0 };
+        std::atomic<GlobalSize> exactNodes = { 0 };
     };
 
     /// \brief Performs a recursive treewalk evaluating gravity for all particles.
@@ -188,9 +231,14 @@ protected:
 
     Vector evalExact(const LeafNode<BarnesHutNode>& node, const Vector& r0, const Size idx) const;
 
-    void buildLeaf(BarnesHutNode& node);
+    /// Returns the moments of given node used for multipole approximation.
+    MultipoleExpansion<3> getNodeMoments(const Size nodeIdx) const;
+
+    void buildLeaf(const Size nodeIdx);
+
+    void buildInner(const Size nodeIdx);
 
-    void buildInner(BarnesHutNode& node, BarnesHutNode& left, BarnesHutNode& right);
+    void buildCompactMoments(const Size nodeIdx);
 };
 
 NAMESPACE_SPH_END
@@ -203,7 +203,8 @@ void mergeOverlappingSpheres(IScheduler& scheduler,
             }
             mergeComponent(r, indices, handler, index, finder, toRemove, dirty);
         }
-        storage.remove(toRemove, Storage::IndicesFlag::INDICES_SORTED | Storage::IndicesFlag::PROPAGATE);
+        storage.remove(
+            scheduler, toRemove, Storage::IndicesFlag::INDICES_SORTED | Storage::IndicesFlag::PROPAGATE);
         surface.remove(toRemove);
 
         r = storage.getValue<Vector>(QuantityId::POSITION);
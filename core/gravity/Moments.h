@@ -311,6 +311,149 @@ INLINE constexpr TracelessMultipole<4> parallelAxisTheorem(const TracelessMultip
         (Term30{ Qijk, d } + Term31{ Qij, f2 } + Term32{ Qij, f2 }) * (-2._f / 7._f));
 }
 
+/// \brief Computes moments of point masses up to octupole with respect to given point.
+///
+/// Gives the same result as \ref computeMultipole followed by \ref computeReducedMultipole for each order,
+/// but the components of moments are summed up directly, using only independent components of the
+/// symmetric tensors. This avoids evaluating the generic tensor expressions for each particle.
+template <typename TSequence>
+MultipoleExpansion<3> computeMultipoleExpansion(ArrayView<const Vector> r,
+    ArrayView<const Float> m,
+    const Vector& r0,
+    const TSequence& sequence) {
+    Float m0 = 0._f;
+    // components x, y, z
+    Float m1[3] = { 0._f, 0._f, 0._f };
+    // components xx, xy, xz, yy, yz, zz
+    Float m2[6] = { 0._f, 0._f, 0._f, 0._f, 0._f, 0._f };
+    // components xxx, xxy, xxz, xyy, xyz, xzz, yyy, yyz, yzz, zzz
+    Float m3[10] = { 0._f, 0._f, 0._f, 0._f, 0._f, 0._f, 0._f, 0._f, 0._f, 0._f };
+    for (Size i : sequence) {
+        const Float x = r[i][X] - r0[X];
+        const Float y = r[i][Y] - r0[Y];
+        const Float z = r[i][Z] - r0[Z];
+        const Float mx = m[i] * x;
+        const Float my = m[i] * y;
+        const Float mz = m[i] * z;
+        const Float mxx = mx * x;
+        const Float mxy = mx * y;
+        const Float mxz = mx * z;
+        const Float myy = my * y;
+        const Float myz = my * z;
+        const Float mzz = mz * z;
+
+        m0 += m[i];
+        m1[0] += mx;
+        m1[1] += my;
+        m1[2] += mz;
+        m2[0] += mxx;
+        m2[1] += mxy;
+        m2[2] += mxz;
+        m2[3] += myy;
+        m2[4] += myz;
+        m2[5] += mzz;
+        m3[0] += mxx * x;
+        m3[1] += mxx * y;
+        m3[2] += mxx * z;
+        m3[3] += mxy * y;
+        m3[4] += mxy * z;
+        m3[5] += mxz * z;
+        m3[6] += myy * y;
+        m3[7] += myy * z;
+        m3[8] += myz * z;
+        m3[9] += mzz * z;
+    }
+
+    MultipoleExpansion<3> ms;
+    ms.order<0>() = m0;
+
+    TracelessMultipole<1>& q1 = ms.order<1>();
+    q1.value<0>() = m1[0];
+    q1.value<1>() = m1[1];
+    q1.value<2>() = m1[2];
+
+    // Q_ij = M_ij - 1/3 delta_ij M_kk
+    const Float tr2 = (m2[0] + m2[3] + m2[5]) / 3._f;
+    TracelessMultipole<2>& q2 = ms.order<2>();
+    q2.value<0, 0>() = m2[0] - tr2;
+    q2.value<0, 1>() = m2[1];
+    q2.value<0, 2>() = m2[2];
+    q2.value<1, 1>() = m2[3] - tr2;
+    q2.value<1, 2>() = m2[4];
+
+    // Q_ijk = M_ijk - 1/5 (delta_ij T_k + delta_ik T_j + delta_jk T_i), where T_k = M_iik
+    const Float tx = (m3[0] + m3[3] + m3[5]) / 5._f;
+    const Float ty = (m3[1] + m3[6] + m3[8]) / 5._f;
+    const Float tz = (m3[2] + m3[7] + m3[9]) / 5._f;
+    TracelessMultipole<3>& q3 = ms.order<3>();
+    q3.value<0, 0, 0>() = m3[0] - 3._f * tx;
+    q3.value<0, 0, 1>() = m3[1] - ty;
+    q3.value<0, 0, 2>() = m3[2] - tz;
+    q3.value<0, 1, 1>() = m3[3] - tx;
+    q3.value<0, 1, 2>() = m3[4];
+    q3.value<1, 1, 1>() = m3[6] - 3._f * ty;
+    q3.value<1, 1, 2>() = m3[7] - tz;
+    return ms;
+}
+
+/// \brief Translates moments up to octupole by given vector and adds them to the accumulated moments.
+///
+/// Equivalent to summing up the results of \ref parallelAxisTheorem for orders 0 to 3, written out for
+/// the independent components of the traceless tensors. As in the generic implementation, the dipole
+/// moment is assumed to be zero, i.e. the moments are expected to be computed around the center of mass.
+/// \param result Moments where the translated moments are added.
+/// \param ms Moments to translate.
+/// \param d Translation vector; d = r - r_new, where r and r_new are the original and the new reference
+///          points, respectively.
+INLINE void addTranslatedMoments(MultipoleExpansion<3>& result, const MultipoleExpansion<3>& ms, const Vector& d) {
+    const Float Q = ms.order<0>();
+    const TracelessMultipole<1>& Q1 = ms.order<1>();
+    const TracelessMultipole<2>& Q2 = ms.order<2>();
+    const TracelessMultipole<3>& Q3 = ms.order<3>();
+    const Float dx = d[X];
+    const Float dy = d[Y];
+    const Float dz = d[Z];
+    const Float dSqr = dx * dx + dy * dy + dz * dz;
+
+    result.order<0>() += Q;
+
+    TracelessMultipole<1>& R1 = result.order<1>();
+    R1.value<0>() += Q1.value<0>() + Q * dx;
+    R1.value<1>() += Q1.value<1>() + Q * dy;
+    R1.value<2>() += Q1.value<2>() + Q * dz;
+
+    const Float qxx = Q2.value<0, 0>();
+    const Float qxy = Q2.value<0, 1>();
+    const Float qxz = Q2.value<0, 2>();
+    const Float qyy = Q2.value<1, 1>();
+    const Float qyz = Q2.value<1, 2>();
+    const Float qzz = -qxx - qyy;
+
+    // Q_ij + Q (d_i d_j - 1/3 delta_ij d^2)
+    TracelessMultipole<2>& R2 = result.order<2>();
+    const Float d2 = dSqr / 3._f;
+    R2.value<0, 0>() += qxx + Q * (dx * dx - d2);
+    R2.value<0, 1>() += qxy + Q * dx * dy;
+    R2.value<0, 2>() += qxz + Q * dx * dz;
+    R2.value<1, 1>() += qyy + Q * (dy * dy - d2);
+    R2.value<1, 2>() += qyz + Q * dy * dz;
+
+    // Q_ijk + Q (d_i d_j d_k - 1/5 d^2 (delta_ij d_k + ...)) + (Q_ij d_k + ...) - 2/5 (delta_ij p_k + ...),
+    // where p_k = Q_kl d_l
+    const Float px = 0.4_f * (qxx * dx + qxy * dy + qxz * dz);
+    const Float py = 0.4_f * (qxy * dx + qyy * dy + qyz * dz);
+    const Float pz = 0.4_f * (qxz * dx + qyz * dy + qzz * dz);
+    const Float d3 = 0.2_f * dSqr;
+    TracelessMultipole<3>& R3 = result.order<3>();
+    R3.value<0, 0, 0>() += Q3.value<0, 0, 0>() + Q * dx * (dx * dx - 3._f * d3) + 3._f * (qxx * dx - px);
+    R3.value<0, 0, 1>() += Q3.value<0, 0, 1>() + Q * dy * (dx * dx - d3) + qxx * dy + 2._f * qxy * dx - py;
+    R3.value<0, 0, 2>() += Q3.value<0, 0, 2>() + Q * dz * (dx * dx - d3) + qxx * dz + 2._f * qxz * dx - pz;
+    R3.value<0, 1, 1>() += Q3.value<0, 1, 1>() + Q * dx * (dy * dy - d3) + qyy * dx + 2._f * qxy * dy - px;
+    R3.value<0, 1, 2>() += Q3.value<0, 1, 2>() + Q * dx * dy * dz + qxy * dz + qyz * dx + qxz * dy;
+    R3.value<1, 1, 1>() += Q3.value<1, 1, 1>() + Q * dy * (dy * dy - 3._f * d3) + 3._f * (qyy * dy - py);
+    R3.value<1, 1, 2>() += Q3.value<1, 1, 2>() + Q * dz * (dy * dy - d3) + qyy * dz + 2._f * qyz * dy - pz;
+}
+
 template <Size M, Size N>
 Vector computeMultipoleAcceleration(const MultipoleExpansion<N>& ms,
     ArrayView<const Float> gamma,
@@ -359,5 +502,38 @@ Vector evaluateGravity(const Vector& dr, const MultipoleExpansion<N>& ms, const
     return a;
 }
 
+/// \brief Returns the potential of given multipole expansion.
+///
+/// The potential is consistent with the acceleration returned by \ref evaluateGravity, i.e. the acceleration
+/// is the negative gradient of the potential. As in \ref evaluateGravity, the masses are assumed to be
+/// multiplied by the gravitational constant.
+template <Size N>
+Float evaluatePotential(const Vector& dr, const MultipoleExpansion<N>& ms, const MultipoleOrder maxOrder) {
+    StaticArray<Float, N + 2> gamma;
+#ifdef SPH_DEBUG
+    gamma.fill(NAN);
+#endif
+    computeGreenGamma<N>(gamma, dr);
+
+    const Multipole<1> mdr = toMultipole(-dr);
+    Float phi = 0._f;
+    switch (maxOrder) {
+    case MultipoleOrder::OCTUPOLE:
+        phi += gamma[3] * computeMultipolePotential<0>(ms.template order<3>(), mdr).value();
+        SPH_FALLTHROUGH
+    case MultipoleOrder::QUADRUPOLE:
+        phi += gamma[2] * computeMultipolePotential<0>(ms.template order<2>(), mdr).value();
+        SPH_FALLTHROUGH
+    case MultipoleOrder::MONOPOLE:
+        phi += gamma[0] * ms.template order<0>().value();
+        break;
+    default:
+        NOT_IMPLEMENTED;
+    };
+
+    SPH_ASSERT(isReal(phi));
+    return phi;
+}
+
 
 NAMESPACE_SPH_END
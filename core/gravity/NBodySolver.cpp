@@ -33,6 +33,7 @@ HardSphereSolver::HardSphereSolver(IScheduler& scheduler,
     AutoPtr<IOverlapHandler>&& overlapHandler)
     : gravity(std::move(gravity))
     , scheduler(scheduler)
+    , savePotentialEnergy(settings.get<bool>(RunSettingsId::RUN_INTEGRALS_ENABLE))
     , threadData(scheduler) {
     collision.handler = std::move(collisionHandler);
     collision.finder = Factory::getFinder(settings);
@@ -102,6 +103,10 @@ void HardSphereSolver::integrate(Storage& storage, Statistics& stats) {
     ArrayView<Vector> dv = storage.getD2t<Vector>(QuantityId::POSITION);
     SPH_ASSERT_UNEVAL(std::all_of(dv.begin(), dv.end(), [](const Vector& a) { return a == Vector(0._f); }));
     gravity->evalSelfGravity(scheduler, dv, stats);
+    if (savePotentialEnergy) {
+        // reuse the built tree, so that the logged integrals do not need their own gravity
+        stats.set(StatisticsId::POTENTIAL_ENERGY, gravity->evalEnergy(scheduler, stats));
+    }
 
     ArrayView<Attractor> attractors = storage.getAttractors();
     gravity->evalAttractors(scheduler, attractors, dv);
@@ -466,7 +471,8 @@ void HardSphereSolver::collide(Storage& storage, Statistics& stats, const Float
     // apply the removal list
     if (!removed.empty()) {
         // remove it also from all dependent storages, since this is a permanent action
-        storage.remove(removed, Storage::IndicesFlag::INDICES_SORTED | Storage::IndicesFlag::PROPAGATE);
+        storage.remove(
+            scheduler, removed, Storage::IndicesFlag::INDICES_SORTED | Storage::IndicesFlag::PROPAGATE);
     }
     SPH_ASSERT(storage.isValid());
 
@@ -589,6 +595,7 @@ SoftSphereSolver::SoftSphereSolver(IScheduler& scheduler,
     AutoPtr<IGravity>&& gravity)
     : gravity(std::move(gravity))
     , scheduler(scheduler)
+    , savePotentialEnergy(settings.get<bool>(RunSettingsId::RUN_INTEGRALS_ENABLE))
     , threadData(scheduler) {
     force.repel = settings.get<Float>(RunSettingsId::SOFT_REPEL_STRENGTH);
     force.friction = settings.get<Float>(RunSettingsId::SOFT_FRICTION_STRENGTH);
@@ -607,6 +614,10 @@ void SoftSphereSolver::integrate(Storage& storage, Statistics& stats) {
     tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
     SPH_ASSERT_UNEVAL(std::all_of(dv.begin(), dv.end(), [](const Vector& a) { return a == Vector(0._f); }));
     gravity->evalSelfGravity(scheduler, dv, stats);
+    if (savePotentialEnergy) {
+        // reuse the built tree, so that the logged integrals do not need their own gravity
+        stats.set(StatisticsId::POTENTIAL_ENERGY, gravity->evalEnergy(scheduler, stats));
+    }
 
     ArrayView<Attractor> attractors = storage.getAttractors();
     gravity->evalAttractors(scheduler, attractors, dv);
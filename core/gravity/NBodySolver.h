@@ -28,6 +28,10 @@ private:
 
     IScheduler& scheduler;
 
+    /// If true, the potential energy is saved into the statistics every time step, used by
+    /// \ref IntegralsLogWriter
+    bool savePotentialEnergy;
+
     struct ThreadData {
         /// Neighbors for parallelized queries
         Array<NeighborRecord> neighs;
@@ -140,6 +144,10 @@ class SoftSphereSolver : public ISolver {
 
     IScheduler& scheduler;
 
+    /// If true, the potential energy is saved into the statistics every time step, used by
+    /// \ref IntegralsLogWriter
+    bool savePotentialEnergy;
+
     struct ThreadData {
         /// Neighbors for parallelized queries
         Array<NeighborRecord> neighs;
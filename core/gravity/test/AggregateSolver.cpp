@@ -0,0 +1,172 @@
+#include "gravity/AggregateSolver.h"
+#include "catch.hpp"
+#include "quantities/IMaterial.h"
+#include "quantities/Quantity.h"
+#include "system/Statistics.h"
+#include "tests/Approx.h"
+#include "thread/Pool.h"
+#include "timestepping/TimeStepping.h"
+
+using namespace Sph;
+
+/// Creates two bodies composed of 27 particles each, the first body is rotating.
+static Storage getAggregateStorage(AggregateSolver& solver) {
+    Storage storage;
+    for (Size body = 0; body < 2; ++body) {
+        Storage bodyStorage(makeAuto<NullMaterial>(EMPTY_SETTINGS));
+        Array<Vector> r;
+        for (Size i = 0; i < 27; ++i) {
+            r.push(Vector(2.5_f * (i % 3) + 20._f * body, 2.5_f * ((i / 3) % 3), 2.5_f * (i / 9), 1._f));
+        }
+        bodyStorage.insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, std::move(r));
+        bodyStorage.insert<Float>(QuantityId::MASS, OrderEnum::ZERO, 1._f);
+        solver.create(bodyStorage, bodyStorage.getMaterial(0));
+        storage.merge(std::move(bodyStorage));
+    }
+
+    ArrayView<Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    for (Size i = 0; i < 27; ++i) {
+        v[i] = cross(Vector(0._f, 0._f, 0.05_f), r[i] - Vector(2.5_f)) + Vector(0.1_f, 0._f, 0._f);
+    }
+    return storage;
+}
+
+TEST_CASE("AggregateSolver rigid bodies", "[nbody]") {
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    const Float dt = 0.5_f;
+    RunSettings settings;
+    settings.set(RunSettingsId::TIMESTEPPING_INITIAL_TIMESTEP, dt)
+        .set(RunSettingsId::TIMESTEPPING_MAX_TIMESTEP, dt)
+        .set(RunSettingsId::TIMESTEPPING_CRITERION, EMPTY_FLAGS);
+    AggregateSolver solver(pool, settings);
+    SharedPtr<Storage> storage = makeShared<Storage>(getAggregateStorage(solver));
+    solver.createAggregateData(*storage, AggregateEnum::MATERIALS);
+
+    ArrayView<const Vector> r = storage->getValue<Vector>(QuantityId::POSITION);
+    auto getDistances = [&r] {
+        Array<Float> distances;
+        for (Size body = 0; body < 2; ++body) {
+            for (Size i = 0; i < 27; ++i) {
+                distances.push(getLength(r[27 * body + i] - r[27 * body]));
+            }
+        }
+        return distances;
+    };
+    const Array<Float> distances0 = getDistances();
+
+    LeapFrog timestepping(storage, settings);
+    Statistics stats;
+    for (Size step = 0; step < 10; ++step) {
+        timestepping.step(pool, solver, stats);
+    }
+    REQUIRE(stats.get<int>(StatisticsId::AGGREGATE_COUNT) == 2);
+
+    ArrayView<const Size> ids = storage->getValue<Size>(QuantityId::AGGREGATE_ID);
+    REQUIRE(ids[0] != Size(-1));
+    REQUIRE(ids[27] != Size(-1));
+    REQUIRE(ids[0] != ids[27]);
+    for (Size i = 0; i < 27; ++i) {
+        REQUIRE(ids[i] == ids[0]);
+        REQUIRE(ids[27 + i] == ids[27]);
+    }
+
+    // the first body moved and rotated as a rigid body
+    REQUIRE(r[0] != approx(Vector(0._f, 0._f, 0._f, 1._f)));
+    const Array<Float> distances = getDistances();
+    for (Size i = 0; i < distances.size(); ++i) {
+        REQUIRE(distances[i] == approx(distances0[i], 1.e-6_f));
+    }
+}
+
+TEST_CASE("AggregateSolver merge", "[nbody]") {
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    AggregateSolver solver(pool, RunSettings::getDefaults());
+    Storage storage(makeAuto<NullMaterial>(EMPTY_SETTINGS));
+    // massive particles slowly approaching each other, so that they are gravitationally bound
+    storage.insert<Vector>(QuantityId::POSITION,
+        OrderEnum::SECOND,
+        Array<Vector>{ Vector(0._f, 0._f, 0._f, 1._f), Vector(2.2_f, 0._f, 0._f, 1._f) });
+    storage.insert<Float>(QuantityId::MASS, OrderEnum::ZERO, 1.e10_f);
+    ArrayView<Vector> v = storage.getDt<Vector>(QuantityId::POSITION);
+    v[0] = Vector(0.01_f, 0._f, 0._f);
+    v[1] = Vector(-0.01_f, 0._f, 0._f);
+    solver.create(storage, storage.getMaterial(0));
+    solver.createAggregateData(storage, AggregateEnum::PARTICLES);
+
+    Statistics stats;
+    storage.zeroHighestDerivatives(pool);
+    solver.integrate(storage, stats);
+    REQUIRE(stats.get<int>(StatisticsId::AGGREGATE_COUNT) == 0);
+
+    solver.collide(storage, stats, 20._f);
+    storage.zeroHighestDerivatives(pool);
+    solver.integrate(storage, stats);
+    REQUIRE(stats.get<int>(StatisticsId::AGGREGATE_COUNT) == 1);
+    ArrayView<const Size> ids = storage.getValue<Size>(QuantityId::AGGREGATE_ID);
+    REQUIRE(ids[0] == ids[1]);
+    REQUIRE(v[0] == approx(v[1]));
+}
+
+TEST_CASE("AggregateSolver disband", "[nbody]") {
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    AggregateSolver solver(pool, RunSettings::getDefaults());
+    Storage storage;
+    // aggregates of three and two particles approaching each other; only particles 0 and 3 collide
+    Array<Vector> r[] = {
+        { Vector(0._f, 0._f, 0._f, 1._f), Vector(0._f, 3._f, 0._f, 1._f), Vector(0._f, 6._f, 0._f, 1._f) },
+        { Vector(2.2_f, 0._f, 0._f, 1._f), Vector(2.2_f, -3._f, 0._f, 1._f) },
+    };
+    for (Size body = 0; body < 2; ++body) {
+        Storage bodyStorage(makeAuto<NullMaterial>(EMPTY_SETTINGS));
+        bodyStorage.insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, std::move(r[body]));
+        bodyStorage.insert<Float>(QuantityId::MASS, OrderEnum::ZERO, 1.e10_f);
+        for (Vector& v : bodyStorage.getDt<Vector>(QuantityId::POSITION)) {
+            v = Vector(body == 0 ? 0.01_f : -0.01_f, 0._f, 0._f);
+        }
+        solver.create(bodyStorage, bodyStorage.getMaterial(0));
+        storage.merge(std::move(bodyStorage));
+    }
+    solver.createAggregateData(storage, AggregateEnum::MATERIALS);
+
+    Statistics stats;
+    storage.zeroHighestDerivatives(pool);
+    solver.integrate(storage, stats);
+    REQUIRE(stats.get<int>(StatisticsId::AGGREGATE_COUNT) == 2);
+
+    // multi-particle aggregates are not merged, the smaller one is broken into particles
+    solver.collide(storage, stats, 11._f);
+    storage.zeroHighestDerivatives(pool);
+    solver.integrate(storage, stats);
+    REQUIRE(stats.get<int>(StatisticsId::AGGREGATE_COUNT) == 1);
+    ArrayView<const Size> ids = storage.getValue<Size>(QuantityId::AGGREGATE_ID);
+    REQUIRE(ids[0] != Size(-1));
+    REQUIRE(ids[0] == ids[1]);
+    REQUIRE(ids[0] == ids[2]);
+    REQUIRE(ids[3] == Size(-1));
+    REQUIRE(ids[4] == Size(-1));
+}
+
+TEST_CASE("AggregateSolver remove particles", "[nbody]") {
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    AggregateSolver solver(pool, RunSettings::getDefaults());
+    Storage storage = getAggregateStorage(solver);
+    solver.createAggregateData(storage, AggregateEnum::MATERIALS);
+
+    // removes the root of the first aggregate
+    storage.remove(Array<Size>{ 0, 5, 30 });
+    REQUIRE(storage.getParticleCnt() == 51);
+
+    Statistics stats;
+    storage.zeroHighestDerivatives(pool);
+    solver.integrate(storage, stats);
+    REQUIRE(stats.get<int>(StatisticsId::AGGREGATE_COUNT) == 2);
+    ArrayView<const Size> ids = storage.getValue<Size>(QuantityId::AGGREGATE_ID);
+    for (Size i = 0; i < 25; ++i) {
+        REQUIRE(ids[i] == ids[0]);
+    }
+    for (Size i = 25; i < 51; ++i) {
+        REQUIRE(ids[i] == ids[25]);
+    }
+    REQUIRE(ids[0] != ids[25]);
+}
@@ -71,6 +71,10 @@ static void testOpeningAngle(const MultipoleOrder order) {
         return SUCCESS;
     };
     REQUIRE_SEQUENCE(test, 0, r.size());
+
+    // all nodes are evaluated exactly
+    REQUIRE(stats.get<GlobalSize>(StatisticsId::GRAVITY_NODES_APPROX) == 0);
+    REQUIRE(stats.get<GlobalSize>(StatisticsId::GRAVITY_NODES_EXACT) > 0);
 }
 
 TEMPLATE_TEST_CASE("BarnesHut zero opening angle", "[gravity]", ThreadPool, Tbb) {
@@ -361,6 +365,84 @@ TEST_CASE("BarnesHut scheduler independence", "[gravity]") {
     REQUIRE(almostEqual(dv1, dv2, EPS));
 }
 
+TEMPLATE_TEST_CASE("BarnesHut compact moments", "[gravity]", ThreadPool, Tbb) {
+    Storage storage = getGravityStorage();
+    TestType& pool = *TestType::getGlobalInstance();
+
+    BruteForceGravity bf;
+    bf.build(pool, storage);
+    BarnesHut full(0.5_f, MultipoleOrder::OCTUPOLE, 5);
+    full.build(pool, storage);
+    BarnesHut compact(0.5_f, MultipoleOrder::OCTUPOLE, 5, 50, Constants::gravity, true);
+    compact.build(pool, storage);
+    REQUIRE(compact.getMoments().order<0>() == full.getMoments().order<0>());
+
+    Statistics stats;
+    Array<Vector> a_bf = storage.getD2t<Vector>(QuantityId::POSITION).clone();
+    bf.evalSelfGravity(pool, a_bf, stats);
+    Array<Vector> a_full = storage.getD2t<Vector>(QuantityId::POSITION).clone();
+    full.evalSelfGravity(pool, a_full, stats);
+    Array<Vector> a_compact = storage.getD2t<Vector>(QuantityId::POSITION).clone();
+    compact.evalSelfGravity(pool, a_compact, stats);
+
+    // rounding error of single-precision moments is much smaller than the error of multipole approximation
+    auto test = [&](const Size i) -> Outcome {
+        const Float errorFull = getLength(a_full[i] - a_bf[i]);
+        const Float diff = getLength(a_compact[i] - a_full[i]);
+        if (diff > 1.e-5_f * getLength(a_bf[i]) || diff > 0.01_f * errorFull + EPS * getLength(a_bf[i])) {
+            return makeFailed(
+                "Compact moments differ: \n{} == {}\n brute force: {}", a_compact[i], a_full[i], a_bf[i]);
+        }
+        return SUCCESS;
+    };
+    REQUIRE_SEQUENCE(test, 0, a_bf.size());
+
+    const Vector r0(3.e7_f, 1.e7_f, -2.e7_f);
+    REQUIRE(compact.evalAcceleration(r0) == approx(full.evalAcceleration(r0), 1.e-6_f));
+}
+
+TEMPLATE_TEST_CASE("BarnesHut energy", "[gravity]", ThreadPool, Tbb) {
+    Storage storage = getGravityStorage();
+    TestType& pool = *TestType::getGlobalInstance();
+
+    BruteForceGravity bf;
+    bf.build(pool, storage);
+    Statistics stats;
+    const Float e_bf = bf.evalEnergy(pool, stats);
+    REQUIRE(e_bf < 0._f);
+
+    // exact for zero opening angle
+    BarnesHut exact(EPS, MultipoleOrder::OCTUPOLE, 5);
+    exact.build(pool, storage);
+    REQUIRE(exact.evalEnergy(pool, stats) == approx(e_bf, 1.e-10_f));
+
+    BarnesHut approximated(0.5_f, MultipoleOrder::OCTUPOLE, 5, 50, Constants::gravity, true);
+    approximated.build(pool, storage);
+    REQUIRE(approximated.evalEnergy(pool, stats) == approx(e_bf, 1.e-3_f));
+}
+
+TEMPLATE_TEST_CASE("BarnesHut energy multipole order", "[gravity]", ThreadPool, Tbb) {
+    Storage storage = getGravityStorage();
+    TestType& pool = *TestType::getGlobalInstance();
+
+    BruteForceGravity bf;
+    bf.build(pool, storage);
+    Statistics stats;
+    const Float e_bf = bf.evalEnergy(pool, stats);
+
+    auto evalError = [&](const MultipoleOrder order) {
+        BarnesHut gravity(0.8_f, order, 5);
+        gravity.build(pool, storage);
+        return abs(gravity.evalEnergy(pool, stats) - e_bf);
+    };
+    const Float monopoleError = evalError(MultipoleOrder::MONOPOLE);
+    const Float quadrupoleError = evalError(MultipoleOrder::QUADRUPOLE);
+    const Float octupoleError = evalError(MultipoleOrder::OCTUPOLE);
+    REQUIRE(monopoleError > 0._f);
+    REQUIRE(quadrupoleError < monopoleError);
+    REQUIRE(octupoleError < quadrupoleError);
+}
+
 // test that everything can be evaluated at compile time
 static_assert(parallelAxisTheorem(TracelessMultipole<4>{},
                   TracelessMultipole<3>{},
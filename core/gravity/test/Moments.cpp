@@ -140,3 +140,81 @@ TEST_CASE("Parallel axis theorem", "[gravity]") {
     MARK_USED(qd4);
     // REQUIRE(qd4 == approx(qpat4));
 }
+
+TEST_CASE("Multipole expansion kernels", "[gravity]") {
+    BodySettings settings;
+    settings.set(BodySettingsId::DENSITY, 1._f);
+    Storage storage = Tests::getGassStorage(100, settings);
+    ArrayView<Vector> r = storage.getValue<Vector>(QuantityId::POSITION);
+    ArrayView<Float> m = storage.getValue<Float>(QuantityId::MASS);
+    for (Size i = 0; i < r.size(); ++i) {
+        // break the symmetry and make the masses different
+        r[i] += Vector(0.3_f * r[i][Y], 0._f, 0.2_f * sqr(r[i][X]));
+        m[i] *= 1._f + 0.1_f * (i % 7);
+    }
+
+    IndexSequence seq(0, r.size());
+    const Vector r0(0.5_f, -0.2_f, 0.1_f);
+    const MultipoleExpansion<3> ms = computeMultipoleExpansion(r, m, r0, seq);
+    const Multipole<1> mr0 = toMultipole(r0);
+    REQUIRE(ms.order<0>().value() == approx(computeMultipole<0>(r, m, mr0, seq).value()));
+    REQUIRE(ms.order<1>() == approx(computeReducedMultipole(computeMultipole<1>(r, m, mr0, seq))));
+    const TracelessMultipole<2> q2 = computeReducedMultipole(computeMultipole<2>(r, m, mr0, seq));
+    const TracelessMultipole<3> q3 = computeReducedMultipole(computeMultipole<3>(r, m, mr0, seq));
+    REQUIRE(ms.order<2>() == approx(q2));
+    REQUIRE(ms.order<3>() == approx(q3));
+
+    const Vector d(2._f, 3._f, -1._f);
+    MultipoleExpansion<3> translated;
+    addTranslatedMoments(translated, ms, d);
+    const Float q0 = ms.order<0>().value();
+    const Multipole<1> md = toMultipole(d);
+    REQUIRE(translated.order<0>().value() == approx(q0));
+    REQUIRE(translated.order<1>() == approx(parallelAxisTheorem(ms.order<1>(), q0, md)));
+    REQUIRE(translated.order<2>() == approx(parallelAxisTheorem(q2, q0, md)));
+    REQUIRE(translated.order<3>() == approx(parallelAxisTheorem(q3, q2, q0, md)));
+}
+
+TEST_CASE("Multipole expansion potential", "[gravity]") {
+    BodySettings settings;
+    settings.set(BodySettingsId::DENSITY, 1._f);
+    Storage storage = Tests::getGassStorage(100, settings);
+    ArrayView<Vector> r = storage.getValue<Vector>(QuantityId::POSITION);
+    ArrayView<Float> m = storage.getValue<Float>(QuantityId::MASS);
+    for (Size i = 0; i < r.size(); ++i) {
+        r[i] += Vector(0.3_f * r[i][Y], 0._f, 0.2_f * sqr(r[i][X]));
+        m[i] *= 1._f + 0.1_f * (i % 7);
+    }
+    CenterOfMass com;
+    const Vector r_com = com.evaluate(storage);
+    IndexSequence seq(0, r.size());
+    const MultipoleExpansion<3> ms = computeMultipoleExpansion(r, m, r_com, seq);
+
+    const Vector r0(6._f, -5._f, 3._f);
+    Float phi = 0._f;
+    for (Size i = 0; i < r.size(); ++i) {
+        phi -= m[i] / getLength(r0 - r[i]);
+    }
+    const Vector dr = r0 - r_com;
+    const Float monopoleError = abs(evaluatePotential(dr, ms, MultipoleOrder::MONOPOLE) - phi);
+    const Float quadrupoleError = abs(evaluatePotential(dr, ms, MultipoleOrder::QUADRUPOLE) - phi);
+    const Float octupoleError = abs(evaluatePotential(dr, ms, MultipoleOrder::OCTUPOLE) - phi);
+    REQUIRE(quadrupoleError < monopoleError);
+    REQUIRE(octupoleError < quadrupoleError);
+    REQUIRE(octupoleError < 1.e-4_f * abs(phi));
+
+    // acceleration has to be the negative gradient of the potential
+    const Float eps = 1.e-5_f;
+    for (MultipoleOrder order :
+        { MultipoleOrder::MONOPOLE, MultipoleOrder::QUADRUPOLE, MultipoleOrder::OCTUPOLE }) {
+        Vector grad(0._f);
+        for (Size i = 0; i < 3; ++i) {
+            Vector dx(0._f);
+            dx[i] = eps;
+            const Float phi1 = evaluatePotential(dr + dx, ms, order);
+            const Float phi2 = evaluatePotential(dr - dx, ms, order);
+            grad[i] = (phi1 - phi2) / (2._f * eps);
+        }
+        REQUIRE(evaluateGravity(dr, ms, order) == approx(-grad, 1.e-6_f));
+    }
+}
@@ -73,7 +73,7 @@ Path RandomPathManager::getPath(const String& extension) {
             const Size index = min(Size(rng() * (sizeof(chars) - 1)), Size(sizeof(chars) - 2));
             name += wchar_t(chars[index]);
         }
-        Path path(name);
+        Path path = directory / Path(name);
         if (!extension.empty()) {
             path.replaceExtension(extension);
         }
@@ -48,11 +48,18 @@ class RandomPathManager : public Noncopyable {
 private:
     UniformRng rng;
 
+    /// Parent directory of the generated paths
+    Path directory;
+
     static char chars[];
 
 public:
-    RandomPathManager()
-        : rng(std::random_device{}()) {}
+    /// \brief Creates the manager generating paths in given directory.
+    ///
+    /// If no directory is given, the paths are relative to the current working directory.
+    explicit RandomPathManager(const Path& directory = Path())
+        : rng(std::random_device{}())
+        , directory(directory) {}
 
     /// \brief Generates a new random path.
     ///
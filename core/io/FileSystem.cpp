@@ -1,6 +1,7 @@
 #include "io/FileSystem.h"
 #include "objects/containers/StaticArray.h"
 #include "objects/utility/Streams.h"
+#include <cstring>
 #include <sstream>
 
 #ifdef SPH_WIN
@@ -67,6 +68,30 @@ std::size_t FileSystem::fileSize(const Path& path) {
     return ifs.tellg();
 }
 
+Outcome FileSystem::resizeFile(const Path& path, const std::size_t size) {
+#ifndef SPH_WIN
+    if (truncate(path.native(), off_t(size)) != 0) {
+        return makeFailed("Cannot resize file {}: {}", path.string(), std::strerror(errno));
+    }
+    return SUCCESS;
+#else
+    HANDLE handle =
+        CreateFileW(path.native(), GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return makeFailed("Cannot resize file {}: {}", path.string(), getLastErrorMessage());
+    }
+    LARGE_INTEGER offset;
+    offset.QuadPart = size;
+    const bool result = SetFilePointerEx(handle, offset, nullptr, FILE_BEGIN) && SetEndOfFile(handle);
+    const String error = result ? String() : getLastErrorMessage();
+    CloseHandle(handle);
+    if (!result) {
+        return makeFailed("Cannot resize file {}: {}", path.string(), error);
+    }
+    return SUCCESS;
+#endif
+}
+
 bool FileSystem::isDirectoryWritable(const Path& path) {
     SPH_ASSERT(pathType(path).valueOr(PathType::OTHER) == PathType::DIRECTORY);
 #ifndef SPH_WIN
@@ -126,6 +151,24 @@ Expected<Path> FileSystem::getUserDataDirectory() {
     }
 }
 
+Expected<Path> FileSystem::getTemporaryDirectory() {
+#ifdef SPH_WIN
+    wchar_t buffer[MAX_PATH + 1] = { 0 };
+    if (GetTempPathW(MAX_PATH + 1, buffer) != 0) {
+        return Path(String(buffer));
+    } else {
+        return makeUnexpected<Path>(getLastErrorMessage());
+    }
+#else
+    const char* tmpDir = getenv("TMPDIR");
+    if (tmpDir != nullptr) {
+        return Path(String::fromUtf8(tmpDir) + L'/');
+    } else {
+        return Path("/tmp/");
+    }
+#endif
+}
+
 Expected<Path> FileSystem::getAbsolutePath(const Path& relativePath) {
 #ifndef SPH_WIN
     char realPath[PATH_MAX];
@@ -26,6 +26,12 @@ bool pathExists(const Path& path);
 /// The file must exist and be accessible, checked by assert.
 std::size_t fileSize(const Path& path);
 
+/// \brief Truncates or extends the file to given size.
+///
+/// If the file is extended, the added bytes are zero-filled.
+/// \return SUCCESS if the file has been resized, or error message.
+Outcome resizeFile(const Path& path, const std::size_t size);
+
 /// \brief Checks whether the given directory is writable.
 bool isDirectoryWritable(const Path& path);
 
@@ -35,6 +41,9 @@ Expected<Path> getHomeDirectory();
 /// \brief Returns the directory where user data can be stored.
 Expected<Path> getUserDataDirectory();
 
+/// \brief Returns the directory for temporary files.
+Expected<Path> getTemporaryDirectory();
+
 /// \brief Returns the absolute path to the file, or error if the path cannot be resolved.
 ///
 /// Function also resolves all symlinks in the path.
@@ -5,6 +5,7 @@
 #include "quantities/Storage.h"
 #include "system/Statistics.h"
 #include "system/Timer.h"
+#include "thread/Scheduler.h"
 #include "timestepping/TimeStepCriterion.h"
 
 NAMESPACE_SPH_BEGIN
@@ -146,21 +147,43 @@ void BriefLogWriter::write(const Storage& UNUSED(storage), const Statistics& sta
 }
 
 
-IntegralsLogWriter::IntegralsLogWriter(const Path& path, const Size period)
-    : IntegralsLogWriter(makeAuto<FileLogger>(path), period) {}
+IntegralsLogWriter::IntegralsLogWriter(const Path& path,
+    const Float period,
+    const SharedPtr<IScheduler>& scheduler)
+    : IntegralsLogWriter(makeAuto<FileLogger>(path), period, scheduler) {}
+
+IntegralsLogWriter::IntegralsLogWriter(const SharedPtr<ILogger>& logger,
+    const Float period,
+    const SharedPtr<IScheduler>& scheduler)
+    : ILogWriter(logger, period)
+    , integrals(IntegralFlag::MOMENTUM | IntegralFlag::ANGULAR_MOMENTUM | IntegralFlag::KINETIC_ENERGY |
+                IntegralFlag::INTERNAL_ENERGY | IntegralFlag::POTENTIAL_ENERGY)
+    , scheduler(scheduler) {
+    if (!this->scheduler) {
+        this->scheduler = SequentialScheduler::getGlobalInstance();
+    }
+}
 
-IntegralsLogWriter::IntegralsLogWriter(const SharedPtr<ILogger>& logger, const Size period)
-    : ILogWriter(logger, period) {}
+AutoPtr<ITrigger> IntegralsLogWriter::action(Storage& storage, Statistics& stats) {
+    const IntegralValues values = this->evaluate(storage, stats);
+    this->log(stats, values);
+    return nullptr;
+}
 
 void IntegralsLogWriter::write(const Storage& storage, const Statistics& stats) {
+    // statistics are const here, save the integrals into a copy
+    Statistics integralStats = stats;
+    const IntegralValues values = this->evaluate(storage, integralStats);
+    this->log(stats, values);
+}
+
+IntegralValues IntegralsLogWriter::evaluate(const Storage& storage, Statistics& stats) {
+    return integrals.evaluate(*scheduler, storage, stats);
+}
+
+void IntegralsLogWriter::log(const Statistics& stats, const IntegralValues& values) {
     const Float time = stats.get<Float>(StatisticsId::RUN_TIME);
-    logger->write(time,
-        " ",
-        momentum.evaluate(storage),
-        " ",
-        energy.evaluate(storage),
-        " ",
-        angularMomentum.evaluate(storage));
+    logger->write(time, " ", values.momentum, " ", values.totalEnergy(), " ", values.angularMomentum);
 }
 
 
@@ -24,8 +24,9 @@ public:
 
     /// \brief Writes to the log using provided storage and statistics.
     ///
-    /// Same as \ref write, implemented to allow using \ref ILogWriter as a \ref ITrigger.
-    virtual AutoPtr<ITrigger> action(Storage& storage, Statistics& stats) override final;
+    /// Same as \ref write, implemented to allow using \ref ILogWriter as a \ref ITrigger. Derived classes may
+    /// override the function to also save computed values into the statistics.
+    virtual AutoPtr<ITrigger> action(Storage& storage, Statistics& stats) override;
 
     /// \brief Writes to the log using provided storage and statistics.
     ///
@@ -71,20 +72,39 @@ public:
 
 /// \brief Writer logging selected integrals of motion.
 ///
-/// Currently fixed to logging total momentum, total angular momentum and total energy.
+/// Currently fixed to logging total momentum, total angular momentum and total energy. The integrals are
+/// computed in a single pass by \ref IntegralsEvaluator. When executed as a trigger of the run, the computed
+/// integrals are also saved into the run statistics. The potential energy is included if the solver saved it
+/// into the statistics, which gravity solvers do when \ref RunSettingsId::RUN_INTEGRALS_ENABLE is set.
 class IntegralsLogWriter : public ILogWriter {
 private:
-    TotalEnergy energy;
-    TotalMomentum momentum;
-    TotalAngularMomentum angularMomentum;
+    IntegralsEvaluator integrals;
+
+    SharedPtr<IScheduler> scheduler;
 
 public:
     /// \brief Creates a writer that writes the output into given file.
-    IntegralsLogWriter(const Path& path, const Size interval);
+    ///
+    /// \param period Log period in run time, zero means the integrals are logged every time step.
+    /// \param scheduler Scheduler used to compute the integrals. If nullptr, the integrals are computed
+    ///                  sequentially.
+    IntegralsLogWriter(const Path& path,
+        const Float period,
+        const SharedPtr<IScheduler>& scheduler = nullptr);
+
+    IntegralsLogWriter(const SharedPtr<ILogger>& logger,
+        const Float period,
+        const SharedPtr<IScheduler>& scheduler = nullptr);
 
-    IntegralsLogWriter(const SharedPtr<ILogger>& logger, const Size interval);
+    /// \brief Computes the integrals, saves them into the statistics and writes them to the log.
+    virtual AutoPtr<ITrigger> action(Storage& storage, Statistics& stats) override;
 
     virtual void write(const Storage& storage, const Statistics& stats) override;
+
+private:
+    IntegralValues evaluate(const Storage& storage, Statistics& stats);
+
+    void log(const Statistics& stats, const IntegralValues& values);
 };
 
 /// \brief Helper writer that does not write any logs.
@@ -8,7 +8,18 @@
 #include "quantities/Attractor.h"
 #include "quantities/IMaterial.h"
 #include "system/Factory.h"
+#include "thread/Scheduler.h"
+#include "thread/ThreadLocal.h"
+#include <cstring>
 #include <fstream>
+#include <mutex>
+
+#ifdef SPH_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 #ifdef SPH_USE_HDF5
 #include <hdf5.h>
@@ -87,6 +98,10 @@ Optional<OutputFile> OutputFile::getMaskFromPath(const Path& path, const Size fi
     return NOTHING;
 }
 
+Size OutputFile::getNextDumpIdx() const {
+    return dumpNum;
+}
+
 bool OutputFile::hasWildcard() const {
     String path = pathMask.string();
     return path.find("%d") != String::npos || path.find("%t") != String::npos;
@@ -109,6 +124,7 @@ static void printHeader(std::ostream& ofs, const std::string& name, const ValueE
     switch (type) {
     case ValueEnum::SCALAR:
     case ValueEnum::INDEX:
+    case ValueEnum::GLOBAL_INDEX:
         ofs << std::setw(20) << name;
         break;
     case ValueEnum::VECTOR:
@@ -286,6 +302,12 @@ Outcome TextInput::load(const Path& path, Storage& storage, Statistics& UNUSED(s
                     column->accumulate(storage, i, particleCnt);
                     break;
                 }
+                case ValueEnum::GLOBAL_INDEX: {
+                    GlobalSize i;
+                    ss >> i;
+                    column->accumulate(storage, i, particleCnt);
+                    break;
+                }
                 case ValueEnum::SCALAR: {
                     Float f;
                     ss >> f;
@@ -343,6 +365,23 @@ namespace {
 
 using BufferView = ArrayView<const char>;
 
+struct NullOutputStream : public IBinaryOutputStream {
+public:
+    virtual bool write(ArrayView<const char> UNUSED(buffer)) override {
+        return true;
+    }
+};
+
+/// Skips given number of bytes, possibly larger than the limit of a single skip.
+void skipBytes(Deserializer<true>& deserializer, uint64_t size) {
+    constexpr uint64_t MAX_SKIP = 1 << 30;
+    while (size > 0) {
+        const Size cnt = Size(min(size, MAX_SKIP));
+        deserializer.skip(cnt);
+        size -= cnt;
+    }
+}
+
 struct StoreBuffersVisitor {
     template <typename TValue>
     void visit(const Quantity& q, Serializer<true>& serializer, const IndexSequence& sequence) {
@@ -373,43 +412,56 @@ struct StoreBuffersVisitor {
 };
 
 struct LoadBuffersVisitor {
+    /// Loads values of particles [first, last) of the material, skipping the remaining values.
     template <typename TValue>
     void visit(Storage& storage,
         Deserializer<true>& deserializer,
-        const IndexSequence& sequence,
+        const Size first,
+        const Size last,
+        const Size particleCnt,
+        const Size valueSize,
         const QuantityId id,
         const OrderEnum order) {
-        Array<TValue> buffer(sequence.size());
-        for (Size i : sequence) {
-            deserializer.read(buffer[i]);
-        }
+        Array<TValue> buffer(last - first);
+        this->read<TValue>(deserializer, buffer, first, last, particleCnt, valueSize);
         storage.insert<TValue>(id, order, std::move(buffer));
         switch (order) {
         case OrderEnum::ZERO:
             // already done
             break;
-        case OrderEnum::FIRST: {
-            ArrayView<TValue> dv = storage.getDt<TValue>(id);
-            for (Size i : sequence) {
-                deserializer.read(dv[i]);
-            }
+        case OrderEnum::FIRST:
+            this->read<TValue>(deserializer, storage.getDt<TValue>(id), first, last, particleCnt, valueSize);
             break;
-        }
-        case OrderEnum::SECOND: {
-            ArrayView<TValue> dv = storage.getDt<TValue>(id);
-            ArrayView<TValue> d2v = storage.getD2t<TValue>(id);
-            for (Size i : sequence) {
-                deserializer.read(dv[i]);
-            }
-            for (Size i : sequence) {
-                deserializer.read(d2v[i]);
-            }
+        case OrderEnum::SECOND:
+            this->read<TValue>(deserializer, storage.getDt<TValue>(id), first, last, particleCnt, valueSize);
+            this->read<TValue>(deserializer, storage.getD2t<TValue>(id), first, last, particleCnt, valueSize);
             break;
-        }
         default:
             NOT_IMPLEMENTED;
         }
     }
+
+private:
+    template <typename TValue>
+    void read(Deserializer<true>& deserializer,
+        ArrayView<TValue> values,
+        const Size first,
+        const Size last,
+        const Size particleCnt,
+        const Size valueSize) {
+        skipBytes(deserializer, uint64_t(first) * valueSize);
+        for (Size i = 0; i < last - first; ++i) {
+            deserializer.read(values[i]);
+        }
+        skipBytes(deserializer, uint64_t(particleCnt - last) * valueSize);
+    }
+};
+
+struct ValueSizeVisitor {
+    template <typename TValue>
+    Size visit(Serializer<true>& encoder) {
+        return encoder.write(TValue()).size();
+    }
 };
 
 void writeString(const String& s, Serializer<true>& serializer) {
@@ -472,27 +524,20 @@ Attractor readAttractor(Deserializer<Precise>& deserializer) {
     return a;
 }
 
-} // namespace
-
-BinaryOutput::BinaryOutput(const OutputFile& fileMask, const RunTypeEnum runTypeId)
-    : IOutput(fileMask)
-    , runTypeId(runTypeId) {}
-
-Expected<Path> BinaryOutput::dump(const Storage& storage, const Statistics& stats) {
-    VERBOSE_LOG
-
-    const Path fileName = paths.getNextPath(stats);
-    Outcome dirResult = FileSystem::createDirectory(fileName.parentPath());
-    if (!dirResult) {
-        return makeUnexpected<Path>(
-            "Cannot create directory {}: {}", fileName.parentPath().string(), dirResult.error());
-    }
-
+/// \brief Writes the file in the format of \ref BinaryOutput.
+///
+/// Buffers of quantities are not written by the serializer, instead the provided functor is called for each
+/// quantity with the range of particles of the material, in order given by the format.
+template <typename TStoreBuffers>
+void writeBinaryFile(Serializer<true>& serializer,
+    const Storage& storage,
+    const Statistics& stats,
+    const RunTypeEnum runTypeId,
+    const Size paddingSize,
+    const TStoreBuffers& storeBuffers) {
     const Float runTime = stats.getOr<Float>(StatisticsId::RUN_TIME, 0._f);
     const Size wallclockTime = stats.getOr<int>(StatisticsId::WALLCLOCK_TIME, 0);
 
-    Serializer<true> serializer(makeAuto<FileBinaryOutputStream>(fileName));
-
     // file format identifier
     const Size materialCnt = storage.getMaterialCnt();
     const Size quantityCnt = storage.getQuantityCnt() - int(storage.has(QuantityId::MATERIAL_ID));
@@ -514,7 +559,7 @@ Expected<Path> BinaryOutput::dump(const Storage& storage, const Statistics& stat
     serializer.serialize(storage.getAttractorCnt());
 
     // zero bytes until 256 to allow extensions of the header
-    serializer.addPadding(PADDING_SIZE);
+    serializer.addPadding(paddingSize);
 
     // quantity information
     Array<QuantityId> cachedIds;
@@ -566,9 +611,7 @@ Expected<Path> BinaryOutput::dump(const Storage& storage, const Statistics& stat
 
         for (auto i : storage.getQuantities()) {
             if (i.id != QuantityId::MATERIAL_ID) {
-                const Quantity& q = i.quantity;
-                StoreBuffersVisitor visitor;
-                dispatch(q.getValueEnum(), visitor, q, serializer, sequence);
+                storeBuffers(i.quantity, sequence);
             }
         }
     }
@@ -577,6 +620,34 @@ Expected<Path> BinaryOutput::dump(const Storage& storage, const Statistics& stat
     for (const Attractor& a : storage.getAttractors()) {
         writeAttractor(serializer, a);
     }
+}
+
+} // namespace
+
+BinaryOutput::BinaryOutput(const OutputFile& fileMask, const RunTypeEnum runTypeId)
+    : IOutput(fileMask)
+    , runTypeId(runTypeId) {}
+
+Expected<Path> BinaryOutput::dump(const Storage& storage, const Statistics& stats) {
+    VERBOSE_LOG
+
+    const Path fileName = paths.getNextPath(stats);
+    Outcome dirResult = FileSystem::createDirectory(fileName.parentPath());
+    if (!dirResult) {
+        return makeUnexpected<Path>(
+            "Cannot create directory {}: {}", fileName.parentPath().string(), dirResult.error());
+    }
+
+    Serializer<true> serializer(makeAuto<FileBinaryOutputStream>(fileName));
+    writeBinaryFile(serializer,
+        storage,
+        stats,
+        runTypeId,
+        PADDING_SIZE,
+        [&serializer](const Quantity& q, const IndexSequence& sequence) {
+            StoreBuffersVisitor visitor;
+            dispatch(q.getValueEnum(), visitor, q, serializer, sequence);
+        });
 
     return fileName;
 }
@@ -694,6 +765,9 @@ static Optional<String> readBuildDate(char* buffer, const BinaryIoVersion versio
     }
 }
 
+BinaryInput::BinaryInput(Selection&& selection)
+    : selection(std::move(selection)) {}
+
 Outcome BinaryInput::load(const Path& path, Storage& storage, Statistics& stats) {
     storage.removeAll();
     Deserializer<true> deserializer(makeAuto<FileBinaryInputStream>(path));
@@ -744,6 +818,11 @@ Outcome BinaryInput::load(const Path& path, Storage& storage, Statistics& stats)
     try {
         for (Size i = 0; i < quantityCnt; ++i) {
             deserializer.deserialize(quantityIds[i], orders[i], valueTypes[i]);
+            if (quantityIds[i] == QuantityId::PERSISTENT_INDEX && valueTypes[i] == ValueEnum::INDEX) {
+                // older files store 32-bit persistent indices; the serialized values are the same, so they
+                // can be loaded directly as global indices
+                valueTypes[i] = ValueEnum::GLOBAL_INDEX;
+            }
         }
     } catch (SerializerException& e) {
         return makeFailed(exceptionMessage(e));
@@ -776,23 +855,54 @@ Outcome BinaryInput::load(const Path& path, Storage& storage, Statistics& stats)
             }
         }
 
+        // particles of the material to load, indexed from the first particle of the material
+        Size first = 0, last = 0;
         try {
             Size from, to;
             deserializer.deserialize(from, to);
-            LoadBuffersVisitor visitor;
+            const bool materialSelected = selection.materials.empty() ||
+                                          std::find(selection.materials.begin(),
+                                              selection.materials.end(),
+                                              matIdx) != selection.materials.end();
+            if (materialSelected) {
+                last = to - from;
+                if (selection.range) {
+                    first = clamp(*selection.range->begin(), from, to) - from;
+                    last = clamp(*selection.range->end(), from, to) - from;
+                }
+            }
+            LoadBuffersVisitor loadVisitor;
+            ValueSizeVisitor sizeVisitor;
+            Serializer<true> encoder(makeAuto<NullOutputStream>());
             for (Size i = 0; i < quantityCnt; ++i) {
-                dispatch(valueTypes[i],
-                    visitor,
-                    bodyStorage,
-                    deserializer,
-                    IndexSequence(0, to - from),
-                    quantityIds[i],
-                    orders[i]);
+                const Size valueSize = dispatch(valueTypes[i], sizeVisitor, encoder);
+                const bool quantitySelected = selection.quantities.empty() ||
+                                              std::find(selection.quantities.begin(),
+                                                  selection.quantities.end(),
+                                                  quantityIds[i]) != selection.quantities.end();
+                if (quantitySelected && first < last) {
+                    dispatch(valueTypes[i],
+                        loadVisitor,
+                        bodyStorage,
+                        deserializer,
+                        first,
+                        last,
+                        to - from,
+                        valueSize,
+                        quantityIds[i],
+                        orders[i]);
+                } else {
+                    // skip the values and all derivatives
+                    const Size bufferCnt = Size(orders[i]) + 1;
+                    skipBytes(deserializer, uint64_t(to - from) * valueSize * bufferCnt);
+                }
             }
         } catch (SerializerException& e) {
             return makeFailed(exceptionMessage(e));
         }
-        storage.merge(std::move(bodyStorage));
+        if (first < last && bodyStorage.getQuantityCnt() > 0) {
+            storage.merge(std::move(bodyStorage));
+        }
     }
     for (Size i = 0; i < attractorCnt; ++i) {
         const Attractor a = readAttractor(deserializer);
@@ -836,6 +946,384 @@ Expected<BinaryInput::Info> BinaryInput::getInfo(const Path& path) {
     return Expected<Info>(std::move(info));
 }
 
+// ----------------------------------------------------------------------------------------------------------
+// ParallelBinaryOutput
+// ----------------------------------------------------------------------------------------------------------
+
+namespace {
+
+/// Alignment of offsets, sizes and memory buffers required by direct I/O
+constexpr Size DIRECT_IO_ALIGNMENT = 4096;
+
+/// \brief Contiguous part of the binary file.
+///
+/// The segment contains either a part of the serialized metadata (header, material parameters, ...), or a
+/// single buffer (values or derivatives) of a quantity for a given material.
+struct FileSegment {
+    /// Offset of the segment in the file
+    uint64_t offset;
+
+    /// Size of the segment in bytes
+    uint64_t size;
+
+    /// Stored quantity or nullptr if the segment contains metadata
+    const Quantity* quantity;
+
+    /// Offset into the metadata buffer or index of the first stored particle
+    uint64_t from;
+
+    /// Index of the stored buffer, 0 for values, 1 for derivatives, 2 for second derivatives
+    Size bufferIdx;
+
+    /// Size of a single serialized value of the quantity
+    Size valueSize;
+};
+
+class BufferOutputStream : public IBinaryOutputStream {
+private:
+    Array<char>& buffer;
+
+public:
+    explicit BufferOutputStream(Array<char>& buffer)
+        : buffer(buffer) {}
+
+    virtual bool write(ArrayView<const char> data) override {
+        buffer.pushAll(data.begin(), data.end());
+        return true;
+    }
+};
+
+struct EncodeBufferVisitor {
+    /// Encodes bytes [from, to) of the segment into the output buffer.
+    template <typename TValue>
+    void visit(const FileSegment& segment,
+        Serializer<true>& encoder,
+        const uint64_t from,
+        const uint64_t to,
+        char* output) {
+        const Array<TValue>& buffer = segment.quantity->getAll<TValue>()[segment.bufferIdx];
+        const uint64_t valueSize = segment.valueSize;
+        for (uint64_t i = from / valueSize; i * valueSize < to; ++i) {
+            Serializer<true>::View bytes = encoder.write(buffer[Size(segment.from + i)]);
+            SPH_ASSERT(bytes.size() == valueSize);
+            // values can be split between two blocks
+            const uint64_t begin = max(from, i * valueSize);
+            const uint64_t end = min(to, (i + 1) * valueSize);
+            std::memcpy(output + (begin - from), &bytes[Size(begin - i * valueSize)], end - begin);
+        }
+    }
+};
+
+/// \brief File allowing concurrent writes at given offsets.
+class PositionalFile : public Noncopyable {
+private:
+#ifdef SPH_WIN
+    std::ofstream ofs;
+    std::mutex mutex;
+#else
+    int fd = -1;
+#endif
+    bool direct = false;
+
+public:
+    ~PositionalFile() {
+#ifdef SPH_WIN
+        ofs.close();
+#else
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+    }
+
+    Outcome open(const Path& path, const bool directIo) {
+#ifdef SPH_WIN
+        MARK_USED(directIo);
+        ofs.open(path.native(), std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!ofs) {
+            return makeFailed("Cannot open file {}", path.string());
+        }
+#else
+        const int mode = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+        if (directIo) {
+            fd = ::open(path.native(), mode | O_DIRECT, 0644);
+            // file systems not supporting direct I/O report EINVAL, use buffered writes instead
+            direct = fd >= 0;
+        }
+#else
+        MARK_USED(directIo);
+#endif
+        if (fd < 0) {
+            fd = ::open(path.native(), mode, 0644);
+        }
+        if (fd < 0) {
+            return makeFailed("Cannot open file {}: {}", path.string(), std::strerror(errno));
+        }
+#endif
+        return SUCCESS;
+    }
+
+    /// \brief Returns true if the file was opened with direct I/O.
+    bool isDirect() const {
+        return direct;
+    }
+
+    /// \brief Reserves the space for the file, so that the concurrent writes do not have to extend it.
+    Outcome allocate(const uint64_t size) {
+#ifndef SPH_WIN
+        const int result = posix_fallocate(fd, 0, off_t(size));
+        // other errors mean the preallocation is not supported, the file is extended by writes instead
+        if (result == ENOSPC) {
+            return makeFailed("Not enough space on the device");
+        }
+#else
+        MARK_USED(size);
+#endif
+        return SUCCESS;
+    }
+
+    /// \brief Writes the data at given offset in file.
+    ///
+    /// Can be called concurrently from different threads.
+    Outcome write(const char* data, const uint64_t size, const uint64_t offset) {
+#ifdef SPH_WIN
+        std::unique_lock<std::mutex> lock(mutex);
+        ofs.seekp(offset);
+        ofs.write(data, size);
+        if (!ofs) {
+            return makeFailed("Write failed");
+        }
+#else
+        uint64_t written = 0;
+        while (written < size) {
+            const ssize_t result = ::pwrite(fd, data + written, size - written, off_t(offset + written));
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return makeFailed(String::fromAscii(std::strerror(errno)));
+            }
+            written += result;
+        }
+#endif
+        return SUCCESS;
+    }
+
+    /// \brief Truncates the file to given size, flushes the data to disk and closes the file.
+    Outcome close(const uint64_t size) {
+#ifdef SPH_WIN
+        MARK_USED(size);
+        ofs.close();
+        if (!ofs) {
+            return makeFailed("Cannot close the file");
+        }
+#else
+        // direct writes are padded to the alignment, remove the padding
+        const bool ok = ::ftruncate(fd, off_t(size)) == 0 && ::fsync(fd) == 0;
+        const int error = errno;
+        ::close(fd);
+        fd = -1;
+        if (!ok) {
+            return makeFailed(String::fromAscii(std::strerror(error)));
+        }
+#endif
+        return SUCCESS;
+    }
+};
+
+Outcome renameFile(const Path& from, const Path& to) {
+#ifdef SPH_WIN
+    const bool ok = MoveFileExW(from.native(), to.native(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    const bool ok = std::rename(from.native(), to.native()) == 0;
+#endif
+    if (!ok) {
+        return makeFailed("Cannot rename {} to {}", from.string(), to.string());
+    }
+    return SUCCESS;
+}
+
+Path getManifestPath(const Path& path) {
+    return Path(path.string() + ".manifest");
+}
+
+} // namespace
+
+ParallelBinaryOutput::ParallelBinaryOutput(const OutputFile& fileMask,
+    const SharedPtr<IScheduler>& scheduler,
+    const RunTypeEnum runTypeId,
+    const Flags<ParallelOutputFlag> flags,
+    const Size blockSize)
+    : IOutput(fileMask)
+    , scheduler(scheduler)
+    , runTypeId(runTypeId)
+    , flags(flags)
+    , blockSize(blockSize) {
+    SPH_ASSERT(scheduler);
+    SPH_ASSERT(blockSize > 0);
+    SPH_ASSERT(!flags.has(ParallelOutputFlag::DIRECT_IO) || blockSize % DIRECT_IO_ALIGNMENT == 0, blockSize);
+}
+
+Expected<Path> ParallelBinaryOutput::dump(const Storage& storage, const Statistics& stats) {
+    VERBOSE_LOG
+
+    const Path fileName = paths.getNextPath(stats);
+    Outcome dirResult = FileSystem::createDirectory(fileName.parentPath());
+    if (!dirResult) {
+        return makeUnexpected<Path>(
+            "Cannot create directory {}: {}", fileName.parentPath().string(), dirResult.error());
+    }
+
+    // serialize the metadata into memory and compute the offsets of quantity buffers
+    Array<char> metadata;
+    Array<FileSegment> segments;
+    uint64_t fileSize = 0;
+    uint64_t metadataEnd = 0;
+    auto flushMetadata = [&] {
+        if (metadata.size() > metadataEnd) {
+            const uint64_t size = metadata.size() - metadataEnd;
+            segments.push(FileSegment{ fileSize, size, nullptr, metadataEnd, 0, 0 });
+            fileSize += size;
+            metadataEnd = metadata.size();
+        }
+    };
+
+    Serializer<true> serializer(makeAuto<BufferOutputStream>(metadata));
+    Serializer<true> encoder(makeAuto<NullOutputStream>());
+    writeBinaryFile(serializer,
+        storage,
+        stats,
+        runTypeId,
+        BinaryOutput::PADDING_SIZE,
+        [&](const Quantity& q, const IndexSequence& sequence) {
+            flushMetadata();
+            ValueSizeVisitor visitor;
+            const Size valueSize = dispatch(q.getValueEnum(), visitor, encoder);
+            const uint64_t size = uint64_t(valueSize) * sequence.size();
+            if (size == 0) {
+                return;
+            }
+            for (Size bufferIdx = 0; bufferIdx <= Size(q.getOrderEnum()); ++bufferIdx) {
+                segments.push(FileSegment{ fileSize, size, &q, *sequence.begin(), bufferIdx, valueSize });
+                fileSize += size;
+            }
+        });
+    flushMetadata();
+
+    // write into a temporary file first, so that the output is never left incomplete under the final name
+    const Path partPath(fileName.string() + ".part");
+    const Path manifestPath = getManifestPath(fileName);
+    if (FileSystem::pathExists(manifestPath)) {
+        FileSystem::removePath(manifestPath);
+    }
+    PositionalFile file;
+    Outcome result = file.open(partPath, flags.has(ParallelOutputFlag::DIRECT_IO));
+    if (!result) {
+        return makeUnexpected<Path>(result.error());
+    }
+    result = file.allocate(fileSize);
+    if (!result) {
+        return makeUnexpected<Path>("Cannot allocate file {}: {}", partPath.string(), result.error());
+    }
+
+    struct Block {
+        Serializer<true> encoder;
+        Array<char> buffer;
+
+        Block()
+            : encoder(makeAuto<NullOutputStream>()) {}
+    };
+    ThreadLocal<Block> blocks(*scheduler);
+    const uint64_t alignment = file.isDirect() ? DIRECT_IO_ALIGNMENT : 1;
+    const Size blockCnt = Size((fileSize + blockSize - 1) / blockSize);
+    std::mutex errorMutex;
+    Outcome writeResult = SUCCESS;
+    parallelFor(*scheduler, blocks, 0, blockCnt, 1, [&](const Size blockIdx, Block& block) {
+        const uint64_t from = uint64_t(blockIdx) * blockSize;
+        const uint64_t to = min(from + blockSize, fileSize);
+        block.buffer.resize(blockSize + alignment);
+        const uintptr_t address = reinterpret_cast<uintptr_t>(&block.buffer[0]);
+        char* data = &block.buffer[Size((alignment - address % alignment) % alignment)];
+
+        // find the first segment intersecting the block
+        auto iter = std::upper_bound(segments.begin(),
+            segments.end(),
+            from,
+            [](const uint64_t offset, const FileSegment& segment) { return offset < segment.offset; });
+        SPH_ASSERT(iter != segments.begin());
+        for (--iter; iter != segments.end() && iter->offset < to; ++iter) {
+            const uint64_t segmentFrom = max(from, iter->offset) - iter->offset;
+            const uint64_t segmentTo = min(to, iter->offset + iter->size) - iter->offset;
+            char* output = data + (iter->offset + segmentFrom - from);
+            if (iter->quantity) {
+                EncodeBufferVisitor visitor;
+                dispatch(iter->quantity->getValueEnum(),
+                    visitor,
+                    *iter,
+                    block.encoder,
+                    segmentFrom,
+                    segmentTo,
+                    output);
+            } else {
+                std::memcpy(output, &metadata[Size(iter->from + segmentFrom)], segmentTo - segmentFrom);
+            }
+        }
+
+        // direct writes must have aligned size; the padding is removed when the file is closed
+        const uint64_t size = (to - from + alignment - 1) / alignment * alignment;
+        std::memset(data + (to - from), 0, size - (to - from));
+        Outcome blockResult = file.write(data, size, from);
+        if (!blockResult) {
+            std::unique_lock<std::mutex> lock(errorMutex);
+            writeResult = blockResult;
+        }
+    });
+
+    result = writeResult && file.close(fileSize);
+    if (!result) {
+        FileSystem::removePath(partPath);
+        return makeUnexpected<Path>("Cannot write file {}: {}", partPath.string(), result.error());
+    }
+    result = renameFile(partPath, fileName);
+    if (!result) {
+        return makeUnexpected<Path>(result.error());
+    }
+
+    if (flags.has(ParallelOutputFlag::MANIFEST)) {
+        std::ofstream ofs(manifestPath.native());
+        ofs << "size " << fileSize << std::endl;
+        ofs << "particles " << storage.getParticleCnt() << std::endl;
+        if (!ofs) {
+            return makeUnexpected<Path>("Cannot write manifest {}", manifestPath.string());
+        }
+    }
+    return fileName;
+}
+
+Outcome ParallelBinaryOutput::checkManifest(const Path& path) {
+    const Path manifestPath = getManifestPath(path);
+    std::ifstream ifs(manifestPath.native());
+    std::string sizeKey, particlesKey;
+    uint64_t size;
+    Size particleCnt;
+    ifs >> sizeKey >> size >> particlesKey >> particleCnt;
+    if (!ifs || sizeKey != "size" || particlesKey != "particles") {
+        return makeFailed("Cannot read manifest {}", manifestPath.string());
+    }
+    if (!FileSystem::pathExists(path) || FileSystem::fileSize(path) != size) {
+        return makeFailed("Size of file {} does not match the manifest", path.string());
+    }
+    Expected<BinaryInput::Info> info = BinaryInput::getInfo(path);
+    if (!info) {
+        return makeFailed(info.error());
+    }
+    if (info->particleCnt != particleCnt) {
+        return makeFailed("Particle count of file {} does not match the manifest", path.string());
+    }
+    return SUCCESS;
+}
+
 // ----------------------------------------------------------------------------------------------------------
 // CompressedOutput/Input
 // ----------------------------------------------------------------------------------------------------------
@@ -849,13 +1337,6 @@ CompressedOutput::CompressedOutput(const OutputFile& fileMask,
 
 const int MAGIC_NUMBER = 42;
 
-struct NullOutputStream : public IBinaryOutputStream {
-public:
-    virtual bool write(ArrayView<const char> UNUSED(buffer)) override {
-        return true;
-    }
-};
-
 template <typename T>
 static void compressQuantity(Serializer<false>& serializer,
     const CompressionEnum compression,
@@ -1104,6 +1585,10 @@ static void writeDataArray(std::ofstream& of,
         of << R"(      <DataArray type="Int32" Name=")" << column.getName().toAscii()
            << R"(" format="ascii">)";
         break;
+    case ValueEnum::GLOBAL_INDEX:
+        of << R"(      <DataArray type="Int64" Name=")" << column.getName().toAscii()
+           << R"(" format="ascii">)";
+        break;
     case ValueEnum::SYMMETRIC_TENSOR:
         of << R"(      <DataArray type="Float32" Name=")" << column.getName().toAscii()
            << R"(" NumberOfComponents="6" format="ascii">)";
@@ -7,6 +7,7 @@
 
 #include "io/Path.h"
 #include "objects/utility/EnumMap.h"
+#include "objects/utility/IteratorAdapters.h"
 #include "objects/wrappers/Expected.h"
 #include "objects/wrappers/Outcome.h"
 #include "physics/Constants.h"
@@ -45,6 +46,9 @@ public:
     /// file is created by this.
     Path getNextPath(const Statistics& stats) const;
 
+    /// \brief Returns the index of the next dump, without incrementing the internal counter.
+    Size getNextDumpIdx() const;
+
     /// \brief Returns true if the file mask contains (at least one) wildcard.
     ///
     /// If not, \ref getNextPath will always return the same path.
@@ -323,6 +327,7 @@ enum class BinaryIoVersion : int64_t {
 ///    the settings it holds. This should be enforced somehow.
 class BinaryOutput : public IOutput {
     friend class BinaryInput;
+    friend class ParallelBinaryOutput;
 
 private:
     static constexpr Size PADDING_SIZE = 156;
@@ -337,9 +342,41 @@ public:
 
 /// \brief Input for the binary file, generated by \ref BinaryOutput.
 ///
-/// Storage loaded by this class can be used to continue a simulation.
+/// Storage loaded by this class can be used to continue a simulation, provided all data are loaded. The input
+/// can be also restricted to a subset of quantities, materials and particles (see \ref Selection), in which
+/// case the unneeded parts of the file are skipped without reading them. This is useful for post-processing
+/// of snapshots, which usually needs only a few quantities.
 class BinaryInput : public IInput {
 public:
+    /// \brief Subset of the data loaded from the file.
+    struct Selection {
+        /// Quantities to load. Quantities not present in the file are ignored. If empty, all quantities are
+        /// loaded.
+        Array<QuantityId> quantities;
+
+        /// Indices of materials to load. Loaded materials are renumbered, i.e. the first selected material
+        /// has index 0 in the loaded storage. If empty, all materials are loaded.
+        Array<Size> materials;
+
+        /// Range of particle indices to load. The indices correspond to the particles in the file, i.e. before
+        /// the material filter is applied. If NOTHING, all particles are loaded.
+        Optional<IndexSequence> range;
+
+        Selection() = default;
+
+        Selection(std::initializer_list<QuantityId> quantities)
+            : quantities(quantities) {}
+    };
+
+private:
+    Selection selection;
+
+public:
+    BinaryInput() = default;
+
+    /// \brief Creates the input loading only selected data.
+    explicit BinaryInput(Selection&& selection);
+
     virtual Outcome load(const Path& path, Storage& storage, Statistics& stats) override;
 
     struct Info {
@@ -397,6 +434,54 @@ public:
     static Expected<Info> getInfo(const Path& path);
 };
 
+enum class ParallelOutputFlag {
+    /// Bypasses the page cache (O_DIRECT), writing aligned blocks directly to the device. Falls back to
+    /// buffered writes if not supported by the file system.
+    DIRECT_IO = 1 << 0,
+
+    /// Writes a manifest file next to the dump once all data are safely written to disk.
+    MANIFEST = 1 << 1,
+};
+
+/// \brief Output writing the binary file format of \ref BinaryOutput from multiple threads.
+///
+/// The file is byte-to-byte identical to the one written by \ref BinaryOutput and can be loaded by \ref
+/// BinaryInput. Since the sizes of all quantity buffers are known before anything is written, the layout of
+/// the file is computed first. The file is then split into blocks of fixed size, which are encoded and
+/// written (using positional writes) concurrently by the workers of the scheduler. This is useful for large
+/// dumps on parallel file systems, where a single stream achieves only a fraction of the bandwidth.
+///
+/// The data are written into a temporary file (with suffix ".part"), which is synced and renamed to the
+/// final path once complete; an interrupted dump thus never leaves a truncated file under the final name.
+/// Optionally, a manifest (with suffix ".manifest") is written after the rename, see \ref checkManifest.
+class ParallelBinaryOutput : public IOutput {
+private:
+    SharedPtr<IScheduler> scheduler;
+    RunTypeEnum runTypeId;
+    Flags<ParallelOutputFlag> flags;
+    Size blockSize;
+
+public:
+    /// \param fileMask Path of the output files, see \ref OutputFile.
+    /// \param scheduler Scheduler used to encode and write the blocks.
+    /// \param runTypeId Type of the run stored in the header.
+    /// \param flags Options of the writer, see \ref ParallelOutputFlag.
+    /// \param blockSize Size of the blocks written by a single call, in bytes. Must be a multiple of 4096 if
+    ///                  DIRECT_IO is used.
+    ParallelBinaryOutput(const OutputFile& fileMask,
+        const SharedPtr<IScheduler>& scheduler,
+        const RunTypeEnum runTypeId = RunTypeEnum::SPH,
+        const Flags<ParallelOutputFlag> flags = ParallelOutputFlag::MANIFEST,
+        const Size blockSize = 1 << 22);
+
+    virtual Expected<Path> dump(const Storage& storage, const Statistics& stats) override;
+
+    /// \brief Checks that the dump is complete, using the manifest written by the output.
+    ///
+    /// Fails if the manifest is missing or if it does not match the file.
+    static Outcome checkManifest(const Path& path);
+};
+
 enum class CompressedIoVersion : int {
     FIRST = 0,
     V2021_08_08 = 20210808, ///< added attractors
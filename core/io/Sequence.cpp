@@ -0,0 +1,791 @@
+#include "io/Sequence.h"
+#include "io/FileSystem.h"
+#include "io/Logger.h"
+#include "io/Serializer.h"
+#include "quantities/Attractor.h"
+#include "quantities/IMaterial.h"
+#include "quantities/Quantity.h"
+#include "system/Factory.h"
+#include "system/Statistics.h"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+NAMESPACE_SPH_BEGIN
+
+namespace {
+
+constexpr Size FILE_HEADER_SIZE = 64;
+constexpr Size FRAME_HEADER_SIZE = 48;
+
+/// Number of particles sharing the quantization steps in delta frames
+constexpr Size DELTA_BLOCK_SIZE = 256;
+
+enum class FrameType : int32_t {
+    KEYFRAME = 0,
+    DELTA = 1,
+};
+
+/// Quantities stored in each frame in single precision
+const QuantityId SCALAR_IDS[] = { QuantityId::DENSITY, QuantityId::ENERGY, QuantityId::DAMAGE };
+
+/// \brief Appends values into a buffer in native byte order.
+class ByteWriter {
+private:
+    Array<char> buffer;
+
+public:
+    template <std::size_t N>
+    void writeChars(const char (&data)[N]) {
+        const Size size = buffer.size();
+        buffer.resize(size + N);
+        std::memcpy(&buffer[size], data, N);
+    }
+
+    template <typename T>
+    void write(const T value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivial types can be written");
+        const Size size = buffer.size();
+        buffer.resize(size + sizeof(T));
+        std::memcpy(&buffer[size], &value, sizeof(T));
+    }
+
+    void writeBytes(ArrayView<const char> data) {
+        buffer.pushAll(data.begin(), data.end());
+    }
+
+    void addPadding(const Size size) {
+        buffer.resizeAndSet(buffer.size() + size, '\0');
+    }
+
+    void reserve(const Size size) {
+        buffer.reserve(size);
+    }
+
+    Size size() const {
+        return buffer.size();
+    }
+
+    ArrayView<const char> view() const {
+        return buffer;
+    }
+};
+
+/// \brief Reads values written by \ref ByteWriter.
+class ByteReader {
+private:
+    ArrayView<const char> buffer;
+    Size offset = 0;
+
+public:
+    explicit ByteReader(ArrayView<const char> buffer)
+        : buffer(buffer) {}
+
+    template <typename T>
+    T read() {
+        if (offset + sizeof(T) > buffer.size()) {
+            throw SerializerException("Unexpected end of frame data");
+        }
+        T value;
+        std::memcpy(&value, &buffer[offset], sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    void readBytes(ArrayView<char> data) {
+        if (offset + data.size() > buffer.size()) {
+            throw SerializerException("Unexpected end of frame data");
+        }
+        std::memcpy(&data[0], &buffer[offset], data.size());
+        offset += data.size();
+    }
+
+    void skip(const Size size) {
+        if (offset + size > buffer.size()) {
+            throw SerializerException("Unexpected end of frame data");
+        }
+        offset += size;
+    }
+};
+
+/// \brief Output stream appending the data to a buffer, used to serialize material parameters.
+class BufferOutputStream : public IBinaryOutputStream {
+private:
+    Array<char>& buffer;
+
+public:
+    explicit BufferOutputStream(Array<char>& buffer)
+        : buffer(buffer) {}
+
+    virtual bool write(ArrayView<const char> data) override {
+        buffer.pushAll(data.begin(), data.end());
+        return true;
+    }
+};
+
+/// \brief Input stream reading the data using \ref ByteReader, used to deserialize material parameters.
+class ReaderInputStream : public IBinaryInputStream {
+private:
+    ByteReader& reader;
+
+public:
+    explicit ReaderInputStream(ByteReader& reader)
+        : reader(reader) {}
+
+    virtual bool read(ArrayView<char> data) override {
+        reader.readBytes(data);
+        return true;
+    }
+
+    virtual bool skip(const Size cnt) override {
+        reader.skip(cnt);
+        return true;
+    }
+
+    virtual bool good() const override {
+        return true;
+    }
+};
+
+struct FrameEntry {
+    /// Offset of the frame data (excluding the header) in the file
+    uint64_t offset;
+    uint64_t size;
+    double time;
+    FrameType type;
+    Size particleCnt;
+    Size keyframeIdx;
+    Size constantsIdx;
+    Size attractorCnt;
+};
+
+/// Quantities stored only when they change
+struct ConstantQuantities {
+    Array<Float> masses;
+    Array<Size> flags;
+    Array<Size> materialIds;
+    Array<BodySettings> materials;
+};
+
+template <typename T>
+bool differs(ArrayView<const T> values, const Array<T>& stored) {
+    return values.size() != stored.size() || !std::equal(values.begin(), values.end(), stored.begin());
+}
+
+Vector roundToFloat(const Vector& v) {
+    return Vector(float(v[X]), float(v[Y]), float(v[Z]), float(v[H]));
+}
+
+void writeVectorsF32(ByteWriter& writer, ArrayView<const Vector> values, Array<Vector>& stored) {
+    stored.resize(values.size());
+    for (Size i = 0; i < values.size(); ++i) {
+        for (Size j = 0; j < 4; ++j) {
+            writer.write(float(values[i][j]));
+        }
+        stored[i] = roundToFloat(values[i]);
+    }
+}
+
+void readVectorsF32(ByteReader& reader, const Size particleCnt, Array<Vector>& values) {
+    values.resize(particleCnt);
+    for (Size i = 0; i < particleCnt; ++i) {
+        for (Size j = 0; j < 4; ++j) {
+            values[i][j] = reader.read<float>();
+        }
+    }
+}
+
+/// \brief Writes the differences from the keyframe, quantized to 16 bits.
+///
+/// Each block of \ref DELTA_BLOCK_SIZE particles has its own scale for each component, so a few fast
+/// particles (ejecta, escapers) only reduce the precision of their own block.
+void writeVectorsDelta(ByteWriter& writer, ArrayView<const Vector> values, ArrayView<const Vector> key) {
+    SPH_ASSERT(values.size() == key.size());
+    for (Size from = 0; from < values.size(); from += DELTA_BLOCK_SIZE) {
+        const Size to = min(from + DELTA_BLOCK_SIZE, values.size());
+        Vector maxAbs(0._f);
+        for (Size i = from; i < to; ++i) {
+            maxAbs = max(maxAbs, abs(values[i] - key[i]));
+        }
+        StaticArray<double, 4> scales;
+        for (Size j = 0; j < 4; ++j) {
+            scales[j] = double(maxAbs[j]) / 32767.;
+            writer.write(scales[j]);
+        }
+        for (Size i = from; i < to; ++i) {
+            for (Size j = 0; j < 4; ++j) {
+                const double delta = double(values[i][j] - key[i][j]);
+                const int16_t quantized = scales[j] > 0. ? int16_t(std::round(delta / scales[j])) : 0;
+                writer.write(quantized);
+            }
+        }
+    }
+}
+
+void readVectorsDelta(ByteReader& reader, ArrayView<const Vector> key, Array<Vector>& values) {
+    values.resize(key.size());
+    for (Size from = 0; from < key.size(); from += DELTA_BLOCK_SIZE) {
+        const Size to = min(from + DELTA_BLOCK_SIZE, key.size());
+        StaticArray<double, 4> scales;
+        for (Size j = 0; j < 4; ++j) {
+            scales[j] = reader.read<double>();
+        }
+        for (Size i = from; i < to; ++i) {
+            for (Size j = 0; j < 4; ++j) {
+                values[i][j] = key[i][j] + Float(scales[j] * reader.read<int16_t>());
+            }
+        }
+    }
+}
+
+/// Serializes parameters of all materials in the storage.
+Array<char> serializeMaterials(const Storage& storage) {
+    Array<char> buffer;
+    Serializer<true> serializer(makeAuto<BufferOutputStream>(buffer));
+    serializer.serialize(storage.getMaterialCnt());
+    for (Size matIdx = 0; matIdx < storage.getMaterialCnt(); ++matIdx) {
+        const BodySettings& params = storage.getMaterial(matIdx)->getParams();
+        serializer.serialize(params.size());
+        for (auto param : params) {
+            serializer.serialize(param.id, param.value.getTypeIdx());
+            forValue(param.value, [&serializer](const auto& value) { serializer.write(value); });
+        }
+    }
+    return buffer;
+}
+
+template <typename T>
+void setParam(BodySettings& body, const BodySettingsId id, const T& value) {
+    body.set(id, value);
+}
+
+void setParam(BodySettings& body, const BodySettingsId id, EnumWrapper value) {
+    // enum is serialized without the type index, use the index of the current value
+    value.index = body.get<EnumWrapper>(id).index;
+    body.set(id, value);
+}
+
+Array<BodySettings> deserializeMaterials(ByteReader& reader) {
+    Deserializer<true> deserializer(makeAuto<ReaderInputStream>(reader));
+    Size materialCnt;
+    deserializer.deserialize(materialCnt);
+    Array<BodySettings> materials;
+    for (Size matIdx = 0; matIdx < materialCnt; ++matIdx) {
+        Size paramCnt;
+        deserializer.deserialize(paramCnt);
+        BodySettings body;
+        for (Size k = 0; k < paramCnt; ++k) {
+            BodySettingsId paramId;
+            Size valueId;
+            deserializer.deserialize(paramId, valueId);
+            SettingsIterator<BodySettingsId>::IteratorValue iteratorValue{ paramId,
+                { CONSTRUCT_TYPE_IDX, valueId } };
+            forValue(iteratorValue.value, [&deserializer, &body, paramId](auto& entry) {
+                deserializer.read(entry);
+                try {
+                    setParam(body, paramId, entry);
+                } catch (const Exception& UNUSED(e)) {
+                    // parameter from a newer version, skip
+                }
+            });
+        }
+        materials.push(std::move(body));
+    }
+    return materials;
+}
+
+void readConstants(ByteReader& reader, const Size particleCnt, ConstantQuantities& constants) {
+    constants = ConstantQuantities();
+    const Size count = reader.read<uint32_t>();
+    for (Size k = 0; k < count; ++k) {
+        const QuantityId id = QuantityId(reader.read<int32_t>());
+        switch (id) {
+        case QuantityId::MASS:
+            constants.masses.resize(particleCnt);
+            for (Size i = 0; i < particleCnt; ++i) {
+                constants.masses[i] = Float(reader.read<double>());
+            }
+            break;
+        case QuantityId::FLAG:
+        case QuantityId::MATERIAL_ID: {
+            Array<Size>& values = id == QuantityId::FLAG ? constants.flags : constants.materialIds;
+            values.resize(particleCnt);
+            for (Size i = 0; i < particleCnt; ++i) {
+                values[i] = reader.read<uint32_t>();
+            }
+            break;
+        }
+        default:
+            throw SerializerException("Unexpected constant quantity " + toString(int(id)));
+        }
+    }
+    constants.materials = deserializeMaterials(reader);
+}
+
+Outcome readFileHeader(std::ifstream& ifs) {
+    char header[FILE_HEADER_SIZE];
+    if (!ifs.read(header, FILE_HEADER_SIZE)) {
+        return makeFailed("Incomplete header");
+    }
+    if (std::strcmp(header, "SSQ") != 0) {
+        return makeFailed("Invalid format specifier");
+    }
+    int32_t version;
+    std::memcpy(&version, header + 4, sizeof(version));
+    if (version > int32_t(SequenceIoVersion::LATEST)) {
+        return makeFailed("Unsupported version of the file: {}", version);
+    }
+    return SUCCESS;
+}
+
+/// \brief Reconstructs the index of frames from the frame headers.
+///
+/// Incomplete frame at the end of the file (written by an interrupted run) is ignored.
+Expected<Array<FrameEntry>> readIndex(const Path& path) {
+    std::ifstream ifs(path.native(), std::ios::in | std::ios::binary);
+    if (!ifs) {
+        return makeUnexpected<Array<FrameEntry>>("Cannot open file '{}'", path.string());
+    }
+    Outcome result = readFileHeader(ifs);
+    if (!result) {
+        return makeUnexpected<Array<FrameEntry>>(
+            "Cannot read file '{}'. {}.", path.string(), result.error());
+    }
+    ifs.seekg(0, std::ios::end);
+    const uint64_t fileSize = ifs.tellg();
+
+    Array<FrameEntry> frames;
+    uint64_t offset = FILE_HEADER_SIZE;
+    char header[FRAME_HEADER_SIZE];
+    while (offset + FRAME_HEADER_SIZE <= fileSize) {
+        ifs.seekg(offset);
+        if (!ifs.read(header, FRAME_HEADER_SIZE) || std::strcmp(header, "FRM") != 0) {
+            break;
+        }
+        ByteReader reader(ArrayView<const char>(header, FRAME_HEADER_SIZE));
+        reader.skip(4);
+        FrameEntry frame;
+        frame.offset = offset + FRAME_HEADER_SIZE;
+        frame.size = reader.read<uint64_t>();
+        frame.time = reader.read<double>();
+        frame.type = FrameType(reader.read<int32_t>());
+        frame.particleCnt = reader.read<uint32_t>();
+        frame.keyframeIdx = reader.read<uint32_t>();
+        frame.constantsIdx = reader.read<uint32_t>();
+        frame.attractorCnt = reader.read<uint32_t>();
+        if (frame.offset + frame.size > fileSize) {
+            break;
+        }
+        frames.push(frame);
+        offset = frame.offset + frame.size;
+    }
+    return frames;
+}
+
+Array<char> readFrameData(std::ifstream& ifs, const FrameEntry& frame) {
+    Array<char> data(frame.size);
+    ifs.seekg(frame.offset);
+    if (frame.size > 0 && !ifs.read(&data[0], frame.size)) {
+        throw SerializerException("Cannot read frame data");
+    }
+    return data;
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------------------------------------------
+// SequenceOutput
+// ----------------------------------------------------------------------------------------------------------
+
+static Path removeWildcards(const Path& mask) {
+    String path = mask.string();
+    path.replaceAll("%d", "");
+    path.replaceAll("%t", "");
+    return Path(path);
+}
+
+SequenceOutput::SequenceOutput(const OutputFile& fileMask,
+    const Size keyframePeriod,
+    const RunTypeEnum runTypeId)
+    : IOutput(fileMask)
+    , path(removeWildcards(fileMask.getMask()))
+    , keyframePeriod(max(keyframePeriod, 1u))
+    , runTypeId(runTypeId)
+    , frameCnt(fileMask.getNextDumpIdx()) {}
+
+Outcome SequenceOutput::open() {
+    Outcome dirResult = FileSystem::createDirectory(path.parentPath());
+    if (!dirResult) {
+        return makeFailed("Cannot create directory {}: {}", path.parentPath().string(), dirResult.error());
+    }
+
+    if (frameCnt > 0 && FileSystem::pathExists(path)) {
+        // resumed run; keep the frames preceding the first dump, the following frames are overwritten
+        Expected<Array<FrameEntry>> frames = readIndex(path);
+        if (frames && !frames->empty()) {
+            frameCnt = min(frameCnt, frames->size());
+            const FrameEntry& last = frames.value()[frameCnt - 1];
+            return FileSystem::resizeFile(path, last.offset + last.size);
+        }
+    }
+
+    frameCnt = 0;
+    std::ofstream ofs(path.native(), std::ios::out | std::ios::binary | std::ios::trunc);
+    ByteWriter fileHeader;
+    fileHeader.writeChars("SSQ");
+    fileHeader.write(int32_t(SequenceIoVersion::LATEST));
+    fileHeader.write(int32_t(runTypeId));
+    fileHeader.write(int32_t(keyframePeriod));
+    fileHeader.addPadding(FILE_HEADER_SIZE - fileHeader.size());
+    ofs.write(&fileHeader.view()[0], fileHeader.size());
+    ofs.close();
+    if (!ofs) {
+        return makeFailed("Cannot write to file '{}'", path.string());
+    }
+    return SUCCESS;
+}
+
+Expected<Path> SequenceOutput::dump(const Storage& storage, const Statistics& stats) {
+    VERBOSE_LOG
+
+    if (!opened) {
+        Outcome result = this->open();
+        if (!result) {
+            return makeUnexpected<Path>(result.error());
+        }
+        opened = true;
+    }
+
+    const Size particleCnt = storage.getParticleCnt();
+    ArrayView<const Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+
+    ArrayView<const Float> m;
+    ArrayView<const Size> flag, matId;
+    if (storage.has(QuantityId::MASS)) {
+        m = storage.getValue<Float>(QuantityId::MASS);
+    }
+    if (storage.has(QuantityId::FLAG)) {
+        flag = storage.getValue<Size>(QuantityId::FLAG);
+    }
+    if (storage.has(QuantityId::MATERIAL_ID)) {
+        matId = storage.getValue<Size>(QuantityId::MATERIAL_ID);
+    }
+
+    const bool countChanged = keyPositions.empty() || keyPositions.size() != particleCnt;
+    const FrameType type =
+        (countChanged || frameCnt - keyframeIdx >= keyframePeriod) ? FrameType::KEYFRAME : FrameType::DELTA;
+    Array<char> params = serializeMaterials(storage);
+    const bool storeConstants = countChanged || differs(m, masses) || differs(flag, flags) ||
+                                differs(matId, materialIds) ||
+                                differs(ArrayView<const char>(params), materials);
+
+    ByteWriter data;
+    data.reserve(particleCnt * (type == FrameType::KEYFRAME ? 64 : 32));
+    if (storeConstants) {
+        constantsIdx = frameCnt;
+        data.write(uint32_t(!m.empty() + !flag.empty() + !matId.empty()));
+        if (!m.empty()) {
+            data.write(int32_t(QuantityId::MASS));
+            for (Size i = 0; i < particleCnt; ++i) {
+                data.write(double(m[i]));
+            }
+        }
+        for (QuantityId id : { QuantityId::FLAG, QuantityId::MATERIAL_ID }) {
+            ArrayView<const Size> values = id == QuantityId::FLAG ? flag : matId;
+            if (!values.empty()) {
+                data.write(int32_t(id));
+                for (Size i = 0; i < particleCnt; ++i) {
+                    data.write(uint32_t(values[i]));
+                }
+            }
+        }
+        masses.clear();
+        masses.pushAll(m.begin(), m.end());
+        flags.clear();
+        flags.pushAll(flag.begin(), flag.end());
+        materialIds.clear();
+        materialIds.pushAll(matId.begin(), matId.end());
+        data.writeBytes(params);
+        materials = std::move(params);
+    }
+
+    if (type == FrameType::KEYFRAME) {
+        keyframeIdx = frameCnt;
+        writeVectorsF32(data, r, keyPositions);
+        writeVectorsF32(data, v, keyVelocities);
+    } else {
+        writeVectorsDelta(data, r, keyPositions);
+        writeVectorsDelta(data, v, keyVelocities);
+    }
+
+    Size scalarCnt = 0;
+    for (QuantityId id : SCALAR_IDS) {
+        scalarCnt += storage.has(id);
+    }
+    data.write(uint32_t(scalarCnt));
+    for (QuantityId id : SCALAR_IDS) {
+        if (storage.has(id)) {
+            data.write(int32_t(id));
+            for (Float value : storage.getValue<Float>(id)) {
+                data.write(float(value));
+            }
+        }
+    }
+
+    for (const Attractor& a : storage.getAttractors()) {
+        for (const Vector& vec : { a.position, a.velocity }) {
+            data.write(double(vec[X]));
+            data.write(double(vec[Y]));
+            data.write(double(vec[Z]));
+        }
+        data.write(double(a.radius));
+        data.write(double(a.mass));
+    }
+
+    ByteWriter header;
+    header.writeChars("FRM");
+    header.write(uint64_t(data.size()));
+    header.write(double(stats.getOr<Float>(StatisticsId::RUN_TIME, 0._f)));
+    header.write(int32_t(type));
+    header.write(uint32_t(particleCnt));
+    header.write(uint32_t(keyframeIdx));
+    header.write(uint32_t(constantsIdx));
+    header.write(uint32_t(storage.getAttractorCnt()));
+    header.addPadding(FRAME_HEADER_SIZE - header.size());
+
+    std::ofstream ofs(path.native(), std::ios::out | std::ios::binary | std::ios::app);
+    ofs.write(&header.view()[0], header.size());
+    if (data.size() > 0) {
+        ofs.write(&data.view()[0], data.size());
+    }
+    ofs.close();
+    if (!ofs) {
+        return makeUnexpected<Path>("Cannot write to file '{}'", path.string());
+    }
+
+    return SequenceInput::getFramePath(path, frameCnt++);
+}
+
+// ----------------------------------------------------------------------------------------------------------
+// SequenceInput
+// ----------------------------------------------------------------------------------------------------------
+
+struct SequenceInput::Cache {
+    /// Path of the file and its size when the index was created
+    Path path;
+    uint64_t fileSize = 0;
+
+    Array<FrameEntry> frames;
+
+    /// Decoded keyframe
+    Optional<Size> keyframeIdx;
+    Array<Vector> keyPositions;
+    Array<Vector> keyVelocities;
+
+    /// Decoded constant quantities
+    Optional<Size> constantsIdx;
+    ConstantQuantities constants;
+};
+
+SequenceInput::SequenceInput()
+    : cache(makeAuto<Cache>()) {}
+
+SequenceInput::~SequenceInput() = default;
+
+/// \brief Creates storage with a separate material for each range of material IDs.
+///
+/// Materials are created from the stored parameters; if the parameters of the material are not stored,
+/// the material is created with default parameters.
+static Storage makeStorage(const ConstantQuantities& constants, const Size particleCnt) {
+    Array<Size> boundaries{ 0 };
+    ArrayView<const Size> matIds = constants.materialIds;
+    if (!matIds.empty() && std::is_sorted(matIds.begin(), matIds.end())) {
+        for (Size i = 1; i < particleCnt; ++i) {
+            if (matIds[i] != matIds[i - 1]) {
+                boundaries.push(i);
+            }
+        }
+    }
+    boundaries.push(particleCnt);
+
+    Storage storage;
+    for (Size b = 0; b < boundaries.size() - 1; ++b) {
+        const Size from = boundaries[b];
+        const Size to = boundaries[b + 1];
+        const Size materialIdx = matIds.empty() ? 0 : matIds[from];
+        const BodySettings& params = materialIdx < constants.materials.size()
+                                         ? constants.materials[materialIdx]
+                                         : BodySettings::getDefaults();
+        Storage body(Factory::getMaterial(params));
+        body.insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, Array<Vector>(to - from));
+        if (!constants.masses.empty()) {
+            Array<Float> m;
+            m.pushAll(constants.masses.begin() + from, constants.masses.begin() + to);
+            body.insert<Float>(QuantityId::MASS, OrderEnum::ZERO, std::move(m));
+        }
+        if (!constants.flags.empty()) {
+            Array<Size> flags;
+            flags.pushAll(constants.flags.begin() + from, constants.flags.begin() + to);
+            body.insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, std::move(flags));
+        }
+        storage.merge(std::move(body));
+    }
+    return storage;
+}
+
+Outcome SequenceInput::load(const Path& path, Storage& storage, Statistics& stats) {
+    Path filePath;
+    Size frameIdx;
+    tieToTuple(filePath, frameIdx) = parseFramePath(path);
+    if (!FileSystem::pathExists(filePath)) {
+        return makeFailed("File '{}' does not exist", filePath.string());
+    }
+
+    const uint64_t fileSize = FileSystem::fileSize(filePath);
+    if (filePath != cache->path || fileSize < cache->fileSize) {
+        *cache = Cache();
+    }
+    if (fileSize != cache->fileSize || cache->frames.empty()) {
+        Expected<Array<FrameEntry>> frames = readIndex(filePath);
+        if (!frames) {
+            return makeFailed(frames.error());
+        }
+        cache->path = filePath;
+        cache->fileSize = fileSize;
+        cache->frames = std::move(frames.value());
+    }
+    if (frameIdx >= cache->frames.size()) {
+        return makeFailed(
+            "Frame {} not found in file '{}', the file contains {} frames",
+            frameIdx,
+            filePath.string(),
+            cache->frames.size());
+    }
+
+    const FrameEntry& frame = cache->frames[frameIdx];
+    const Size particleCnt = frame.particleCnt;
+    if (frame.keyframeIdx > frameIdx || frame.constantsIdx > frameIdx ||
+        cache->frames[frame.keyframeIdx].particleCnt != particleCnt ||
+        cache->frames[frame.constantsIdx].particleCnt != particleCnt) {
+        return makeFailed("Frame {} of file '{}' is corrupted", frameIdx, filePath.string());
+    }
+
+    std::ifstream ifs(filePath.native(), std::ios::in | std::ios::binary);
+    Array<Vector> r, v;
+    try {
+        if (!cache->constantsIdx || cache->constantsIdx.value() != frame.constantsIdx) {
+            Array<char> data = readFrameData(ifs, cache->frames[frame.constantsIdx]);
+            ByteReader reader(data);
+            readConstants(reader, particleCnt, cache->constants);
+            cache->constantsIdx = frame.constantsIdx;
+        }
+
+        // constants stored in the keyframe or in the frame itself have been decoded above, skip them
+        ConstantQuantities skipped;
+        if (frame.type == FrameType::DELTA &&
+            (!cache->keyframeIdx || cache->keyframeIdx.value() != frame.keyframeIdx)) {
+            const FrameEntry& keyframe = cache->frames[frame.keyframeIdx];
+            Array<char> data = readFrameData(ifs, keyframe);
+            ByteReader reader(data);
+            if (keyframe.constantsIdx == frame.keyframeIdx) {
+                readConstants(reader, particleCnt, skipped);
+            }
+            readVectorsF32(reader, particleCnt, cache->keyPositions);
+            readVectorsF32(reader, particleCnt, cache->keyVelocities);
+            cache->keyframeIdx = frame.keyframeIdx;
+        }
+
+        Array<char> data = readFrameData(ifs, frame);
+        ByteReader reader(data);
+        if (frame.constantsIdx == frameIdx) {
+            readConstants(reader, particleCnt, skipped);
+        }
+        if (frame.type == FrameType::KEYFRAME) {
+            readVectorsF32(reader, particleCnt, r);
+            readVectorsF32(reader, particleCnt, v);
+        } else {
+            readVectorsDelta(reader, cache->keyPositions, r);
+            readVectorsDelta(reader, cache->keyVelocities, v);
+        }
+
+        storage = makeStorage(cache->constants, particleCnt);
+        storage.getValue<Vector>(QuantityId::POSITION) = std::move(r);
+        storage.getDt<Vector>(QuantityId::POSITION) = std::move(v);
+
+        const Size scalarCnt = reader.read<uint32_t>();
+        for (Size k = 0; k < scalarCnt; ++k) {
+            const QuantityId id = QuantityId(reader.read<int32_t>());
+            Array<Float> values(particleCnt);
+            for (Size i = 0; i < particleCnt; ++i) {
+                values[i] = reader.read<float>();
+            }
+            storage.insert<Float>(id, OrderEnum::ZERO, std::move(values));
+        }
+
+        for (Size k = 0; k < frame.attractorCnt; ++k) {
+            StaticArray<Float, 8> params;
+            for (Size j = 0; j < 8; ++j) {
+                params[j] = Float(reader.read<double>());
+            }
+            storage.addAttractor(Attractor(Vector(params[0], params[1], params[2]),
+                Vector(params[3], params[4], params[5]),
+                params[6],
+                params[7]));
+        }
+    } catch (const SerializerException& e) {
+        return makeFailed("Cannot read frame {} of file '{}'. {}", frameIdx, filePath.string(), exceptionMessage(e));
+    }
+
+    stats.set(StatisticsId::RUN_TIME, Float(frame.time));
+    SPH_ASSERT(storage.isValid());
+    return SUCCESS;
+}
+
+Path SequenceInput::getFramePath(const Path& path, const Size frameIdx) {
+    const Path filePath = parseFramePath(path).get<0>();
+    std::wostringstream ss;
+    ss << L'#' << std::setw(4) << std::setfill(L'0') << frameIdx;
+    const String name = filePath.fileName().string();
+    const Size dot = name.findLast(L'.');
+    String frameName;
+    if (dot == String::npos) {
+        frameName = name + String::fromWstring(ss.str());
+    } else {
+        frameName = name.substr(0, dot) + String::fromWstring(ss.str()) + name.substr(dot);
+    }
+    return filePath.parentPath() / Path(frameName);
+}
+
+Tuple<Path, Size> SequenceInput::parseFramePath(const Path& path) {
+    const String name = path.fileName().string();
+    const Size hash = name.findLast(L'#');
+    if (hash == String::npos) {
+        return makeTuple(path, 0u);
+    }
+    const Size dot = name.find(L'.', hash);
+    const Size digitCnt = (dot == String::npos) ? name.size() - hash - 1 : dot - hash - 1;
+    const Optional<Size> frameIdx = fromString<Size>(name.substr(hash + 1, digitCnt));
+    if (digitCnt == 0 || !frameIdx) {
+        return makeTuple(path, 0u);
+    }
+    String fileName = name.substr(0, hash);
+    if (dot != String::npos) {
+        fileName += name.substr(dot);
+    }
+    return makeTuple(path.parentPath() / Path(fileName), frameIdx.value());
+}
+
+Expected<Array<Float>> SequenceInput::getFrameTimes(const Path& path) {
+    Expected<Array<FrameEntry>> frames = readIndex(parseFramePath(path).get<0>());
+    if (!frames) {
+        return makeUnexpected<Array<Float>>(frames.error());
+    }
+    Array<Float> times;
+    for (const FrameEntry& frame : frames.value()) {
+        times.push(Float(frame.time));
+    }
+    return times;
+}
+
+NAMESPACE_SPH_END
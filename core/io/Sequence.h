@@ -0,0 +1,139 @@
+#pragma once
+
+/// \file Sequence.h
+/// \brief Container storing a sequence of snapshots in a single file
+/// \author Pavel Sevecek (sevecek at sirrah.troja.mff.cuni.cz)
+/// \date 2016-2021
+
+#include "io/Output.h"
+#include "objects/containers/Tuple.h"
+
+NAMESPACE_SPH_BEGIN
+
+enum class SequenceIoVersion : int {
+    FIRST = 0,
+    LATEST = FIRST,
+};
+
+/// \brief Output storing all dumps of the run into a single file.
+///
+/// The output is intended for visualization of the run with a high resolution in time, similarly to \ref
+/// CompressedOutput. Consecutive frames are highly correlated, so the frames are stored relative to each
+/// other rather than as standalone snapshots:
+///  - quantities that do not change during the run (masses, flags, material IDs and material parameters)
+///    are stored only when they differ from the previously stored values, usually only in the first frame,
+///  - every n-th frame is a keyframe, storing positions and velocities of particles in single precision,
+///  - other frames store positions and velocities as 16-bit quantized differences from the previous
+///    keyframe. The quantization step is computed separately for each component and each block of 256
+///    particles, the maximal error is thus 1/65534 of the largest displacement within the block since the
+///    keyframe.
+///  - other quantities (density, energy and damage) are stored in single precision in each frame.
+/// Any frame can be therefore reconstructed by reading at most three frames (the frame itself, its keyframe
+/// and the frame with constant quantities). A keyframe is also written whenever the particle count changes.
+///
+/// Each frame is appended to the file when created, the file is closed between the dumps. The index of
+/// frames is not stored explicitly, it is reconstructed by \ref SequenceInput from headers of frames; the
+/// file thus stays readable even if the run is interrupted while writing a frame. If the first dump index of
+/// the output file is non-zero (the run is resumed from a frame of the file), frames preceding the dump index
+/// are kept and the following frames are replaced by the new ones.
+///
+/// \subsection Format specification
+/// The file starts with a 64-byte header: identifier "SSQ" (4 bytes including terminating zero), format
+/// version [int32], run type [int32], keyframe period [int32], padding. It is followed by frames, each
+/// starting with a 48-byte frame header:
+///  - identifier "FRM" (4 bytes including terminating zero)
+///  - size of the frame data [uint64], not including the header
+///  - run time [double]
+///  - frame type [int32], 0 for keyframes, 1 for delta frames
+///  - particle count [uint32]
+///  - index of the keyframe of the frame [uint32]
+///  - index of the frame storing constant quantities [uint32]
+///  - number of attractors [uint32]
+///  - padding (8 bytes)
+/// The frame data consist of the constant quantities and material parameters (if stored in the frame),
+/// positions and velocities, other quantities and attractors. Each block of quantities starts with the
+/// number of quantities [uint32], followed by quantity ID [int32] and values for each quantity. Material
+/// parameters are serialized in the same way as in \ref BinaryOutput. Quantized differences of each block of
+/// particles are preceded by the quantization steps of the block [4x double].
+class SequenceOutput : public IOutput {
+private:
+    Path path;
+    Size keyframePeriod;
+    RunTypeEnum runTypeId;
+
+    /// Number of frames written so far
+    Size frameCnt = 0;
+
+    /// Index of the last keyframe
+    Size keyframeIdx = 0;
+
+    /// Index of the last frame with constant quantities
+    Size constantsIdx = 0;
+
+    /// Positions and velocities stored in the last keyframe, as loaded by \ref SequenceInput
+    Array<Vector> keyPositions;
+    Array<Vector> keyVelocities;
+
+    /// Last stored constant quantities
+    Array<Float> masses;
+    Array<Size> flags;
+    Array<Size> materialIds;
+
+    /// Last stored material parameters, serialized
+    Array<char> materials;
+
+    /// True if the file has been created (or opened, if the run is resumed)
+    bool opened = false;
+
+public:
+    /// \param fileMask Path of the file. Wildcards are removed from the path, all dumps are stored in a
+    ///                 single file.
+    /// \param keyframePeriod Number of frames between two consecutive keyframes.
+    /// \param runTypeId Type of the run stored in the header.
+    explicit SequenceOutput(const OutputFile& fileMask,
+        const Size keyframePeriod = 20,
+        const RunTypeEnum runTypeId = RunTypeEnum::SPH);
+
+    virtual Expected<Path> dump(const Storage& storage, const Statistics& stats) override;
+
+private:
+    /// Creates the file or truncates the existing file to the first dump index.
+    Outcome open();
+};
+
+/// \brief Input loading frames of the file created by \ref SequenceOutput.
+///
+/// A frame of the file is addressed by a "frame path" (see \ref getFramePath), consisting of the path of
+/// the file and the index of the frame, so that the frames can be enumerated and opened as a regular file
+/// sequence. Loading the path of the file itself loads the first frame.
+///
+/// The input caches the index of frames and the last decoded keyframe, loading consecutive frames thus
+/// reads each keyframe only once.
+class SequenceInput : public IInput {
+private:
+    struct Cache;
+    AutoPtr<Cache> cache;
+
+public:
+    SequenceInput();
+
+    ~SequenceInput() override;
+
+    virtual Outcome load(const Path& path, Storage& storage, Statistics& stats) override;
+
+    /// \brief Returns the path addressing given frame of the file.
+    ///
+    /// The frame index is added to the file name, for example frame 12 of "out/run.ssq" is addressed by
+    /// "out/run#0012.ssq". The frame path can be used by \ref OutputFile::getDumpIdx.
+    static Path getFramePath(const Path& path, const Size frameIdx);
+
+    /// \brief Returns the path of the file and the frame index addressed by the path.
+    ///
+    /// If the path is not a frame path, it is returned unchanged together with frame index 0.
+    static Tuple<Path, Size> parseFramePath(const Path& path);
+
+    /// \brief Returns the run times of all frames stored in the file.
+    static Expected<Array<Float>> getFrameTimes(const Path& path);
+};
+
+NAMESPACE_SPH_END
@@ -74,6 +74,9 @@ public:
     View write(const Size value) {
         return this->serialize(value);
     }
+    View write(const GlobalSize value) {
+        return this->serialize(value);
+    }
     View write(const Float& value) {
         return this->serialize(value);
     }
@@ -180,6 +183,9 @@ public:
     void read(Size& value) {
         return this->deserialize(value);
     }
+    void read(GlobalSize& value) {
+        return this->deserialize(value);
+    }
     void read(Float& value) {
         return this->deserialize(value);
     }
@@ -1,5 +1,6 @@
 #include "io/FileManager.h"
 #include "catch.hpp"
+#include "io/FileSystem.h"
 //#include <cctype>
 
 using namespace Sph;
@@ -54,6 +55,12 @@ TEST_CASE("RandomPathManager", "[filemanager]") {
     for (Size i = 0; i < 5; ++i) {
         REQUIRE(manager.getPath() != manager.getPath());
     }
+
+    const Path tmpDir = FileSystem::getTemporaryDirectory().value();
+    RandomPathManager tmpManager(tmpDir);
+    path = tmpManager.getPath("ssf");
+    REQUIRE(path.parentPath() == tmpDir);
+    REQUIRE(path.fileName().removeExtension().string().size() == 8);
 }
 
 TEST_CASE("Unique name manager", "[filemanager]") {
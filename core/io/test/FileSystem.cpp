@@ -272,3 +272,10 @@ TEST_CASE("GetHomeDirectory", "[filesystem]") {
     REQUIRE(path);
     REQUIRE(path.value() == HOME_DIR);
 }
+
+TEST_CASE("GetTemporaryDirectory", "[filesystem]") {
+    Expected<Path> path = FileSystem::getTemporaryDirectory();
+    REQUIRE(path);
+    REQUIRE(FileSystem::pathType(path.value()).value() == FileSystem::PathType::DIRECTORY);
+    REQUIRE(FileSystem::isDirectoryWritable(path.value()));
+}
@@ -178,6 +178,36 @@ TEST_CASE("BinaryOutput dump&accumulate simple", "[output]") {
             SymmetricTensor(6._f));
 }
 
+TEST_CASE("BinaryOutput persistent indices", "[output]") {
+    const GlobalSize large = GlobalSize(std::numeric_limits<Size>::max()) + 10;
+    Storage storage1;
+    storage1.insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, makeArray(Vector(0._f), Vector(1._f)));
+    storage1.insert<GlobalSize>(QuantityId::PERSISTENT_INDEX, OrderEnum::ZERO, Array<GlobalSize>{ 3, large });
+
+    RandomPathManager manager;
+    Path path = manager.getPath("out");
+    BinaryOutput output(path);
+    Statistics stats;
+    stats.set(StatisticsId::RUN_TIME, 0._f);
+    stats.set(StatisticsId::TIMESTEP_VALUE, 0._f);
+    output.dump(storage1, stats);
+
+    Storage storage2;
+    BinaryInput input;
+    REQUIRE(input.load(path, storage2, stats));
+    REQUIRE(storage2.getValue<GlobalSize>(QuantityId::PERSISTENT_INDEX) == Array<GlobalSize>({ 3, large }));
+
+    // files written by older versions store the indices as Size
+    Storage legacy;
+    legacy.insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, makeArray(Vector(0._f), Vector(1._f)));
+    legacy.insert<Size>(QuantityId::PERSISTENT_INDEX, OrderEnum::ZERO, Array<Size>{ 3, 4 });
+    path = manager.getPath("out");
+    BinaryOutput legacyOutput(path);
+    legacyOutput.dump(legacy, stats);
+    REQUIRE(input.load(path, storage2, stats));
+    REQUIRE(storage2.getValue<GlobalSize>(QuantityId::PERSISTENT_INDEX) == Array<GlobalSize>({ 3, 4 }));
+}
+
 TEST_CASE("BinaryOutput dump&accumulate materials", "[output]") {
     Storage storage;
     RunSettings settings;
@@ -432,6 +462,136 @@ TEST_CASE("BinaryOutput backward compatibility", "[output]") {
     testVersion(BinaryIoVersion::V2021_08_08);
 }
 
+TEST_CASE("BinaryInput selection", "[output]") {
+    Storage storage = Tests::getSolidStorage(1000);
+    BodySettings body;
+    body.set(BodySettingsId::DENSITY, 500._f);
+    storage.merge(Tests::getSolidStorage(500, body));
+    const Size particleCnt = storage.getParticleCnt();
+    const Size secondFrom = *storage.getMaterial(1).sequence().begin();
+
+    RandomPathManager manager;
+    Path path = manager.getPath("ssf");
+    BinaryOutput output(path);
+    Statistics stats;
+    REQUIRE(output.dump(storage, stats));
+
+    SECTION("quantities") {
+        BinaryInput input({ QuantityId::POSITION, QuantityId::MASS, QuantityId::TEMPERATURE });
+        Storage loaded;
+        REQUIRE(input.load(path, loaded, stats));
+        REQUIRE(loaded.getParticleCnt() == particleCnt);
+        REQUIRE(loaded.getMaterialCnt() == 2);
+        // positions, masses and material IDs; temperature is not in the file
+        REQUIRE(loaded.getQuantityCnt() == 3);
+        REQUIRE(loaded.getValue<Vector>(QuantityId::POSITION) == storage.getValue<Vector>(QuantityId::POSITION));
+        REQUIRE(loaded.getDt<Vector>(QuantityId::POSITION) == storage.getDt<Vector>(QuantityId::POSITION));
+        REQUIRE(loaded.getValue<Float>(QuantityId::MASS) == storage.getValue<Float>(QuantityId::MASS));
+        REQUIRE(loaded.getMaterial(1)->getParam<Float>(BodySettingsId::DENSITY) == 500._f);
+    }
+    SECTION("materials") {
+        BinaryInput::Selection selection{ QuantityId::DENSITY };
+        selection.materials = { 1 };
+        BinaryInput input(std::move(selection));
+        Storage loaded;
+        REQUIRE(input.load(path, loaded, stats));
+        REQUIRE(loaded.getParticleCnt() == particleCnt - secondFrom);
+        REQUIRE(loaded.getMaterialCnt() == 1);
+        REQUIRE(loaded.getMaterial(0)->getParam<Float>(BodySettingsId::DENSITY) == 500._f);
+        REQUIRE(perElement(loaded.getValue<Float>(QuantityId::DENSITY)) == 500._f);
+    }
+    SECTION("range") {
+        BinaryInput::Selection selection;
+        selection.range = IndexSequence(secondFrom - 100, secondFrom + 50);
+        BinaryInput input(std::move(selection));
+        Storage loaded;
+        REQUIRE(input.load(path, loaded, stats));
+        REQUIRE(loaded.getParticleCnt() == 150);
+        REQUIRE(loaded.getMaterialCnt() == 2);
+        REQUIRE(loaded.getQuantityCnt() == storage.getQuantityCnt());
+        REQUIRE(loaded.getMaterial(0).sequence() == IndexSequence(0, 100));
+        iterate<VisitorEnum::ALL_VALUES>(loaded, [&](const QuantityId id, const auto& values) {
+            using TValue = typename std::decay_t<decltype(values)>::Type;
+            ArrayView<const TValue> expected = storage.getValue<TValue>(id);
+            for (Size i = 0; i < values.size(); ++i) {
+                REQUIRE(values[i] == expected[secondFrom - 100 + i]);
+            }
+        });
+        ArrayView<const Vector> v = storage.getDt<Vector>(QuantityId::POSITION);
+        REQUIRE(loaded.getDt<Vector>(QuantityId::POSITION)[0] == v[secondFrom - 100]);
+    }
+    SECTION("factory") {
+        AutoPtr<IInput> input = Factory::getInput(path, { QuantityId::POSITION, QuantityId::MASS });
+        Storage loaded;
+        REQUIRE(input->load(path, loaded, stats));
+        REQUIRE(loaded.getParticleCnt() == particleCnt);
+        REQUIRE(loaded.getQuantityCnt() == 3);
+        REQUIRE(loaded.getValue<Float>(QuantityId::MASS) == storage.getValue<Float>(QuantityId::MASS));
+
+        // empty selection loads all quantities
+        input = Factory::getInput(path, {});
+        Storage all;
+        REQUIRE(input->load(path, all, stats));
+        REQUIRE(all.getQuantityCnt() == storage.getQuantityCnt());
+    }
+}
+
+static void testParallelBinaryOutput(const Flags<ParallelOutputFlag> flags, const Size blockSize) {
+    Storage storage = Tests::getSolidStorage(1000);
+    BodySettings body;
+    body.set(BodySettingsId::DENSITY, 500._f);
+    storage.merge(Tests::getSolidStorage(300, body));
+    storage.addAttractor(Attractor(Vector(1._f, 2._f, 3._f), Vector(0._f), 2._f, 5._f));
+    Statistics stats;
+    stats.set(StatisticsId::RUN_TIME, 15._f);
+    stats.set(StatisticsId::TIMESTEP_VALUE, 0.5_f);
+
+    RandomPathManager manager;
+    const Path expectedPath = manager.getPath("ssf");
+    BinaryOutput output(expectedPath);
+    REQUIRE(output.dump(storage, stats));
+
+    const Path path = manager.getPath("ssf");
+    ParallelBinaryOutput parallelOutput(path, makeShared<ThreadPool>(4), RunTypeEnum::SPH, flags, blockSize);
+    Expected<Path> result = parallelOutput.dump(storage, stats);
+    REQUIRE(result);
+    REQUIRE(result.value() == path);
+    REQUIRE_FALSE(FileSystem::pathExists(Path(path.string() + ".part")));
+
+    // byte-to-byte identical to the sequential output
+    std::ifstream expected(expectedPath.native(), std::ios::binary);
+    std::ifstream actual(path.native(), std::ios::binary);
+    const std::string expectedBytes{ std::istreambuf_iterator<char>(expected), {} };
+    const std::string actualBytes{ std::istreambuf_iterator<char>(actual), {} };
+    REQUIRE(actualBytes.size() > 10 * blockSize);
+    REQUIRE(actualBytes == expectedBytes);
+
+    Storage loaded;
+    BinaryInput input;
+    REQUIRE(input.load(path, loaded, stats));
+    REQUIRE(loaded.getParticleCnt() == storage.getParticleCnt());
+    REQUIRE(loaded.getMaterialCnt() == 2);
+    REQUIRE(loaded.getAttractorCnt() == 1);
+
+    if (flags.has(ParallelOutputFlag::MANIFEST)) {
+        REQUIRE(ParallelBinaryOutput::checkManifest(path));
+        // simulate a truncated file
+        std::ofstream ofs(path.native(), std::ios::binary);
+        ofs.write(actualBytes.data(), actualBytes.size() / 2);
+        ofs.close();
+        REQUIRE_FALSE(ParallelBinaryOutput::checkManifest(path));
+    } else {
+        REQUIRE_FALSE(ParallelBinaryOutput::checkManifest(path));
+    }
+}
+
+TEST_CASE("ParallelBinaryOutput", "[output]") {
+    // block size not divisible by sizes of values, so that values are split between blocks
+    testParallelBinaryOutput(ParallelOutputFlag::MANIFEST, 1000);
+    testParallelBinaryOutput(EMPTY_FLAGS, 1000);
+    testParallelBinaryOutput(ParallelOutputFlag::DIRECT_IO | ParallelOutputFlag::MANIFEST, 4096);
+}
+
 static void testCompression(CompressionEnum compression) {
     Storage storage = Tests::getSolidStorage(1200);
     Statistics stats;
@@ -0,0 +1,258 @@
+#include "io/Sequence.h"
+#include "catch.hpp"
+#include "io/FileManager.h"
+#include "io/FileSystem.h"
+#include "objects/utility/Algorithm.h"
+#include "quantities/Attractor.h"
+#include "quantities/IMaterial.h"
+#include "quantities/Quantity.h"
+#include "tests/Approx.h"
+#include "tests/Setup.h"
+#include "utils/Utils.h"
+#include <fstream>
+
+using namespace Sph;
+
+static Storage getSequenceStorage(const Size particleCnt) {
+    Storage storage1 = Tests::getSolidStorage(particleCnt, BodySettings::getDefaults(), 2._f);
+    Storage storage2 = Tests::getSolidStorage(particleCnt / 4, BodySettings::getDefaults(), 1._f);
+    ArrayView<Vector> r = storage2.getValue<Vector>(QuantityId::POSITION);
+    for (Size i = 0; i < r.size(); ++i) {
+        r[i] += Vector(5._f, 0._f, 0._f);
+    }
+    storage1.merge(std::move(storage2));
+    storage1.addAttractor(Attractor(Vector(1._f, 2._f, 3._f), Vector(-1._f, 0._f, 0._f), 0.5_f, 2._f));
+    return storage1;
+}
+
+/// Moves the particles, so that the frames differ
+static void advance(Storage& storage, const Float dt) {
+    ArrayView<Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    for (Size i = 0; i < r.size(); ++i) {
+        v[i] = Vector(std::sin(Float(i)), std::cos(Float(i)), 0.1_f * i / r.size());
+        r[i] += v[i] * dt;
+    }
+    ArrayView<Float> u = storage.getValue<Float>(QuantityId::ENERGY);
+    for (Float& value : u) {
+        value += dt;
+    }
+}
+
+static void checkFrame(const Storage& expected, const Storage& loaded, const Float tolerance) {
+    REQUIRE(loaded.getParticleCnt() == expected.getParticleCnt());
+    REQUIRE(loaded.getMaterialCnt() == expected.getMaterialCnt());
+    for (OrderEnum order : { OrderEnum::ZERO, OrderEnum::FIRST }) {
+        ArrayView<const Vector> values1 = expected.getAll<Vector>(QuantityId::POSITION)[int(order)];
+        ArrayView<const Vector> values2 = loaded.getAll<Vector>(QuantityId::POSITION)[int(order)];
+        REQUIRE(almostEqual(values1, values2, tolerance));
+    }
+    REQUIRE(expected.getValue<Float>(QuantityId::MASS) == loaded.getValue<Float>(QuantityId::MASS));
+    REQUIRE(expected.getValue<Size>(QuantityId::FLAG) == loaded.getValue<Size>(QuantityId::FLAG));
+    for (QuantityId id : { QuantityId::DENSITY, QuantityId::ENERGY }) {
+        ArrayView<const Float> values1 = expected.getValue<Float>(id);
+        ArrayView<const Float> values2 = loaded.getValue<Float>(id);
+        REQUIRE(almostEqual(values1, values2, 1.e-6_f));
+    }
+    REQUIRE(loaded.getAttractorCnt() == 1);
+    REQUIRE(loaded.getAttractors()[0].position == expected.getAttractors()[0].position);
+    REQUIRE(loaded.getAttractors()[0].mass == expected.getAttractors()[0].mass);
+}
+
+TEST_CASE("SequenceOutput dump&load", "[output]") {
+    RandomPathManager manager;
+    const Path path = manager.getPath("ssq");
+    SequenceOutput output(OutputFile(path), 4);
+
+    Storage storage = getSequenceStorage(1000);
+    Array<Storage> frames;
+    Statistics stats;
+    for (Size i = 0; i < 10; ++i) {
+        stats.set(StatisticsId::RUN_TIME, Float(i));
+        Expected<Path> framePath = output.dump(storage, stats);
+        REQUIRE(framePath);
+        REQUIRE(framePath.value() == SequenceInput::getFramePath(path, i));
+        REQUIRE(OutputFile::getDumpIdx(framePath.value()) == i);
+        frames.push(storage.clone(VisitorEnum::ALL_BUFFERS));
+        advance(storage, 0.1_f);
+    }
+
+    Expected<Array<Float>> times = SequenceInput::getFrameTimes(path);
+    REQUIRE(times);
+    REQUIRE(times->size() == 10);
+    REQUIRE(times.value()[7] == 7._f);
+
+    // keyframes are stored in single precision, other frames are quantized relative to the keyframes
+    SequenceInput input;
+    Storage loaded;
+    for (Size i : { 9, 0, 5, 6, 3, 2, 8 }) {
+        REQUIRE(input.load(SequenceInput::getFramePath(path, i), loaded, stats));
+        REQUIRE(stats.get<Float>(StatisticsId::RUN_TIME) == Float(i));
+        checkFrame(frames[i], loaded, 1.e-4_f);
+    }
+
+    // the path of the file itself loads the first frame
+    REQUIRE(input.load(path, loaded, stats));
+    REQUIRE(stats.get<Float>(StatisticsId::RUN_TIME) == 0._f);
+
+    REQUIRE_FALSE(input.load(SequenceInput::getFramePath(path, 10), loaded, stats));
+}
+
+TEST_CASE("SequenceOutput particle count change", "[output]") {
+    RandomPathManager manager;
+    const Path path = manager.getPath("ssq");
+    SequenceOutput output(OutputFile(path), 100);
+
+    Statistics stats;
+    Storage storage = getSequenceStorage(1000);
+    REQUIRE(output.dump(storage, stats));
+    advance(storage, 0.1_f);
+    REQUIRE(output.dump(storage, stats));
+
+    // removing particles forces a keyframe and new constant quantities
+    Array<Size> toRemove{ 0, 1, 2, 100 };
+    storage.remove(toRemove);
+    Storage removed = storage.clone(VisitorEnum::ALL_BUFFERS);
+    REQUIRE(output.dump(storage, stats));
+    advance(storage, 0.1_f);
+    REQUIRE(output.dump(storage, stats));
+
+    SequenceInput input;
+    Storage loaded;
+    REQUIRE(input.load(SequenceInput::getFramePath(path, 2), loaded, stats));
+    checkFrame(removed, loaded, 1.e-4_f);
+    REQUIRE(input.load(SequenceInput::getFramePath(path, 3), loaded, stats));
+    checkFrame(storage, loaded, 1.e-4_f);
+}
+
+TEST_CASE("SequenceOutput block quantization", "[output]") {
+    RandomPathManager manager;
+    const Path path = manager.getPath("ssq");
+    SequenceOutput output(OutputFile(path), 100);
+
+    Statistics stats;
+    Storage storage = getSequenceStorage(1000);
+    REQUIRE(output.dump(storage, stats));
+    ArrayView<Vector> r = storage.getValue<Vector>(QuantityId::POSITION);
+    for (Size i = 0; i < r.size(); ++i) {
+        r[i] += Vector(0.01_f, 0._f, 0._f);
+    }
+    // single fast particle must not reduce the precision of other blocks
+    r[0] += Vector(1.e6_f, 0._f, 0._f);
+    REQUIRE(output.dump(storage, stats));
+
+    SequenceInput input;
+    Storage loaded;
+    REQUIRE(input.load(SequenceInput::getFramePath(path, 1), loaded, stats));
+    ArrayView<const Vector> r1 = loaded.getValue<Vector>(QuantityId::POSITION);
+    REQUIRE(r1[0][X] == approx(r[0][X], 1.e-4_f));
+    for (Size i = 256; i < r.size(); ++i) {
+        REQUIRE(getLength(r1[i] - r[i]) < 1.e-5_f);
+    }
+}
+
+TEST_CASE("SequenceOutput material params", "[output]") {
+    RandomPathManager manager;
+    const Path path = manager.getPath("ssq");
+    SequenceOutput output(OutputFile(path), 4);
+
+    BodySettings body;
+    body.set(BodySettingsId::DENSITY, 1234._f)
+        .set(BodySettingsId::RHEOLOGY_YIELDING, YieldingEnum::DRUCKER_PRAGER);
+    Storage storage = Tests::getSolidStorage(100, body);
+    Statistics stats;
+    REQUIRE(output.dump(storage, stats));
+    advance(storage, 0.1_f);
+    REQUIRE(output.dump(storage, stats));
+
+    SequenceInput input;
+    Storage loaded;
+    REQUIRE(input.load(SequenceInput::getFramePath(path, 1), loaded, stats));
+    REQUIRE(loaded.getMaterialCnt() == 1);
+    MaterialView material = loaded.getMaterial(0);
+    REQUIRE(material->getParam<Float>(BodySettingsId::DENSITY) == 1234._f);
+    REQUIRE(material->getParam<YieldingEnum>(BodySettingsId::RHEOLOGY_YIELDING) ==
+            YieldingEnum::DRUCKER_PRAGER);
+}
+
+TEST_CASE("SequenceOutput resume", "[output]") {
+    RandomPathManager manager;
+    const Path path = manager.getPath("ssq");
+    Storage storage = getSequenceStorage(100);
+    Statistics stats;
+    {
+        SequenceOutput output(OutputFile(path), 4);
+        for (Size i = 0; i < 6; ++i) {
+            stats.set(StatisticsId::RUN_TIME, Float(i));
+            REQUIRE(output.dump(storage, stats));
+            advance(storage, 0.1_f);
+        }
+    }
+
+    // resumed from frame 3, the following frames are replaced
+    SequenceOutput output(OutputFile(path, 3), 4);
+    for (Size i = 0; i < 2; ++i) {
+        stats.set(StatisticsId::RUN_TIME, Float(10 + i));
+        Expected<Path> framePath = output.dump(storage, stats);
+        REQUIRE(framePath);
+        REQUIRE(framePath.value() == SequenceInput::getFramePath(path, 3 + i));
+        advance(storage, 0.1_f);
+    }
+
+    Expected<Array<Float>> times = SequenceInput::getFrameTimes(path);
+    REQUIRE(times);
+    REQUIRE(times.value() == Array<Float>({ 0._f, 1._f, 2._f, 10._f, 11._f }));
+
+    SequenceInput input;
+    Storage loaded;
+    REQUIRE(input.load(SequenceInput::getFramePath(path, 2), loaded, stats));
+    REQUIRE(stats.get<Float>(StatisticsId::RUN_TIME) == 2._f);
+    REQUIRE(input.load(SequenceInput::getFramePath(path, 4), loaded, stats));
+    REQUIRE(stats.get<Float>(StatisticsId::RUN_TIME) == 11._f);
+}
+
+TEST_CASE("SequenceInput truncated file", "[output]") {
+    RandomPathManager manager;
+    const Path path = manager.getPath("ssq");
+    SequenceOutput output(path);
+    Statistics stats;
+    Storage storage = getSequenceStorage(100);
+    for (Size i = 0; i < 3; ++i) {
+        REQUIRE(output.dump(storage, stats));
+    }
+
+    // simulate a run interrupted while writing the last frame
+    const Size size = FileSystem::fileSize(path);
+    Array<char> data(size);
+    {
+        std::ifstream ifs(path.native(), std::ios::binary);
+        ifs.read(&data[0], size);
+    }
+    {
+        std::ofstream ofs(path.native(), std::ios::binary | std::ios::trunc);
+        ofs.write(&data[0], size - 10);
+    }
+    Expected<Array<Float>> times = SequenceInput::getFrameTimes(path);
+    REQUIRE(times);
+    REQUIRE(times->size() == 2);
+
+    SequenceInput input;
+    Storage loaded;
+    REQUIRE(input.load(SequenceInput::getFramePath(path, 1), loaded, stats));
+    REQUIRE_FALSE(input.load(SequenceInput::getFramePath(path, 2), loaded, stats));
+}
+
+TEST_CASE("SequenceInput frame paths", "[output]") {
+    const Path path("dir/run.ssq");
+    REQUIRE(SequenceInput::getFramePath(path, 12) == Path("dir/run#0012.ssq"));
+    REQUIRE(SequenceInput::getFramePath(Path("dir/run#0005.ssq"), 7) == Path("dir/run#0007.ssq"));
+
+    Path file;
+    Size frameIdx;
+    tieToTuple(file, frameIdx) = SequenceInput::parseFramePath(Path("dir/run#0012.ssq"));
+    REQUIRE(file == path);
+    REQUIRE(frameIdx == 12);
+    tieToTuple(file, frameIdx) = SequenceInput::parseFramePath(path);
+    REQUIRE(file == path);
+    REQUIRE(frameIdx == 0);
+}
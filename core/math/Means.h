@@ -15,7 +15,7 @@ template <int Power>
 class GeneralizedMean {
 private:
     double sum = 0.; // using double to limit round-off errors in summing
-    Size weight = 0;
+    GlobalSize weight = 0;
 
 public:
     GeneralizedMean() = default;
@@ -35,7 +35,7 @@ public:
         return Float(pow(sum / weight, 1. / Power));
     }
 
-    INLINE Size count() const {
+    INLINE GlobalSize count() const {
         return weight;
     }
 
@@ -50,7 +50,7 @@ template <>
 class GeneralizedMean<0> {
 private:
     double sum = 1.;
-    Size weight = 0;
+    GlobalSize weight = 0;
 
 public:
     GeneralizedMean() = default;
@@ -69,7 +69,7 @@ public:
         return Float(pow(sum, 1. / weight));
     }
 
-    INLINE Size count() const {
+    INLINE GlobalSize count() const {
         return weight;
     }
 
@@ -92,7 +92,7 @@ using GeometricMean = GeneralizedMean<0>;
 class PositiveMean {
 protected:
     double sum = 0.;
-    Size weight = 0;
+    GlobalSize weight = 0;
     Float power;
 
 public:
@@ -121,7 +121,7 @@ public:
         return Float(powFastest(Float(sum / weight), 1._f / power));
     }
 
-    INLINE Size count() const {
+    INLINE GlobalSize count() const {
         return weight;
     }
 
@@ -204,7 +204,7 @@ public:
         return minMax;
     }
 
-    INLINE Size count() const {
+    INLINE GlobalSize count() const {
         return avg.count();
     }
 
@@ -37,6 +37,36 @@ public:
 };
 
 
+/// \brief Counter-based random number generator.
+///
+/// The generated numbers are obtained by hashing the seed, the index of the stream and the counter of
+/// generated numbers, so the generator has no state shared between streams. Assigning a stream to each
+/// particle allows to generate random numbers in parallel, with results independent of the number of
+/// threads and of the order in which the particles are processed.
+class CounterRng {
+private:
+    uint64_t key;
+    uint64_t counter = 0;
+
+public:
+    CounterRng(const int seed, const uint64_t stream)
+        : key(mix(mix(uint64_t(seed)) ^ (stream + 0x632be59bd9b4e019ull))) {}
+
+    Float operator()(const int UNUSED(s) = 0) {
+        const uint64_t bits = mix(key + (++counter) * 0x9e3779b97f4a7c15ull);
+        // use 53 bits of the hash, giving uniformly distributed doubles in [0, 1)
+        return Float(bits >> 11) * (1._f / Float(1ull << 53));
+    }
+
+private:
+    /// Finalizer of SplitMix64
+    INLINE static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+};
+
 /// \brief Random number generator used in code SPH5 of Benz & Asphaug (1994).
 ///
 /// Reimplemented for reproducibility of results.
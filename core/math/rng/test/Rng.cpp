@@ -47,6 +47,21 @@ TEST_CASE("HaltonQrng", "[rng]") {
     testRng(HaltonQrng());
 }
 
+TEST_CASE("CounterRng", "[rng]") {
+    testRng(CounterRng(1234, 0));
+
+    CounterRng rng1(1234, 5);
+    CounterRng rng2(1234, 5);
+    CounterRng rng3(1234, 6);
+    CounterRng rng4(4321, 5);
+    for (Size i = 0; i < 100; ++i) {
+        const Float value = rng1();
+        REQUIRE(value == rng2());
+        REQUIRE(value != rng3());
+        REQUIRE(value != rng4());
+    }
+}
+
 TEST_CASE("BenzAsphaugRng", "[rng]") {
     testRng(BenzAsphaugRng(1234));
     // first few numbers with seed 1234
@@ -0,0 +1,19 @@
+#include "objects/containers/BasicAllocators.h"
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+NAMESPACE_SPH_BEGIN
+
+void* Mallocator::allocateHugePages(const std::size_t size, const std::size_t align) noexcept {
+    void* ptr = _mm_malloc(size, align > HUGE_PAGE_SIZE ? align : std::size_t(HUGE_PAGE_SIZE));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (ptr) {
+        // only a hint, the allocation is valid even if the kernel does not support huge pages
+        madvise(ptr, size, MADV_HUGEPAGE);
+    }
+#endif
+    return ptr;
+}
+
+NAMESPACE_SPH_END
@@ -70,11 +70,26 @@ INLINE bool isAligned(const T* value, const std::size_t align) noexcept {
 }
 
 /// \brief Default allocator, simply wrapping _mm_malloc and _mm_free calls.
+///
+/// On Linux, blocks larger than the size of a huge page are aligned to the huge page and marked for the
+/// transparent huge pages, reducing the TLB misses when iterating over large particle buffers. The memory is
+/// not touched by the allocator, so the pages are physically placed on the NUMA node of the thread that
+/// first writes into them.
 class Mallocator {
 public:
+    static constexpr std::size_t HUGE_PAGE_SIZE = 2 << 20;
+
     INLINE MemoryBlock allocate(const std::size_t size, const std::size_t align) noexcept {
         MemoryBlock block;
+#ifdef __linux__
+        if (SPH_UNLIKELY(size >= HUGE_PAGE_SIZE)) {
+            block.ptr = allocateHugePages(size, align);
+        } else {
+            block.ptr = _mm_malloc(size, align);
+        }
+#else
         block.ptr = _mm_malloc(size, align);
+#endif
         if (block.ptr) {
             block.size = size;
         } else {
@@ -87,6 +102,12 @@ public:
         _mm_free(block.ptr);
         block.ptr = nullptr;
     }
+
+private:
+    /// \brief Allocates a block aligned to the huge page, advising the kernel to use transparent huge pages.
+    ///
+    /// Memory is released by _mm_free like any other block.
+    static void* allocateHugePages(const std::size_t size, const std::size_t align) noexcept;
 };
 
 /// \brief Allocator used pre-allocated fixed-size buffer on stack.
@@ -51,6 +51,11 @@ INLINE bool isReal(const Size& UNUSED(value)) {
     return true;
 }
 
+template <>
+INLINE bool isReal(const GlobalSize& UNUSED(value)) {
+    return true;
+}
+
 /// \brief Compares two objects of the same time component-wise.
 ///
 /// Returns object containing components 0 or 1, depending whether components of the first objects are smaller
@@ -10,6 +10,9 @@ struct ScalarFunctor {
     Float operator()(const Size value) {
         return Float(value);
     }
+    Float operator()(const GlobalSize value) {
+        return Float(value);
+    }
     Float operator()(const Vector& value) {
         return getLength(value);
     }
@@ -25,6 +25,7 @@ enum class DynamicId {
     TRACELESS_TENSOR,
     MIN_MAX_MEAN,
     STRING,
+    GLOBAL_SIZE,
 };
 
 /// \brief Convenient object for storing a single value of different types
@@ -44,7 +45,8 @@ private:
         SymmetricTensor,
         TracelessTensor,
         MinMaxMean,
-        String>;
+        String,
+        GlobalSize>;
 
     DynamicVariant storage;
 
@@ -46,6 +46,10 @@ TEST_CASE("Dynamic get", "[dynamic]") {
     REQUIRE(value2.getType() == DynamicId::VECTOR);
     REQUIRE(value2.get<Vector>() == Vector(2.f, 1.f, 0.f));
     static_assert(std::is_same<decltype(value2.get<Vector>()), const Vector&>::value, "static test failed");
+
+    const Dynamic value3 = GlobalSize(1) << 40;
+    REQUIRE(value3.getType() == DynamicId::GLOBAL_SIZE);
+    REQUIRE(value3.get<GlobalSize>() == GlobalSize(1) << 40);
 }
 
 TEST_CASE("Dynamic getScalar", "[dynamic]") {
@@ -139,10 +139,10 @@ void ScalarGradyKippModel::integrate(IScheduler& scheduler, Storage& storage, co
     ArrayView<Float> damage, ddamage;
     tie(damage, ddamage) = storage.getAll<Float>(QuantityId::DAMAGE);
 
+    const Interval range = material->range(QuantityId::DAMAGE);
+    const Float young = material->getParam<Float>(BodySettingsId::YOUNG_MODULUS);
     IndexSequence seq = material.sequence();
     parallelFor(scheduler, *seq.begin(), *seq.end(), [&](const Size i) {
-        const Interval range = material->range(QuantityId::DAMAGE);
-
         if (damage[i] >= range.upper()) {
             // We CANNOT set derivative of damage to zero, it would break predictor-corrector integrator!
             // Instead, we set damage derivative to large value, so that it is larger than the derivative from
@@ -155,7 +155,6 @@ void ScalarGradyKippModel::integrate(IScheduler& scheduler, Storage& storage, co
         Float sig1, sig2, sig3;
         tie(sig1, sig2, sig3) = findEigenvalues(sigma);
         const Float sigMax = max(sig1, sig2, sig3);
-        const Float young = material->getParam<Float>(BodySettingsId::YOUNG_MODULUS);
         // we need to assume reduces Young modulus here, hence 1-D factor
         const Float young_red = max((1._f - pow<3>(damage[i])) * young, 1.e-20_f);
         const Float strain = sigMax / young_red;
@@ -5,6 +5,16 @@
 
 NAMESPACE_SPH_BEGIN
 
+void IEos::evaluateRange(ArrayView<const Float> rho,
+    ArrayView<const Float> u,
+    ArrayView<Float> p,
+    ArrayView<Float> cs,
+    const IndexSequence sequence) const {
+    for (Size i : sequence) {
+        tie(p[i], cs[i]) = this->evaluate(rho[i], u[i]);
+    }
+}
+
 //-----------------------------------------------------------------------------------------------------------
 // IdealGasEos implementation
 //-----------------------------------------------------------------------------------------------------------
@@ -17,6 +27,17 @@ Pair<Float> IdealGasEos::evaluate(const Float rho, const Float u) const {
     return { p, sqrt(gamma * p / rho) };
 }
 
+void IdealGasEos::evaluateRange(ArrayView<const Float> rho,
+    ArrayView<const Float> u,
+    ArrayView<Float> p,
+    ArrayView<Float> cs,
+    const IndexSequence sequence) const {
+    for (Size i : sequence) {
+        // qualified call is not virtual and can be inlined
+        tie(p[i], cs[i]) = IdealGasEos::evaluate(rho[i], u[i]);
+    }
+}
+
 Float IdealGasEos::getTemperature(const Float UNUSED(rho), const Float u) const {
     return u / Constants::gasConstant;
 }
@@ -138,6 +159,16 @@ Pair<Float> TillotsonEos::evaluate(const Float rho, const Float u) const {
     return { p, sqrt(cs) };
 }
 
+void TillotsonEos::evaluateRange(ArrayView<const Float> rho,
+    ArrayView<const Float> u,
+    ArrayView<Float> p,
+    ArrayView<Float> cs,
+    const IndexSequence sequence) const {
+    for (Size i : sequence) {
+        tie(p[i], cs[i]) = TillotsonEos::evaluate(rho[i], u[i]);
+    }
+}
+
 Float TillotsonEos::getInternalEnergy(const Float rho, const Float p) const {
     // try compressed phase first
     const Float eta = rho / rho0;
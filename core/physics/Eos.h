@@ -9,6 +9,7 @@
 #include "common/Globals.h"
 #include "objects/containers/Array.h"
 #include "objects/containers/StaticArray.h"
+#include "objects/utility/IteratorAdapters.h"
 
 NAMESPACE_SPH_BEGIN
 
@@ -18,6 +19,16 @@ public:
     /// Computes pressure and local sound speed from given density rho and specific internal energy u.
     virtual Pair<Float> evaluate(const Float rho, const Float u) const = 0;
 
+    /// \brief Computes pressure and local sound speed of particles in given sequence.
+    ///
+    /// Equivalent to calling \ref evaluate for each particle. Equations of state can override the function
+    /// to avoid the virtual call per particle.
+    virtual void evaluateRange(ArrayView<const Float> rho,
+        ArrayView<const Float> u,
+        ArrayView<Float> p,
+        ArrayView<Float> cs,
+        const IndexSequence sequence) const;
+
     /// Computes the temperature from given density rho and specific internal energy u.
     virtual Float getTemperature(const Float rho, const Float u) const = 0;
 
@@ -39,6 +50,12 @@ public:
 
     virtual Pair<Float> evaluate(const Float rho, const Float u) const override;
 
+    virtual void evaluateRange(ArrayView<const Float> rho,
+        ArrayView<const Float> u,
+        ArrayView<Float> p,
+        ArrayView<Float> cs,
+        const IndexSequence sequence) const override;
+
     virtual Float getTemperature(const Float rho, const Float u) const override;
 
     virtual Float getInternalEnergy(const Float rho, const Float p) const override;
@@ -135,6 +152,12 @@ public:
 
     virtual Pair<Float> evaluate(const Float rho, const Float u) const override;
 
+    virtual void evaluateRange(ArrayView<const Float> rho,
+        ArrayView<const Float> u,
+        ArrayView<Float> p,
+        ArrayView<Float> cs,
+        const IndexSequence sequence) const override;
+
     virtual Float getTemperature(const Float rho, const Float u) const override;
 
     virtual Float getInternalEnergy(const Float rho, const Float p) const override;
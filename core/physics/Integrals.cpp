@@ -1,7 +1,10 @@
 #include "physics/Integrals.h"
+#include "gravity/IGravity.h"
 #include "post/Analysis.h"
 #include "quantities/Storage.h"
 #include "system/Factory.h"
+#include "system/Statistics.h"
+#include "thread/Scheduler.h"
 
 NAMESPACE_SPH_BEGIN
 
@@ -149,6 +152,136 @@ Vector CenterOfMass::evaluate(const Storage& storage) const {
     return com / totalMass;
 }
 
+//-----------------------------------------------------------------------------------------------------------
+// IntegralsEvaluator implementation
+//-----------------------------------------------------------------------------------------------------------
+
+/// Number of particles summed sequentially; partial sums of the blocks are then added pairwise.
+const Size INTEGRALS_BLOCK_SIZE = 1024;
+
+namespace {
+
+/// Partial sums of a block of particles, computed in double precision.
+struct PartialIntegrals {
+    double mass = 0.;
+    BasicVector<double> momentum = BasicVector<double>(0.);
+    BasicVector<double> angularMomentum = BasicVector<double>(0.);
+    double kineticEnergy = 0.;
+    double internalEnergy = 0.;
+    BasicVector<double> massMoment = BasicVector<double>(0.);
+
+    PartialIntegrals& operator+=(const PartialIntegrals& other) {
+        mass += other.mass;
+        momentum += other.momentum;
+        angularMomentum += other.angularMomentum;
+        kineticEnergy += other.kineticEnergy;
+        internalEnergy += other.internalEnergy;
+        massMoment += other.massMoment;
+        return *this;
+    }
+};
+
+} // namespace
+
+IntegralsEvaluator::IntegralsEvaluator(const Flags<IntegralFlag> flags, const Float omega)
+    : flags(flags)
+    , omega(0._f, 0._f, omega) {}
+
+IntegralValues IntegralsEvaluator::evaluate(IScheduler& scheduler,
+    const Storage& storage,
+    Statistics& stats,
+    const IGravity* gravity) const {
+    ArrayView<const Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    ArrayView<const Float> m = storage.getValue<Float>(QuantityId::MASS);
+    ArrayView<const Float> u;
+    if (flags.has(IntegralFlag::INTERNAL_ENERGY) && storage.has(QuantityId::ENERGY)) {
+        u = storage.getValue<Float>(QuantityId::ENERGY);
+    }
+
+    const bool useMomentum = flags.has(IntegralFlag::MOMENTUM);
+    const bool useAngularMomentum = flags.has(IntegralFlag::ANGULAR_MOMENTUM);
+    const bool useKineticEnergy = flags.has(IntegralFlag::KINETIC_ENERGY);
+    const bool useCenterOfMass = flags.has(IntegralFlag::CENTER_OF_MASS);
+
+    // the blocks are fixed, so that the result is the same for any scheduler
+    const Size particleCnt = r.size();
+    const Size blockCnt = (particleCnt + INTEGRALS_BLOCK_SIZE - 1) / INTEGRALS_BLOCK_SIZE;
+    Array<PartialIntegrals> partials(max(blockCnt, Size(1)));
+    partials.fill(PartialIntegrals{});
+    parallelFor(scheduler, 0, blockCnt, 1, [&](const Size blockIdx) {
+        PartialIntegrals& partial = partials[blockIdx];
+        const Size n1 = blockIdx * INTEGRALS_BLOCK_SIZE;
+        const Size n2 = min(n1 + INTEGRALS_BLOCK_SIZE, particleCnt);
+        for (Size i = n1; i < n2; ++i) {
+            partial.mass += m[i];
+            if (useMomentum) {
+                partial.momentum += vectorCast<double>(m[i] * (v[i] + cross(omega, r[i])));
+            }
+            if (useAngularMomentum) {
+                partial.angularMomentum += vectorCast<double>(m[i] * cross(r[i], v[i] + cross(omega, r[i])));
+            }
+            if (useKineticEnergy) {
+                partial.kineticEnergy += 0.5 * m[i] * getSqrLength(v[i]);
+            }
+            if (!u.empty()) {
+                partial.internalEnergy += double(m[i] * u[i]);
+            }
+            if (useCenterOfMass) {
+                partial.massMoment += vectorCast<double>(m[i] * r[i]);
+            }
+        }
+    });
+
+    // pairwise summation of partial results
+    for (Size stride = 1; stride < partials.size(); stride *= 2) {
+        for (Size i = 0; i + stride < partials.size(); i += 2 * stride) {
+            partials[i] += partials[i + stride];
+        }
+    }
+    const PartialIntegrals& total = partials[0];
+
+    IntegralValues values;
+    if (flags.has(IntegralFlag::MASS)) {
+        values.mass = Float(total.mass);
+        stats.set(StatisticsId::TOTAL_MASS, values.mass);
+    }
+    if (useMomentum) {
+        values.momentum = vectorCast<Float>(total.momentum);
+        stats.set(StatisticsId::TOTAL_MOMENTUM, Dynamic(values.momentum));
+    }
+    if (useAngularMomentum) {
+        values.angularMomentum = vectorCast<Float>(total.angularMomentum);
+        stats.set(StatisticsId::TOTAL_ANGULAR_MOMENTUM, Dynamic(values.angularMomentum));
+    }
+    if (useKineticEnergy) {
+        values.kineticEnergy = Float(total.kineticEnergy);
+        stats.set(StatisticsId::KINETIC_ENERGY, values.kineticEnergy);
+    }
+    if (flags.has(IntegralFlag::INTERNAL_ENERGY)) {
+        values.internalEnergy = Float(total.internalEnergy);
+        stats.set(StatisticsId::INTERNAL_ENERGY, values.internalEnergy);
+    }
+    if (flags.has(IntegralFlag::POTENTIAL_ENERGY)) {
+        if (gravity != nullptr) {
+            values.potentialEnergy = gravity->evalEnergy(scheduler, stats);
+            stats.set(StatisticsId::POTENTIAL_ENERGY, values.potentialEnergy);
+        } else if (stats.has(StatisticsId::POTENTIAL_ENERGY)) {
+            values.potentialEnergy = stats.get<Float>(StatisticsId::POTENTIAL_ENERGY);
+        }
+    }
+    if (flags.hasAny(
+            IntegralFlag::KINETIC_ENERGY, IntegralFlag::INTERNAL_ENERGY, IntegralFlag::POTENTIAL_ENERGY)) {
+        stats.set(StatisticsId::TOTAL_ENERGY, values.totalEnergy());
+    }
+    if (useCenterOfMass && total.mass > 0.) {
+        values.centerOfMass = vectorCast<Float>(total.massMoment / total.mass);
+        stats.set(StatisticsId::CENTER_OF_MASS, Dynamic(values.centerOfMass));
+    }
+    SPH_ASSERT(isReal(values.totalEnergy()) && isReal(values.momentum) && isReal(values.angularMomentum));
+    return values;
+}
+
 QuantityMeans::QuantityMeans(const QuantityId id, const Optional<Size> bodyId)
     : quantity(id)
     , bodyId(bodyId) {}
@@ -9,12 +9,15 @@
 #include "math/Means.h"
 #include "objects/containers/Array.h"
 #include "objects/utility/Dynamic.h"
+#include "objects/wrappers/Flags.h"
 #include "objects/wrappers/Function.h"
 #include "quantities/QuantityIds.h"
 #include "system/Settings.h"
 
 NAMESPACE_SPH_BEGIN
 
+class IGravity;
+
 /// \brief Interface for classes computing integral quantities from storage
 ///
 /// This interface is used to get reduced information from all particles (and possibly all quantities) in the
@@ -161,6 +164,71 @@ public:
     }
 };
 
+/// \brief Integrals computed by \ref IntegralsEvaluator.
+enum class IntegralFlag {
+    MASS = 1 << 0,
+    MOMENTUM = 1 << 1,
+    ANGULAR_MOMENTUM = 1 << 2,
+    KINETIC_ENERGY = 1 << 3,
+    INTERNAL_ENERGY = 1 << 4,
+
+    /// Computed by a gravity object passed to \ref IntegralsEvaluator::evaluate, or taken from the statistics
+    /// if no gravity is passed
+    POTENTIAL_ENERGY = 1 << 5,
+
+    CENTER_OF_MASS = 1 << 6,
+};
+
+/// \brief Values of integrals computed by \ref IntegralsEvaluator.
+///
+/// Integrals that have not been requested are zero.
+struct IntegralValues {
+    Float mass = 0._f;
+    Vector momentum = Vector(0._f);
+    Vector angularMomentum = Vector(0._f);
+    Float kineticEnergy = 0._f;
+    Float internalEnergy = 0._f;
+    Float potentialEnergy = 0._f;
+    Vector centerOfMass = Vector(0._f);
+
+    /// \brief Returns the sum of kinetic, internal and potential energy.
+    Float totalEnergy() const {
+        return kineticEnergy + internalEnergy + potentialEnergy;
+    }
+};
+
+/// \brief Computes several integrals of motion in a single parallel pass over particles.
+///
+/// Gives the same values as \ref TotalMomentum, \ref TotalAngularMomentum, \ref TotalKineticEnergy, etc.,
+/// but all requested integrals are accumulated at once. Particles are split into blocks of fixed size, each
+/// block is summed in double precision and partial sums of blocks are then added pairwise. The round-off
+/// error thus grows only logarithmically with the number of particles and the result does not depend on the
+/// number of threads.
+class IntegralsEvaluator {
+private:
+    Flags<IntegralFlag> flags;
+
+    /// Angular frequency of the reference frame
+    Vector omega;
+
+public:
+    explicit IntegralsEvaluator(const Flags<IntegralFlag> flags, const Float omega = 0._f);
+
+    /// \brief Computes the integrals and saves them into the statistics.
+    ///
+    /// \param scheduler Scheduler used for parallelization.
+    /// \param storage Storage containing at least positions, velocities and masses of particles.
+    /// \param stats Statistics where the computed integrals are saved.
+    /// \param gravity Gravity used to compute the potential energy. The gravity must be already built for
+    ///                particles in the storage, the potential energy is then obtained from the tree without
+    ///                rebuilding it. If nullptr, the potential energy is taken from the statistics, provided
+    ///                the solver saved it there; otherwise it is not included.
+    IntegralValues evaluate(IScheduler& scheduler,
+        const Storage& storage,
+        Statistics& stats,
+        const IGravity* gravity = nullptr) const;
+};
+
 /// \brief Interface for auxilirary user-defined scalar quantities.
 ///
 /// The quantity values needs to be computed from other quantities already stored in Storage. The class is
@@ -8,6 +8,16 @@
 
 NAMESPACE_SPH_BEGIN
 
+void IRheology::initialize(IScheduler& scheduler, Storage& storage, const MaterialView material) {
+    VERBOSE_LOG
+
+    const IndexSequence seq = material.sequence();
+    const Size granularity = scheduler.getRecommendedGranularity();
+    scheduler.parallelFor(*seq.begin(), *seq.end(), granularity, [&](const Size n1, const Size n2) {
+        this->initializeBlock(storage, material, IndexSequence(n1, n2));
+    });
+}
+
 // ----------------------------------------------------------------------------------------------------------
 // VonMisesRheology
 // ----------------------------------------------------------------------------------------------------------
@@ -33,9 +43,9 @@ void VonMisesRheology::create(Storage& storage,
     damage->setFlaws(storage, material, context);
 }
 
-void VonMisesRheology::initialize(IScheduler& scheduler, Storage& storage, const MaterialView material) {
-    VERBOSE_LOG
-
+void VonMisesRheology::initializeBlock(Storage& storage,
+    const MaterialView material,
+    const IndexSequence block) {
     ArrayView<Float> u = storage.getValue<Float>(QuantityId::ENERGY);
     ArrayView<Float> reducing = storage.getValue<Float>(QuantityId::STRESS_REDUCING);
     ArrayView<Float> p = storage.getValue<Float>(QuantityId::PRESSURE);
@@ -49,9 +59,8 @@ void VonMisesRheology::initialize(IScheduler& scheduler, Storage& storage, const
     SPH_ASSERT(limit > 0._f);
 
     const Float u_melt = material->getParam<Float>(BodySettingsId::MELT_ENERGY);
-    IndexSequence seq = material.sequence();
     constexpr Float eps = 1.e-15_f;
-    parallelFor(scheduler, *seq.begin(), *seq.end(), [&](const Size i) INL {
+    for (Size i : block) {
         // reduce the pressure (pressure is reduced only for negative values)
         const Float d = D ? pow<3>(D[i]) : 0._f;
         if (p[i] < 0._f) {
@@ -67,7 +76,7 @@ void VonMisesRheology::initialize(IScheduler& scheduler, Storage& storage, const
         if (Y < EPS) {
             reducing[i] = 0._f;
             S[i] = TracelessTensor::null();
-            return;
+            continue;
         }
         // compute second invariant using damaged stress tensor
         const Float J2 = 0.5_f * ddot(S[i], S[i]) + eps;
@@ -79,7 +88,7 @@ void VonMisesRheology::initialize(IScheduler& scheduler, Storage& storage, const
         // apply yield reduction in place
         S[i] = S[i] * red;
         SPH_ASSERT(isReal(S[i]));
-    });
+    }
 }
 
 void VonMisesRheology::integrate(IScheduler& scheduler, Storage& storage, const MaterialView material) {
@@ -116,9 +125,9 @@ void DruckerPragerRheology::create(Storage& storage,
     damage->setFlaws(storage, material, context);
 }
 
-void DruckerPragerRheology::initialize(IScheduler& scheduler, Storage& storage, const MaterialView material) {
-    VERBOSE_LOG
-
+void DruckerPragerRheology::initializeBlock(Storage& storage,
+    const MaterialView material,
+    const IndexSequence block) {
     ArrayView<const Float> u = storage.getValue<Float>(QuantityId::ENERGY);
     ArrayView<Float> p = storage.getValue<Float>(QuantityId::PRESSURE);
     ArrayView<TracelessTensor> S = storage.getValue<TracelessTensor>(QuantityId::DEVIATORIC_STRESS);
@@ -142,8 +151,7 @@ void DruckerPragerRheology::initialize(IScheduler& scheduler, Storage& storage,
             QuantityId::VIBRATIONAL_VELOCITY, QuantityId::DENSITY, QuantityId::SOUND_SPEED);
     }
 
-    const IndexSequence seq = material.sequence();
-    parallelFor(scheduler, *seq.begin(), *seq.end(), [&](const Size i) {
+    for (Size i : block) {
         // reduce the pressure (pressure is reduced only for negative values)
         const Float d = D ? pow<3>(D[i]) : 0._f;
         if (p[i] < 0._f) {
@@ -173,7 +181,7 @@ void DruckerPragerRheology::initialize(IScheduler& scheduler, Storage& storage,
         if (Y < EPS) {
             reducing[i] = 0._f;
             S[i] = TracelessTensor::null();
-            return;
+            continue;
         }
 
         const Float J2 = 0.5_f * ddot(S[i], S[i]) + EPS;
@@ -184,7 +192,7 @@ void DruckerPragerRheology::initialize(IScheduler& scheduler, Storage& storage,
         // apply yield reduction in place
         S[i] = S[i] * red;
         SPH_ASSERT(isReal(S[i]));
-    });
+    }
 }
 
 void DruckerPragerRheology::integrate(IScheduler& scheduler, Storage& storage, const MaterialView material) {
@@ -202,12 +210,12 @@ void DruckerPragerRheology::integrate(IScheduler& scheduler, Storage& storage, c
         const Float e = material->getParam<Float>(BodySettingsId::OSCILLATION_REGENERATION);
         const Float rho = material->getParam<Float>(BodySettingsId::DENSITY);
 
-        for (Size i : material.sequence()) {
+        parallelFor(scheduler, material.sequence(), [&](const Size i) INL {
             const SymmetricTensor sigma = p[i] * SymmetricTensor::identity() - SymmetricTensor(S[i]);
             const Float dE = e * max(ddot(sigma, eps[i]), 0._f);
             // energy to velocity
             dv[i] = sqrt(2._f * dE / rho) - v[i] / t_dec;
-        }
+        });
     }
 
     damage->integrate(scheduler, storage, material);
@@ -224,9 +232,9 @@ void ElasticRheology::create(Storage& storage,
     storage.insert<Float>(QuantityId::STRESS_REDUCING, OrderEnum::ZERO, 1._f);
 }
 
-void ElasticRheology::initialize(IScheduler& UNUSED(scheduler),
-    Storage& UNUSED(storage),
-    const MaterialView UNUSED(material)) {}
+void ElasticRheology::initializeBlock(Storage& UNUSED(storage),
+    const MaterialView UNUSED(material),
+    const IndexSequence UNUSED(block)) {}
 
 void ElasticRheology::integrate(IScheduler& UNUSED(scheduler),
     Storage& UNUSED(storage),
@@ -240,10 +248,13 @@ void DustRheology::create(Storage& UNUSED(storage),
     IMaterial& UNUSED(material),
     const MaterialInitialContext& UNUSED(context)) const {}
 
-void DustRheology::initialize(IScheduler& scheduler, Storage& storage, const MaterialView material) {
-    const IndexSequence seq = material.sequence();
+void DustRheology::initializeBlock(Storage& storage,
+    const MaterialView UNUSED(material),
+    const IndexSequence block) {
     ArrayView<Float> p = storage.getValue<Float>(QuantityId::PRESSURE);
-    parallelFor(scheduler, *seq.begin(), *seq.end(), [&](const Size i) { p[i] = max(p[i], 0._f); });
+    for (Size i : block) {
+        p[i] = max(p[i], 0._f);
+    }
 }
 
 void DustRheology::integrate(IScheduler& UNUSED(scheduler),
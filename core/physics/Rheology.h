@@ -8,6 +8,7 @@
 #include "common/ForwardDecl.h"
 #include "objects/containers/Array.h"
 #include "objects/geometry/TracelessTensor.h"
+#include "objects/utility/IteratorAdapters.h"
 #include "objects/wrappers/AutoPtr.h"
 
 NAMESPACE_SPH_BEGIN
@@ -36,12 +37,24 @@ public:
 
     /// \brief Evaluates the stress tensor reduction factors.
     ///
-    /// Called for every material in the simulation every timestep, before iteration over particle pairs
+    /// Called for every material in the simulation every timestep, before iteration over particle pairs.
+    /// The default implementation calls \ref initializeBlock concurrently for blocks of the particles.
     /// \param scheduler Scheduler used for parallelization.
     /// \param storage Storage including all the particles.
     /// \param material Material properties and sequence of particles with this material. Implementation
     ///                 should only modify particles with indices in this sequence.
-    virtual void initialize(IScheduler& scheduler, Storage& storage, const MaterialView material) = 0;
+    virtual void initialize(IScheduler& scheduler, Storage& storage, const MaterialView material);
+
+    /// \brief Evaluates the stress tensor reduction factors of a block of particles.
+    ///
+    /// Allows \ref SolidMaterial to apply the rheology in the same pass over particles as the equation of
+    /// state, while the particles are still in cache. The function is called concurrently for disjoint
+    /// blocks, the pressure of particles in the block has already been computed.
+    /// \param storage Storage including all the particles.
+    /// \param material Material properties and sequence of particles with this material.
+    /// \param block Particles to process, subset of the material sequence. Implementation must only access
+    ///              particles in the block.
+    virtual void initializeBlock(Storage& storage, const MaterialView material, const IndexSequence block) = 0;
 
     /// \brief Computes derivatives of the time-dependent quantities of the rheological model.
     ///
@@ -74,7 +87,9 @@ public:
         IMaterial& settings,
         const MaterialInitialContext& context) const override;
 
-    virtual void initialize(IScheduler& scheduler, Storage& storage, const MaterialView material) override;
+    virtual void initializeBlock(Storage& storage,
+        const MaterialView material,
+        const IndexSequence block) override;
 
     virtual void integrate(IScheduler& scheduler, Storage& storage, const MaterialView material) override;
 };
@@ -100,7 +115,9 @@ public:
         IMaterial& material,
         const MaterialInitialContext& context) const override;
 
-    virtual void initialize(IScheduler& scheduler, Storage& storage, const MaterialView material) override;
+    virtual void initializeBlock(Storage& storage,
+        const MaterialView material,
+        const IndexSequence block) override;
 
     virtual void integrate(IScheduler& scheduler, Storage& storage, const MaterialView material) override;
 };
@@ -112,7 +129,9 @@ public:
         IMaterial& material,
         const MaterialInitialContext& context) const override;
 
-    virtual void initialize(IScheduler& scheduler, Storage& storage, const MaterialView material) override;
+    virtual void initializeBlock(Storage& storage,
+        const MaterialView material,
+        const IndexSequence block) override;
 
     virtual void integrate(IScheduler& scheduler, Storage& storage, const MaterialView material) override;
 };
@@ -124,7 +143,9 @@ public:
         IMaterial& material,
         const MaterialInitialContext& context) const override;
 
-    virtual void initialize(IScheduler& scheduler, Storage& storage, const MaterialView material) override;
+    virtual void initializeBlock(Storage& storage,
+        const MaterialView material,
+        const IndexSequence block) override;
 
     virtual void integrate(IScheduler& scheduler, Storage& storage, const MaterialView material) override;
 };
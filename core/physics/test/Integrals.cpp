@@ -1,9 +1,11 @@
 #include "physics/Integrals.h"
 #include "catch.hpp"
+#include "gravity/BruteForceGravity.h"
 #include "objects/geometry/Domain.h"
 #include "quantities/Quantity.h"
 #include "quantities/Storage.h"
 #include "sph/initial/Initial.h"
+#include "system/Statistics.h"
 #include "tests/Approx.h"
 #include "thread/Pool.h"
 
@@ -135,3 +137,51 @@ TEST_CASE("Center of Mass", "[integrals]") {
     // second body is 8x bigger in volume, but half the density -> 4x more massive
     REQUIRE(CenterOfMass().evaluate(storage) == approx((r1 + 4._f * r2) / 5._f, 1.e-6_f));
 }
+
+TEST_CASE("IntegralsEvaluator", "[integrals]") {
+    Storage storage;
+    InitialConditions conds(RunSettings::getDefaults());
+    BodySettings settings;
+    settings.set(BodySettingsId::DENSITY, 5._f);
+    settings.set(BodySettingsId::ENERGY, 20._f);
+    settings.set(BodySettingsId::PARTICLE_COUNT, 10000);
+    conds.addMonolithicBody(storage, SphericalDomain(Vector(1._f, 0._f, 2._f), 3._f), settings)
+        .addVelocity(Vector(5._f, 1._f, -2._f))
+        .addRotation(Vector(0._f, 1._f, 3._f), BodyView::RotationOrigin::CENTER_OF_MASS);
+
+    const Float omega = 0.5_f;
+    const Flags<IntegralFlag> flags = IntegralFlag::MASS | IntegralFlag::MOMENTUM |
+                                      IntegralFlag::ANGULAR_MOMENTUM | IntegralFlag::KINETIC_ENERGY |
+                                      IntegralFlag::INTERNAL_ENERGY | IntegralFlag::POTENTIAL_ENERGY |
+                                      IntegralFlag::CENTER_OF_MASS;
+    IntegralsEvaluator evaluator(flags, omega);
+    BruteForceGravity gravity;
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    gravity.build(pool, storage);
+
+    Statistics stats;
+    const IntegralValues values = evaluator.evaluate(pool, storage, stats, &gravity);
+    REQUIRE(values.mass == approx(TotalMass().evaluate(storage)));
+    REQUIRE(values.momentum == approx(TotalMomentum(omega).evaluate(storage)));
+    REQUIRE(values.angularMomentum == approx(TotalAngularMomentum(omega).evaluate(storage)));
+    REQUIRE(values.kineticEnergy == approx(TotalKineticEnergy().evaluate(storage)));
+    REQUIRE(values.internalEnergy == approx(TotalInternalEnergy().evaluate(storage)));
+    REQUIRE(values.potentialEnergy == approx(gravity.evalEnergy(pool, stats)));
+    REQUIRE(values.potentialEnergy < 0._f);
+    REQUIRE(values.centerOfMass == approx(CenterOfMass().evaluate(storage)));
+
+    REQUIRE(stats.get<Float>(StatisticsId::TOTAL_ENERGY) == values.totalEnergy());
+    REQUIRE(stats.get<Float>(StatisticsId::POTENTIAL_ENERGY) == values.potentialEnergy);
+    REQUIRE(stats.get<Dynamic>(StatisticsId::TOTAL_MOMENTUM).get<Vector>() == values.momentum);
+
+    // the result does not depend on the scheduler
+    const IntegralValues sequential = evaluator.evaluate(SEQUENTIAL, storage, stats);
+    REQUIRE(sequential.momentum == values.momentum);
+    REQUIRE(sequential.angularMomentum == values.angularMomentum);
+    REQUIRE(sequential.kineticEnergy == values.kineticEnergy);
+
+    // without gravity, the potential energy saved in the statistics is used
+    REQUIRE(sequential.potentialEnergy == values.potentialEnergy);
+    Statistics emptyStats;
+    REQUIRE(evaluator.evaluate(SEQUENTIAL, storage, emptyStats).potentialEnergy == 0._f);
+}
@@ -1,5 +1,7 @@
 #include "catch.hpp"
 #include "objects/geometry/Domain.h"
+#include "math/rng/Rng.h"
+#include "physics/Eos.h"
 #include "physics/Rheology.h"
 #include "quantities/IMaterial.h"
 #include "quantities/Quantity.h"
@@ -9,6 +11,7 @@
 #include "system/Factory.h"
 #include "system/Settings.h"
 #include "tests/Approx.h"
+#include "tests/Setup.h"
 #include "thread/Pool.h"
 #include "utils/Utils.h"
 
@@ -96,3 +99,49 @@ TEST_CASE("Yielding combinations", "[yielding]") {
         }
     }
 }
+
+TEST_CASE("SolidMaterial fused initialize", "[yielding]") {
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    for (YieldingEnum yieldingId : { YieldingEnum::VON_MISES, YieldingEnum::DRUCKER_PRAGER }) {
+        BodySettings body;
+        body.set(BodySettingsId::RHEOLOGY_YIELDING, yieldingId);
+        body.set(BodySettingsId::RHEOLOGY_DAMAGE, FractureEnum::SCALAR_GRADY_KIPP);
+        Storage fused = Tests::getSolidStorage(5000, body);
+
+        UniformRng rng;
+        const Float rho0 = body.get<Float>(BodySettingsId::DENSITY);
+        const Float u_cv = body.get<Float>(BodySettingsId::TILLOTSON_ENERGY_CV);
+        ArrayView<Float> rho, u, D;
+        tie(rho, u, D) = fused.getValues<Float>(QuantityId::DENSITY, QuantityId::ENERGY, QuantityId::DAMAGE);
+        ArrayView<TracelessTensor> S = fused.getValue<TracelessTensor>(QuantityId::DEVIATORIC_STRESS);
+        for (Size i = 0; i < rho.size(); ++i) {
+            rho[i] = rho0 * (0.8_f + 0.4_f * rng());
+            u[i] = 2._f * u_cv * rng();
+            D[i] = rng();
+            S[i] = 1.e8_f * TracelessTensor(rng() - 0.5_f, rng() - 0.5_f, rng() - 0.5_f, rng(), rng());
+        }
+        Storage separate = fused.clone(VisitorEnum::ALL_BUFFERS);
+
+        // reference: the EoS and the rheology evaluated in separate passes
+        TillotsonEos eos(body);
+        AutoPtr<IRheology> rheology = Factory::getRheology(body);
+        ArrayView<Float> p, cs;
+        tie(rho, u, p, cs) = separate.getValues<Float>(
+            QuantityId::DENSITY, QuantityId::ENERGY, QuantityId::PRESSURE, QuantityId::SOUND_SPEED);
+        for (Size i = 0; i < rho.size(); ++i) {
+            tie(p[i], cs[i]) = eos.evaluate(rho[i], u[i]);
+        }
+        MaterialView material = separate.getMaterial(0);
+        rheology->initialize(pool, separate, material);
+
+        fused.getMaterial(0)->initialize(pool, fused, fused.getMaterial(0).sequence());
+
+        for (QuantityId id : { QuantityId::PRESSURE, QuantityId::SOUND_SPEED }) {
+            REQUIRE(fused.getValue<Float>(id) == separate.getValue<Float>(id));
+        }
+        REQUIRE(fused.getValue<TracelessTensor>(QuantityId::DEVIATORIC_STRESS) ==
+                separate.getValue<TracelessTensor>(QuantityId::DEVIATORIC_STRESS));
+        REQUIRE(fused.getValue<Float>(QuantityId::STRESS_REDUCING) ==
+                separate.getValue<Float>(QuantityId::STRESS_REDUCING));
+    }
+}
@@ -3,6 +3,7 @@
 #include "io/Logger.h"
 #include "io/Output.h"
 #include "objects/finders/BruteForceFinder.h"
+#include "objects/finders/KdTree.h"
 #include "objects/finders/UniformGrid.h"
 #include "objects/geometry/Box.h"
 #include "objects/utility/Algorithm.h"
@@ -16,6 +17,7 @@
 #include "sph/kernel/Kernel.h"
 #include "system/Factory.h"
 #include "thread/Scheduler.h"
+#include "thread/ThreadLocal.h"
 #include <numeric>
 #include <set>
 
@@ -241,6 +243,13 @@ Array<Size> Post::findLargestComponent(const Storage& storage,
 }
 
 Array<Post::MoonEnum> Post::findMoons(const Storage& storage, const Float radius, const Float limit) {
+    return findMoons(SEQUENTIAL, storage, radius, limit);
+}
+
+Array<Post::MoonEnum> Post::findMoons(IScheduler& scheduler,
+    const Storage& storage,
+    const Float radius,
+    const Float limit) {
     // first, find the larget one
     ArrayView<const Float> m = storage.getValue<Float>(QuantityId::MASS);
     const auto largestIter = findMax(m);
@@ -256,15 +265,15 @@ Array<Post::MoonEnum> Post::findMoons(const Storage& storage, const Float radius
     // find the ellipse for all bodies
     ArrayView<const Vector> r = storage.getValue<Vector>(QuantityId::POSITION);
     ArrayView<const Vector> v = storage.getDt<Vector>(QuantityId::POSITION);
-    for (Size i = 0; i < m.size(); ++i) {
+    parallelFor(scheduler, 0, m.size(), [&](const Size i) {
         if (i == largestIdx) {
-            continue;
+            return;
         }
 
         // check for observability
         if (r[i][H] < limit * r[largestIdx][H]) {
             statuses[i] = MoonEnum::UNOBSERVABLE;
-            continue;
+            return;
         }
 
         // compute the orbital elements
@@ -283,11 +292,24 @@ Array<Post::MoonEnum> Post::findMoons(const Storage& storage, const Float radius
                 statuses[i] = MoonEnum::MOON;
             }
         }
-    }
+    });
 
     return statuses;
 }
 
+/// Checks if the body is counted as a moon of the i-th body; see \ref Post::findMoonCount.
+INLINE static bool isMoon(ArrayView<const Float> m,
+    ArrayView<const Vector> r,
+    ArrayView<const Vector> v,
+    const Size i,
+    const Size j,
+    const Float radius) {
+    Optional<Kepler::Elements> elements = Kepler::computeOrbitalElements(
+        m[i] + m[j], m[i] * m[j] / (m[i] + m[j]), r[i] - r[j], v[i] - v[j]);
+
+    return elements && elements->pericenterDist() > radius * (r[i][H] + r[j][H]);
+}
+
 Size Post::findMoonCount(ArrayView<const Float> m,
     ArrayView<const Vector> r,
     ArrayView<const Vector> v,
@@ -302,11 +324,7 @@ Size Post::findMoonCount(ArrayView<const Float> m,
         if (m[j] < limit * m[i]) {
             break;
         }
-
-        Optional<Kepler::Elements> elements = Kepler::computeOrbitalElements(
-            m[i] + m[j], m[i] * m[j] / (m[i] + m[j]), r[i] - r[j], v[i] - v[j]);
-
-        if (elements && elements->pericenterDist() > radius * (r[i][H] + r[j][H])) {
+        if (isMoon(m, r, v, i, j, radius)) {
             count++;
         }
     }
@@ -314,21 +332,135 @@ Size Post::findMoonCount(ArrayView<const Float> m,
     return count;
 }
 
+namespace {
+
+/// Node of the K-d tree used to search moons.
+struct MoonNode : public KdNode {
+    /// Bounding box of velocities of contained bodies
+    Box velocities;
+
+    /// Largest mass of contained bodies
+    Float maxMass;
+
+    /// Largest index of contained bodies
+    Size maxIdx;
+
+    MoonNode(const Type& type)
+        : KdNode(type) {}
+};
+
+} // namespace
+
+/// Returns the distance of the point from the box, or zero if the point lies inside the box.
+INLINE static Float getDistance(const Box& box, const Vector& pos) {
+    return getLength(box.clamp(pos) - pos);
+}
+
+Array<Size> Post::findMoonCounts(IScheduler& scheduler,
+    ArrayView<const Float> m,
+    ArrayView<const Vector> r,
+    ArrayView<const Vector> v,
+    const Float radius,
+    const Float limit) {
+    SPH_ASSERT(std::is_sorted(m.begin(), m.end(), std::greater<Float>{}));
+    SPH_ASSERT(r.size() == m.size() && v.size() == m.size());
+
+    Array<Size> counts(m.size());
+    counts.fill(0);
+    if (m.empty()) {
+        return counts;
+    }
+
+    KdTree<MoonNode> tree;
+    tree.build(scheduler, r, FinderFlag::SKIP_RANK);
+    iterateTree<IterateDirection::BOTTOM_UP>(
+        tree, SEQUENTIAL, [&tree, m, v](MoonNode& node, MoonNode* left, MoonNode* right) {
+            if (node.isLeaf()) {
+                node.velocities = Box();
+                node.maxMass = 0._f;
+                node.maxIdx = 0;
+                for (Size j : tree.getLeafIndices(reinterpret_cast<LeafNode<MoonNode>&>(node))) {
+                    node.velocities.extend(v[j]);
+                    node.maxMass = max(node.maxMass, m[j]);
+                    node.maxIdx = max(node.maxIdx, j);
+                }
+            } else {
+                // boxes of inner nodes are not computed by the tree
+                node.box = left->box;
+                node.box.extend(right->box);
+                node.velocities = left->velocities;
+                node.velocities.extend(right->velocities);
+                node.maxMass = max(left->maxMass, right->maxMass);
+                node.maxIdx = max(left->maxIdx, right->maxIdx);
+            }
+            return true;
+        });
+
+    // relative tolerance of the bound check, so that round-off errors never exclude a bound body
+    const Float eps = 1.e-6_f;
+    ThreadLocal<Array<Size>> stacks(scheduler);
+    parallelFor(scheduler, stacks, 0, m.size(), [&](const Size i, Array<Size>& stack) {
+        Size count = 0;
+        SPH_ASSERT(stack.empty());
+        stack.push(0);
+        while (!stack.empty()) {
+            const MoonNode& node = tree.getNode(stack.pop());
+            // only smaller (and not too small) bodies are counted as moons
+            if (node.maxIdx <= i || node.maxMass < limit * m[i] || node.velocities == Box()) {
+                continue;
+            }
+            // bound bodies satisfy v^2/2 < G(m_i+m_j)/r, check the condition for the whole node; note that
+            // moons cannot be more massive than the body itself
+            const Float dr = getDistance(node.box, r[i]);
+            const Float dv = getDistance(node.velocities, v[i]);
+            const Float maxMass = min(node.maxMass, m[i]);
+            if (0.5_f * sqr(dv) * dr > (1._f + eps) * Constants::gravity * (m[i] + maxMass)) {
+                continue;
+            }
+
+            if (node.isLeaf()) {
+                const LeafNode<MoonNode>& leaf = reinterpret_cast<const LeafNode<MoonNode>&>(node);
+                for (Size j : tree.getLeafIndices(leaf)) {
+                    if (j > i && m[j] >= limit * m[i] && isMoon(m, r, v, i, j, radius)) {
+                        count++;
+                    }
+                }
+            } else {
+                const InnerNode<MoonNode>& inner = reinterpret_cast<const InnerNode<MoonNode>&>(node);
+                stack.push(inner.left);
+                stack.push(inner.right);
+            }
+        }
+        counts[i] = count;
+    });
+    return counts;
+}
+
 Array<Post::Tumbler> Post::findTumblers(const Storage& storage, const Float limit) {
-    Array<Tumbler> tumblers;
+    return findTumblers(SEQUENTIAL, storage, limit);
+}
+
+Array<Post::Tumbler> Post::findTumblers(IScheduler& scheduler, const Storage& storage, const Float limit) {
     ArrayView<const Vector> omega = storage.getValue<Vector>(QuantityId::ANGULAR_FREQUENCY);
     ArrayView<const SymmetricTensor> I = storage.getValue<SymmetricTensor>(QuantityId::MOMENT_OF_INERTIA);
 
-    for (Size i = 0; i < omega.size(); ++i) {
-        const Vector L = I[i] * omega[i];
+    // compute the angles in parallel, negative values denote bodies without rotation
+    Array<Float> betas(omega.size());
+    parallelFor(scheduler, 0, omega.size(), [&](const Size i) {
         if (omega[i] == Vector(0._f)) {
-            continue;
+            betas[i] = -1._f;
+            return;
         }
+        const Vector L = I[i] * omega[i];
         const Float cosBeta = dot(L, omega[i]) / (getLength(L) * getLength(omega[i]));
         SPH_ASSERT(cosBeta >= -1._f && cosBeta <= 1._f);
-        const Float beta = acos(cosBeta);
-        if (beta > limit) {
-            tumblers.push(Tumbler{ i, beta });
+        betas[i] = acos(cosBeta);
+    });
+
+    Array<Tumbler> tumblers;
+    for (Size i = 0; i < betas.size(); ++i) {
+        if (betas[i] >= 0._f && betas[i] > limit) {
+            tumblers.push(Tumbler{ i, betas[i] });
         }
     }
     return tumblers;
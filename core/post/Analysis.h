@@ -105,6 +105,11 @@ struct Tumbler {
 /// accuracy data (Henych, 2013).
 Array<Tumbler> findTumblers(const Storage& storage, const Float limit);
 
+/// \brief Find all tumbling asteroids, evaluating the bodies in parallel.
+///
+/// Returns the same result as the sequential overload.
+Array<Tumbler> findTumblers(IScheduler& scheduler, const Storage& storage, const Float limit);
+
 /// \brief Potential relationship of the body with a respect to the largest remnant (fragment).
 enum class MoonEnum {
     LARGEST_FRAGMENT, ///< This is the largest fragment (or remnant, depending on definition)
@@ -137,6 +142,14 @@ enum class MoonEnum {
 /// \return Array of the same size of storage, marking each body in the storage; see MoonEnum.
 Array<MoonEnum> findMoons(const Storage& storage, const Float radius = 1._f, const Float limit = 0._f);
 
+/// \brief Find a potential satellites of the largest body, evaluating the bodies in parallel.
+///
+/// Returns the same result as the sequential overload.
+Array<MoonEnum> findMoons(IScheduler& scheduler,
+    const Storage& storage,
+    const Float radius = 1._f,
+    const Float limit = 0._f);
+
 /// \brief Find the number of moons of given body.
 ///
 /// \param m Masses of bodies, sorted in descending order.
@@ -152,6 +165,27 @@ Size findMoonCount(ArrayView<const Float> m,
     const Float radius = 1._f,
     const Float limit = 0._f);
 
+/// \brief Find the number of moons of all bodies.
+///
+/// Returns the same values as calling \ref findMoonCount for each body, but avoids testing all pairs of
+/// bodies. Bodies are stored in a K-d tree, with each node holding the bounding box of velocities and the
+/// largest mass of its bodies. Nodes that cannot contain any body bound to the queried body, as follows from
+/// the minimal distance and the minimal relative velocity, are skipped; the orbital elements are computed
+/// only for the remaining candidates. This is efficient if the velocities are correlated with positions, as
+/// is the case for fragments of a disrupted body. Bodies are processed in parallel.
+/// \param m Masses of bodies, sorted in descending order.
+/// \param r Positions and radii of bodies, sorted by mass (in descending order)
+/// \param v Velocities of bodies, sorted by mass (in descending order)
+/// \param radius Radius multiplier, may be used to exclude moons with pericenter very close to the body.
+/// \param limit Limiting mass radio, moons with masses lower than limit*m[i] are excluded.
+/// \return Array of moon counts, one value for each body.
+Array<Size> findMoonCounts(IScheduler& scheduler,
+    ArrayView<const Float> m,
+    ArrayView<const Vector> r,
+    ArrayView<const Vector> v,
+    const Float radius = 1._f,
+    const Float limit = 0._f);
+
 /// \brief Computes the center of mass.
 Vector getCenterOfMass(ArrayView<const Float> m,
     ArrayView<const Vector> r,
@@ -83,26 +83,54 @@ RadialDistributionPlot::RadialDistributionPlot(const QuantityId id, const Option
 // TemporalPlot
 // ----------------------------------------------------------------------------------------------------------
 
+TemporalPlot::TemporalPlot(const IntegralWrapper& integral, const Params& params)
+    : usesStorage(true)
+    , name(integral.getName())
+    , params(params) {
+    SPH_ASSERT(params.segment > 0._f);
+    sampler = [integral](const Storage& storage, const Statistics& UNUSED(stats)) -> Optional<Float> {
+        return integral.evaluate(storage);
+    };
+    actPeriod = params.period;
+}
+
+TemporalPlot::TemporalPlot(const String& name, const Sampler& sampler, const Params& params)
+    : sampler(sampler)
+    , usesStorage(false)
+    , name(name)
+    , params(params) {
+    SPH_ASSERT(params.segment > 0._f);
+    actPeriod = params.period;
+}
+
 void TemporalPlot::onTimeStep(const Storage& storage, const Statistics& stats) {
     // add new point to the queue
     const Float t = stats.get<Float>(StatisticsId::RUN_TIME);
     if (t - lastTime < actPeriod) {
         return;
     }
+    const Optional<Float> y = sampler(storage, stats);
+    if (!y) {
+        return;
+    }
     lastTime = t;
-
-    const Float y = integral.evaluate(storage);
-    points.pushBack(PlotPoint{ t, y });
-
-    if (params.segment == INFTY && points.size() > params.maxPointCnt) {
-        // plot is unnecessarily detailed, drop every second point to reduce the drawing time
-        Queue<PlotPoint> newPoints;
-        for (Size i = 0; i < points.size(); i += 2) {
-            newPoints.pushBack(points[i]);
+    points.pushBack(PlotPoint{ t, y.value() });
+
+    if (points.size() > params.maxPointCnt) {
+        // plot is unnecessarily detailed, decimate the points to reduce the memory and the drawing time
+        Array<PlotPoint> oldPoints;
+        oldPoints.reserve(points.size());
+        for (const PlotPoint& p : points) {
+            oldPoints.push(p);
+        }
+        points.clear();
+        for (const PlotPoint& p : decimateMinMax(oldPoints, max(params.maxPointCnt / 4, 1u))) {
+            points.pushBack(p);
+        }
+        if (params.segment == INFTY) {
+            // also add new points with double period
+            actPeriod *= 2._f;
         }
-        points = std::move(newPoints);
-        // also add new points with double period
-        actPeriod *= 2._f;
     }
 
     // pop expired points
@@ -196,6 +224,26 @@ void HistogramPlot::onTimeStep(const Storage& storage, const Statistics& stats)
     ranges.y.extend(0);
 }
 
+bool HistogramPlot::addRequiredQuantities(Array<QuantityId>& ids) const {
+    switch (Post::HistogramId(id)) {
+    case Post::HistogramId::RADII:
+    case Post::HistogramId::VELOCITIES:
+        ids.push(QuantityId::POSITION);
+        break;
+    case Post::HistogramId::EQUIVALENT_MASS_RADII:
+        ids.push(QuantityId::MASS);
+        break;
+    case Post::HistogramId::ROTATIONAL_FREQUENCY:
+    case Post::HistogramId::ROTATIONAL_PERIOD:
+    case Post::HistogramId::ROTATIONAL_AXIS:
+        ids.push(QuantityId::ANGULAR_FREQUENCY);
+        break;
+    default:
+        ids.push(QuantityId(id));
+    }
+    return true;
+}
+
 void HistogramPlot::clear() {
     ranges.x = ranges.y = Interval();
 }
@@ -328,6 +376,16 @@ void SfdPlot::onTimeStep(const Storage& storage, const Statistics& stats) {
     }
 }
 
+bool SfdPlot::addRequiredQuantities(Array<QuantityId>& ids) const {
+    // positions are needed for components (including radii) and velocities (for cutoff and escape velocity)
+    ids.push(QuantityId::POSITION);
+    ids.push(QuantityId::MASS);
+    if (connect.has(Post::ComponentFlag::SEPARATE_BY_FLAG)) {
+        ids.push(QuantityId::FLAG);
+    }
+    return true;
+}
+
 void SfdPlot::clear() {
     ranges.x = ranges.y = Interval();
     lastTime = 0._f;
@@ -406,6 +464,15 @@ void MultiPlot::onTimeStep(const Storage& storage, const Statistics& stats) {
     }
 }
 
+bool MultiPlot::addRequiredQuantities(Array<QuantityId>& ids) const {
+    for (auto& plot : plots) {
+        if (!plot->addRequiredQuantities(ids)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void MultiPlot::clear() {
     ranges.x = ranges.y = Interval();
     for (auto& plot : plots) {
@@ -420,6 +487,42 @@ void MultiPlot::plot(IDrawingContext& dc) const {
     }
 }
 
+// ----------------------------------------------------------------------------------------------------------
+// decimateMinMax
+// ----------------------------------------------------------------------------------------------------------
+
+Array<PlotPoint> decimateMinMax(ArrayView<const PlotPoint> points, const Size bucketCnt) {
+    SPH_ASSERT(bucketCnt > 0);
+    Array<PlotPoint> decimated;
+    if (points.size() <= 2 * bucketCnt) {
+        for (const PlotPoint& p : points) {
+            decimated.push(p);
+        }
+        return decimated;
+    }
+    decimated.reserve(2 * bucketCnt);
+    for (Size bucket = 0; bucket < bucketCnt; ++bucket) {
+        const Size from = Size(uint64_t(bucket) * points.size() / bucketCnt);
+        const Size to = Size(uint64_t(bucket + 1) * points.size() / bucketCnt);
+        SPH_ASSERT(to > from);
+        Size minIdx = from;
+        Size maxIdx = from;
+        for (Size i = from + 1; i < to; ++i) {
+            if (points[i].y < points[minIdx].y) {
+                minIdx = i;
+            }
+            if (points[i].y > points[maxIdx].y) {
+                maxIdx = i;
+            }
+        }
+        decimated.push(points[min(minIdx, maxIdx)]);
+        if (minIdx != maxIdx) {
+            decimated.push(points[max(minIdx, maxIdx)]);
+        }
+    }
+    return decimated;
+}
+
 // ----------------------------------------------------------------------------------------------------------
 // getTics
 // ----------------------------------------------------------------------------------------------------------
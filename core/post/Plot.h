@@ -7,6 +7,7 @@
 
 #include "objects/containers/Queue.h"
 #include "objects/utility/OperatorTemplate.h"
+#include "objects/wrappers/Function.h"
 #include "physics/Integrals.h"
 #include "post/Analysis.h"
 
@@ -98,6 +99,15 @@ public:
     /// Called every time step.
     virtual void onTimeStep(const Storage& storage, const Statistics& stats) = 0;
 
+    /// \brief Adds the IDs of quantities needed by \ref onTimeStep into the array.
+    ///
+    /// Allows to update the plot from a snapshot containing only the necessary quantities. Returns false if
+    /// the quantities cannot be determined; the plot has to be updated from the complete storage in such a
+    /// case.
+    virtual bool addRequiredQuantities(Array<QuantityId>& UNUSED(ids)) const {
+        return false;
+    }
+
     /// \brief Clears all cached data, prepares for next run.
     virtual void clear() = 0;
 
@@ -130,6 +140,12 @@ public:
 
     virtual void onTimeStep(const Storage& storage, const Statistics& UNUSED(stats)) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(id);
+        ids.push(QuantityId::POSITION);
+        return true;
+    }
+
     virtual void clear() override;
 
     virtual void plot(IDrawingContext& dc) const override;
@@ -169,9 +185,15 @@ public:
 ///
 /// Plot shows a given segment of history of a quantity. This segment moves as time goes. Alternatively, the
 /// segment can be (formally) infinite, meaning the plot shows the whole history of a quantity; the x-range is
-/// rescaled as time goes.
+/// rescaled as time goes. The number of stored points is bounded; when exceeded, the points are decimated
+/// using \ref decimateMinMax, so that the extremes of the plotted quantity are preserved.
 class TemporalPlot : public IPlot {
 public:
+    /// \brief Function returning the plotted value.
+    ///
+    /// Can return NOTHING if the value is not available, no point is added to the plot in this case.
+    using Sampler = Function<Optional<Float>(const Storage& storage, const Statistics& stats)>;
+
     /// Parameters of the plot
     struct Params {
         /// Plotted time segment
@@ -186,8 +208,8 @@ public:
         /// When discarting points out of plotted range, shrink y-axis to fit currently visible points
         bool shrinkY = false;
 
-        /// Maximum number of points on the plot. When exceeded, every second point is removed and the plot
-        /// period is doubled.
+        /// Maximum number of points on the plot. When exceeded, the points are decimated to a half and, if
+        /// the plot shows the whole history, the plot period is doubled.
         Size maxPointCnt = 100;
 
         /// Time that needs to pass before a new point is added
@@ -196,8 +218,14 @@ public:
 
 
 private:
-    /// Integral being plotted
-    IntegralWrapper integral;
+    /// Source of plotted values
+    Sampler sampler;
+
+    /// True if the values are evaluated from the storage, false if they are read from the statistics.
+    bool usesStorage;
+
+    /// Name of the plotted quantity
+    String name;
 
     /// Points on the timeline; x coordinate is time, y coordinate is the value of the quantity
     Queue<PlotPoint> points;
@@ -212,20 +240,27 @@ private:
     Float actPeriod;
 
 public:
-    /// Creates a plot showing the whole history of given integral.
-    TemporalPlot(const IntegralWrapper& integral, const Params& params)
-        : integral(integral)
-        , params(params) {
-        SPH_ASSERT(params.segment > 0._f);
-        actPeriod = params.period;
-    }
+    /// Creates a plot showing the history of given integral.
+    TemporalPlot(const IntegralWrapper& integral, const Params& params);
+
+    /// \brief Creates a plot showing the history of values returned by given function.
+    ///
+    /// The function can be used to plot values evaluated during the run and saved into \ref Statistics,
+    /// instead of computing them from the storage. The function shall not access the storage, so that the
+    /// plot can be updated from a snapshot without any quantities.
+    TemporalPlot(const String& name, const Sampler& sampler, const Params& params);
 
     virtual String getCaption() const override {
-        return integral.getName();
+        return name;
     }
 
     virtual void onTimeStep(const Storage& storage, const Statistics& stats) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& UNUSED(ids)) const override {
+        // quantities needed by the integral are unknown
+        return !usesStorage;
+    }
+
     virtual void clear() override;
 
     virtual void plot(IDrawingContext& dc) const override;
@@ -283,6 +318,8 @@ public:
 
     virtual void onTimeStep(const Storage& storage, const Statistics& stats) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override;
+
     virtual void clear() override;
 
     virtual void plot(IDrawingContext& dc) const override;
@@ -308,6 +345,11 @@ public:
 
     virtual void onTimeStep(const Storage& storage, const Statistics& stats) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::POSITION);
+        return true;
+    }
+
     virtual void clear() override;
 
     virtual void plot(IDrawingContext& dc) const override;
@@ -334,6 +376,8 @@ public:
 
     virtual void onTimeStep(const Storage& storage, const Statistics& stats) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override;
+
     virtual void clear() override;
 
     virtual void plot(IDrawingContext& dc) const override;
@@ -357,6 +401,10 @@ public:
 
     virtual void onTimeStep(const Storage& storage, const Statistics& stats) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& UNUSED(ids)) const override {
+        return true;
+    }
+
     virtual void clear() override;
 
     virtual void plot(IDrawingContext& dc) const override;
@@ -377,11 +425,22 @@ public:
 
     virtual void onTimeStep(const Storage& storage, const Statistics& stats) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override;
+
     virtual void clear() override;
 
     virtual void plot(IDrawingContext& dc) const override;
 };
 
+/// \brief Reduces the number of points while preserving the extremes of the plotted function.
+///
+/// Points are split into buckets of equal number of points; for each bucket, the points with minimal and
+/// maximal y-coordinate are kept, in their original order. The result thus contains at most 2*bucketCnt
+/// points. Repeated decimation of already decimated points keeps the global extremes.
+/// \param points Points sorted by their x-coordinate.
+/// \param bucketCnt Number of buckets, must be positive.
+Array<PlotPoint> decimateMinMax(ArrayView<const PlotPoint> points, const Size bucketCnt);
+
 /// \brief Returns the tics to be drawn on a linear axis of a plot.
 ///
 /// The tics are not necessarily equidistant.
@@ -2,6 +2,7 @@
 #include "catch.hpp"
 #include "io/FileSystem.h"
 #include "io/Path.h"
+#include "math/rng/Rng.h"
 #include "objects/geometry/Domain.h"
 #include "objects/utility/PerElementWrapper.h"
 #include "physics/Constants.h"
@@ -165,6 +166,33 @@ TEST_CASE("FindMoons", "[post]") {
     REQUIRE(status[1] == Post::MoonEnum::MOON);
 }
 
+TEST_CASE("FindMoonCounts", "[post]") {
+    // expanding cloud of fragments with random velocity dispersion, some of them bound
+    UniformRng rng;
+    const Size n = 2000;
+    Array<Float> m(n);
+    Array<Vector> r(n), v(n);
+    for (Size i = 0; i < n; ++i) {
+        m[i] = 1.e16_f / (1._f + i);
+        r[i] = 1.e5_f * Vector(rng() - 0.5_f, rng() - 0.5_f, rng() - 0.5_f);
+        r[i][H] = 10._f * Sph::cbrt(m[i] / 1.e16_f);
+        v[i] = 1.e-3_f * r[i] + 0.5_f * Vector(rng() - 0.5_f, rng() - 0.5_f, rng() - 0.5_f);
+        v[i][H] = 0._f;
+    }
+
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    for (Float limit : { 0._f, 1.e-2_f }) {
+        Array<Size> counts = Post::findMoonCounts(pool, m, r, v, 1._f, limit);
+        REQUIRE(counts.size() == n);
+        Size total = 0;
+        for (Size i = 0; i < n; ++i) {
+            REQUIRE(counts[i] == Post::findMoonCount(m, r, v, i, 1._f, limit));
+            total += counts[i];
+        }
+        REQUIRE(total > 0);
+    }
+}
+
 TEST_CASE("Inertia Tensor Sphere", "[post]") {
     const Float r_sphere = 5._f;
     const Float m_tot = 1234._f;
@@ -0,0 +1,180 @@
+#include "post/Plot.h"
+#include "catch.hpp"
+#include "post/Point.h"
+#include "quantities/Quantity.h"
+#include "quantities/Storage.h"
+#include "system/Statistics.h"
+#include "tests/Approx.h"
+#include "tests/Setup.h"
+
+using namespace Sph;
+
+namespace {
+
+class CountingDrawingContext : public IDrawingContext {
+public:
+    Array<PlotPoint> points;
+
+    virtual void drawPoint(const PlotPoint& point) override {
+        points.push(point);
+    }
+
+    virtual void drawErrorPoint(const ErrorPlotPoint& UNUSED(point)) override {}
+
+    virtual void drawLine(const PlotPoint& UNUSED(from), const PlotPoint& UNUSED(to)) override {}
+
+    virtual AutoPtr<IDrawPath> drawPath() override {
+        class NullPath : public IDrawPath {
+            virtual void addPoint(const PlotPoint& UNUSED(point)) override {}
+            virtual void closePath() override {}
+            virtual void endPath() override {}
+        };
+        return makeAuto<NullPath>();
+    }
+
+    virtual void setStyle(const Size UNUSED(index)) override {}
+
+    virtual void setTransformMatrix(const AffineMatrix2& UNUSED(matrix)) override {}
+};
+
+} // namespace
+
+TEST_CASE("DecimateMinMax", "[plot]") {
+    Array<PlotPoint> points;
+    for (Size i = 0; i < 1000; ++i) {
+        points.push(PlotPoint(Float(i), std::sin(0.1_f * i)));
+    }
+    points[437].y = 5._f;
+    points[802].y = -5._f;
+
+    Array<PlotPoint> decimated = decimateMinMax(points, 50);
+    REQUIRE(decimated.size() <= 100);
+    REQUIRE(decimated.size() > 50);
+    bool hasMax = false, hasMin = false;
+    for (Size i = 0; i < decimated.size(); ++i) {
+        if (i > 0) {
+            REQUIRE(decimated[i].x > decimated[i - 1].x);
+        }
+        hasMax |= decimated[i] == PlotPoint(437._f, 5._f);
+        hasMin |= decimated[i] == PlotPoint(802._f, -5._f);
+    }
+    REQUIRE(hasMax);
+    REQUIRE(hasMin);
+
+    // small arrays are kept unchanged
+    decimated = decimateMinMax(ArrayView<const PlotPoint>(points).subset(0, 20), 10);
+    REQUIRE(decimated.size() == 20);
+    REQUIRE(decimated[13] == points[13]);
+}
+
+TEST_CASE("TemporalPlot bounded points", "[plot]") {
+    TemporalPlot::Params params;
+    params.segment = INFTY;
+    params.maxPointCnt = 40;
+    params.shrinkY = false;
+    TemporalPlot plot("Energy",
+        [](const Storage& UNUSED(storage), const Statistics& stats) -> Optional<Float> {
+            if (!stats.has(StatisticsId::TOTAL_ENERGY)) {
+                return NOTHING;
+            }
+            return stats.get<Float>(StatisticsId::TOTAL_ENERGY);
+        },
+        params);
+    REQUIRE(plot.getCaption() == "Energy");
+
+    Storage storage;
+    Statistics stats;
+    stats.set(StatisticsId::RUN_TIME, 0._f);
+    plot.onTimeStep(storage, stats);
+    REQUIRE(plot.rangeX().empty());
+
+    for (Size i = 0; i < 1000; ++i) {
+        stats.set(StatisticsId::RUN_TIME, Float(i));
+        stats.set(StatisticsId::TOTAL_ENERGY, i == 123 ? 10._f : std::cos(0.05_f * i));
+        plot.onTimeStep(storage, stats);
+    }
+    REQUIRE(plot.rangeY().upper() == 10._f);
+    REQUIRE(plot.rangeY().lower() == approx(-1._f, 1.e-3_f));
+    REQUIRE(plot.rangeX().upper() == 999._f);
+
+    CountingDrawingContext dc;
+    plot.plot(dc);
+    REQUIRE(dc.points.size() <= 40);
+    REQUIRE(dc.points.size() >= 10);
+    // the spike is kept by the decimation
+    auto spike = std::find_if(
+        dc.points.begin(), dc.points.end(), [](const PlotPoint& p) { return p.y == 10._f; });
+    REQUIRE(spike != dc.points.end());
+    REQUIRE(spike->x == 123._f);
+}
+
+TEST_CASE("Plot required quantities", "[plot]") {
+    Storage storage = Tests::getGassStorage(1000);
+    ArrayView<Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    for (Size i = 0; i < v.size(); ++i) {
+        v[i] = Vector(r[i][Y], -r[i][X], 0._f);
+    }
+    Statistics stats;
+    stats.set(StatisticsId::RUN_TIME, 0._f);
+
+    HistogramPlot plot(Post::HistogramId::VELOCITIES, NOTHING, 0._f, "Speed histogram");
+    Array<QuantityId> ids;
+    REQUIRE(plot.addRequiredQuantities(ids));
+    Storage snapshot = storage.clone(VisitorEnum::STATE_VALUES, ids);
+    REQUIRE_FALSE(snapshot.has(QuantityId::DENSITY));
+
+    plot.onTimeStep(storage, stats);
+    const Interval rangeX = plot.rangeX();
+    const Interval rangeY = plot.rangeY();
+    plot.clear();
+    stats.set(StatisticsId::RUN_TIME, 1._f);
+    plot.onTimeStep(snapshot, stats);
+    REQUIRE(plot.rangeX() == rangeX);
+    REQUIRE(plot.rangeY() == rangeY);
+
+    // a plot that cannot tell the quantities it needs requires the complete storage
+    Array<AutoPtr<IPlot>> multiplot;
+    multiplot.emplaceBack(makeAuto<AngularHistogramPlot>(0._f));
+    multiplot.emplaceBack(makeAuto<TemporalPlot>(
+        IntegralWrapper(makeAuto<TotalEnergy>()), TemporalPlot::Params{}));
+    MultiPlot multi(std::move(multiplot));
+    REQUIRE_FALSE(multi.addRequiredQuantities(ids));
+}
+
+TEST_CASE("SfdPlot required quantities", "[plot]") {
+    Storage storage = Tests::getGassStorage(1000);
+    ArrayView<Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    storage.insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, 0);
+    ArrayView<Size> flag = storage.getValue<Size>(QuantityId::FLAG);
+    for (Size i = 0; i < v.size(); ++i) {
+        // split the particles into two separated bodies
+        r[i][X] += (i % 2) ? 5._f : -5._f;
+        flag[i] = i % 2;
+        v[i] = Vector(r[i][Y], -r[i][X], 0._f) * 1.e-3_f;
+    }
+    Statistics stats;
+
+    for (Flags<Post::ComponentFlag> flags : { Flags<Post::ComponentFlag>(Post::ComponentFlag::OVERLAP),
+             Flags<Post::ComponentFlag>(Post::ComponentFlag::ESCAPE_VELOCITY),
+             Flags<Post::ComponentFlag>(Post::ComponentFlag::SEPARATE_BY_FLAG) }) {
+        SfdPlot plot(flags, 0._f);
+        Array<QuantityId> ids;
+        REQUIRE(plot.addRequiredQuantities(ids));
+        Storage snapshot = storage.clone(VisitorEnum::STATE_VALUES, ids);
+        REQUIRE_FALSE(snapshot.has(QuantityId::DENSITY));
+        REQUIRE(snapshot.has(QuantityId::FLAG) == flags.has(Post::ComponentFlag::SEPARATE_BY_FLAG));
+
+        stats.set(StatisticsId::RUN_TIME, 0._f);
+        plot.onTimeStep(storage, stats);
+        const Interval rangeX = plot.rangeX();
+        const Interval rangeY = plot.rangeY();
+        REQUIRE_FALSE(rangeX.empty());
+        plot.clear();
+        stats.set(StatisticsId::RUN_TIME, 1._f);
+        plot.onTimeStep(snapshot, stats);
+        REQUIRE(plot.rangeX() == rangeX);
+        REQUIRE(plot.rangeY() == rangeY);
+    }
+}
@@ -92,6 +92,7 @@ void Holder<TValue>::visitConst(Holder& other, const Flags<VisitorEnum> flags, T
 }
 
 template class Holder<Size>;
+template class Holder<GlobalSize>;
 template class Holder<Float>;
 template class Holder<Vector>;
 template class Holder<SymmetricTensor>;
@@ -10,7 +10,7 @@
 
 NAMESPACE_SPH_BEGIN
 
-enum class ValueEnum { SCALAR, VECTOR, TENSOR, SYMMETRIC_TENSOR, TRACELESS_TENSOR, INDEX };
+enum class ValueEnum { SCALAR, VECTOR, TENSOR, SYMMETRIC_TENSOR, TRACELESS_TENSOR, INDEX, GLOBAL_INDEX };
 
 /// Convert type to ValueType enum
 template <typename T>
@@ -39,6 +39,10 @@ template <>
 struct GetValueEnum<Size> {
     static constexpr ValueEnum type = ValueEnum::INDEX;
 };
+template <>
+struct GetValueEnum<GlobalSize> {
+    static constexpr ValueEnum type = ValueEnum::GLOBAL_INDEX;
+};
 
 /// Convert ValueType enum to type
 template <ValueEnum Type>
@@ -67,6 +71,10 @@ template <>
 struct GetTypeFromEnum<ValueEnum::INDEX> {
     using Type = Size;
 };
+template <>
+struct GetTypeFromEnum<ValueEnum::GLOBAL_INDEX> {
+    using Type = GlobalSize;
+};
 
 
 /// \brief Selects type based on run-time ValueEnum value and runs visit<Type>() method of the visitor.
@@ -87,6 +95,8 @@ decltype(auto) dispatch(const ValueEnum value, TVisitor&& visitor, TArgs&&... ar
         return visitor.template visit<TracelessTensor>(std::forward<TArgs>(args)...);
     case ValueEnum::INDEX:
         return visitor.template visit<Size>(std::forward<TArgs>(args)...);
+    case ValueEnum::GLOBAL_INDEX:
+        return visitor.template visit<GlobalSize>(std::forward<TArgs>(args)...);
     default:
         NOT_IMPLEMENTED;
     }
@@ -97,7 +97,7 @@ QuantityMetadata getMetadata(const QuantityId key) {
     case QuantityId::MATERIAL_ID:
         return QuantityMetadata("Material ID", L"matID", ValueEnum::INDEX);
     case QuantityId::PERSISTENT_INDEX:
-        return QuantityMetadata("Original index", L"flag_0", ValueEnum::INDEX);
+        return QuantityMetadata("Original index", L"flag_0", ValueEnum::GLOBAL_INDEX);
     case QuantityId::XSPH_VELOCITIES:
         return QuantityMetadata("XSPH correction", L"xsph", ValueEnum::VECTOR);
     case QuantityId::GRAD_H:
@@ -1,5 +1,6 @@
 #include "quantities/Storage.h"
 #include "objects/Exceptions.h"
+#include "objects/utility/Algorithm.h"
 #include "physics/Eos.h"
 #include "quantities/Attractor.h"
 #include "quantities/IMaterial.h"
@@ -153,6 +154,7 @@ bool Storage::has(const QuantityId key, const OrderEnum order) const {
 }
 
 template bool Storage::has<Size>(const QuantityId, const OrderEnum) const;
+template bool Storage::has<GlobalSize>(const QuantityId, const OrderEnum) const;
 template bool Storage::has<Float>(const QuantityId, const OrderEnum) const;
 template bool Storage::has<Vector>(const QuantityId, const OrderEnum) const;
 template bool Storage::has<SymmetricTensor>(const QuantityId, const OrderEnum) const;
@@ -179,6 +181,7 @@ StaticArray<Array<TValue>&, 3> Storage::getAll(const QuantityId key) {
 }
 
 template StaticArray<Array<Size>&, 3> Storage::getAll(const QuantityId);
+template StaticArray<Array<GlobalSize>&, 3> Storage::getAll(const QuantityId);
 template StaticArray<Array<Float>&, 3> Storage::getAll(const QuantityId);
 template StaticArray<Array<Vector>&, 3> Storage::getAll(const QuantityId);
 template StaticArray<Array<SymmetricTensor>&, 3> Storage::getAll(const QuantityId);
@@ -193,6 +196,7 @@ StaticArray<const Array<TValue>&, 3> Storage::getAll(const QuantityId key) const
 }
 
 template StaticArray<const Array<Size>&, 3> Storage::getAll(const QuantityId) const;
+template StaticArray<const Array<GlobalSize>&, 3> Storage::getAll(const QuantityId) const;
 template StaticArray<const Array<Float>&, 3> Storage::getAll(const QuantityId) const;
 template StaticArray<const Array<Vector>&, 3> Storage::getAll(const QuantityId) const;
 template StaticArray<const Array<SymmetricTensor>&, 3> Storage::getAll(const QuantityId) const;
@@ -207,6 +211,7 @@ Array<TValue>& Storage::getValue(const QuantityId key) {
 }
 
 template Array<Size>& Storage::getValue(const QuantityId);
+template Array<GlobalSize>& Storage::getValue(const QuantityId);
 template Array<Float>& Storage::getValue(const QuantityId);
 template Array<Vector>& Storage::getValue(const QuantityId);
 template Array<SymmetricTensor>& Storage::getValue(const QuantityId);
@@ -219,6 +224,7 @@ const Array<TValue>& Storage::getValue(const QuantityId key) const {
 }
 
 template const Array<Size>& Storage::getValue(const QuantityId) const;
+template const Array<GlobalSize>& Storage::getValue(const QuantityId) const;
 template const Array<Float>& Storage::getValue(const QuantityId) const;
 template const Array<Vector>& Storage::getValue(const QuantityId) const;
 template const Array<SymmetricTensor>& Storage::getValue(const QuantityId) const;
@@ -233,6 +239,7 @@ Array<TValue>& Storage::getDt(const QuantityId key) {
 }
 
 template Array<Size>& Storage::getDt(const QuantityId);
+template Array<GlobalSize>& Storage::getDt(const QuantityId);
 template Array<Float>& Storage::getDt(const QuantityId);
 template Array<Vector>& Storage::getDt(const QuantityId);
 template Array<SymmetricTensor>& Storage::getDt(const QuantityId);
@@ -245,6 +252,7 @@ const Array<TValue>& Storage::getDt(const QuantityId key) const {
 }
 
 template const Array<Size>& Storage::getDt(const QuantityId) const;
+template const Array<GlobalSize>& Storage::getDt(const QuantityId) const;
 template const Array<Float>& Storage::getDt(const QuantityId) const;
 template const Array<Vector>& Storage::getDt(const QuantityId) const;
 template const Array<SymmetricTensor>& Storage::getDt(const QuantityId) const;
@@ -259,6 +267,7 @@ Array<TValue>& Storage::getD2t(const QuantityId key) {
 }
 
 template Array<Size>& Storage::getD2t(const QuantityId);
+template Array<GlobalSize>& Storage::getD2t(const QuantityId);
 template Array<Float>& Storage::getD2t(const QuantityId);
 template Array<Vector>& Storage::getD2t(const QuantityId);
 template Array<SymmetricTensor>& Storage::getD2t(const QuantityId);
@@ -271,6 +280,7 @@ const Array<TValue>& Storage::getD2t(const QuantityId key) const {
 }
 
 template const Array<Size>& Storage::getD2t(const QuantityId) const;
+template const Array<GlobalSize>& Storage::getD2t(const QuantityId) const;
 template const Array<Float>& Storage::getD2t(const QuantityId) const;
 template const Array<Vector>& Storage::getD2t(const QuantityId) const;
 template const Array<SymmetricTensor>& Storage::getD2t(const QuantityId) const;
@@ -298,6 +308,7 @@ Quantity& Storage::insert(const QuantityId key, const OrderEnum order, const TVa
 }
 
 template Quantity& Storage::insert(const QuantityId, const OrderEnum, const Size&);
+template Quantity& Storage::insert(const QuantityId, const OrderEnum, const GlobalSize&);
 template Quantity& Storage::insert(const QuantityId, const OrderEnum, const Float&);
 template Quantity& Storage::insert(const QuantityId, const OrderEnum, const Vector&);
 template Quantity& Storage::insert(const QuantityId, const OrderEnum, const TracelessTensor&);
@@ -342,6 +353,7 @@ Quantity& Storage::insert(const QuantityId key, const OrderEnum order, Array<TVa
 }
 
 template Quantity& Storage::insert(const QuantityId, const OrderEnum, Array<Size>&&);
+template Quantity& Storage::insert(const QuantityId, const OrderEnum, Array<GlobalSize>&&);
 template Quantity& Storage::insert(const QuantityId, const OrderEnum, Array<Float>&&);
 template Quantity& Storage::insert(const QuantityId, const OrderEnum, Array<Vector>&&);
 template Quantity& Storage::insert(const QuantityId, const OrderEnum, Array<TracelessTensor>&&);
@@ -519,6 +531,10 @@ void Storage::merge(Storage&& other) {
 
     SPH_ASSERT(this->isValid() && other.isValid());
 
+    // particles are indexed by Size locally, only the persistent indices are 64-bit, see GlobalSize
+    if (uint64_t(this->getParticleCnt()) + other.getParticleCnt() > std::numeric_limits<Size>::max()) {
+        throw InvalidSetup("Cannot merge storages, the particle count exceeds the range of Size");
+    }
 
     // make sure that either both have materials or neither
     if (bool(this->getMaterialCnt()) != bool(other.getMaterialCnt())) {
@@ -548,8 +564,8 @@ void Storage::merge(Storage&& other) {
 
     // update persistent indices
     if (this->has(QuantityId::PERSISTENT_INDEX)) {
-        ArrayView<Size> idxs = this->getValue<Size>(QuantityId::PERSISTENT_INDEX);
-        const Size idx0 = idxs[partCnt - 1] + 1; // next available index
+        ArrayView<GlobalSize> idxs = this->getValue<GlobalSize>(QuantityId::PERSISTENT_INDEX);
+        const GlobalSize idx0 = idxs[partCnt - 1] + 1; // next available index
         for (Size i = partCnt; i < this->getParticleCnt(); ++i) {
             idxs[i] = idx0 + (i - partCnt);
         }
@@ -622,6 +638,24 @@ Storage Storage::clone(const Flags<VisitorEnum> buffers) const {
     return cloned;
 }
 
+Storage Storage::clone(const Flags<VisitorEnum> buffers, ArrayView<const QuantityId> ids) const {
+    SPH_ASSERT(!userData, "Cloning storages with user data is currently not supported");
+    Storage cloned;
+    for (const auto& q : quantities) {
+        if (q.key() == QuantityId::MATERIAL_ID || contains(ids, q.key())) {
+            cloned.quantities.insert(q.key(), q.value().clone(buffers));
+        }
+    }
+
+    if (cloned.has(QuantityId::MATERIAL_ID) && !cloned.getValue<Size>(QuantityId::MATERIAL_ID).empty()) {
+        cloned.mats = this->mats.clone();
+    }
+    cloned.attractors = this->attractors.clone();
+
+    cloned.update();
+    return cloned;
+}
+
 void Storage::resize(const Size newParticleCnt, const Flags<ResizeFlag> flags) {
     SPH_ASSERT(getQuantityCnt() > 0 && getMaterialCnt() <= 1);
     SPH_ASSERT(!userData, "Resizing storages with user data is currently not supported");
@@ -645,6 +679,30 @@ void Storage::resize(const Size newParticleCnt, const Flags<ResizeFlag> flags) {
         flags.has(ResizeFlag::KEEP_EMPTY_UNCHANGED) ? Flags<ValidFlag>() : ValidFlag::COMPLETE));
 }
 
+/// Reallocates all buffers of given storage, newly allocated memory is first touched by the copy.
+static void reallocateInParallel(Storage& storage, IScheduler& scheduler) {
+    iterate<VisitorEnum::ALL_BUFFERS>(storage, [&scheduler](auto& buffer) {
+        using Type = typename std::decay_t<decltype(buffer)>::Type;
+        if (buffer.empty()) {
+            return;
+        }
+        Array<Type> copy(buffer.size());
+        parallelFor(scheduler, 0, buffer.size(), [&copy, &buffer](const Size i) { copy[i] = buffer[i]; });
+        buffer = std::move(copy);
+    });
+}
+
+void Storage::redistribute(IScheduler& scheduler) {
+    MEASURE_SCOPE("Storage::redistribute");
+    reallocateInParallel(*this, scheduler);
+    this->update();
+
+    this->propagate([&scheduler](Storage& storage) {
+        reallocateInParallel(storage, scheduler);
+        storage.update();
+    });
+}
+
 void Storage::swap(Storage& other, const Flags<VisitorEnum> flags) {
     SPH_ASSERT(this->getQuantityCnt() == other.getQuantityCnt());
     for (auto i1 = quantities.begin(), i2 = other.quantities.begin(); i1 != quantities.end(); ++i1, ++i2) {
@@ -808,6 +866,10 @@ Array<Size> Storage::duplicate(ArrayView<const Size> idxs, const Flags<IndicesFl
 }
 
 void Storage::remove(ArrayView<const Size> idxs, const Flags<IndicesFlag> flags) {
+    this->remove(SEQUENTIAL, idxs, flags);
+}
+
+void Storage::remove(IScheduler& scheduler, ArrayView<const Size> idxs, const Flags<IndicesFlag> flags) {
     if (idxs.empty()) {
         // job well done!
         return;
@@ -824,24 +886,60 @@ void Storage::remove(ArrayView<const Size> idxs, const Flags<IndicesFlag> flags)
         sortedIdxs = sortedHolder;
     }
 
-    this->removeSorted(sortedIdxs, ValidFlag::COMPLETE);
+    this->removeSorted(scheduler, sortedIdxs, ValidFlag::COMPLETE);
 
     if (flags.has(IndicesFlag::PROPAGATE)) {
-        this->propagate([sortedIdxs](Storage& storage) { //
-            storage.removeSorted(sortedIdxs, EMPTY_FLAGS);
+        this->propagate([&scheduler, sortedIdxs](Storage& storage) { //
+            storage.removeSorted(scheduler, sortedIdxs, EMPTY_FLAGS);
         });
     }
 }
 
-void Storage::removeSorted(ArrayView<const Size> sortedIdxs, const Flags<ValidFlag> flags) {
-    Size particleCnt = this->getParticleCnt();
-    iterate<VisitorEnum::ALL_BUFFERS>(*this, [sortedIdxs, flags, particleCnt](auto& buffer) {
-        MARK_USED(particleCnt);
-        SPH_ASSERT(!flags.has(ValidFlag::COMPLETE) || buffer.size() == particleCnt);
-        if (buffer.size() == particleCnt) {
-            buffer.remove(sortedIdxs);
+/// Returns the indices of particles not contained in the sorted list of removed particles.
+static Array<Size> getRemainingIdxs(ArrayView<const Size> sortedIdxs, const Size particleCnt) {
+    Array<Size> remainingIdxs;
+    remainingIdxs.reserve(particleCnt - sortedIdxs.size());
+    Size next = 0;
+    for (Size i = 0; i < particleCnt; ++i) {
+        if (next < sortedIdxs.size() && sortedIdxs[next] == i) {
+            ++next;
+        } else {
+            remainingIdxs.push(i);
         }
-    });
+    }
+    return remainingIdxs;
+}
+
+void Storage::removeSorted(IScheduler& scheduler,
+    ArrayView<const Size> sortedIdxs,
+    const Flags<ValidFlag> flags) {
+    Size particleCnt = this->getParticleCnt();
+    if (scheduler.getThreadCnt() == 1) {
+        // shift the values in place, no need to allocate new buffers
+        iterate<VisitorEnum::ALL_BUFFERS>(*this, [sortedIdxs, flags, particleCnt](auto& buffer) {
+            MARK_USED(particleCnt);
+            SPH_ASSERT(!flags.has(ValidFlag::COMPLETE) || buffer.size() == particleCnt);
+            if (buffer.size() == particleCnt) {
+                buffer.remove(sortedIdxs);
+            }
+        });
+    } else {
+        // gather the remaining values, the indices are shared by all buffers
+        const Array<Size> remainingIdxs = getRemainingIdxs(sortedIdxs, particleCnt);
+        iterate<VisitorEnum::ALL_BUFFERS>(
+            *this, [&scheduler, &remainingIdxs, flags, particleCnt](auto& buffer) {
+                MARK_USED(flags);
+                using Type = typename std::decay_t<decltype(buffer)>::Type;
+                SPH_ASSERT(!flags.has(ValidFlag::COMPLETE) || buffer.size() == particleCnt);
+                if (buffer.size() == particleCnt) {
+                    Array<Type> remaining(remainingIdxs.size());
+                    parallelFor(scheduler, 0, remainingIdxs.size(), [&](const Size i) { //
+                        remaining[i] = buffer[remainingIdxs[i]];
+                    });
+                    buffer = std::move(remaining);
+                }
+            });
+    }
 
     // update material ids
     this->update();
@@ -904,11 +1002,11 @@ SharedPtr<IStorageUserData> Storage::getUserData() const {
 
 void setPersistentIndices(Storage& storage) {
     const Size n = storage.getParticleCnt();
-    Array<Size> idxs(n);
+    Array<GlobalSize> idxs(n);
     for (Size i = 0; i < n; ++i) {
         idxs[i] = i;
     }
-    storage.insert<Size>(QuantityId::PERSISTENT_INDEX, OrderEnum::ZERO, std::move(idxs));
+    storage.insert<GlobalSize>(QuantityId::PERSISTENT_INDEX, OrderEnum::ZERO, std::move(idxs));
 }
 
 
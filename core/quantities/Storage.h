@@ -538,6 +538,14 @@ public:
     /// \param idxs Indices of particles to remove. No need to sort the indices.
     void remove(ArrayView<const Size> idxs, const Flags<IndicesFlag> flags = EMPTY_FLAGS);
 
+    /// \brief Removes specified particles from the storage, compacting the buffers in parallel.
+    ///
+    /// Same as \ref remove, except the remaining particles of each buffer are copied into a newly allocated
+    /// buffer using given scheduler. Useful when particles are removed from large storages every time step.
+    void remove(IScheduler& scheduler,
+        ArrayView<const Size> idxs,
+        const Flags<IndicesFlag> flags = EMPTY_FLAGS);
+
     /// \brief Removes all particles with all quantities (including materials) from the storage.
     ///
     /// The storage is left is a state as if it was default-constructed. Dependent storages are also cleared.
@@ -552,6 +560,15 @@ public:
     /// parameters in cloned storage will also modify the parameters in the parent storage.
     Storage clone(const Flags<VisitorEnum> buffers) const;
 
+    /// \brief Clones specified buffers of given quantities.
+    ///
+    /// Other quantities are not copied into the cloned storage. Quantity MATERIAL_ID is always cloned (if
+    /// present), so that the cloned storage shares the materials of the parent storage; the attractors are
+    /// cloned as well. Useful to make a cheap snapshot of the data needed by an observer of the run.
+    /// \param buffers Cloned buffers of the quantities.
+    /// \param ids Cloned quantities; IDs of quantities not stored in the storage are ignored.
+    Storage clone(const Flags<VisitorEnum> buffers, ArrayView<const QuantityId> ids) const;
+
     /// Options for the storage resize
     enum class ResizeFlag {
         /// Empty buffers will not be resized to new values.
@@ -569,6 +586,15 @@ public:
     /// \param flags Options of the resizing, see ResizeFlag enum. By default, all quantities are resized.
     void resize(const Size newParticleCnt, const Flags<ResizeFlag> flags = EMPTY_FLAGS);
 
+    /// \brief Reallocates all buffers, copying the values in parallel.
+    ///
+    /// On NUMA systems, memory pages are placed on the node of the thread that first writes into them. The
+    /// values are copied by the same partition of particles as used by parallel loops of the solvers, so that
+    /// each thread mostly accesses memory of its own node, provided the threads are pinned to cores. The
+    /// function invalidates any reference or \ref ArrayView to quantity values or derivatives. Dependent
+    /// storages are reallocated as well.
+    void redistribute(IScheduler& scheduler);
+
     /// \brief Swap quantities or given subset of quantities between two storages.
     ///
     /// Note that materials of the storages are NOT changed.
@@ -602,7 +628,9 @@ private:
     /// All added quantities are initialized to zero.
     void addMissingBuffers(const Storage& source);
 
-    void removeSorted(ArrayView<const Size> idxs, const Flags<ValidFlag> flags = ValidFlag::COMPLETE);
+    void removeSorted(IScheduler& scheduler,
+        ArrayView<const Size> idxs,
+        const Flags<ValidFlag> flags = ValidFlag::COMPLETE);
 
     /// \brief Updates the cached matIds view.
     void update();
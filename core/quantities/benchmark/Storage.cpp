@@ -0,0 +1,57 @@
+#include "bench/Session.h"
+#include "quantities/Quantity.h"
+#include "quantities/Storage.h"
+#include "thread/Pool.h"
+
+using namespace Sph;
+
+/// Memory-bound loops over particle buffers, comparing buffers first touched by the main thread with buffers
+/// distributed to the threads of a pinned thread pool. The difference is only visible on NUMA systems.
+
+static Storage getStreamStorage() {
+    constexpr Size particleCnt = 4000000;
+    Storage storage;
+    storage.insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, Array<Vector>(particleCnt));
+    ArrayView<Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    for (Size i = 0; i < particleCnt; ++i) {
+        r[i] = Vector(Float(i), 0._f, 0._f, 1._f);
+        v[i] = Vector(1._f, 0._f, 0._f);
+        dv[i] = Vector(0._f, 1._f, 0._f);
+    }
+    return storage;
+}
+
+static void benchmarkStream(ThreadPool& pool, Storage& storage, Benchmark::Context& context) {
+    ArrayView<Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    const Float dt = 1.e-3_f;
+    while (context.running()) {
+        parallelFor(pool, 0, r.size(), [&r, &v, &dv, dt](const Size i) {
+            v[i] += dv[i] * dt;
+            r[i] += v[i] * dt;
+        });
+        Benchmark::clobberMemory();
+    }
+}
+
+BENCHMARK("Storage stream main thread touch", "[numa]", Benchmark::Context& context) {
+    ThreadPool pool;
+    Storage storage = getStreamStorage();
+    benchmarkStream(pool, storage, context);
+}
+
+BENCHMARK("Storage stream pinned", "[numa]", Benchmark::Context& context) {
+    ThreadPool pool;
+    pool.pinThreads();
+    Storage storage = getStreamStorage();
+    benchmarkStream(pool, storage, context);
+}
+
+BENCHMARK("Storage stream pinned first touch", "[numa]", Benchmark::Context& context) {
+    ThreadPool pool;
+    pool.pinThreads();
+    Storage storage = getStreamStorage();
+    storage.redistribute(pool);
+    benchmarkStream(pool, storage, context);
+}
@@ -31,6 +31,10 @@ template <>
 void executeType<Size>(int& a) {
     a = 6;
 }
+template <>
+void executeType<GlobalSize>(int& a) {
+    a = 7;
+}
 
 
 struct TestVisitor {
@@ -54,4 +58,6 @@ TEST_CASE("Dispatch", "[quantityhelpers]") {
     REQUIRE(a == 5);
     dispatch(ValueEnum::INDEX, TestVisitor(), a);
     REQUIRE(a == 6);
+    dispatch(ValueEnum::GLOBAL_INDEX, TestVisitor(), a);
+    REQUIRE(a == 7);
 }
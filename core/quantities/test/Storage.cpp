@@ -1,6 +1,7 @@
 #include "quantities/Storage.h"
 #include "catch.hpp"
 #include "objects/Exceptions.h"
+#include "objects/utility/PerElementWrapper.h"
 #include "physics/Eos.h"
 #include "quantities/Attractor.h"
 #include "quantities/IMaterial.h"
@@ -8,6 +9,8 @@
 #include "sph/Materials.h"
 #include "system/Factory.h"
 #include "system/Settings.h"
+#include "tests/Setup.h"
+#include "thread/Pool.h"
 #include "utils/Utils.h"
 
 using namespace Sph;
@@ -245,6 +248,32 @@ TEST_CASE("Storage clone material", "[storage]") {
     REQUIRE(parentMat1.getParam<Float>(BodySettingsId::DENSITY) == 666._f);
 }
 
+TEST_CASE("Storage clone quantities", "[storage]") {
+    Storage storage(makeAuto<NullMaterial>(BodySettings::getDefaults()));
+    storage.insert<Vector>(
+        QuantityId::POSITION, OrderEnum::SECOND, Array<Vector>{ Vector(1._f), Vector(2._f) });
+    storage.insert<Float>(QuantityId::MASS, OrderEnum::ZERO, 3._f);
+    storage.insert<Float>(QuantityId::DENSITY, OrderEnum::FIRST, 4._f);
+    storage.insert<Float>(QuantityId::ENERGY, OrderEnum::FIRST, 5._f);
+    storage.addAttractor(Attractor(Vector(0._f), Vector(0._f), 1._f, 2._f));
+
+    const Array<QuantityId> ids{ QuantityId::POSITION, QuantityId::DENSITY, QuantityId::PRESSURE };
+    Storage cloned = storage.clone(VisitorEnum::ALL_BUFFERS, ids);
+    REQUIRE(cloned.getQuantityCnt() == 3); // positions, densities + matId
+    REQUIRE(cloned.has(QuantityId::MATERIAL_ID));
+    REQUIRE_FALSE(cloned.has(QuantityId::MASS));
+    REQUIRE_FALSE(cloned.has(QuantityId::PRESSURE));
+    REQUIRE(cloned.getParticleCnt() == 2);
+    REQUIRE(cloned.getMaterialCnt() == 1);
+    REQUIRE(cloned.getAttractorCnt() == 1);
+    REQUIRE(cloned.getValue<Vector>(QuantityId::POSITION)[1] == Vector(2._f));
+    REQUIRE(cloned.getAll<Float>(QuantityId::DENSITY)[1].size() == 2);
+
+    cloned = storage.clone(VisitorEnum::ZERO_ORDER, ids);
+    REQUIRE(cloned.getAll<Float>(QuantityId::DENSITY)[1].empty());
+    REQUIRE(cloned.getValue<Float>(QuantityId::DENSITY)[0] == 4._f);
+}
+
 TEST_CASE("Storage merge", "[storage]") {
     Storage storage1;
     storage1.insert<Float>(QuantityId::DENSITY, OrderEnum::FIRST, Array<Float>{ 0._f, 1._f });
@@ -424,6 +453,74 @@ TEST_CASE("Storage remove", "[storage]") {
     REQUIRE(storage1.getMaterial(0).sequence() == IndexSequence(0, 2));
 }
 
+TEST_CASE("Storage remove parallel", "[storage]") {
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    Storage storage1(getMaterial(MaterialEnum::BASALT));
+    storage1.insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, Array<Size>{ 0, 1, 2 });
+    storage1.insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, Vector(1._f));
+    Storage storage2(getMaterial(MaterialEnum::BASALT));
+    storage2.insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, Array<Size>{ 3, 4, 5, 6 });
+    storage2.insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, Vector(2._f));
+    storage1.merge(std::move(storage2));
+
+    storage1.remove(pool, Array<Size>{ 5, 0, 1, 2 });
+    REQUIRE(storage1.getValue<Size>(QuantityId::FLAG) == Array<Size>({ 3, 4, 6 }));
+    REQUIRE(storage1.getDt<Vector>(QuantityId::POSITION).size() == 3);
+    REQUIRE(perElement(storage1.getValue<Vector>(QuantityId::POSITION)) == Vector(2._f));
+    REQUIRE(storage1.getMaterialCnt() == 1);
+    REQUIRE(storage1.getMaterial(0).sequence() == IndexSequence(0, 3));
+    REQUIRE(storage1.isValid());
+}
+
+TEST_CASE("Storage remove parallel large", "[storage]") {
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    Storage storage = Tests::getSolidStorage(10000);
+    storage.insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, Array<Size>(storage.getParticleCnt()));
+    ArrayView<Size> flag = storage.getValue<Size>(QuantityId::FLAG);
+    for (Size i = 0; i < flag.size(); ++i) {
+        flag[i] = i;
+    }
+    SharedPtr<Storage> dependent = makeShared<Storage>(storage.clone(VisitorEnum::ALL_BUFFERS));
+    Storage expected = storage.clone(VisitorEnum::ALL_BUFFERS);
+
+    Array<Size> toRemove;
+    for (Size i = 0; i < storage.getParticleCnt(); i += 7) {
+        toRemove.push(i);
+    }
+    storage.addDependent(dependent);
+    storage.remove(pool, toRemove, Storage::IndicesFlag::INDICES_SORTED | Storage::IndicesFlag::PROPAGATE);
+    expected.remove(toRemove, Storage::IndicesFlag::INDICES_SORTED);
+
+    REQUIRE(storage.getParticleCnt() == expected.getParticleCnt());
+    REQUIRE(storage.isValid());
+    for (Storage* s : { &storage, &*dependent }) {
+        iteratePair<VisitorEnum::ALL_BUFFERS>(*s, expected, [](auto& buffer1, auto& buffer2) {
+            REQUIRE(buffer1 == buffer2);
+        });
+    }
+}
+
+TEST_CASE("Storage redistribute", "[storage]") {
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    SharedPtr<Storage> storage1 = makeShared<Storage>(getMaterial(MaterialEnum::BASALT));
+    storage1->insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, Array<Size>{ 0, 1, 2, 3, 4 });
+    storage1->insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, Vector(1._f, 2._f, 3._f));
+    SharedPtr<Storage> storage2 = makeShared<Storage>(storage1->clone(VisitorEnum::ALL_BUFFERS));
+    storage1->addDependent(storage2);
+
+    const Vector* data = &storage1->getValue<Vector>(QuantityId::POSITION)[0];
+    storage1->redistribute(pool);
+    REQUIRE(&storage1->getValue<Vector>(QuantityId::POSITION)[0] != data);
+    REQUIRE(storage1->getValue<Size>(QuantityId::FLAG) == Array<Size>({ 0, 1, 2, 3, 4 }));
+    REQUIRE(storage1->getValue<Size>(QuantityId::MATERIAL_ID) == Array<Size>({ 0, 0, 0, 0, 0 }));
+    REQUIRE(storage2->getValue<Size>(QuantityId::FLAG) == Array<Size>({ 0, 1, 2, 3, 4 }));
+    for (SharedPtr<Storage> storage : { storage1, storage2 }) {
+        REQUIRE(perElement(storage->getValue<Vector>(QuantityId::POSITION)) == Vector(1._f, 2._f, 3._f));
+        REQUIRE(perElement(storage->getD2t<Vector>(QuantityId::POSITION)) == Vector(0._f));
+    }
+    REQUIRE(storage1->isValid());
+}
+
 TEST_CASE("Storage removeAll", "[storage]") {
     Storage storage;
     storage.insert<Float>(QuantityId::FLAG, OrderEnum::ZERO, Array<Float>{ 0 }); // dummy unit
@@ -491,19 +588,34 @@ TEST_CASE("Storage persistent indices", "[storage]") {
 
     setPersistentIndices(storage1);
     REQUIRE(storage1.has(QuantityId::PERSISTENT_INDEX));
-    ArrayView<const Size> idxs = storage1.getValue<Size>(QuantityId::PERSISTENT_INDEX);
-    REQUIRE(idxs == Array<Size>({ 0, 1, 2, 3 }));
+    ArrayView<const GlobalSize> idxs = storage1.getValue<GlobalSize>(QuantityId::PERSISTENT_INDEX);
+    REQUIRE(idxs == Array<GlobalSize>({ 0, 1, 2, 3 }));
     storage1.remove(Array<Size>{ 1 });
-    idxs = storage1.getValue<Size>(QuantityId::PERSISTENT_INDEX);
-    REQUIRE(idxs == Array<Size>({ 0, 2, 3 }));
+    idxs = storage1.getValue<GlobalSize>(QuantityId::PERSISTENT_INDEX);
+    REQUIRE(idxs == Array<GlobalSize>({ 0, 2, 3 }));
 
     Storage storage2;
     storage2.insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, Array<Size>{ 4, 5, 6 });
     setPersistentIndices(storage2);
 
     storage1.merge(std::move(storage2));
-    idxs = storage1.getValue<Size>(QuantityId::PERSISTENT_INDEX);
-    REQUIRE(idxs == Array<Size>({ 0, 2, 3, 4, 5, 6 }));
+    idxs = storage1.getValue<GlobalSize>(QuantityId::PERSISTENT_INDEX);
+    REQUIRE(idxs == Array<GlobalSize>({ 0, 2, 3, 4, 5, 6 }));
+}
+
+TEST_CASE("Storage persistent indices 64-bit", "[storage]") {
+    // indices exceeding the range of Size are kept when merging
+    const GlobalSize large = GlobalSize(std::numeric_limits<Size>::max()) + 10;
+    Storage storage1;
+    storage1.insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, Array<Size>{ 0, 1 });
+    storage1.insert<GlobalSize>(QuantityId::PERSISTENT_INDEX, OrderEnum::ZERO, Array<GlobalSize>{ 5, large });
+    Storage storage2;
+    storage2.insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, Array<Size>{ 2, 3 });
+    setPersistentIndices(storage2);
+
+    storage1.merge(std::move(storage2));
+    ArrayView<const GlobalSize> idxs = storage1.getValue<GlobalSize>(QuantityId::PERSISTENT_INDEX);
+    REQUIRE(idxs == Array<GlobalSize>({ 5, large, large + 1, large + 2 }));
 }
 
 TEST_CASE("Storage duplicate", "[storage]") {
@@ -4,6 +4,7 @@
 #include "io/Output.h"
 #include "physics/Integrals.h"
 #include "quantities/IMaterial.h"
+#include "run/InSituAnalysis.h"
 #include "run/Trigger.h"
 #include "sph/Diagnostics.h"
 #include "sph/boundary/Boundary.h"
@@ -192,6 +193,14 @@ AutoPtr<IOutputTime> getOutputTimes(const RunSettings& settings) {
     }
 }
 
+static AutoPtr<ILogWriter> getIntegralsLogWriter(const RunSettings& settings,
+    const SharedPtr<IScheduler>& scheduler) {
+    const Path file(settings.get<String>(RunSettingsId::RUN_INTEGRALS_NAME));
+    const Path outputPath(settings.get<String>(RunSettingsId::RUN_OUTPUT_PATH));
+    const Float interval = settings.get<Float>(RunSettingsId::RUN_INTEGRALS_INTERVAL);
+    return makeAuto<IntegralsLogWriter>(outputPath / file, interval, scheduler);
+}
+
 Statistics IRun::run(Storage& input) {
     NullRunCallbacks callbacks;
     return this->run(input, callbacks);
@@ -216,6 +225,29 @@ Statistics IRun::run(Storage& input, IRunCallbacks& callbacks) {
     // set uninitilized variables
     setNullToDefaults(storage);
 
+    if (settings.get<bool>(RunSettingsId::RUN_INTEGRALS_ENABLE)) {
+        triggers.pushBack(getIntegralsLogWriter(settings, scheduler));
+    }
+    if (settings.getFlags<InSituAnalysisEnum>(RunSettingsId::RUN_INSITU_ANALYSES) != EMPTY_FLAGS) {
+        // analyses get their own threads, so that they do not compete with the run for workers
+        const Size threadCnt = max(settings.get<int>(RunSettingsId::RUN_INSITU_THREAD_CNT), 1);
+        SharedPtr<IScheduler> analysisScheduler = makeShared<ThreadPool>(threadCnt);
+        for (AutoPtr<ITrigger>& trigger : getInSituAnalysisTriggers(settings, analysisScheduler)) {
+            triggers.pushBack(std::move(trigger));
+        }
+    }
+
+    if (settings.get<bool>(RunSettingsId::RUN_THREAD_PINNING)) {
+        RawPtr<ThreadPool> pool = dynamicCast<ThreadPool>(scheduler.get());
+        if (pool && pool->isPinned()) {
+            // move the particle buffers (including buffers of the timestepping) close to the threads
+            storage->redistribute(*scheduler);
+        } else {
+            // threads of other schedulers can migrate, redistributing the buffers would have no effect
+            logger->write("Warning: threads of the scheduler are not pinned, thread pinning is ignored");
+        }
+    }
+
     // fetch parameters of run from settings
     const Interval timeRange(
         settings.get<Float>(RunSettingsId::RUN_START_TIME), settings.get<Float>(RunSettingsId::RUN_END_TIME));
@@ -92,7 +92,8 @@ protected:
     /// Solver
     AutoPtr<ISolver> solver;
 
-    /// Triggers
+    /// Triggers, executed after each time step. Triggers of in-situ analyses enabled in the settings are
+    /// added automatically, see \ref InSituAnalysisTrigger.
     List<AutoPtr<ITrigger>> triggers;
 
     /// Diagnostics
@@ -0,0 +1,267 @@
+#include "run/InSituAnalysis.h"
+#include "io/Logger.h"
+#include "quantities/Iterate.h"
+#include "system/Profiler.h"
+#include "thread/Scheduler.h"
+#include <algorithm>
+#include <map>
+
+NAMESPACE_SPH_BEGIN
+
+//-----------------------------------------------------------------------------------------------------------
+// InSituAnalysisTrigger implementation
+//-----------------------------------------------------------------------------------------------------------
+
+/// \brief Copies given quantities into a new storage.
+///
+/// The storage cannot be simply cloned, as it generally contains user data of the solver.
+static Storage makeSnapshot(Storage& storage, ArrayView<const QuantityId> ids) {
+    Storage snapshot;
+    iterate<VisitorEnum::ALL_VALUES>(storage, [&](const QuantityId id, auto& values) {
+        using TValue = typename std::decay_t<decltype(values)>::Type;
+        if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+            return;
+        }
+        const OrderEnum order = storage.getQuantity(id).getOrderEnum();
+        Quantity& q = snapshot.insert<TValue>(id, order, values.clone());
+        if (order != OrderEnum::ZERO) {
+            q.getDt<TValue>() = storage.getDt<TValue>(id).clone();
+        }
+    });
+    return snapshot;
+}
+
+InSituAnalysisTrigger::InSituAnalysisTrigger(Array<AutoPtr<IInSituAnalysis>>&& analyses,
+    const SharedPtr<IScheduler>& scheduler,
+    const Float period,
+    const Float startTime)
+    : PeriodicTrigger(period, startTime)
+    , analyses(std::move(analyses))
+    , scheduler(scheduler) {
+    SPH_ASSERT(scheduler);
+    for (const AutoPtr<IInSituAnalysis>& analysis : this->analyses) {
+        for (QuantityId id : analysis->getRequiredQuantities()) {
+            if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+                ids.push(id);
+            }
+        }
+    }
+}
+
+InSituAnalysisTrigger::~InSituAnalysisTrigger() {
+    this->wait();
+}
+
+AutoPtr<ITrigger> InSituAnalysisTrigger::action(Storage& storage, Statistics& stats) {
+    PROFILE_SCOPE("InSituAnalysisTrigger::action");
+    // limit the memory footprint to a single pending snapshot
+    this->wait();
+
+    // the copy is the only part executed synchronously with the run
+    SharedPtr<Storage> snapshot = makeShared<Storage>(makeSnapshot(storage, ids));
+    task = scheduler->submit([this, snapshot, stats] {
+        for (AutoPtr<IInSituAnalysis>& analysis : analyses) {
+            analysis->analyze(*scheduler, *snapshot, stats);
+        }
+    });
+    return nullptr;
+}
+
+void InSituAnalysisTrigger::wait() {
+    if (task) {
+        task->wait();
+        task = nullptr;
+    }
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// ComponentsAnalysis implementation
+//-----------------------------------------------------------------------------------------------------------
+
+ComponentsAnalysis::ComponentsAnalysis(const Path& pathMask,
+    const Float particleRadius,
+    const Flags<Post::ComponentFlag> flags)
+    : paths(pathMask)
+    , particleRadius(particleRadius)
+    , flags(flags) {}
+
+Array<QuantityId> ComponentsAnalysis::getRequiredQuantities() const {
+    return { QuantityId::POSITION, QuantityId::MASS, QuantityId::FLAG };
+}
+
+void ComponentsAnalysis::analyze(IScheduler& UNUSED(scheduler),
+    const Storage& snapshot,
+    const Statistics& stats) {
+    Array<Size> indices;
+    const Size componentCnt =
+        Post::findComponents(snapshot, particleRadius, flags | Post::ComponentFlag::SORT_BY_MASS, indices);
+
+    ArrayView<const Vector> r, v, dv;
+    tie(r, v, dv) = snapshot.getAll<Vector>(QuantityId::POSITION);
+    ArrayView<const Float> m = snapshot.getValue<Float>(QuantityId::MASS);
+    Array<Size> counts(componentCnt);
+    Array<Float> masses(componentCnt);
+    Array<Vector> positions(componentCnt);
+    Array<Vector> velocities(componentCnt);
+    counts.fill(0);
+    masses.fill(0._f);
+    positions.fill(Vector(0._f));
+    velocities.fill(Vector(0._f));
+    for (Size i = 0; i < r.size(); ++i) {
+        const Size idx = indices[i];
+        counts[idx]++;
+        masses[idx] += m[i];
+        positions[idx] += m[i] * r[i];
+        velocities[idx] += m[i] * v[i];
+    }
+
+    FileLogger logger(paths.getNextPath(stats));
+    logger.write("# time = ", stats.get<Float>(StatisticsId::RUN_TIME));
+    logger.write("# particle count, mass, position, velocity");
+    for (Size idx = 0; idx < componentCnt; ++idx) {
+        const Vector r_com = positions[idx] / masses[idx];
+        const Vector v_com = velocities[idx] / masses[idx];
+        logger.write(counts[idx], " ", masses[idx], " ", r_com, " ", v_com);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// HistogramAnalysis implementation
+//-----------------------------------------------------------------------------------------------------------
+
+HistogramAnalysis::HistogramAnalysis(const Path& pathMask,
+    const Post::ExtHistogramId id,
+    const Post::HistogramSource source,
+    const Post::HistogramParams& params)
+    : paths(pathMask)
+    , id(id)
+    , source(source)
+    , params(params) {}
+
+Array<QuantityId> HistogramAnalysis::getRequiredQuantities() const {
+    Array<QuantityId> ids{
+        QuantityId::POSITION, QuantityId::MASS, QuantityId::FLAG, QuantityId::ANGULAR_FREQUENCY
+    };
+    if (int(QuantityId(id)) >= 0) {
+        ids.push(QuantityId(id));
+    }
+    return ids;
+}
+
+void HistogramAnalysis::analyze(IScheduler& UNUSED(scheduler),
+    const Storage& snapshot,
+    const Statistics& stats) {
+    Array<Post::HistPoint> histogram = Post::getCumulativeHistogram(snapshot, id, source, params);
+
+    FileLogger logger(paths.getNextPath(stats));
+    logger.write("# time = ", stats.get<Float>(StatisticsId::RUN_TIME));
+    for (const Post::HistPoint& point : histogram) {
+        logger.write(point.value, " ", point.count);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// MoonsAnalysis implementation
+//-----------------------------------------------------------------------------------------------------------
+
+MoonsAnalysis::MoonsAnalysis(const Path& pathMask, const Float radius, const Float limit)
+    : paths(pathMask)
+    , radius(radius)
+    , limit(limit) {}
+
+Array<QuantityId> MoonsAnalysis::getRequiredQuantities() const {
+    return { QuantityId::POSITION, QuantityId::MASS };
+}
+
+void MoonsAnalysis::analyze(IScheduler& scheduler, const Storage& snapshot, const Statistics& stats) {
+    if (snapshot.getParticleCnt() == 0) {
+        return;
+    }
+    Array<Post::MoonEnum> statuses = Post::findMoons(scheduler, snapshot, radius, limit);
+
+    ArrayView<const Vector> r, v, dv;
+    tie(r, v, dv) = snapshot.getAll<Vector>(QuantityId::POSITION);
+    ArrayView<const Float> m = snapshot.getValue<Float>(QuantityId::MASS);
+
+    FileLogger logger(paths.getNextPath(stats));
+    logger.write("# time = ", stats.get<Float>(StatisticsId::RUN_TIME));
+    logger.write("# index, mass, position, velocity");
+    for (Size i = 0; i < statuses.size(); ++i) {
+        if (statuses[i] == Post::MoonEnum::MOON) {
+            logger.write(i, " ", m[i], " ", r[i], " ", v[i]);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// TumblersAnalysis implementation
+//-----------------------------------------------------------------------------------------------------------
+
+TumblersAnalysis::TumblersAnalysis(const Path& pathMask, const Float limit)
+    : paths(pathMask)
+    , limit(limit) {}
+
+Array<QuantityId> TumblersAnalysis::getRequiredQuantities() const {
+    return { QuantityId::ANGULAR_FREQUENCY, QuantityId::MOMENT_OF_INERTIA };
+}
+
+void TumblersAnalysis::analyze(IScheduler& scheduler, const Storage& snapshot, const Statistics& stats) {
+    if (!snapshot.has(QuantityId::ANGULAR_FREQUENCY) || !snapshot.has(QuantityId::MOMENT_OF_INERTIA)) {
+        // particles do not rotate, nothing to analyze
+        return;
+    }
+    Array<Post::Tumbler> tumblers = Post::findTumblers(scheduler, snapshot, limit);
+
+    FileLogger logger(paths.getNextPath(stats));
+    logger.write("# time = ", stats.get<Float>(StatisticsId::RUN_TIME));
+    logger.write("# index, misalignment angle [deg]");
+    for (const Post::Tumbler& tumbler : tumblers) {
+        logger.write(tumbler.index, " ", tumbler.beta * RAD_TO_DEG);
+    }
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// Triggers from settings
+//-----------------------------------------------------------------------------------------------------------
+
+Array<AutoPtr<ITrigger>> getInSituAnalysisTriggers(const RunSettings& settings,
+    const SharedPtr<IScheduler>& scheduler) {
+    const Flags<InSituAnalysisEnum> enabled =
+        settings.getFlags<InSituAnalysisEnum>(RunSettingsId::RUN_INSITU_ANALYSES);
+    const Path outputPath(settings.get<String>(RunSettingsId::RUN_OUTPUT_PATH));
+    const Float startTime = settings.get<Float>(RunSettingsId::RUN_START_TIME);
+    const bool isNBody = settings.get<RunTypeEnum>(RunSettingsId::RUN_TYPE) == RunTypeEnum::NBODY;
+
+    // group the analyses by their periods
+    std::map<Float, Array<AutoPtr<IInSituAnalysis>>> analyses;
+    if (enabled.has(InSituAnalysisEnum::COMPONENTS)) {
+        const Float period = settings.get<Float>(RunSettingsId::RUN_INSITU_COMPONENTS_INTERVAL);
+        analyses[period].push(makeAuto<ComponentsAnalysis>(outputPath / Path("components_%d.txt")));
+    }
+    if (enabled.has(InSituAnalysisEnum::SFD)) {
+        const Float period = settings.get<Float>(RunSettingsId::RUN_INSITU_SFD_INTERVAL);
+        // particles are individual bodies in N-body simulations, SPH particles need to be grouped
+        const Post::HistogramSource source =
+            isNBody ? Post::HistogramSource::PARTICLES : Post::HistogramSource::COMPONENTS;
+        analyses[period].push(makeAuto<HistogramAnalysis>(outputPath / Path("sfd_%d.txt"),
+            Post::HistogramId::EQUIVALENT_MASS_RADII,
+            source,
+            Post::HistogramParams{}));
+    }
+    if (enabled.has(InSituAnalysisEnum::MOONS)) {
+        const Float period = settings.get<Float>(RunSettingsId::RUN_INSITU_MOONS_INTERVAL);
+        analyses[period].push(makeAuto<MoonsAnalysis>(outputPath / Path("moons_%d.txt")));
+    }
+    if (enabled.has(InSituAnalysisEnum::TUMBLERS)) {
+        const Float period = settings.get<Float>(RunSettingsId::RUN_INSITU_TUMBLERS_INTERVAL);
+        analyses[period].push(makeAuto<TumblersAnalysis>(outputPath / Path("tumblers_%d.txt")));
+    }
+
+    Array<AutoPtr<ITrigger>> triggers;
+    for (auto& group : analyses) {
+        triggers.push(makeAuto<InSituAnalysisTrigger>(std::move(group.second), scheduler, group.first, startTime));
+    }
+    return triggers;
+}
+
+NAMESPACE_SPH_END
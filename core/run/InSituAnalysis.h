@@ -0,0 +1,177 @@
+#pragma once
+
+/// \file InSituAnalysis.h
+/// \brief Analysis of particle data executed concurrently with the run
+/// \author Pavel Sevecek (sevecek at sirrah.troja.mff.cuni.cz)
+/// \date 2016-2021
+
+#include "io/Output.h"
+#include "post/Analysis.h"
+#include "run/Trigger.h"
+
+NAMESPACE_SPH_BEGIN
+
+class ITask;
+
+/// \brief Analysis of particle data executed during the run.
+///
+/// The analysis is given a snapshot of particles, i.e. a copy of selected quantities made at the time the
+/// analysis was triggered. It is therefore executed asynchronously, while the simulation continues, and it
+/// is expected to write compact results (histograms, tables of components, etc.) rather than full dumps.
+class IInSituAnalysis : public Polymorphic {
+public:
+    /// \brief Returns the quantities copied into the snapshot.
+    ///
+    /// Quantities not present in the simulation are skipped. Values and first derivatives are copied for
+    /// first-order and second-order quantities, so that the snapshot of positions contains velocities.
+    virtual Array<QuantityId> getRequiredQuantities() const = 0;
+
+    /// \brief Analyzes the snapshot.
+    ///
+    /// Called from a worker thread of the analysis scheduler. The function is never called concurrently for
+    /// the same object, so the implementation does not have to be thread-safe.
+    /// \param scheduler Scheduler of the analysis, can be used to parallelize the analysis.
+    /// \param snapshot Copy of the required quantities.
+    /// \param stats Copy of run statistics at the time the snapshot was created.
+    virtual void analyze(IScheduler& scheduler, const Storage& snapshot, const Statistics& stats) = 0;
+};
+
+/// \brief Trigger periodically running analyses on particle snapshots.
+///
+/// The action of the trigger only copies the required quantities and submits the analyses into the provided
+/// scheduler, the run then continues without waiting for the analyses to finish. The scheduler should be
+/// different from the one used by the run, for example a \ref ThreadPool with a few threads, so that the
+/// analyses do not compete with the integration for workers. If the previous analyses have not finished
+/// before the next snapshot is due, the trigger waits for them, so there is at most one snapshot in flight.
+///
+/// Triggers of analyses enabled by \ref RunSettingsId::RUN_INSITU_ANALYSES are created by \ref IRun, using a
+/// dedicated thread pool; custom analyses can be registered by adding the trigger to the \ref IRun::triggers
+/// list in \ref IRun::setUp. The trigger waits for the pending analyses when destroyed, i.e. when the run is
+/// torn down.
+class InSituAnalysisTrigger : public PeriodicTrigger {
+private:
+    Array<AutoPtr<IInSituAnalysis>> analyses;
+
+    /// Scheduler executing the analyses
+    SharedPtr<IScheduler> scheduler;
+
+    /// Union of quantities required by the analyses
+    Array<QuantityId> ids;
+
+    /// Currently running analyses, or nullptr
+    SharedPtr<ITask> task;
+
+public:
+    /// \param analyses Analyses executed every period.
+    /// \param scheduler Scheduler used to execute the analyses. Must not be nullptr.
+    /// \param period Period of the analyses in simulation time.
+    /// \param startTime Time of the first analysis.
+    InSituAnalysisTrigger(Array<AutoPtr<IInSituAnalysis>>&& analyses,
+        const SharedPtr<IScheduler>& scheduler,
+        const Float period,
+        const Float startTime = 0._f);
+
+    ~InSituAnalysisTrigger() override;
+
+    virtual AutoPtr<ITrigger> action(Storage& storage, Statistics& stats) override;
+
+    /// \brief Blocks until the pending analyses finish.
+    void wait();
+};
+
+/// \brief Writes the table of components (separated bodies) found in the snapshot.
+///
+/// Each snapshot is written into a separate file, given by the path mask. The file contains a line for each
+/// component, consisting of the particle count, mass, position of the center of mass and velocity of the
+/// center of mass. Components are sorted by mass.
+class ComponentsAnalysis : public IInSituAnalysis {
+private:
+    OutputFile paths;
+    Float particleRadius;
+    Flags<Post::ComponentFlag> flags;
+
+public:
+    /// \param pathMask Path of the output files, see \ref OutputFile.
+    /// \param particleRadius Size of particles in smoothing lengths, see \ref Post::findComponents.
+    /// \param flags Connectivity of components, see \ref Post::findComponents.
+    ComponentsAnalysis(const Path& pathMask,
+        const Float particleRadius = 2._f,
+        const Flags<Post::ComponentFlag> flags = Post::ComponentFlag::OVERLAP);
+
+    virtual Array<QuantityId> getRequiredQuantities() const override;
+
+    virtual void analyze(IScheduler& scheduler, const Storage& snapshot, const Statistics& stats) override;
+};
+
+/// \brief Writes the cumulative histogram (e.g. the size-frequency distribution) of the snapshot.
+///
+/// Each snapshot is written into a separate file, given by the path mask. The file contains a line for each
+/// point of the histogram.
+class HistogramAnalysis : public IInSituAnalysis {
+private:
+    OutputFile paths;
+    Post::ExtHistogramId id;
+    Post::HistogramSource source;
+    Post::HistogramParams params;
+
+public:
+    HistogramAnalysis(const Path& pathMask,
+        const Post::ExtHistogramId id,
+        const Post::HistogramSource source,
+        const Post::HistogramParams& params);
+
+    virtual Array<QuantityId> getRequiredQuantities() const override;
+
+    virtual void analyze(IScheduler& scheduler, const Storage& snapshot, const Statistics& stats) override;
+};
+
+/// \brief Writes the potential satellites of the largest body found in the snapshot.
+///
+/// Each snapshot is written into a separate file, given by the path mask. The file contains a line for each
+/// body bound to the largest body and not on a collisional trajectory, consisting of the particle index,
+/// mass, position and velocity. See \ref Post::findMoons.
+class MoonsAnalysis : public IInSituAnalysis {
+private:
+    OutputFile paths;
+    Float radius;
+    Float limit;
+
+public:
+    /// \param pathMask Path of the output files, see \ref OutputFile.
+    /// \param radius Radius multiplier of bodies, see \ref Post::findMoons.
+    /// \param limit Observational limit of moons, see \ref Post::findMoons.
+    MoonsAnalysis(const Path& pathMask, const Float radius = 1._f, const Float limit = 0._f);
+
+    virtual Array<QuantityId> getRequiredQuantities() const override;
+
+    virtual void analyze(IScheduler& scheduler, const Storage& snapshot, const Statistics& stats) override;
+};
+
+/// \brief Writes the tumbling bodies found in the snapshot.
+///
+/// Each snapshot is written into a separate file, given by the path mask. The file contains a line for each
+/// tumbler, consisting of the particle index and the misalignment angle in degrees. Nothing is written if
+/// the simulation does not evolve rotations of particles. See \ref Post::findTumblers.
+class TumblersAnalysis : public IInSituAnalysis {
+private:
+    OutputFile paths;
+    Float limit;
+
+public:
+    /// \param pathMask Path of the output files, see \ref OutputFile.
+    /// \param limit Minimal misalignment angle (in radians) of tumblers.
+    explicit TumblersAnalysis(const Path& pathMask, const Float limit = 15._f * DEG_TO_RAD);
+
+    virtual Array<QuantityId> getRequiredQuantities() const override;
+
+    virtual void analyze(IScheduler& scheduler, const Storage& snapshot, const Statistics& stats) override;
+};
+
+/// \brief Creates the in-situ analysis triggers enabled in the run settings.
+///
+/// Analyses with the same period share a single trigger, so that the particles are copied only once. All
+/// analyses are executed by the given scheduler.
+Array<AutoPtr<ITrigger>> getInSituAnalysisTriggers(const RunSettings& settings,
+    const SharedPtr<IScheduler>& scheduler);
+
+NAMESPACE_SPH_END
@@ -0,0 +1,232 @@
+#include "bench/Session.h"
+#include "gravity/NBodySolver.h"
+#include "io/FileManager.h"
+#include "io/FileSystem.h"
+#include "io/Output.h"
+#include "math/rng/VectorRng.h"
+#include "objects/geometry/Domain.h"
+#include "physics/Constants.h"
+#include "quantities/IMaterial.h"
+#include "quantities/Quantity.h"
+#include "run/jobs/SimulationJobs.h"
+#include "sph/initial/Initial.h"
+#include "system/Factory.h"
+#include "system/Statistics.h"
+#include "thread/Pool.h"
+#include "timestepping/TimeStepping.h"
+
+using namespace Sph;
+
+/// End-to-end benchmarks of complete time steps, using setups of the regression tests. Each iteration of the
+/// benchmark is a single time step starting from the initial conditions, including the output of the state
+/// into a binary file.
+
+/// Wraps a solver, measuring the total duration of its calls.
+class TimedSolver : public ISolver {
+private:
+    ISolver& solver;
+
+public:
+    /// Durations of \ref integrate and \ref collide in the current step (in ms)
+    Float integrateDuration = 0._f;
+    Float collideDuration = 0._f;
+
+    explicit TimedSolver(ISolver& solver)
+        : solver(solver) {}
+
+    virtual void integrate(Storage& storage, Statistics& stats) override {
+        Timer timer;
+        solver.integrate(storage, stats);
+        integrateDuration += 1.e-3_f * timer.elapsed(TimerUnit::MICROSECOND);
+    }
+
+    virtual void collide(Storage& storage, Statistics& stats, const Float dt) override {
+        Timer timer;
+        solver.collide(storage, stats, dt);
+        collideDuration += 1.e-3_f * timer.elapsed(TimerUnit::MICROSECOND);
+    }
+
+    virtual void create(Storage& storage, IMaterial& material) const override {
+        solver.create(storage, material);
+    }
+};
+
+/// \brief Runs the time steps and reports durations of the individual phases of the step.
+///
+/// Durations of the tree build and the gravity evaluation are taken from the statistics, the rest of the
+/// solver evaluation is reported as the SPH loop. Collision handling is only reported for N-body runs; for
+/// SPH runs, it merely drifts the particles and it is included in the integration phase.
+static void benchmarkScenario(Benchmark::Context& context,
+    IScheduler& scheduler,
+    const RunSettings& settings,
+    SharedPtr<Storage> storage,
+    ISolver& solver) {
+    // each step starts from the same state, so that all samples measure the same amount of work
+    const Storage initial = storage->clone(VisitorEnum::ALL_BUFFERS);
+    const Path outputPath =
+        RandomPathManager(FileSystem::getTemporaryDirectory().valueOr(Path())).getPath("ssf");
+    BinaryOutput output{ OutputFile(outputPath) };
+    const bool isNBody = settings.get<RunTypeEnum>(RunSettingsId::RUN_TYPE) == RunTypeEnum::NBODY;
+    TimedSolver timedSolver(solver);
+
+    while (context.running()) {
+        *storage = initial.clone(VisitorEnum::ALL_BUFFERS);
+        AutoPtr<ITimeStepping> timeStepping = Factory::getTimeStepping(settings, storage);
+        context.restartIteration();
+
+        Statistics stats;
+        stats.set(StatisticsId::RUN_TIME, 0._f);
+        timedSolver.integrateDuration = timedSolver.collideDuration = 0._f;
+        Timer timer;
+        timeStepping->step(scheduler, timedSolver, stats);
+        const Float stepDuration = 1.e-3_f * timer.elapsed(TimerUnit::MICROSECOND);
+
+        timer.restart();
+        output.dump(*storage, stats);
+        context.addPhase("output", 1.e-3_f * timer.elapsed(TimerUnit::MICROSECOND));
+
+        const Float buildDuration = stats.getOr<int>(StatisticsId::GRAVITY_BUILD_TIME, 0);
+        const Float gravityDuration = stats.getOr<int>(StatisticsId::GRAVITY_EVAL_TIME, 0);
+        context.addPhase("tree build", buildDuration);
+        context.addPhase("gravity", gravityDuration);
+        Float integrationDuration = stepDuration - timedSolver.integrateDuration;
+        if (isNBody) {
+            context.addPhase("collisions", timedSolver.collideDuration);
+            integrationDuration -= timedSolver.collideDuration;
+        } else {
+            context.addPhase(
+                "SPH loop", max(timedSolver.integrateDuration - buildDuration - gravityDuration, 0._f));
+        }
+        context.addPhase("integration", max(integrationDuration, 0._f));
+    }
+    FileSystem::removePath(outputPath);
+}
+
+static BodySettings getBasaltBody() {
+    BodySettings body;
+    body.set(BodySettingsId::ENERGY, 1.e3_f)
+        .set(BodySettingsId::RHEOLOGY_YIELDING, YieldingEnum::DRUCKER_PRAGER)
+        .set(BodySettingsId::RHEOLOGY_DAMAGE, FractureEnum::SCALAR_GRADY_KIPP);
+    return body;
+}
+
+/// Impact of a small projectile into a target, see regression/impact.
+static void benchmarkImpact(Benchmark::Context& context, const Benchmark::ScalingPoint& point) {
+    RunSettings settings = SphJob::getDefaultSettings("impact");
+    settings.set(RunSettingsId::TIMESTEPPING_INITIAL_TIMESTEP, 0.01_f);
+    ThreadPool pool(point.threadCnt);
+
+    SharedPtr<Storage> storage = makeShared<Storage>();
+    InitialConditions ic(settings);
+    const Float targetRadius = 1.e3_f;
+    const Float impactorRadius = 0.05_f * targetRadius;
+    BodySettings body = getBasaltBody();
+    body.set(BodySettingsId::PARTICLE_COUNT, int(point.particleCnt));
+    ic.addMonolithicBody(*storage, SphericalDomain(Vector(0._f), targetRadius), body);
+
+    const Float impactAngle = 60._f * DEG_TO_RAD;
+    const Float h = storage->getValue<Vector>(QuantityId::POSITION)[0][H];
+    const Vector dir(std::cos(impactAngle), std::sin(impactAngle), 0._f);
+    const Vector center = (targetRadius + impactorRadius) * dir + Vector(3._f * h, 0._f, 0._f);
+    body.set(BodySettingsId::PARTICLE_COUNT, 20);
+    ic.addMonolithicBody(*storage, SphericalDomain(center, impactorRadius), body)
+        .addVelocity(Vector(-1.e3_f, 0._f, 0._f));
+
+    AutoPtr<ISolver> solver = Factory::getSolver(pool, settings);
+    for (Size matId = 0; matId < storage->getMaterialCnt(); ++matId) {
+        solver->create(*storage, storage->getMaterial(matId));
+    }
+    benchmarkScenario(context, pool, settings, storage, *solver);
+}
+
+/// Spinning elongated body composed of two materials, see regression/rotation.
+static void benchmarkRotation(Benchmark::Context& context, const Benchmark::ScalingPoint& point) {
+    RunSettings settings = SphJob::getDefaultSettings("rotation");
+    settings.set(RunSettingsId::SPH_SOLVER_FORCES, ForceEnum::PRESSURE | ForceEnum::SOLID_STRESS)
+        .set(RunSettingsId::SPH_DISCRETIZATION, DiscretizationEnum::BENZ_ASPHAUG);
+    ThreadPool pool(point.threadCnt);
+
+    SharedPtr<Storage> storage = makeShared<Storage>();
+    InitialConditions ic(settings);
+    BodySettings heavy = getBasaltBody();
+    heavy.set(BodySettingsId::PARTICLE_COUNT, int(point.particleCnt))
+        .set(BodySettingsId::INITIAL_DISTRIBUTION, DistributionEnum::CUBIC);
+    BodySettings light = heavy;
+    light.set(BodySettingsId::DENSITY, 1500._f);
+    InitialConditions::BodySetup environment(
+        makeShared<BlockDomain>(Vector(0._f), Vector(100._f, 15._f, 15._f)), heavy);
+    Array<InitialConditions::BodySetup> bodies;
+    bodies.emplaceBack(
+        makeShared<BlockDomain>(Vector(25._f, 0._f, 0._f), Vector(50._f, 15._f, 15._f)), light);
+    // 24 revolutions per day
+    ic.addHeterogeneousBody(*storage, environment, bodies)
+        .addRotation(Vector(0._f, 0._f, 2._f * PI * 24._f / (24._f * 3600._f)),
+            BodyView::RotationOrigin::CENTER_OF_MASS);
+
+    AutoPtr<ISolver> solver = Factory::getSolver(pool, settings);
+    for (Size matId = 0; matId < storage->getMaterialCnt(); ++matId) {
+        solver->create(*storage, storage->getMaterial(matId));
+    }
+    benchmarkScenario(context, pool, settings, storage, *solver);
+}
+
+/// Rotating cloud of gravitationally interacting spheres merging on collisions, see regression/nbody-merge.
+static void benchmarkNBodyMerge(Benchmark::Context& context, const Benchmark::ScalingPoint& point) {
+    RunSettings settings = NBodyJob::getDefaultSettings("nbody-merge");
+    settings.set(RunSettingsId::COLLISION_HANDLER, CollisionHandlerEnum::PERFECT_MERGING)
+        .set(RunSettingsId::COLLISION_OVERLAP, OverlapEnum::FORCE_MERGE)
+        .set(RunSettingsId::TIMESTEPPING_INITIAL_TIMESTEP, 0.001_f)
+        .set(RunSettingsId::TIMESTEPPING_MAX_TIMESTEP, 0.01_f);
+    ThreadPool pool(point.threadCnt);
+
+    const Float cloudRadius = 1.e5_f;
+    const Float density = 2.e3_f;
+    // particles fill about 1% of the cloud volume
+    const Float radius = 0.2_f * cloudRadius / std::cbrt(Float(point.particleCnt));
+    const Float mass = density * sphereVolume(radius);
+    const Float omega = sqrt(Constants::gravity * mass * point.particleCnt / pow<3>(cloudRadius));
+
+    VectorRng<UniformRng> rng;
+    Array<Vector> r;
+    while (r.size() < point.particleCnt) {
+        const Vector pos = cloudRadius * (2._f * rng() - Vector(1._f));
+        if (getLength(pos) <= cloudRadius) {
+            r.push(Vector(pos[X], pos[Y], 0.1_f * pos[Z], radius));
+        }
+    }
+
+    SharedPtr<Storage> storage = makeShared<Storage>(makeAuto<NullMaterial>(EMPTY_SETTINGS));
+    storage->insert<Vector>(QuantityId::POSITION, OrderEnum::SECOND, std::move(r));
+    storage->insert<Float>(QuantityId::MASS, OrderEnum::ZERO, mass);
+    ArrayView<Vector> v = storage->getDt<Vector>(QuantityId::POSITION);
+    ArrayView<const Vector> pos = storage->getValue<Vector>(QuantityId::POSITION);
+    for (Size i = 0; i < v.size(); ++i) {
+        const Vector dispersion = 0.05_f * omega * cloudRadius * (2._f * rng() - Vector(1._f));
+        v[i] = cross(Vector(0._f, 0._f, omega), pos[i]) + dispersion;
+        v[i][H] = 0._f;
+    }
+
+    HardSphereSolver solver(pool, settings);
+    solver.create(*storage, storage->getMaterial(0));
+    setPersistentIndices(*storage);
+    benchmarkScenario(context, pool, settings, storage, solver);
+}
+
+// particle counts and thread counts have the same ratios, so that the weak scaling can be evaluated
+static Benchmark::RegisterScaling registerImpact("Impact",
+    "[scenarios]",
+    { 2500, 5000, 10000, 20000 },
+    { 1, 2, 4, 8 },
+    &benchmarkImpact);
+
+static Benchmark::RegisterScaling registerRotation("Rotation",
+    "[scenarios]",
+    { 2500, 5000, 10000, 20000 },
+    { 1, 2, 4, 8 },
+    &benchmarkRotation);
+
+static Benchmark::RegisterScaling registerNBodyMerge("NBody merge",
+    "[scenarios]",
+    { 5000, 10000, 20000, 40000 },
+    { 1, 2, 4, 8 },
+    &benchmarkNBodyMerge);
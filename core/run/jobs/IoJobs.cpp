@@ -1,6 +1,7 @@
 #include "run/jobs/IoJobs.h"
 #include "io/FileSystem.h"
 #include "io/Output.h"
+#include "io/Sequence.h"
 #include "objects/geometry/Delaunay.h"
 #include "post/MarchingCubes.h"
 #include "post/MeshFile.h"
@@ -52,7 +53,8 @@ VirtualSettings LoadFileJob::getSettings() {
 }
 
 void LoadFileJob::evaluate(const RunSettings& UNUSED(global), IRunCallbacks& UNUSED(callbacks)) {
-    if (!FileSystem::pathExists(path)) {
+    // frames of sequence files are addressed by virtual paths, check the file itself
+    if (!FileSystem::pathExists(SequenceInput::parseFramePath(path).get<0>())) {
         throw InvalidSetup("File '" + path.string() + "' does not exist or cannot be accessed.");
     }
     AutoPtr<IInput> input = Factory::getInput(path);
@@ -109,11 +111,29 @@ VirtualSettings FileSequenceJob::getSettings() {
 
 /// \todo deduplicate with timeline
 FlatMap<Size, Path> getFileSequence(const Path& firstFile) {
+    FlatMap<Size, Path> fileMap;
+    if (getIoEnum(firstFile.extension().string()) == IoEnum::SEQUENCE_FILE) {
+        // all frames are stored in a single file
+        Path file;
+        Size firstIndex;
+        tieToTuple(file, firstIndex) = SequenceInput::parseFramePath(firstFile);
+        Expected<Array<Float>> times = SequenceInput::getFrameTimes(file);
+        if (!times) {
+            throw InvalidSetup(times.error());
+        }
+        for (Size index = firstIndex; index < times->size(); ++index) {
+            fileMap.insert(index, SequenceInput::getFramePath(file, index));
+        }
+        if (fileMap.empty()) {
+            throw InvalidSetup("No frames found in file '" + firstFile.string() + "'.");
+        }
+        return fileMap;
+    }
+
     if (!FileSystem::pathExists(firstFile)) {
         throw InvalidSetup("File '" + firstFile.string() + "' does not exist.");
     }
 
-    FlatMap<Size, Path> fileMap;
     Optional<OutputFile> referenceMask = OutputFile::getMaskFromPath(firstFile);
     if (!referenceMask) {
         throw InvalidSetup("Cannot deduce sequence from file '" + firstFile.string() + "'.");
@@ -98,6 +98,10 @@ static void addGravityCategory(VirtualSettings& connector, RunSettings& settings
     gravityCat.connect<EnumWrapper>("Softening kernel", settings, RunSettingsId::GRAVITY_KERNEL);
     gravityCat.connect<Float>(
         "Recomputation period [s]", settings, RunSettingsId::GRAVITY_RECOMPUTATION_PERIOD);
+    gravityCat.connect<bool>("Compact moments", settings, RunSettingsId::GRAVITY_COMPACT_MOMENTS)
+        .setEnabler([&settings] {
+            return settings.get<GravityEnum>(RunSettingsId::GRAVITY_SOLVER) == GravityEnum::BARNES_HUT;
+        });
 }
 
 static void addOutputCategory(VirtualSettings& connector, RunSettings& settings, const SharedToken& owner) {
@@ -145,6 +149,11 @@ static void addOutputCategory(VirtualSettings& connector, RunSettings& settings,
             const OutputSpacing spacing = settings.get<OutputSpacing>(RunSettingsId::RUN_OUTPUT_SPACING);
             return type != IoEnum::NONE && spacing == OutputSpacing::CUSTOM;
         });
+    outputCat.connect<int>("Keyframe period", settings, RunSettingsId::RUN_OUTPUT_SEQUENCE_KEYFRAME_PERIOD)
+        .setEnabler([&settings] {
+            const IoEnum type = settings.get<IoEnum>(RunSettingsId::RUN_OUTPUT_TYPE);
+            return type == IoEnum::SEQUENCE_FILE;
+        });
 }
 
 static void addLoggerCategory(VirtualSettings& connector, RunSettings& settings) {
@@ -155,6 +164,31 @@ static void addLoggerCategory(VirtualSettings& connector, RunSettings& settings)
         .setEnabler(
             [&settings] { return settings.get<LoggerEnum>(RunSettingsId::RUN_LOGGER) == LoggerEnum::FILE; });
     loggerCat.connect<int>("Log verbosity", settings, RunSettingsId::RUN_LOGGER_VERBOSITY);
+    auto integralsEnabler = [&settings] { return settings.get<bool>(RunSettingsId::RUN_INTEGRALS_ENABLE); };
+    loggerCat.connect<bool>("Log integrals", settings, RunSettingsId::RUN_INTEGRALS_ENABLE);
+    loggerCat.connect<String>("Integrals file", settings, RunSettingsId::RUN_INTEGRALS_NAME)
+        .setEnabler(integralsEnabler);
+    loggerCat.connect<Float>("Integrals interval [s]", settings, RunSettingsId::RUN_INTEGRALS_INTERVAL)
+        .setEnabler(integralsEnabler);
+}
+
+static void addInSituCategory(VirtualSettings& connector, RunSettings& settings) {
+    auto enabler = [&settings](const InSituAnalysisEnum analysis) {
+        return [&settings, analysis] {
+            return settings.getFlags<InSituAnalysisEnum>(RunSettingsId::RUN_INSITU_ANALYSES).has(analysis);
+        };
+    };
+    VirtualSettings::Category& inSituCat = connector.addCategory("In-situ analysis");
+    inSituCat.connect<Flags<InSituAnalysisEnum>>("Analyses", settings, RunSettingsId::RUN_INSITU_ANALYSES);
+    inSituCat.connect<int>("Thread count", settings, RunSettingsId::RUN_INSITU_THREAD_CNT);
+    inSituCat.connect<Float>("Components interval [s]", settings, RunSettingsId::RUN_INSITU_COMPONENTS_INTERVAL)
+        .setEnabler(enabler(InSituAnalysisEnum::COMPONENTS));
+    inSituCat.connect<Float>("SFD interval [s]", settings, RunSettingsId::RUN_INSITU_SFD_INTERVAL)
+        .setEnabler(enabler(InSituAnalysisEnum::SFD));
+    inSituCat.connect<Float>("Moons interval [s]", settings, RunSettingsId::RUN_INSITU_MOONS_INTERVAL)
+        .setEnabler(enabler(InSituAnalysisEnum::MOONS));
+    inSituCat.connect<Float>("Tumblers interval [s]", settings, RunSettingsId::RUN_INSITU_TUMBLERS_INTERVAL)
+        .setEnabler(enabler(InSituAnalysisEnum::TUMBLERS));
 }
 
 
@@ -326,6 +360,7 @@ VirtualSettings SphJob::getSettings() {
     addGravityCategory(connector, settings);
     addOutputCategory(connector, settings, *this);
     addLoggerCategory(connector, settings);
+    addInSituCategory(connector, settings);
 
     return connector;
 }
@@ -559,6 +594,7 @@ VirtualSettings NBodyJob::getSettings() {
         .setEnabler(mergeLimitEnabler);
 
     addLoggerCategory(connector, settings);
+    addInSituCategory(connector, settings);
     addOutputCategory(connector, settings, *this);
     return connector;
 }
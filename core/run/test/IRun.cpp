@@ -1,5 +1,7 @@
 #include "run/IRun.h"
 #include "catch.hpp"
+#include "io/FileManager.h"
+#include "io/FileSystem.h"
 #include "io/Output.h"
 #include "objects/geometry/Domain.h"
 #include "quantities/Storage.h"
@@ -126,3 +128,50 @@ TEST_CASE("Run twice", "[run]") {
         i++;
     }
 }
+
+TEST_CASE("Run integrals", "[run]") {
+    class IntegralsCallbacks : public DummyCallbacks {
+    public:
+        Size integralsCnt = 0;
+        Size potentialCnt = 0;
+
+        virtual void onTimeStep(const Storage& storage, Statistics& stats) override {
+            DummyCallbacks::onTimeStep(storage, stats);
+            if (stats.has(StatisticsId::TOTAL_ENERGY)) {
+                integralsCnt++;
+            }
+            if (stats.getOr<Float>(StatisticsId::POTENTIAL_ENERGY, 0._f) < 0._f) {
+                potentialCnt++;
+            }
+        }
+    };
+
+    class IntegralsRun : public TestRun {
+    public:
+        IntegralsRun(const Path& path, const bool selfGravity) {
+            settings.set(RunSettingsId::RUN_INTEGRALS_ENABLE, true);
+            settings.set(RunSettingsId::RUN_INTEGRALS_NAME, path.string());
+            settings.set(RunSettingsId::RUN_OUTPUT_PATH, String(""));
+            if (selfGravity) {
+                settings.set(RunSettingsId::SPH_SOLVER_FORCES,
+                    ForceEnum::PRESSURE | ForceEnum::SOLID_STRESS | ForceEnum::SELF_GRAVITY);
+            }
+        }
+    };
+
+    RandomPathManager manager;
+    for (bool selfGravity : { false, true }) {
+        const Path path = manager.getPath("txt");
+        IntegralsRun run(path, selfGravity);
+        IntegralsCallbacks callbacks;
+        Storage storage;
+        REQUIRE_NOTHROW(run.run(storage, callbacks));
+        REQUIRE(callbacks.integralsCnt == 10);
+        // the potential energy is saved by the solver, using its own gravity
+        REQUIRE(callbacks.potentialCnt == (selfGravity ? 10 : 0));
+
+        const String content = FileSystem::readFile(path);
+        REQUIRE(split(content, '\n').size() >= 10);
+        REQUIRE(FileSystem::removePath(path));
+    }
+}
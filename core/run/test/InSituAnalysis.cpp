@@ -0,0 +1,220 @@
+#include "run/InSituAnalysis.h"
+#include "catch.hpp"
+#include "io/FileManager.h"
+#include "io/FileSystem.h"
+#include "objects/geometry/Domain.h"
+#include "physics/Constants.h"
+#include "quantities/Quantity.h"
+#include "quantities/Storage.h"
+#include "sph/initial/Initial.h"
+#include "tests/Approx.h"
+#include "tests/Setup.h"
+#include "thread/Pool.h"
+
+using namespace Sph;
+
+namespace {
+
+struct Record {
+    Float time;
+    Size particleCnt;
+    Float sumX;
+    bool hasVelocities;
+};
+
+class RecordingAnalysis : public IInSituAnalysis {
+private:
+    Array<Record>& records;
+
+public:
+    explicit RecordingAnalysis(Array<Record>& records)
+        : records(records) {}
+
+    virtual Array<QuantityId> getRequiredQuantities() const override {
+        return { QuantityId::POSITION, QuantityId::MASS };
+    }
+
+    virtual void analyze(IScheduler& UNUSED(scheduler),
+        const Storage& snapshot,
+        const Statistics& stats) override {
+        ArrayView<const Vector> r = snapshot.getValue<Vector>(QuantityId::POSITION);
+        Float sumX = 0._f;
+        for (Size i = 0; i < r.size(); ++i) {
+            sumX += r[i][X];
+        }
+        records.push(Record{ stats.get<Float>(StatisticsId::RUN_TIME),
+            snapshot.getParticleCnt(),
+            sumX,
+            snapshot.getDt<Vector>(QuantityId::POSITION).size() == r.size() });
+    }
+};
+
+} // namespace
+
+TEST_CASE("InSituAnalysisTrigger", "[run]") {
+    Storage storage = Tests::getGassStorage(1000);
+    Array<Record> records;
+    Array<AutoPtr<IInSituAnalysis>> analyses;
+    analyses.push(makeAuto<RecordingAnalysis>(records));
+    InSituAnalysisTrigger trigger(std::move(analyses), makeShared<ThreadPool>(2), 0.3_f);
+
+    Array<Float> expectedSums;
+    Statistics stats;
+    ArrayView<Vector> r = storage.getValue<Vector>(QuantityId::POSITION);
+    for (Float t = 0._f; t < 2._f; t += 0.25_f) {
+        stats.set(StatisticsId::RUN_TIME, t);
+        if (trigger.condition(storage, stats)) {
+            Float sumX = 0._f;
+            for (Size i = 0; i < r.size(); ++i) {
+                sumX += r[i][X];
+            }
+            expectedSums.push(sumX);
+            REQUIRE_FALSE(trigger.action(storage, stats));
+        }
+        // modify the particles while the analysis is (possibly) running
+        for (Size i = 0; i < r.size(); ++i) {
+            r[i][X] += 1._f;
+        }
+    }
+    trigger.wait();
+
+    // triggered at t = 0.5, 1, 1.5
+    REQUIRE(records.size() == 3);
+    REQUIRE(expectedSums.size() == records.size());
+    for (Size i = 0; i < records.size(); ++i) {
+        REQUIRE(records[i].time == 0.5_f * (i + 1));
+        REQUIRE(records[i].particleCnt == storage.getParticleCnt());
+        REQUIRE(records[i].sumX == approx(expectedSums[i]));
+        REQUIRE(records[i].hasVelocities);
+    }
+}
+
+TEST_CASE("ComponentsAnalysis", "[run]") {
+    Storage storage;
+    InitialConditions conds(RunSettings::getDefaults());
+    BodySettings body;
+    body.set(BodySettingsId::PARTICLE_COUNT, 1000);
+    conds.addMonolithicBody(storage, SphericalDomain(Vector(0._f), 2._f), body);
+    body.set(BodySettingsId::PARTICLE_COUNT, 100);
+    conds.addMonolithicBody(storage, SphericalDomain(Vector(10._f, 0._f, 0._f), 1._f), body)
+        .addVelocity(Vector(0._f, 3._f, 0._f));
+
+    RandomPathManager manager;
+    const Path path = manager.getPath();
+    Array<AutoPtr<IInSituAnalysis>> analyses;
+    analyses.push(makeAuto<ComponentsAnalysis>(Path(path.string() + "_%d.txt")));
+    InSituAnalysisTrigger trigger(std::move(analyses), SequentialScheduler::getGlobalInstance(), 1._f);
+
+    Statistics stats;
+    stats.set(StatisticsId::RUN_TIME, 1.5_f);
+    REQUIRE(trigger.condition(storage, stats));
+    trigger.action(storage, stats);
+    trigger.wait();
+
+    const Path outputPath(path.string() + "_0000.txt");
+    REQUIRE(FileSystem::pathExists(outputPath));
+    Array<String> lines = split(FileSystem::readFile(outputPath), '\n');
+    Array<String> components;
+    for (const String& line : lines) {
+        if (!line.empty() && line[0] != '#') {
+            components.push(line);
+        }
+    }
+    REQUIRE(components.size() == 2);
+
+    // sorted by mass, first column is the particle count
+    ArrayView<const Size> flags = storage.getValue<Size>(QuantityId::FLAG);
+    const Size largerCnt = std::count(flags.begin(), flags.end(), 0);
+    const Size smallerCnt = std::count(flags.begin(), flags.end(), 1);
+    REQUIRE(fromString<int>(split(components[0], ' ')[0]).value() == largerCnt);
+    REQUIRE(fromString<int>(split(components[1], ' ')[0]).value() == smallerCnt);
+}
+
+static Array<String> readDataLines(const Path& path) {
+    Array<String> data;
+    for (const String& line : split(FileSystem::readFile(path), '\n')) {
+        if (!line.empty() && line[0] != '#') {
+            data.push(line);
+        }
+    }
+    return data;
+}
+
+TEST_CASE("MoonsAnalysis", "[run]") {
+    // central body, a satellite on circular orbit and an escaping body
+    const Float M = 1.e20_f;
+    const Float a = 1.e6_f;
+    const Float v_circ = sqrt(Constants::gravity * M / a);
+    Storage storage;
+    storage.insert<Vector>(QuantityId::POSITION,
+        OrderEnum::SECOND,
+        Array<Vector>{ Vector(0._f, 0._f, 0._f, 1.e4_f),
+            Vector(a, 0._f, 0._f, 1.e3_f),
+            Vector(-a, 0._f, 0._f, 1.e3_f) });
+    storage.getDt<Vector>(QuantityId::POSITION) =
+        Array<Vector>{ Vector(0._f), Vector(0._f, v_circ, 0._f), Vector(0._f, -5._f * v_circ, 0._f) };
+    storage.insert<Float>(QuantityId::MASS, OrderEnum::ZERO, Array<Float>{ M, 1.e10_f, 1.e10_f });
+
+    RandomPathManager manager;
+    const Path path = manager.getPath();
+    Array<AutoPtr<IInSituAnalysis>> analyses;
+    analyses.push(makeAuto<MoonsAnalysis>(Path(path.string() + "_%d.txt")));
+    InSituAnalysisTrigger trigger(std::move(analyses), makeShared<ThreadPool>(1), 1._f);
+
+    Statistics stats;
+    stats.set(StatisticsId::RUN_TIME, 1.5_f);
+    REQUIRE(trigger.condition(storage, stats));
+    trigger.action(storage, stats);
+    trigger.wait();
+
+    Array<String> moons = readDataLines(Path(path.string() + "_0000.txt"));
+    REQUIRE(moons.size() == 1);
+    REQUIRE(fromString<int>(split(moons[0], ' ')[0]).value() == 1);
+}
+
+TEST_CASE("TumblersAnalysis", "[run]") {
+    Storage storage;
+    storage.insert<Vector>(QuantityId::POSITION,
+        OrderEnum::SECOND,
+        Array<Vector>{ Vector(0._f, 0._f, 0._f, 1._f), Vector(5._f, 0._f, 0._f, 1._f) });
+    storage.insert<Float>(QuantityId::MASS, OrderEnum::ZERO, 1._f);
+
+    RandomPathManager manager;
+    const Path path = manager.getPath();
+    Array<AutoPtr<IInSituAnalysis>> analyses;
+    analyses.push(makeAuto<TumblersAnalysis>(Path(path.string() + "_%d.txt")));
+    InSituAnalysisTrigger trigger(std::move(analyses), SequentialScheduler::getGlobalInstance(), 1._f);
+    Statistics stats;
+    stats.set(StatisticsId::RUN_TIME, 1.5_f);
+
+    // no rotation, nothing written
+    trigger.action(storage, stats);
+    trigger.wait();
+    REQUIRE_FALSE(FileSystem::pathExists(Path(path.string() + "_0000.txt")));
+
+    // rotation around a principal axis and around a tilted axis
+    storage.insert<Vector>(QuantityId::ANGULAR_FREQUENCY,
+        OrderEnum::ZERO,
+        Array<Vector>{ Vector(0._f, 0._f, 1._f), Vector(1._f, 0._f, 1._f) });
+    storage.insert<SymmetricTensor>(QuantityId::MOMENT_OF_INERTIA,
+        OrderEnum::ZERO,
+        SymmetricTensor(Vector(1._f, 2._f, 3._f), Vector(0._f)));
+    trigger.action(storage, stats);
+    trigger.wait();
+    Array<String> tumblers = readDataLines(Path(path.string() + "_0000.txt"));
+    REQUIRE(tumblers.size() == 1);
+    REQUIRE(fromString<int>(split(tumblers[0], ' ')[0]).value() == 1);
+}
+
+TEST_CASE("InSituAnalysis from settings", "[run]") {
+    RunSettings settings;
+    REQUIRE(getInSituAnalysisTriggers(settings, SequentialScheduler::getGlobalInstance()).empty());
+
+    settings.set(RunSettingsId::RUN_INSITU_ANALYSES,
+        InSituAnalysisEnum::COMPONENTS | InSituAnalysisEnum::SFD | InSituAnalysisEnum::MOONS);
+    settings.set(RunSettingsId::RUN_INSITU_COMPONENTS_INTERVAL, 10._f);
+    settings.set(RunSettingsId::RUN_INSITU_SFD_INTERVAL, 10._f);
+    settings.set(RunSettingsId::RUN_INSITU_MOONS_INTERVAL, 20._f);
+    // analyses with the same period share the trigger
+    REQUIRE(getInSituAnalysisTriggers(settings, SequentialScheduler::getGlobalInstance()).size() == 2);
+}
@@ -50,11 +50,11 @@ void EosMaterial::initialize(IScheduler& scheduler, Storage& storage, const Inde
     ArrayView<Float> rho, u, p, cs;
     tie(rho, u, p, cs) = storage.getValues<Float>(
         QuantityId::DENSITY, QuantityId::ENERGY, QuantityId::PRESSURE, QuantityId::SOUND_SPEED);
-    parallelFor(scheduler, sequence, [&](const Size i) INL {
-        /// \todo now we can easily pass sequence into the EoS and iterate inside, to avoid calling
-        /// virtual function (and we could also optimize with SSE)
-        tie(p[i], cs[i]) = eos->evaluate(rho[i], u[i]);
-    });
+    const Size granularity = scheduler.getRecommendedGranularity();
+    scheduler.parallelFor(
+        *sequence.begin(), *sequence.end(), granularity, [&](const Size n1, const Size n2) {
+            eos->evaluateRange(rho, u, p, cs, IndexSequence(n1, n2));
+        });
 }
 
 SolidMaterial::SolidMaterial(const BodySettings& body, AutoPtr<IEos>&& eos, AutoPtr<IRheology>&& rheology)
@@ -71,11 +71,29 @@ void SolidMaterial::create(Storage& storage, const MaterialInitialContext& conte
     rheology->create(storage, *this, context);
 }
 
+/// Number of particles processed by the equation of state and the rheology at once, chosen so that the
+/// accessed quantities of the block fit into L2 cache.
+constexpr Size CONSTITUTIVE_BLOCK_SIZE = 1024;
+
 void SolidMaterial::initialize(IScheduler& scheduler, Storage& storage, const IndexSequence sequence) {
     VERBOSE_LOG
 
-    EosMaterial::initialize(scheduler, storage, sequence);
-    rheology->initialize(scheduler, storage, MaterialView(this, sequence));
+    // Evaluates the pressure and applies the yielding in a single pass; the rheology reads the pressure
+    // computed by the EoS while the block is still in cache.
+    ArrayView<Float> rho, u, p, cs;
+    tie(rho, u, p, cs) = storage.getValues<Float>(
+        QuantityId::DENSITY, QuantityId::ENERGY, QuantityId::PRESSURE, QuantityId::SOUND_SPEED);
+    const IEos& eos = this->getEos();
+    const MaterialView material(this, sequence);
+    const Size granularity = max(scheduler.getRecommendedGranularity(), CONSTITUTIVE_BLOCK_SIZE);
+    scheduler.parallelFor(
+        *sequence.begin(), *sequence.end(), granularity, [&](const Size n1, const Size n2) {
+            for (Size from = n1; from < n2; from += CONSTITUTIVE_BLOCK_SIZE) {
+                const IndexSequence block(from, min(from + CONSTITUTIVE_BLOCK_SIZE, n2));
+                eos.evaluateRange(rho, u, p, cs, block);
+                rheology->initializeBlock(storage, material, block);
+            }
+        });
 }
 
 void SolidMaterial::finalize(IScheduler& scheduler, Storage& storage, const IndexSequence sequence) {
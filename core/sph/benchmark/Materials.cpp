@@ -0,0 +1,42 @@
+#include "sph/Materials.h"
+#include "bench/Session.h"
+#include "math/rng/Rng.h"
+#include "quantities/Quantity.h"
+#include "quantities/Storage.h"
+#include "tests/Setup.h"
+#include "thread/Tbb.h"
+
+using namespace Sph;
+
+static void benchmarkMaterial(const MaterialEnum type, Benchmark::Context& context) {
+    Tbb& tbb = *Tbb::getGlobalInstance();
+    AutoPtr<IMaterial> reference = getMaterial(type);
+    Storage storage = Tests::getSolidStorage(1000000, reference->getParams(), 1.e3_f);
+
+    // perturb the state, so that particles end up in different phases of the EoS and some are yielding
+    UniformRng rng;
+    const Float rho0 = reference->getParam<Float>(BodySettingsId::DENSITY);
+    const Float u_cv = reference->getParam<Float>(BodySettingsId::TILLOTSON_ENERGY_CV);
+    ArrayView<Float> rho = storage.getValue<Float>(QuantityId::DENSITY);
+    ArrayView<Float> u = storage.getValue<Float>(QuantityId::ENERGY);
+    ArrayView<TracelessTensor> S = storage.getValue<TracelessTensor>(QuantityId::DEVIATORIC_STRESS);
+    for (Size i = 0; i < storage.getParticleCnt(); ++i) {
+        rho[i] = rho0 * (0.8_f + 0.4_f * rng());
+        u[i] = 2._f * u_cv * rng();
+        S[i] = 1.e8_f * TracelessTensor(rng() - 0.5_f, rng() - 0.5_f, rng() - 0.5_f, rng(), rng());
+    }
+
+    MaterialView material = storage.getMaterial(0);
+    while (context.running()) {
+        material->initialize(tbb, storage, material.sequence());
+        material->finalize(tbb, storage, material.sequence());
+    }
+}
+
+BENCHMARK("SolidMaterial basalt", "[materials]", Benchmark::Context& context) {
+    benchmarkMaterial(MaterialEnum::BASALT, context);
+}
+
+BENCHMARK("SolidMaterial ice", "[materials]", Benchmark::Context& context) {
+    benchmarkMaterial(MaterialEnum::ICE, context);
+}
@@ -36,12 +36,17 @@ template void Accumulated::insert<SymmetricTensor>(const QuantityId, const Order
 template void Accumulated::insert<TracelessTensor>(const QuantityId, const OrderEnum, const BufferSource);
 
 void Accumulated::initialize(const Size size) {
+    this->initialize(SEQUENTIAL, size);
+}
+
+void Accumulated::initialize(IScheduler& scheduler, const Size size) {
     for (Element& e : buffers) {
-        forValue(e.buffer, [size](auto& values) {
+        forValue(e.buffer, [&scheduler, size](auto& values) {
             using T = typename std::decay_t<decltype(values)>::Type;
             if (values.size() != size) {
-                values.resize(size);
-                values.fill(T(0._f));
+                // allocate a new buffer instead of resizing, the memory is first touched by the parallel loop
+                values = Array<T>(size);
+                parallelFor(scheduler, 0, size, [&values](const Size i) { values[i] = T(0._f); });
             } else {
                 // check that the array is really cleared
                 SPH_ASSERT(std::count(values.begin(), values.end(), T(0._f)) == values.size());
@@ -69,7 +69,12 @@ public:
 
     /// \brief Initialize all storages.
     ///
-    /// Storages are resized if needed and cleared out of all previously accumulated values.
+    /// Storages are resized if needed and cleared out of all previously accumulated values. Newly allocated
+    /// buffers are cleared in parallel, using the same partition of particles as parallel loops of the
+    /// solvers, so that memory pages of the buffers are placed close to the threads on NUMA systems.
+    void initialize(IScheduler& scheduler, const Size size);
+
+    /// \brief Initialize all storages, clearing newly allocated buffers sequentially.
     void initialize(const Size size);
 
     /// \brief Returns the buffer of given quantity and given order.
@@ -2,6 +2,7 @@
 #include "objects/Exceptions.h"
 #include "objects/containers/FlatMap.h"
 #include "quantities/Quantity.h"
+#include "thread/Scheduler.h"
 
 NAMESPACE_SPH_BEGIN
 
@@ -94,6 +95,10 @@ void DerivativeHolder::require(AutoPtr<IDerivative>&& derivative) {
 }
 
 void DerivativeHolder::initialize(const Storage& input) {
+    this->initialize(SEQUENTIAL, input);
+}
+
+void DerivativeHolder::initialize(IScheduler& scheduler, const Storage& input) {
     if (needsCreate) {
         // lazy buffer creation
         for (const auto& deriv : derivatives) {
@@ -102,7 +107,7 @@ void DerivativeHolder::initialize(const Storage& input) {
         needsCreate = false;
     }
     // initialize buffers first, possibly resizing then and invalidating previously stored arrayviews
-    accumulated.initialize(input.getParticleCnt());
+    accumulated.initialize(scheduler, input.getParticleCnt());
 
     for (const auto& deriv : derivatives) {
         // then get the arrayviews for derivatives
@@ -205,7 +205,13 @@ public:
     virtual void require(AutoPtr<IDerivative>&& derivative);
 
     /// \brief Initialize derivatives before loop.
-    virtual void initialize(const Storage& input);
+    ///
+    /// \param scheduler Scheduler used to clear the accumulated buffers.
+    /// \param input Storage containing all the input quantities from which derivatives are computed.
+    virtual void initialize(IScheduler& scheduler, const Storage& input);
+
+    /// \brief Initialize derivatives before loop, clearing the accumulated buffers sequentially.
+    void initialize(const Storage& input);
 
     /// \brief Evaluates all held derivatives for given particle.
     void eval(const Size idx, ArrayView<const Size> neighs, ArrayView<const Vector> grads);
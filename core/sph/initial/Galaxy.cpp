@@ -85,6 +85,23 @@ INLINE Float bulgePdf(const Float r, const Float a) {
     return r / (sqr(a) * pow<3>(1._f + r / a));
 }
 
+/// Quantities sampled from random streams, each using different streams of the particles
+enum class SampledEnum {
+    POSITION,
+    VELOCITY,
+};
+
+/// \brief Returns the random number generator of given particle.
+///
+/// Each particle has its own stream of random numbers, so the particles can be sampled in parallel and the
+/// result does not depend on the number of threads.
+INLINE CounterRng getParticleRng(const int seed,
+    const Galaxy::PartEnum part,
+    const SampledEnum sampled,
+    const Size idx) {
+    return CounterRng(seed, (uint64_t(sampled) << 40) | (uint64_t(part) << 32) | uint64_t(idx));
+}
+
 static Float getEpicyclicFrequency(IGravity& gravity, const Vector& r, const Vector& dv1, const Float dr) {
     const Float radius = sqrt(sqr(r[X]) + sqr(r[Y])) + EPS;
     const Vector dv2 = gravity.evalAcceleration(r * (1._f + dr));
@@ -96,10 +113,9 @@ static Float getEpicyclicFrequency(IGravity& gravity, const Vector& r, const Vec
     return sqrt(abs(k2));
 }
 
-Storage Galaxy::generateDisk(UniformRng& rng, const GalaxySettings& settings) {
+Storage Galaxy::generateDisk(IScheduler& scheduler, const int seed, const GalaxySettings& settings) {
     MEASURE_SCOPE("Galaxy::generateDisk");
 
-    Array<Vector> positions;
     const Size n_disk = settings.get<int>(GalaxySettingsId::DISK_PARTICLE_COUNT);
     const Float r_cutoff = settings.get<Float>(GalaxySettingsId::DISK_RADIAL_CUTOFF);
     const Float r0 = settings.get<Float>(GalaxySettingsId::DISK_RADIAL_SCALE);
@@ -116,7 +132,9 @@ Storage Galaxy::generateDisk(UniformRng& rng, const GalaxySettings& settings) {
     // vertical pdf is maximal at z = 0
     const Float maxVerticalPdf = diskVerticalPdf(0, z0);
 
-    for (Size i = 0; i < n_disk; ++i) {
+    Array<Vector> positions(n_disk);
+    parallelFor(scheduler, 0, n_disk, [&](const Size i) {
+        CounterRng rng = getParticleRng(seed, PartEnum::DISK, SampledEnum::POSITION, i);
         const Float r = sampleDistribution(
             rng, radialRange, maxSurfacePdf, [r0](const Float x) { return diskSurfacePdf(x, r0); });
 
@@ -127,9 +145,8 @@ Storage Galaxy::generateDisk(UniformRng& rng, const GalaxySettings& settings) {
 
         Vector pos = cylindricalToCartesian(r, phi, z);
         pos[H] = h;
-        positions.push(pos);
-    }
-
+        positions[i] = pos;
+    });
 
     const Float m_disk = settings.get<Float>(GalaxySettingsId::DISK_MASS);
     const Float m = m_disk / n_disk;
@@ -141,7 +158,7 @@ Storage Galaxy::generateDisk(UniformRng& rng, const GalaxySettings& settings) {
     return storage;
 }
 
-Storage Galaxy::generateHalo(UniformRng& rng, const GalaxySettings& settings) {
+Storage Galaxy::generateHalo(IScheduler& scheduler, const int seed, const GalaxySettings& settings) {
     MEASURE_SCOPE("Galaxy::generateHalo");
 
     const Size n_halo = settings.get<int>(GalaxySettingsId::HALO_PARTICLE_COUNT);
@@ -156,16 +173,17 @@ Storage Galaxy::generateHalo(UniformRng& rng, const GalaxySettings& settings) {
 
     const Float maxPdf = maxHaloPdf(r0, g0);
 
-    Array<Vector> positions;
-    for (Size i = 0; i < n_halo; ++i) {
+    Array<Vector> positions(n_halo);
+    parallelFor(scheduler, 0, n_halo, [&](const Size i) {
+        CounterRng rng = getParticleRng(seed, PartEnum::HALO, SampledEnum::POSITION, i);
         const Float r = sampleDistribution(rng, range, maxPdf, [r0, g0](const Float x) { //
             return haloPdf(x, r0, g0);
         });
 
         Vector pos = sampleUnitSphere(rng) * r;
         pos[H] = h;
-        positions.push(pos);
-    }
+        positions[i] = pos;
+    });
 
     const Float m_halo = settings.get<Float>(GalaxySettingsId::HALO_MASS);
     const Float m = m_halo / n_halo;
@@ -177,7 +195,7 @@ Storage Galaxy::generateHalo(UniformRng& rng, const GalaxySettings& settings) {
     return storage;
 }
 
-Storage Galaxy::generateBulge(UniformRng& rng, const GalaxySettings& settings) {
+Storage Galaxy::generateBulge(IScheduler& scheduler, const int seed, const GalaxySettings& settings) {
     MEASURE_SCOPE("Galaxy::generateBulge");
 
     const Size n_bulge = settings.get<int>(GalaxySettingsId::BULGE_PARTICLE_COUNT);
@@ -192,14 +210,15 @@ Storage Galaxy::generateBulge(UniformRng& rng, const GalaxySettings& settings) {
     // PDF is maximal at x=a/2
     const Float maxPdf = bulgePdf(0.5_f * a, a);
 
-    Array<Vector> positions;
-    for (Size i = 0; i < n_bulge; ++i) {
+    Array<Vector> positions(n_bulge);
+    parallelFor(scheduler, 0, n_bulge, [&](const Size i) {
+        CounterRng rng = getParticleRng(seed, PartEnum::BULGE, SampledEnum::POSITION, i);
         const Float r = sampleDistribution(rng, range, maxPdf, [a](const Float x) { return bulgePdf(x, a); });
 
         Vector pos = sampleUnitSphere(rng) * r;
         pos[H] = h;
-        positions.push(pos);
-    }
+        positions[i] = pos;
+    });
 
     const Float m_bulge = settings.get<Float>(GalaxySettingsId::BULGE_MASS);
     const Float m = m_bulge / n_bulge;
@@ -252,7 +271,7 @@ static IndexSequence getPartSequence(const Storage& storage, const Galaxy::PartE
 }
 
 static void computeDiskVelocities(IScheduler& scheduler,
-    UniformRng& rng,
+    const int seed,
     const GalaxySettings& settings,
     Storage& storage) {
     MEASURE_SCOPE("computeDiskVelocities");
@@ -282,12 +301,24 @@ static void computeDiskVelocities(IScheduler& scheduler,
     Float sigma = 0._f;
     Size count = 0;
     Float annulus = dr;
+    const Size first = *sequence.begin();
+    Array<Float> sigmas(sequence.size());
     while (count == 0._f) {
-        for (Size i : sequence) {
+        auto isInAnnulus = [&](const Size i) {
             const Float radius = sqrt(sqr(r[i][X]) + sqr(r[i][Y]));
-            if (abs(radius - r_ref) < annulus) {
+            return abs(radius - r_ref) < annulus;
+        };
+        // evaluate the accelerations in parallel, but sum up the values in fixed order
+        parallelFor(scheduler, sequence, [&](const Size i) {
+            if (isInAnnulus(i)) {
+                const Float radius = sqrt(sqr(r[i][X]) + sqr(r[i][Y]));
                 const Float kappa = getEpicyclicFrequency(gravity, r[i], dv[i], 0.05_f * annulus);
-                sigma += 3.36_f * diskSurfaceDensity(radius, r0, m_disk) / kappa;
+                sigmas[i - first] = 3.36_f * diskSurfaceDensity(radius, r0, m_disk) / kappa;
+            }
+        });
+        for (Size i : sequence) {
+            if (isInAnnulus(i)) {
+                sigma += sigmas[i - first];
                 count++;
             }
         }
@@ -302,6 +333,7 @@ static void computeDiskVelocities(IScheduler& scheduler,
     SPH_ASSERT(A >= 0._f, A);
 
     parallelFor(scheduler, sequence, [&](const Size i) {
+        CounterRng rng = getParticleRng(seed, Galaxy::PartEnum::DISK, SampledEnum::VELOCITY, i - first);
         const Float radius = sqrt(sqr(r[i][X]) + sqr(r[i][Y]));
         const Float vz2 = PI * z0 * diskSurfaceDensity(sqrt(sqr(radius) + 2._f * sqr(as)), r0, m_disk);
         const Float vz = sampleNormalDistribution(rng, 0._f, vz2);
@@ -339,7 +371,8 @@ static void computeDiskVelocities(IScheduler& scheduler,
 }
 
 template <typename TFunc>
-static void computeSphericalVelocities(UniformRng& rng,
+static void computeSphericalVelocities(IScheduler& scheduler,
+    const int seed,
     ArrayView<const Pair<Float>> massDist,
     const Galaxy::PartEnum partId,
     Storage& storage,
@@ -349,18 +382,23 @@ static void computeSphericalVelocities(UniformRng& rng,
     ArrayView<const Vector> r = storage.getValue<Vector>(QuantityId::POSITION);
     ArrayView<Vector> v = storage.getDt<Vector>(QuantityId::POSITION);
 
+    // precompute the integrals from each bin to the cutoff
+    Array<Float> integrals(massDist.size() + 1);
+    integrals[massDist.size()] = 0._f;
+    for (Size binIdx = massDist.size(); binIdx-- > 0;) {
+        integrals[binIdx] = integrals[binIdx + 1] + func(massDist[binIdx][0]) * dr * massDist[binIdx][1];
+    }
+
     const IndexSequence sequence = getPartSequence(storage, partId);
-    for (Size i : sequence) {
+    const Size first = *sequence.begin();
+    parallelFor(scheduler, sequence, [&](const Size i) {
+        CounterRng rng = getParticleRng(seed, partId, SampledEnum::VELOCITY, i - first);
         const Float radius = getLength(r[i]);
         const Size firstBin = Size(radius / dr);
 
         const Float v_esc = sqrt(2._f * massDist[firstBin][1] / radius);
 
-        Float vr2 = 0._f;
-        for (Size binIdx = firstBin; binIdx < massDist.size(); ++binIdx) {
-            vr2 += func(massDist[binIdx][0]) * dr * massDist[binIdx][1];
-        }
-        vr2 /= func(radius) / sqr(radius);
+        const Float vr2 = integrals[firstBin] / (func(radius) / sqr(radius));
 
         const Interval range(0._f, 0.95_f * v_esc);
         const Float maxPdf = velocityPdf(sqrt(2._f * vr2), vr2);
@@ -370,10 +408,11 @@ static void computeSphericalVelocities(UniformRng& rng,
         });
 
         v[i] = sampleUnitSphere(rng) * u;
-    }
+    });
 }
 
-static void computeHaloVelocities(UniformRng& rng,
+static void computeHaloVelocities(IScheduler& scheduler,
+    const int seed,
     const GalaxySettings& settings,
     ArrayView<const Pair<Float>> massDist,
     Storage& storage) {
@@ -382,12 +421,14 @@ static void computeHaloVelocities(UniformRng& rng,
     const Float r0 = settings.get<Float>(GalaxySettingsId::HALO_SCALE_LENGTH);
     const Float g0 = settings.get<Float>(GalaxySettingsId::HALO_GAMMA);
 
-    computeSphericalVelocities(rng, massDist, Galaxy::PartEnum::HALO, storage, [r0, g0](const Float x) { //
-        return haloPdf(x, r0, g0);
-    });
+    computeSphericalVelocities(
+        scheduler, seed, massDist, Galaxy::PartEnum::HALO, storage, [r0, g0](const Float x) { //
+            return haloPdf(x, r0, g0);
+        });
 }
 
-static void computeBulgeVelocities(UniformRng& rng,
+static void computeBulgeVelocities(IScheduler& scheduler,
+    const int seed,
     const GalaxySettings& settings,
     ArrayView<const Pair<Float>> massDist,
     Storage& storage) {
@@ -395,9 +436,10 @@ static void computeBulgeVelocities(UniformRng& rng,
 
     const Float a = settings.get<Float>(GalaxySettingsId::BULGE_SCALE_LENGTH);
 
-    computeSphericalVelocities(rng, massDist, Galaxy::PartEnum::BULGE, storage, [a](const Float x) { //
-        return bulgePdf(x, a);
-    });
+    computeSphericalVelocities(
+        scheduler, seed, massDist, Galaxy::PartEnum::BULGE, storage, [a](const Float x) { //
+            return bulgePdf(x, a);
+        });
 }
 
 class StorageBuilder {
@@ -432,18 +474,17 @@ Storage Galaxy::generateIc(const RunSettings& globals,
     const GalaxySettings& settings,
     const IProgressCallbacks& callbacks) {
     const int seed = globals.get<int>(RunSettingsId::RUN_RNG_SEED);
-    UniformRng rng(seed);
     SharedPtr<IScheduler> scheduler = Factory::getScheduler(globals);
 
     StorageBuilder builder(callbacks);
-    builder->merge(generateDisk(rng, settings));
-    builder->merge(generateHalo(rng, settings));
-    builder->merge(generateBulge(rng, settings));
+    builder->merge(generateDisk(*scheduler, seed, settings));
+    builder->merge(generateHalo(*scheduler, seed, settings));
+    builder->merge(generateBulge(*scheduler, seed, settings));
 
     Array<Pair<Float>> massDist = computeCumulativeMass(settings, *builder);
-    computeDiskVelocities(*scheduler, rng, settings, *builder);
-    computeHaloVelocities(rng, settings, massDist, *builder);
-    computeBulgeVelocities(rng, settings, massDist, *builder);
+    computeDiskVelocities(*scheduler, seed, settings, *builder);
+    computeHaloVelocities(*scheduler, seed, settings, massDist, *builder);
+    computeBulgeVelocities(*scheduler, seed, settings, massDist, *builder);
 
     Storage storage = std::move(builder).release();
     ArrayView<const Size> flag = storage.getValue<Size>(QuantityId::FLAG);
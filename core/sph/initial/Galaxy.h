@@ -11,7 +11,7 @@
 NAMESPACE_SPH_BEGIN
 
 class IGravity;
-class UniformRng;
+class IScheduler;
 
 enum class GalaxySettingsId {
     DISK_PARTICLE_COUNT,
@@ -47,11 +47,17 @@ enum class PartEnum {
     BULGE,
 };
 
-Storage generateDisk(UniformRng& rng, const GalaxySettings& settings);
+/// \brief Generates particles of the galaxy disk.
+///
+/// Particles are sampled in parallel, each particle using a separate random stream given by the seed and the
+/// particle index, so the result does not depend on the number of threads.
+Storage generateDisk(IScheduler& scheduler, const int seed, const GalaxySettings& settings);
 
-Storage generateHalo(UniformRng& rng, const GalaxySettings& settings);
+/// \brief Generates particles of the galaxy halo, see \ref generateDisk.
+Storage generateHalo(IScheduler& scheduler, const int seed, const GalaxySettings& settings);
 
-Storage generateBulge(UniformRng& rng, const GalaxySettings& settings);
+/// \brief Generates particles of the galaxy bulge, see \ref generateDisk.
+Storage generateBulge(IScheduler& scheduler, const int seed, const GalaxySettings& settings);
 
 struct IProgressCallbacks : public Polymorphic {
     /// \brief Called when computing new part of the galaxy (particle positions or velocities).
@@ -0,0 +1,64 @@
+#include "sph/initial/Galaxy.h"
+#include "catch.hpp"
+#include "quantities/Quantity.h"
+#include "quantities/Storage.h"
+#include "system/Settings.impl.h"
+#include "tests/Approx.h"
+#include "utils/Utils.h"
+
+using namespace Sph;
+
+static GalaxySettings getGalaxySettings() {
+    GalaxySettings settings;
+    settings.set(GalaxySettingsId::DISK_PARTICLE_COUNT, 2000)
+        .set(GalaxySettingsId::HALO_PARTICLE_COUNT, 1000)
+        .set(GalaxySettingsId::BULGE_PARTICLE_COUNT, 500);
+    return settings;
+}
+
+TEST_CASE("Galaxy generateIc", "[galaxy]") {
+    RunSettings globals;
+    Storage storage = Galaxy::generateIc(globals, getGalaxySettings(), Galaxy::NullProgressCallbacks{});
+    REQUIRE(storage.getParticleCnt() == 3500);
+
+    ArrayView<const Size> flag = storage.getValue<Size>(QuantityId::FLAG);
+    REQUIRE(std::count(flag.begin(), flag.end(), Size(Galaxy::PartEnum::DISK)) == 2000);
+    REQUIRE(std::count(flag.begin(), flag.end(), Size(Galaxy::PartEnum::HALO)) == 1000);
+    REQUIRE(std::count(flag.begin(), flag.end(), Size(Galaxy::PartEnum::BULGE)) == 500);
+
+    const GalaxySettings settings = getGalaxySettings();
+    ArrayView<const Vector> r = storage.getValue<Vector>(QuantityId::POSITION);
+    ArrayView<const Vector> v = storage.getDt<Vector>(QuantityId::POSITION);
+    for (Size i = 0; i < r.size(); ++i) {
+        REQUIRE(isReal(r[i]));
+        REQUIRE(isReal(v[i]));
+        if (flag[i] == Size(Galaxy::PartEnum::DISK)) {
+            REQUIRE(abs(r[i][Z]) <= settings.get<Float>(GalaxySettingsId::DISK_VERTICAL_CUTOFF));
+        }
+    }
+    REQUIRE(getLength(v[0]) > 0._f);
+}
+
+TEST_CASE("Galaxy generateIc deterministic", "[galaxy]") {
+    RunSettings globals;
+    globals.set(RunSettingsId::RUN_THREAD_CNT, 1);
+    Storage storage1 = Galaxy::generateIc(globals, getGalaxySettings(), Galaxy::NullProgressCallbacks{});
+
+    globals.set(RunSettingsId::RUN_THREAD_CNT, 0).set(RunSettingsId::RUN_THREAD_GRANULARITY, 10);
+    Storage storage2 = Galaxy::generateIc(globals, getGalaxySettings(), Galaxy::NullProgressCallbacks{});
+
+    REQUIRE(storage1.getParticleCnt() == storage2.getParticleCnt());
+    for (OrderEnum order : { OrderEnum::ZERO, OrderEnum::FIRST }) {
+        ArrayView<const Vector> values1 = storage1.getAll<Vector>(QuantityId::POSITION)[int(order)];
+        ArrayView<const Vector> values2 = storage2.getAll<Vector>(QuantityId::POSITION)[int(order)];
+        for (Size i = 0; i < values1.size(); ++i) {
+            REQUIRE(values1[i] == values2[i]);
+        }
+    }
+
+    // different seed gives different galaxy
+    globals.set(RunSettingsId::RUN_RNG_SEED, 4321);
+    Storage storage3 = Galaxy::generateIc(globals, getGalaxySettings(), Galaxy::NullProgressCallbacks{});
+    REQUIRE(storage3.getValue<Vector>(QuantityId::POSITION)[0] !=
+            storage1.getValue<Vector>(QuantityId::POSITION)[0]);
+}
@@ -34,7 +34,8 @@ GravitySolver<TSphSolver>::GravitySolver(IScheduler& scheduler,
     AutoPtr<IBoundaryCondition>&& bc,
     AutoPtr<IGravity>&& gravity)
     : TSphSolver(scheduler, settings, equations, std::move(bc))
-    , gravity(std::move(gravity)) {
+    , gravity(std::move(gravity))
+    , savePotentialEnergy(settings.get<bool>(RunSettingsId::RUN_INTEGRALS_ENABLE)) {
 
     // make sure acceleration are being accumulated
     Accumulated& results = this->derivatives.getAccumulated();
@@ -48,7 +49,8 @@ GravitySolver<SymmetricSolver<DIMENSIONS>>::GravitySolver(IScheduler& scheduler,
     AutoPtr<IBoundaryCondition>&& bc,
     AutoPtr<IGravity>&& gravity)
     : SymmetricSolver<DIMENSIONS>(scheduler, settings, equations, std::move(bc))
-    , gravity(std::move(gravity)) {
+    , gravity(std::move(gravity))
+    , savePotentialEnergy(settings.get<bool>(RunSettingsId::RUN_INTEGRALS_ENABLE)) {
 
     // make sure acceleration are being accumulated
     for (ThreadData& data : threadData) {
@@ -78,6 +80,10 @@ void GravitySolver<TSphSolver>::loop(Storage& storage, Statistics& stats) {
     // evaluate gravity for each particle
     timer.restart();
     gravity->evalSelfGravity(this->scheduler, dv, stats);
+    if (savePotentialEnergy) {
+        // reuse the built tree, so that the logged integrals do not need their own gravity
+        stats.set(StatisticsId::POTENTIAL_ENERGY, gravity->evalEnergy(this->scheduler, stats));
+    }
     stats.set(StatisticsId::GRAVITY_EVAL_TIME, int(timer.elapsed(TimerUnit::MILLISECOND)));
 
     // evaluate gravity of attractors
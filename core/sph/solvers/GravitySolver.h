@@ -24,6 +24,10 @@ private:
     /// Implementation of gravity used by the solver
     AutoPtr<IGravity> gravity;
 
+    /// If true, the potential energy is saved into the statistics every time step, used by
+    /// \ref IntegralsLogWriter
+    bool savePotentialEnergy;
+
 public:
     /// \brief Creates the gravity solver, used implementation of gravity given by settings parameters.
     GravitySolver(IScheduler& scheduler, const RunSettings& settings, const EquationHolder& equations);
@@ -8,6 +8,7 @@
 #include "io/LogWriter.h"
 #include "io/Logger.h"
 #include "io/Output.h"
+#include "io/Sequence.h"
 #include "math/rng/Rng.h"
 #include "objects/Exceptions.h"
 #include "objects/finders/BruteForceFinder.h"
@@ -149,6 +150,11 @@ AutoPtr<ITimeStepping> Factory::getTimeStepping(const RunSettings& settings,
         return makeAuto<ModifiedMidpointMethod>(storage, settings);
     case TimesteppingEnum::RUNGE_KUTTA:
         return makeAuto<RungeKutta>(storage, settings);
+    case TimesteppingEnum::LOW_STORAGE_RK3:
+    case TimesteppingEnum::LOW_STORAGE_RK4:
+        return makeAuto<LowStorageRungeKutta>(storage, settings);
+    case TimesteppingEnum::SSP_RK3:
+        return makeAuto<SspRungeKutta>(storage, settings);
     default:
         NOT_IMPLEMENTED;
     }
@@ -202,17 +208,25 @@ SharedPtr<IScheduler> Factory::getScheduler(const RunSettings& settings) {
         scheduler->setGranularity(granularity);
         return scheduler;
 #else
+        // globals of older projects do not contain the pinning, do not pin the threads in that case
+        const bool pinning = settings.getOr<bool>(RunSettingsId::RUN_THREAD_PINNING, false);
         static WeakPtr<ThreadPool> weakGlobal = ThreadPool::getGlobalInstance();
         if (SharedPtr<ThreadPool> global = weakGlobal.lock()) {
             if (global->getThreadCnt() == threadCnt) {
                 // scheduler is already used by some component and has the same thread count, we can reuse the
                 // instance instead of creating a new one
                 global->setGranularity(granularity);
+                if (pinning) {
+                    global->pinThreads();
+                }
                 return global;
             }
         }
 
         SharedPtr<ThreadPool> newPool = makeShared<ThreadPool>(threadCnt, granularity);
+        if (pinning) {
+            newPool->pinThreads();
+        }
         weakGlobal = newPool;
         return newPool;
 #endif
@@ -365,7 +379,8 @@ AutoPtr<IGravity> Factory::getGravity(const RunSettings& settings) {
         const Size leafSize = settings.get<int>(RunSettingsId::FINDER_LEAF_SIZE);
         const Size maxDepth = settings.get<int>(RunSettingsId::FINDER_MAX_PARALLEL_DEPTH);
         const Float constant = settings.get<Float>(RunSettingsId::GRAVITY_CONSTANT);
-        gravity = makeAuto<BarnesHut>(theta, order, std::move(kernel), leafSize, maxDepth, constant);
+        const bool compact = settings.get<bool>(RunSettingsId::GRAVITY_COMPACT_MOMENTS);
+        gravity = makeAuto<BarnesHut>(theta, order, std::move(kernel), leafSize, maxDepth, constant, compact);
         break;
     }
     default:
@@ -587,12 +602,20 @@ AutoPtr<IOutput> Factory::getOutput(const RunSettings& settings) {
     }
     case IoEnum::BINARY_FILE: {
         const RunTypeEnum runType = settings.get<RunTypeEnum>(RunSettingsId::RUN_TYPE);
+        if (settings.get<bool>(RunSettingsId::RUN_OUTPUT_PARALLEL)) {
+            return makeAuto<ParallelBinaryOutput>(file, getScheduler(settings), runType);
+        }
         return makeAuto<BinaryOutput>(file, runType);
     }
     case IoEnum::DATA_FILE: {
         const RunTypeEnum runType = settings.get<RunTypeEnum>(RunSettingsId::RUN_TYPE);
         return makeAuto<CompressedOutput>(file, CompressionEnum::NONE /*TODO*/, runType);
     }
+    case IoEnum::SEQUENCE_FILE: {
+        const RunTypeEnum runType = settings.get<RunTypeEnum>(RunSettingsId::RUN_TYPE);
+        const Size keyframePeriod = settings.get<int>(RunSettingsId::RUN_OUTPUT_SEQUENCE_KEYFRAME_PERIOD);
+        return makeAuto<SequenceOutput>(file, keyframePeriod, runType);
+    }
     case IoEnum::VTK_FILE: {
         const Flags<OutputQuantityFlag> flags =
             settings.getFlags<OutputQuantityFlag>(RunSettingsId::RUN_OUTPUT_QUANTITIES);
@@ -618,6 +641,8 @@ AutoPtr<IInput> Factory::getInput(const Path& path) {
         return makeAuto<BinaryInput>();
     } else if (ext == "sdf" || ext == "scf") { // .scf is an older extension of this format
         return makeAuto<CompressedInput>();
+    } else if (ext == "ssq") {
+        return makeAuto<SequenceInput>();
     } else if (ext == "h5") {
         return makeAuto<Hdf5Input>();
     } else if (ext == "tab") {
@@ -632,6 +657,16 @@ AutoPtr<IInput> Factory::getInput(const Path& path) {
     throw InvalidSetup("Unknown file type: " + path.string());
 }
 
+AutoPtr<IInput> Factory::getInput(const Path& path, Array<QuantityId>&& quantities) {
+    if (path.extension().string() == "ssf") {
+        BinaryInput::Selection selection;
+        selection.quantities = std::move(quantities);
+        return makeAuto<BinaryInput>(std::move(selection));
+    } else {
+        return getInput(path);
+    }
+}
+
 AutoPtr<IRng> Factory::getRng(const RunSettings& settings) {
     const RngEnum id = settings.get<RngEnum>(RunSettingsId::RUN_RNG);
     const int seed = settings.get<int>(RunSettingsId::RUN_RNG_SEED);
@@ -37,6 +37,7 @@ class IUvMapping;
 class Storage;
 class EquationHolder;
 enum class FinderFlag;
+enum class QuantityId;
 template <Size D>
 class LutKernel;
 class GravityLutKernel;
@@ -56,6 +57,10 @@ AutoPtr<IOutput> getOutput(const RunSettings& settings);
 // deduces format from path extension
 AutoPtr<IInput> getInput(const Path& path);
 
+// deduces format from path extension; binary files are loaded partially, containing only given quantities
+// (all quantities if the array is empty), other formats always load all quantities
+AutoPtr<IInput> getInput(const Path& path, Array<QuantityId>&& quantities);
+
 AutoPtr<IRng> getRng(const RunSettings& settings);
 
 AutoPtr<ISolver> getSolver(IScheduler& scheduler, const RunSettings& settings);
@@ -63,6 +63,15 @@ static RegisterEnum<TimesteppingEnum> sTimestepping({
         "modified_midpoint",
         "Modified midpoint method with constant number of substeps." },
     //{ TimesteppingEnum::BULIRSCH_STOER, "bulirsch_stoer", "Bulirsch-Stoer integrator" },
+    { TimesteppingEnum::LOW_STORAGE_RK3,
+        "low_storage_rk3",
+        "Low-storage Runge-Kutta 3rd-order integration, requiring only one auxiliary buffer per quantity." },
+    { TimesteppingEnum::LOW_STORAGE_RK4,
+        "low_storage_rk4",
+        "Low-storage Runge-Kutta 4th-order integration, requiring only one auxiliary buffer per quantity." },
+    { TimesteppingEnum::SSP_RK3,
+        "ssp_rk3",
+        "Strong stability preserving Runge-Kutta 3rd-order integration." },
 });
 
 static RegisterEnum<TimeStepCriterionEnum> sTimeStepCriterion({
@@ -329,6 +338,11 @@ static RegisterEnum<IoEnum> sIo({
         "miluphcuda. Requires to build the code with libhdf5." },
     { IoEnum::MPCORP_FILE, "mpcorp_file", "Export from Minor Planet Center Orbit Database" },
     { IoEnum::PKDGRAV_INPUT, "pkdgrav_input", "Generate a pkdgrav input file." },
+    { IoEnum::SEQUENCE_FILE,
+        "sequence_file",
+        "Save all dumps into a single file, storing positions and velocities as quantized differences from "
+        "periodic keyframes. Suitable for visualization of runs with many dumps. Cannot be used to continue "
+        "simulation." },
 #ifdef SPH_USE_VDB
     { IoEnum::VDB_FILE, "vdb_file", "Save output data as OpenVDB grid." },
 #endif
@@ -354,6 +368,8 @@ Optional<String> getIoExtension(const IoEnum type) {
         return String("dat");
     case IoEnum::VDB_FILE:
         return String("vdb");
+    case IoEnum::SEQUENCE_FILE:
+        return String("ssq");
     default:
         NOT_IMPLEMENTED;
     }
@@ -376,6 +392,8 @@ Optional<IoEnum> getIoEnum(const String& ext) {
         return IoEnum::MPCORP_FILE;
     } else if (ext == "vdb") {
         return IoEnum::VDB_FILE;
+    } else if (ext == "ssq") {
+        return IoEnum::SEQUENCE_FILE;
     } else {
         return NOTHING;
     }
@@ -401,6 +419,8 @@ String getIoDescription(const IoEnum type) {
         return "mpcorp dump";
     case IoEnum::VDB_FILE:
         return "OpenVDB grid";
+    case IoEnum::SEQUENCE_FILE:
+        return "SPH sequence file";
     default:
         NOT_IMPLEMENTED;
     }
@@ -426,6 +446,8 @@ Flags<IoCapability> getIoCapabilities(const IoEnum type) {
         return IoCapability::INPUT;
     case IoEnum::VDB_FILE:
         return IoCapability::OUTPUT;
+    case IoEnum::SEQUENCE_FILE:
+        return IoCapability::INPUT | IoCapability::OUTPUT;
     default:
         NOT_IMPLEMENTED;
     }
@@ -437,6 +459,13 @@ static RegisterEnum<OutputSpacing> sSpacing({
     { OutputSpacing::CUSTOM, "custom", "User-defined list of output times " },
 });
 
+static RegisterEnum<InSituAnalysisEnum> sInSitu({
+    { InSituAnalysisEnum::COMPONENTS, "components", "Table of components (separated bodies)." },
+    { InSituAnalysisEnum::SFD, "sfd", "Cumulative size-frequency distribution." },
+    { InSituAnalysisEnum::MOONS, "moons", "Potential satellites of the largest body." },
+    { InSituAnalysisEnum::TUMBLERS, "tumblers", "Tumbling bodies." },
+});
+
 static RegisterEnum<RngEnum> sRng({
     { RngEnum::UNIFORM, "uniform", "Mersenne Twister PRNG from Standard library." },
     { RngEnum::HALTON, "halton", "Halton sequence for quasi-random numbers." },
@@ -482,11 +511,21 @@ const RunSettings& getDefaultSettings() {
     { RunSettingsId::RUN_OUTPUT_QUANTITIES, "run.output.quantitites", DEFAULT_QUANTITY_IDS,
         "List of quantities to write to output file. Applicable for text and VTK outputs, binary output always stores "
         "all quantitites. Can be one or more values from:\n" + EnumMap::getDesc<OutputQuantityFlag>() },
+    { RunSettingsId::RUN_OUTPUT_PARALLEL,           "run.output.parallel",      false,
+        "If true, binary output files are written concurrently by all threads. This can considerably speed up "
+        "writing of large files, especially on parallel file systems." },
+    { RunSettingsId::RUN_OUTPUT_SEQUENCE_KEYFRAME_PERIOD, "run.output.sequence.keyframe_period", 20,
+        "Number of frames between two consecutive keyframes of the sequence file. Other frames store "
+        "positions and velocities relative to the keyframe; longer period reduces the file size, but loading "
+        "a frame is slower and the differences are quantized with a lower precision." },
     { RunSettingsId::RUN_THREAD_CNT,                "run.thread.cnt",           0,
         "Number of threads used by the simulation. 0 means all available threads are used." },
     { RunSettingsId::RUN_THREAD_GRANULARITY,        "run.thread.granularity",   1000,
         "Number of particles processed by one thread in a single batch. Lower number can help to distribute tasks "
         "between threads more evenly, higher number means faster processing of particles within single thread." },
+    { RunSettingsId::RUN_THREAD_PINNING,            "run.thread.pinning",       false,
+        "If true, threads are pinned to individual cores and particle buffers are placed into memory of the threads "
+        "processing them. This can improve the performance on systems with multiple NUMA nodes." },
     { RunSettingsId::RUN_LOGGER,                    "run.logger",               LoggerEnum::STD_OUT,
         "Type of a log generated by the simulation. Can be one of the following:\n" + EnumMap::getDesc<LoggerEnum>() },
     { RunSettingsId::RUN_LOGGER_FILE,               "run.logger.file",          "log.txt"_s,
@@ -513,6 +552,28 @@ const RunSettings& getDefaultSettings() {
         "Seed of the random number generator (if applicable)." },
     { RunSettingsId::RUN_DIAGNOSTICS_INTERVAL,      "run.diagnostics_interval", 0.1_f,
         "Time period (in run time) of running diagnostics of the run. 0 means the diagnostics are run every time step." },
+    { RunSettingsId::RUN_INTEGRALS_ENABLE,          "run.integrals.enable",     false,
+        "If true, total momentum, angular momentum and energy of particles are periodically written into a file and "
+        "saved into the run statistics. Potential energy is included if the simulation uses self-gravity; it is "
+        "computed by the solver from its gravity tree every time step." },
+    { RunSettingsId::RUN_INTEGRALS_NAME,            "run.integrals.name",       "integrals.txt"_s,
+        "Name of a file where the integrals of motion are written." },
+    { RunSettingsId::RUN_INTEGRALS_INTERVAL,        "run.integrals.interval",   0._f,
+        "Time period (in run time) of computing the integrals of motion. 0 means the integrals are computed every "
+        "time step." },
+    { RunSettingsId::RUN_INSITU_ANALYSES,           "run.insitu.analyses",      Flags<InSituAnalysisEnum>(),
+        "Analyses of particles executed concurrently with the simulation, using a copy of particle data. Results are "
+        "written into the output directory. Can be one or more values from:\n" + EnumMap::getDesc<InSituAnalysisEnum>() },
+    { RunSettingsId::RUN_INSITU_THREAD_CNT,         "run.insitu.thread_cnt",    1,
+        "Number of threads executing the in-situ analyses. These threads are not used by the simulation itself." },
+    { RunSettingsId::RUN_INSITU_COMPONENTS_INTERVAL, "run.insitu.components.interval", 100._f,
+        "Time period (in run time) of the analysis of components." },
+    { RunSettingsId::RUN_INSITU_SFD_INTERVAL,       "run.insitu.sfd.interval",  100._f,
+        "Time period (in run time) of the analysis of the size-frequency distribution." },
+    { RunSettingsId::RUN_INSITU_MOONS_INTERVAL,     "run.insitu.moons.interval", 100._f,
+        "Time period (in run time) of the analysis of moons." },
+    { RunSettingsId::RUN_INSITU_TUMBLERS_INTERVAL,  "run.insitu.tumblers.interval", 100._f,
+        "Time period (in run time) of the analysis of tumblers." },
 
     /// SPH solvers
     { RunSettingsId::SPH_SOLVER_TYPE,               "sph.solver.type",                  SolverEnum::SYMMETRIC_SOLVER,
@@ -638,6 +699,9 @@ const RunSettings& getDefaultSettings() {
         "Period of gravity evaluation. If zero, gravity is computed every time step, for any positive value, "
         "gravitational acceleration is cached for each particle and used each time step until the next "
         "recomputation." },
+    { RunSettingsId::GRAVITY_COMPACT_MOMENTS,       "gravity.compact_moments",  false,
+        "If true, Barnes-Hut stores multipole moments of tree nodes in single precision, reducing the memory "
+        "traffic of the gravity evaluation. Accelerations are still summed up in double precision." },
 
     /// Collision handling
     { RunSettingsId::COLLISION_HANDLER,             "collision.handler",                CollisionHandlerEnum::MERGE_OR_BOUNCE,
@@ -571,7 +571,16 @@ enum class TimesteppingEnum {
     MODIFIED_MIDPOINT,
 
     /// Bulirsch-Stoer integrator
-    BULIRSCH_STOER
+    BULIRSCH_STOER,
+
+    /// Low-storage (2N) Runge-Kutta 3rd-order integration
+    LOW_STORAGE_RK3,
+
+    /// Low-storage (2N) Runge-Kutta 4th-order integration
+    LOW_STORAGE_RK4,
+
+    /// Strong stability preserving Runge-Kutta 3rd-order integration
+    SSP_RK3,
 };
 
 enum class TimeStepCriterionEnum {
@@ -895,6 +904,11 @@ enum class IoEnum {
 
     /// OpenVDB grid
     VDB_FILE = 9,
+
+    /// Sequence of snapshots stored in a single file. Positions and velocities are stored as quantized
+    /// differences from periodic keyframes, making the format suitable for visualization of runs with many
+    /// dumps.
+    SEQUENCE_FILE = 10,
 };
 
 /// \brief Returns the file extension associated with given IO type.
@@ -933,6 +947,21 @@ enum class OutputSpacing {
     CUSTOM,
 };
 
+/// \brief Analyses executed concurrently with the run, see \ref InSituAnalysisTrigger.
+enum class InSituAnalysisEnum {
+    /// Table of components (separated bodies)
+    COMPONENTS = 1 << 0,
+
+    /// Cumulative size-frequency distribution
+    SFD = 1 << 1,
+
+    /// Potential satellites of the largest body
+    MOONS = 1 << 2,
+
+    /// Tumbling bodies
+    TUMBLERS = 1 << 3,
+};
+
 enum class RngEnum {
     /// Mersenne Twister PRNG from Standard library
     UNIFORM,
@@ -994,6 +1023,12 @@ enum class RunSettingsId {
     /// List of quantities to write to text output. Binary output always stores all quantitites.
     RUN_OUTPUT_QUANTITIES,
 
+    /// If true, binary output files are written by multiple threads, see \ref ParallelBinaryOutput.
+    RUN_OUTPUT_PARALLEL,
+
+    /// Number of frames between two consecutive keyframes of the sequence file, see \ref SequenceOutput.
+    RUN_OUTPUT_SEQUENCE_KEYFRAME_PERIOD,
+
     /// Number of threads used by the code. If 0, all available threads are used.
     RUN_THREAD_CNT,
 
@@ -1002,6 +1037,10 @@ enum class RunSettingsId {
     /// thread.
     RUN_THREAD_GRANULARITY,
 
+    /// If true, threads are pinned to cores and particle buffers are distributed to memory of the threads
+    /// processing them. Improves the performance on NUMA systems.
+    RUN_THREAD_PINNING,
+
     /// Selected logger of a run, see LoggerEnum
     RUN_LOGGER,
 
@@ -1044,6 +1083,35 @@ enum class RunSettingsId {
     /// time step.
     RUN_DIAGNOSTICS_INTERVAL,
 
+    /// If true, integrals of motion (total momentum, angular momentum and energy) are periodically logged into
+    /// a file and saved into the run statistics, see \ref IntegralsLogWriter.
+    RUN_INTEGRALS_ENABLE,
+
+    /// Name of the file where the integrals of motion are logged.
+    RUN_INTEGRALS_NAME,
+
+    /// Time period (in run time) of logging the integrals of motion. 0 means the integrals are logged every
+    /// time step.
+    RUN_INTEGRALS_INTERVAL,
+
+    /// Analyses executed concurrently with the run, see \ref InSituAnalysisEnum.
+    RUN_INSITU_ANALYSES,
+
+    /// Number of threads executing the in-situ analyses. The threads are not shared with the run.
+    RUN_INSITU_THREAD_CNT,
+
+    /// Time period (in run time) of the analysis of components.
+    RUN_INSITU_COMPONENTS_INTERVAL,
+
+    /// Time period (in run time) of the analysis of the size-frequency distribution.
+    RUN_INSITU_SFD_INTERVAL,
+
+    /// Time period (in run time) of the analysis of moons.
+    RUN_INSITU_MOONS_INTERVAL,
+
+    /// Time period (in run time) of the analysis of tumblers.
+    RUN_INSITU_TUMBLERS_INTERVAL,
+
     /// Selected solver for computing derivatives of physical variables.
     SPH_SOLVER_TYPE,
 
@@ -1215,6 +1283,10 @@ enum class RunSettingsId {
     /// recomputation.
     GRAVITY_RECOMPUTATION_PERIOD,
 
+    /// If true, Barnes-Hut stores multipole moments of tree nodes in single precision, reducing the memory
+    /// traffic of the treewalk. Accelerations are still summed up in double precision.
+    GRAVITY_COMPACT_MOMENTS,
+
     /// Specifies how the collisions of particles should be handler; see CollisionHandlerEnum.
     COLLISION_HANDLER,
 
@@ -21,9 +21,9 @@ NAMESPACE_SPH_BEGIN
 /// accumulated by each component of the running problem (timestepping, solver, ...).
 class Statistics {
 private:
-    enum Types { BOOL, INT, FLOAT, MEANS, VALUE, INTERVAL };
+    enum Types { BOOL, INT, FLOAT, MEANS, VALUE, INTERVAL, GLOBAL_SIZE };
 
-    using ValueType = Variant<bool, int, Float, MinMaxMean, Dynamic, Interval>;
+    using ValueType = Variant<bool, int, Float, MinMaxMean, Dynamic, Interval, GlobalSize>;
 
     FlatMap<StatisticsId, ValueType> entries;
 
@@ -143,10 +143,10 @@ enum class StatisticsId {
     /// Number of nodes in used gravity tree
     GRAVITY_NODE_COUNT,
 
-    /// Number of tree nodes evaluated by pair-wise interacting
+    /// Number of tree nodes evaluated by pair-wise interacting, stored as GlobalSize
     GRAVITY_NODES_EXACT,
 
-    /// Number of tree nodes evaluated using multipole approximation
+    /// Number of tree nodes evaluated using multipole approximation, stored as GlobalSize
     GRAVITY_NODES_APPROX,
 
     /// Wallclock duration of gravity evaluation
@@ -196,6 +196,30 @@ enum class StatisticsId {
 
     /// Derivative value of particle that currently limits the timestep.
     LIMITING_DERIVATIVE,
+
+    /// Total mass of all particles
+    TOTAL_MASS,
+
+    /// Total momentum of all particles (stored as Dynamic)
+    TOTAL_MOMENTUM,
+
+    /// Total angular momentum of all particles (stored as Dynamic)
+    TOTAL_ANGULAR_MOMENTUM,
+
+    /// Total kinetic energy of particles
+    KINETIC_ENERGY,
+
+    /// Total internal energy of particles
+    INTERNAL_ENERGY,
+
+    /// Gravitational potential energy of particles
+    POTENTIAL_ENERGY,
+
+    /// Sum of kinetic, internal and potential energy
+    TOTAL_ENERGY,
+
+    /// Center of mass of all particles (stored as Dynamic)
+    CENTER_OF_MASS,
 };
 
 NAMESPACE_SPH_END
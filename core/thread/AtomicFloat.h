@@ -77,6 +77,14 @@ public:
         return value.load() / f;
     }
 
+    /// \brief Replaces the value with the desired value if it is equal to the expected value.
+    ///
+    /// Returns true if the value has been replaced. Otherwise, the current value is stored to the expected
+    /// value and the function returns false.
+    INLINE bool compareExchange(Type& expected, const Type desired) {
+        return value.compare_exchange_strong(expected, desired);
+    }
+
     INLINE bool operator==(const Type f) const {
         return value.load() == f;
     }
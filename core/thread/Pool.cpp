@@ -1,5 +1,9 @@
 #include "thread/Pool.h"
 #include "objects/wrappers/Finally.h"
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 NAMESPACE_SPH_BEGIN
 
@@ -154,6 +158,35 @@ ThreadPool::~ThreadPool() {
     }
 }
 
+bool ThreadPool::pinThreads() {
+#ifdef __linux__
+    // cores available to the process, may be restricted by taskset or cgroups
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) {
+        pinned = false;
+        return false;
+    }
+    Array<int> cores;
+    for (int core = 0; core < CPU_SETSIZE; ++core) {
+        if (CPU_ISSET(core, &allowed)) {
+            cores.push(core);
+        }
+    }
+    bool result = !cores.empty();
+    for (Size i = 0; i < threads.size(); ++i) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cores[i % cores.size()], &cpus);
+        result &= pthread_setaffinity_np(threads[i]->native_handle(), sizeof(cpu_set_t), &cpus) == 0;
+    }
+    pinned = result;
+    return result;
+#else
+    return false;
+#endif
+}
+
 SharedPtr<ITask> ThreadPool::submit(const Function<void()>& task) {
     SharedPtr<Task> handle = makeShared<Task>(task);
     handle->setParent(threadLocalContext.current);
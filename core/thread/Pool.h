@@ -94,6 +94,9 @@ private:
     /// Number of unprocessed tasks (either currently processing or waiting).
     std::atomic<int> tasksLeft;
 
+    /// True if all threads are pinned to cores, see \ref pinThreads
+    bool pinned = false;
+
     /// Global instance of the ThreadPool.
     /// \note This is not a singleton, another instances can be created if needed.
     static SharedPtr<ThreadPool> globalInstance;
@@ -144,6 +147,21 @@ public:
         granularity = newGranularity;
     }
 
+    /// \brief Pins the threads of the pool to logical cores.
+    ///
+    /// Thread with index i is pinned to the i-th core (modulo the number of cores) the calling thread is
+    /// allowed to run on, so that the threads are not migrated by the operating system and memory pages
+    /// first touched by a thread stay on its NUMA node. The affinity mask of the process is respected, the
+    /// threads are thus never pinned to cores excluded by taskset or cgroups. Currently only implemented on
+    /// Linux.
+    /// \return True if all threads have been pinned, false otherwise.
+    bool pinThreads();
+
+    /// \brief Checks if the threads have been successfully pinned by the last call of \ref pinThreads.
+    bool isPinned() const {
+        return pinned;
+    }
+
     /// \brief Returns the global instance of the thread pool.
     ///
     /// Other instances can be constructed if needed.
@@ -2,6 +2,9 @@
 #include "catch.hpp"
 #include "system/Timer.h"
 #include "utils/Utils.h"
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 using namespace Sph;
 
@@ -192,6 +195,35 @@ TEST_CASE("Pool ParallelFor", "[thread]") {
     REQUIRE_THREAD_SAFE(pool.remainingTaskCnt() == 0);
 }
 
+TEST_CASE("Pool pinThreads", "[thread]") {
+    ThreadPool pool(4);
+    REQUIRE_FALSE(pool.isPinned());
+    // pinning may not be permitted, for example in restricted containers
+    const bool pinned = pool.pinThreads();
+    REQUIRE(pool.isPinned() == pinned);
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    REQUIRE(sched_getaffinity(0, sizeof(cpu_set_t), &allowed) == 0);
+    std::atomic<bool> onAllowedCore;
+    onAllowedCore = true;
+    parallelFor(pool, 0, 1000, 1, [&onAllowedCore, &allowed](Size UNUSED(i)) {
+        // threads must only run on the cores available to the process, pinned or not
+        const int core = sched_getcpu();
+        if (core >= 0 && !CPU_ISSET(core, &allowed)) {
+            onAllowedCore = false;
+        }
+    });
+    REQUIRE(onAllowedCore);
+#else
+    REQUIRE_FALSE(pinned);
+#endif
+    std::atomic<uint64_t> sum;
+    sum = 0;
+    parallelFor(pool, 1, 100000, [&sum](Size i) { sum += i; });
+    REQUIRE_THREAD_SAFE(sum == 4999950000);
+}
+
 TEST_CASE("Pool GetThreadIdx", "[thread]") {
     ThreadPool pool(2);
     REQUIRE_THREAD_SAFE(pool.getThreadCnt() == 2);
@@ -356,23 +356,260 @@ TimeStep CourantCriterion::compute(IScheduler& scheduler,
 }
 
 //-----------------------------------------------------------------------------------------------------------
-// MultiCriterion implementation
+// FusedCriterion implementation
 //-----------------------------------------------------------------------------------------------------------
 
-MultiCriterion::MultiCriterion(const RunSettings& settings) {
+/// Thread-local results of all criteria.
+struct FusedCriterion::Tl {
+    Float courant = INFTY;
+    Float acceleration = INFTY;
+    Float divergence = INFTY;
+
+    /// Minimal time step and index of the limiting particle for each first-order quantity
+    Array<Float> derivativeMin;
+    Array<Size> derivativeIdx;
+
+    /// Mean time step for each first-order quantity, used instead of the minimum if the power is finite.
+    /// Wrapped in Optional as the mean is not default-constructible.
+    Array<Optional<NegativeMean>> derivativeMean;
+
+    Tl(const Size quantityCnt, const Float power) {
+        derivativeMin.resizeAndSet(quantityCnt, INFTY);
+        derivativeIdx.resizeAndSet(quantityCnt, 0);
+        for (Size k = 0; k < quantityCnt; ++k) {
+            derivativeMean.push(NegativeMean(power));
+        }
+    }
+};
+
+FusedCriterion::FusedCriterion(const RunSettings& settings) {
     const Flags<TimeStepCriterionEnum> flags =
         settings.getFlags<TimeStepCriterionEnum>(RunSettingsId::TIMESTEPPING_CRITERION);
-    if (flags.has(TimeStepCriterionEnum::COURANT)) {
-        criteria.push(makeAuto<CourantCriterion>(settings));
+    useCourant = flags.has(TimeStepCriterionEnum::COURANT);
+    useDerivatives = flags.has(TimeStepCriterionEnum::DERIVATIVES);
+    useAcceleration = flags.has(TimeStepCriterionEnum::ACCELERATION);
+    useDivergence = flags.has(TimeStepCriterionEnum::DIVERGENCE);
+
+    courant = settings.get<Float>(RunSettingsId::TIMESTEPPING_COURANT_NUMBER);
+    derivativeFactor = settings.get<Float>(RunSettingsId::TIMESTEPPING_DERIVATIVE_FACTOR);
+    divergenceFactor = settings.get<Float>(RunSettingsId::TIMESTEPPING_DIVERGENCE_FACTOR);
+    power = settings.get<Float>(RunSettingsId::TIMESTEPPING_MEAN_POWER);
+    SPH_ASSERT(!useDerivatives || power < 0._f); // currently not implemented for non-negative powers
+}
+
+FusedCriterion::~FusedCriterion() = default;
+
+TimeStep FusedCriterion::compute(IScheduler& scheduler,
+    Storage& storage,
+    const Float maxStep,
+    Statistics& stats,
+    ArrayView<TimeStep> dts) {
+    VERBOSE_LOG
+
+    ArrayView<const Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    ArrayView<const Float> cs;
+    if (useCourant) {
+        cs = storage.getValue<Float>(QuantityId::SOUND_SPEED);
+    }
+    ArrayView<const Float> divv;
+    if (useDivergence && storage.has(QuantityId::VELOCITY_DIVERGENCE)) {
+        divv = storage.getValue<Float>(QuantityId::VELOCITY_DIVERGENCE);
+    }
+
+    // very high negative power is effectively computing minimal timestep
+    const bool useMinimum = power < -1.e3_f;
+
+    // derivative criterion needs to be evaluated for each first-order quantity, so we create a kernel
+    // processing a block of particles for each of them
+    Array<QuantityId> ids;
+    Array<Function<void(Size n1, Size n2, Tl& tl)>> kernels;
+    if (useDerivatives) {
+        ArrayView<const Size> matIds = storage.getValue<Size>(QuantityId::MATERIAL_ID);
+        iterate<VisitorEnum::FIRST_ORDER>(storage, [&](const QuantityId id, auto& x, auto& dx) {
+            SPH_ASSERT(x.size() == dx.size());
+            const Size k = ids.size();
+            ids.push(id);
+
+            // minimal values are cached for each material, so that we don't have to query the material
+            // of each particle
+            Array<Float> minimals;
+            for (Size matId = 0; matId < storage.getMaterialCnt(); ++matId) {
+                minimals.push(storage.getMaterial(matId)->minimal(id));
+            }
+
+            const Float factor = derivativeFactor;
+            auto kernel = [&x, &dx, &dts, k, matIds, factor, useMinimum, minimals = std::move(minimals)](
+                              const Size n1, const Size n2, Tl& tl) {
+                for (Size i = n1; i < n2; ++i) {
+                    const Float minValue = minimals[matIds[i]];
+                    SPH_ASSERT(minValue > 0._f); // some nonzero minimal value must be set for all quantities
+
+                    StaticArray<Float, 6> vs = getComponents(abs(x[i]));
+                    StaticArray<Float, 6> dvs = getComponents(abs(dx[i]));
+                    SPH_ASSERT(vs.size() == dvs.size());
+
+                    for (Size j = 0; j < vs.size(); ++j) {
+                        if (abs(vs[j]) < 2._f * minValue) {
+                            continue;
+                        }
+                        const Float value = factor * (vs[j] + minValue) / (dvs[j] + EPS);
+                        SPH_ASSERT(isReal(value));
+                        if (useMinimum) {
+                            if (value < tl.derivativeMin[k]) {
+                                tl.derivativeMin[k] = value;
+                                tl.derivativeIdx[k] = i;
+                            }
+                        } else {
+                            tl.derivativeMean[k]->accumulate(value);
+                        }
+                        if (!dts.empty() && value < dts[i].value) {
+                            dts[i].value = value;
+                            dts[i].id = CriterionId::DERIVATIVE;
+                        }
+                    }
+                }
+            };
+            kernels.push(std::move(kernel));
+        });
+    }
+
+    // single pass over all particles; the criteria are evaluated in the same order as in MultiCriterion,
+    // so that the per-particle time steps are identical
+    ThreadLocal<Tl> tls(scheduler, ids.size(), power);
+    const Size granularity = scheduler.getRecommendedGranularity();
+    scheduler.parallelFor(0, r.size(), granularity, [&](const Size n1, const Size n2) {
+        Tl& tl = tls.local();
+        if (!cs.empty()) {
+            for (Size i = n1; i < n2; ++i) {
+                if (cs[i] > 0._f) {
+                    const Float value = courant * r[i][H] / cs[i];
+                    SPH_ASSERT(isReal(value) && value > 0._f && value < INFTY);
+                    tl.courant = min(tl.courant, value);
+                    if (!dts.empty() && value < dts[i].value) {
+                        dts[i].value = value;
+                        dts[i].id = CriterionId::CFL_CONDITION;
+                    }
+                }
+            }
+        }
+        for (Function<void(Size, Size, Tl&)>& kernel : kernels) {
+            kernel(n1, n2, tl);
+        }
+        if (useAcceleration) {
+            for (Size i = n1; i < n2; ++i) {
+                const Float dvNorm = getSqrLength(dv[i]);
+                if (dvNorm > EPS) {
+                    const Float step = derivativeFactor * root<4>(sqr(r[i][H]) / dvNorm);
+                    SPH_ASSERT(isReal(step) && step > 0._f && step < INFTY);
+                    tl.acceleration = min(tl.acceleration, step);
+                    if (!dts.empty() && step < dts[i].value) {
+                        dts[i].value = step;
+                        dts[i].id = CriterionId::ACCELERATION;
+                    }
+                }
+            }
+        }
+        if (!divv.empty()) {
+            for (Size i = n1; i < n2; ++i) {
+                const Float dv = abs(divv[i]);
+                if (dv > EPS) {
+                    const Float step = divergenceFactor / dv;
+                    SPH_ASSERT(isReal(step) && step > 0._f && step < INFTY);
+                    tl.divergence = min(tl.divergence, step);
+                    if (!dts.empty() && step < dts[i].value) {
+                        dts[i].value = step;
+                        dts[i].id = CriterionId::DIVERGENCE;
+                    }
+                }
+            }
+        }
+    });
+
+    // reduce the thread-local results
+    Tl result(ids.size(), power);
+    for (Tl& tl : tls) {
+        result.courant = min(result.courant, tl.courant);
+        result.acceleration = min(result.acceleration, tl.acceleration);
+        result.divergence = min(result.divergence, tl.divergence);
+        for (Size k = 0; k < ids.size(); ++k) {
+            if (tl.derivativeMin[k] < result.derivativeMin[k]) {
+                result.derivativeMin[k] = tl.derivativeMin[k];
+                result.derivativeIdx[k] = tl.derivativeIdx[k];
+            }
+            result.derivativeMean[k]->accumulate(tl.derivativeMean[k].value());
+        }
     }
-    if (flags.has(TimeStepCriterionEnum::DERIVATIVES)) {
-        criteria.push(makeAuto<DerivativeCriterion>(settings));
+
+    // select the time step of the most restrictive criterion
+    Float minStep = INFTY;
+    CriterionId minId = CriterionId::INITIAL_VALUE;
+    auto addStep = [&minStep, &minId, maxStep](const Float step, const CriterionId id) {
+        // each criterion is limited by the maximal value separately, as in MultiCriterion
+        const TimeStep limited = step > maxStep ? TimeStep{ maxStep, CriterionId::MAXIMAL_VALUE }
+                                                : TimeStep{ step, id };
+        if (limited.value < minStep) {
+            minStep = limited.value;
+            minId = limited.id;
+        }
+    };
+
+    if (useCourant) {
+        addStep(result.courant, CriterionId::CFL_CONDITION);
     }
-    if (flags.has(TimeStepCriterionEnum::ACCELERATION)) {
-        criteria.push(makeAuto<AccelerationCriterion>(settings));
+    if (useDerivatives) {
+        Float derivativeStep = INFTY;
+        Optional<QuantityId> limitingId;
+        Size limitingIdx = 0;
+        for (Size k = 0; k < ids.size(); ++k) {
+            Float step;
+            if (useMinimum) {
+                step = result.derivativeMin[k];
+            } else if (result.derivativeMean[k]->count() > 0) {
+                step = result.derivativeMean[k]->compute();
+                SPH_ASSERT(isReal(step) || step == INFTY, step);
+            } else {
+                continue;
+            }
+            if (step < derivativeStep) {
+                derivativeStep = step;
+                limitingId = ids[k];
+                limitingIdx = result.derivativeIdx[k];
+            }
+        }
+        if (limitingId) {
+            stats.set(StatisticsId::LIMITING_QUANTITY, limitingId.value());
+            if (useMinimum) {
+                iterate<VisitorEnum::FIRST_ORDER>(storage, [&](const QuantityId id, auto& x, auto& dx) {
+                    if (id == limitingId.value()) {
+                        stats.set(StatisticsId::LIMITING_PARTICLE_IDX, int(limitingIdx));
+                        stats.set(StatisticsId::LIMITING_VALUE, Dynamic(x[limitingIdx]));
+                        stats.set(StatisticsId::LIMITING_DERIVATIVE, Dynamic(dx[limitingIdx]));
+                    }
+                });
+            }
+        }
+        addStep(derivativeStep, CriterionId::DERIVATIVE);
     }
-    if (flags.has(TimeStepCriterionEnum::DIVERGENCE)) {
-        criteria.push(makeAuto<DivergenceCriterion>(settings));
+    if (useAcceleration) {
+        addStep(result.acceleration, CriterionId::ACCELERATION);
+    }
+    if (useDivergence) {
+        addStep(result.divergence, CriterionId::DIVERGENCE);
+    }
+    return { minStep, minId };
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// MultiCriterion implementation
+//-----------------------------------------------------------------------------------------------------------
+
+MultiCriterion::MultiCriterion(const RunSettings& settings) {
+    const Flags<TimeStepCriterionEnum> flags =
+        settings.getFlags<TimeStepCriterionEnum>(RunSettingsId::TIMESTEPPING_CRITERION);
+    if (flags != EMPTY_FLAGS) {
+        // all built-in criteria are evaluated in a single pass
+        criteria.push(makeAuto<FusedCriterion>(settings));
     }
 
     maxChange = settings.get<Float>(RunSettingsId::TIMESTEPPING_MAX_INCREASE);
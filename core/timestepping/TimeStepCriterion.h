@@ -169,11 +169,47 @@ public:
 };
 
 
+/// \brief Criterion evaluating all built-in criteria in a single pass over particles.
+///
+/// Computes the same time step as the combination of \ref CourantCriterion, \ref DerivativeCriterion,
+/// \ref AccelerationCriterion and \ref DivergenceCriterion, enabled by parameter \ref
+/// RunSettingsId::TIMESTEPPING_CRITERION. Instead of a separate parallelFor for each criterion (and each
+/// quantity in case of \ref DerivativeCriterion), blocks of particles are processed by all criteria at once
+/// and the results are reduced using thread-local storages.
+class FusedCriterion : public ITimeStepCriterion {
+private:
+    struct Tl;
+
+    /// Enabled criteria
+    bool useCourant;
+    bool useDerivatives;
+    bool useAcceleration;
+    bool useDivergence;
+
+    /// Parameters of the criteria, see the individual criteria for details
+    Float courant;
+    Float derivativeFactor;
+    Float divergenceFactor;
+    Float power;
+
+public:
+    explicit FusedCriterion(const RunSettings& settings);
+
+    ~FusedCriterion() override;
+
+    virtual TimeStep compute(IScheduler& scheduler,
+        Storage& storage,
+        Float maxStep,
+        Statistics& stats,
+        ArrayView<TimeStep> dts = nullptr) override;
+};
+
 /// \brief Helper criterion, wrapping multiple criteria under \ref ITimeStepCriterion interface.
 ///
 /// Time step critaria can be added automatically based on parameter \ref
 /// RunSettingsId::TIMESTEPPING_CRITERION in settings, or they can be specified explicitly. Each criterion
-/// computes a time step and the minimal time step of these is returned.
+/// computes a time step and the minimal time step of these is returned. Criteria created from settings are
+/// evaluated by a single \ref FusedCriterion.
 class MultiCriterion : public ITimeStepCriterion {
 private:
     Array<AutoPtr<ITimeStepCriterion>> criteria;
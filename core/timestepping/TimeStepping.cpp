@@ -78,154 +78,158 @@ void ITimeStepping::step(IScheduler& scheduler, ISolver& solver, Statistics& sta
 // Helper functions for stepping
 //-----------------------------------------------------------------------------------------------------------
 
-template <typename TFunc>
-static void stepFirstOrder(Storage& storage, IScheduler& scheduler, const TFunc& stepper) {
-
-    // note that derivatives are not advanced in time, but cannot be const as they might be clamped
-    auto process = [&](const QuantityId id, auto& x, auto& dx) {
+/// \brief Helper object advancing all evolved quantities in a single parallel pass over the particles.
+///
+/// Steppers of individual quantities are first registered using the add* functions and then executed by
+/// \ref run in a single parallelFor. Each block of particles is processed for all quantities (including
+/// clamping of values to the allowed range) while it is still in cache, instead of making a separate sweep
+/// over memory with a barrier for each quantity.
+class FusedStep : public Noncopyable {
+private:
+    /// Storage with quantities being advanced
+    Storage& storage;
+
+    /// Steppers of individual quantities, processing given range of particles
+    Array<Function<void(Size n1, Size n2)>> kernels;
+
+public:
+    explicit FusedStep(Storage& storage)
+        : storage(storage) {}
+
+    /// \brief Adds a generic stepper of a single quantity.
+    ///
+    /// The stepper is called with particle index; after it returns, values x and derivatives dx of the
+    /// particle are clamped to the range of the corresponding material.
+    template <typename TValue, typename TFunc>
+    void add(const QuantityId id, Array<TValue>& x, Array<TValue>& dx, const TFunc& stepper) {
         SPH_ASSERT(x.size() == dx.size());
+        // ranges are cached for each material, so that we don't have to query the material per particle
+        Array<Interval> ranges;
+        bool bounded = false;
+        for (Size matId = 0; matId < storage.getMaterialCnt(); ++matId) {
+            ranges.push(storage.getRange(id, matId));
+            bounded |= ranges.back() != Interval::unbounded();
+        }
 
-        parallelFor(scheduler, 0, x.size(), [&](const Size i) INL {
-            stepper(x[i], asConst(dx[i]));
-            const Interval range = storage.getMaterialOfParticle(i)->range(id);
-            if (range != Interval::unbounded()) {
-                tie(x[i], dx[i]) = clampWithDerivative(x[i], dx[i], range);
-            }
-        });
-    };
-
-    iterate<VisitorEnum::FIRST_ORDER>(storage, SEQUENTIAL, process);
-}
-
-template <typename TFunc>
-static void stepSecondOrder(Storage& storage, IScheduler& scheduler, const TFunc& stepper) {
-
-    auto process = [&](const QuantityId id, auto& r, auto& v, const auto& dv) {
-        SPH_ASSERT(r.size() == v.size() && r.size() == dv.size());
+        if (!bounded) {
+            kernels.push([stepper](const Size n1, const Size n2) {
+                for (Size i = n1; i < n2; ++i) {
+                    stepper(i);
+                }
+            });
+        } else {
+            ArrayView<const Size> matIds = storage.getValue<Size>(QuantityId::MATERIAL_ID);
+            auto kernel = [&x, &dx, stepper, matIds, ranges = std::move(ranges)](
+                              const Size n1, const Size n2) {
+                for (Size i = n1; i < n2; ++i) {
+                    stepper(i);
+                    const Interval& range = ranges[matIds[i]];
+                    if (range != Interval::unbounded()) {
+                        tie(x[i], dx[i]) = clampWithDerivative(x[i], dx[i], range);
+                    }
+                }
+            };
+            kernels.push(std::move(kernel));
+        }
+    }
 
-        parallelFor(scheduler, 0, r.size(), [&](const Size i) INL {
-            stepper(r[i], v[i], dv[i]);
-            /// \todo optimize gettings range of materials (same in derivativecriterion for minimals)
-            const Interval range = storage.getMaterialOfParticle(i)->range(id);
-            if (range != Interval::unbounded()) {
-                tie(r[i], v[i]) = clampWithDerivative(r[i], v[i], range);
-            }
+    /// Adds all first-order quantities; the stepper is called with values and derivatives.
+    template <typename TFunc>
+    void addFirstOrder(const TFunc& stepper) {
+        // note that derivatives are not advanced in time, but cannot be const as they might be clamped
+        iterate<VisitorEnum::FIRST_ORDER>(storage, [&](const QuantityId id, auto& x, auto& dx) {
+            this->add(id, x, dx, [&x, &dx, stepper](const Size i) INL { stepper(x[i], asConst(dx[i])); });
         });
-    };
-
-    iterate<VisitorEnum::SECOND_ORDER>(storage, SEQUENTIAL, process);
-}
-
-template <typename TFunc>
-static void stepFirstOrder(Storage& storage1,
-    Storage& storage2,
-    IScheduler& scheduler,
-    const TFunc& stepper) {
-
-    auto processPair = [&](QuantityId id, auto& px, auto& pdx, const auto& cx, const auto& cdx) {
-        SPH_ASSERT(px.size() == pdx.size());
-        SPH_ASSERT(cdx.size() == px.size());
-        SPH_ASSERT(cx.empty());
-
-        parallelFor(scheduler, 0, px.size(), [&](const Size i) {
-            stepper(px[i], pdx[i], cdx[i]);
+    }
 
-            const Interval range = storage1.getMaterialOfParticle(i)->range(id);
-            if (range != Interval::unbounded()) {
-                tie(px[i], pdx[i]) = clampWithDerivative(px[i], pdx[i], range);
-            }
+    /// Adds all second-order quantities; the stepper is called with values, 1st and 2nd derivatives.
+    template <typename TFunc>
+    void addSecondOrder(const TFunc& stepper) {
+        iterate<VisitorEnum::SECOND_ORDER>(storage, [&](const QuantityId id, auto& r, auto& v, auto& dv) {
+            SPH_ASSERT(r.size() == dv.size());
+            this->add(id, r, v, [&r, &v, &dv, stepper](const Size i) INL { stepper(r[i], v[i], dv[i]); });
         });
-    };
-
-    iteratePair<VisitorEnum::FIRST_ORDER>(storage1, storage2, processPair);
-}
-
-/// \todo remove code duplication using if constexpr
-template <typename TFunc>
-static void stepPairFirstOrder(Storage& storage1,
-    Storage& storage2,
-    IScheduler& scheduler,
-    const TFunc& stepper) {
-
-    auto processPair = [&](QuantityId id, auto& px, auto& pdx, const auto& cx, const auto& cdx) {
-        SPH_ASSERT(px.size() == pdx.size());
-        SPH_ASSERT(cdx.size() == px.size());
-        SPH_ASSERT(cx.size() == cdx.size());
-
-        parallelFor(scheduler, 0, px.size(), [&](const Size i) {
-            stepper(px[i], pdx[i], cx[i], cdx[i]);
+    }
 
-            const Interval range = storage1.getMaterialOfParticle(i)->range(id);
-            if (range != Interval::unbounded()) {
-                tie(px[i], pdx[i]) = clampWithDerivative(px[i], pdx[i], range);
-            }
-        });
-    };
+    /// Adds all first-order quantities, passing also the derivatives stored in the other storage.
+    template <typename TFunc>
+    void addFirstOrder(Storage& other, const TFunc& stepper) {
+        auto processPair = [&](QuantityId id, auto& px, auto& pdx, const auto& cx, const auto& cdx) {
+            SPH_ASSERT(cdx.size() == px.size());
+            SPH_ASSERT(cx.empty());
+            this->add(id, px, pdx, [&px, &pdx, &cdx, stepper](const Size i) INL {
+                stepper(px[i], pdx[i], cdx[i]);
+            });
+        };
+        iteratePair<VisitorEnum::FIRST_ORDER>(storage, other, processPair);
+    }
 
-    iteratePair<VisitorEnum::FIRST_ORDER>(storage1, storage2, processPair);
-}
+    /// Adds all second-order quantities, passing also the 2nd derivatives stored in the other storage.
+    template <typename TFunc>
+    void addSecondOrder(Storage& other, const TFunc& stepper) {
+        auto processPair = [&](QuantityId id,
+                               auto& pr,
+                               auto& pv,
+                               const auto& pdv,
+                               const auto& cr,
+                               const auto& cv,
+                               const auto& cdv) {
+            SPH_ASSERT(pr.size() == pdv.size());
+            SPH_ASSERT(cdv.size() == pr.size());
+            SPH_ASSERT(cr.empty());
+            SPH_ASSERT(cv.empty());
+            this->add(id, pr, pv, [&pr, &pv, &pdv, &cdv, stepper](const Size i) INL {
+                stepper(pr[i], pv[i], pdv[i], cdv[i]);
+            });
+        };
+        iteratePair<VisitorEnum::SECOND_ORDER>(storage, other, processPair);
+    }
 
-template <typename TFunc>
-static void stepSecondOrder(Storage& storage1,
-    Storage& storage2,
-    IScheduler& scheduler,
-    const TFunc& stepper) {
-
-    auto processPair = [&](QuantityId id,
-                           auto& pr,
-                           auto& pv,
-                           const auto& pdv,
-                           const auto& cr,
-                           const auto& cv,
-                           const auto& cdv) {
-        SPH_ASSERT(pr.size() == pv.size() && pr.size() == pdv.size());
-        SPH_ASSERT(cdv.size() == pr.size());
-        SPH_ASSERT(cr.empty());
-        SPH_ASSERT(cv.empty());
-
-        parallelFor(scheduler, 0, pr.size(), [&](const Size i) {
-            stepper(pr[i], pv[i], pdv[i], cdv[i]);
-
-            const Interval range = storage1.getMaterialOfParticle(i)->range(id);
-            if (range != Interval::unbounded()) {
-                tie(pr[i], pv[i]) = clampWithDerivative(pr[i], pv[i], range);
-            }
-        });
-    };
+    /// Adds all first-order quantities, passing also values and derivatives stored in the other storage.
+    template <typename TFunc>
+    void addPairFirstOrder(Storage& other, const TFunc& stepper) {
+        auto processPair = [&](QuantityId id, auto& px, auto& pdx, const auto& cx, const auto& cdx) {
+            SPH_ASSERT(cdx.size() == px.size());
+            SPH_ASSERT(cx.size() == cdx.size());
+            this->add(id, px, pdx, [&px, &pdx, &cx, &cdx, stepper](const Size i) INL {
+                stepper(px[i], pdx[i], cx[i], cdx[i]);
+            });
+        };
+        iteratePair<VisitorEnum::FIRST_ORDER>(storage, other, processPair);
+    }
 
-    iteratePair<VisitorEnum::SECOND_ORDER>(storage1, storage2, processPair);
-}
+    /// Adds all second-order quantities, passing also all buffers stored in the other storage.
+    template <typename TFunc>
+    void addPairSecondOrder(Storage& other, const TFunc& stepper) {
+        auto processPair = [&](QuantityId id,
+                               auto& pr,
+                               auto& pv,
+                               const auto& pdv,
+                               auto& cr,
+                               const auto& cv,
+                               const auto& cdv) {
+            SPH_ASSERT(pr.size() == pdv.size());
+            SPH_ASSERT(cdv.size() == pr.size());
+            SPH_ASSERT(cr.size() == cdv.size());
+            SPH_ASSERT(cv.size() == cdv.size());
+            this->add(id, pr, pv, [&pr, &pv, &pdv, &cr, &cv, &cdv, stepper](const Size i) INL {
+                stepper(pr[i], pv[i], pdv[i], cr[i], cv[i], cdv[i]);
+            });
+        };
+        iteratePair<VisitorEnum::SECOND_ORDER>(storage, other, processPair);
+    }
 
-template <typename TFunc>
-static void stepPairSecondOrder(Storage& storage1,
-    Storage& storage2,
-    IScheduler& scheduler,
-    const TFunc& stepper) {
-
-    auto processPair = [&](QuantityId id,
-                           auto& pr,
-                           auto& pv,
-                           const auto& pdv,
-                           const auto& cr,
-                           const auto& cv,
-                           const auto& cdv) {
-        SPH_ASSERT(pr.size() == pv.size() && pr.size() == pdv.size());
-        SPH_ASSERT(cdv.size() == pr.size());
-        SPH_ASSERT(cr.size() == cdv.size());
-        SPH_ASSERT(cv.size() == cdv.size());
-
-        parallelFor(scheduler, 0, pr.size(), [&](const Size i) {
-            stepper(pr[i], pv[i], pdv[i], cr[i], cv[i], cdv[i]);
-
-            const Interval range = storage1.getMaterialOfParticle(i)->range(id);
-            if (range != Interval::unbounded()) {
-                tie(pr[i], pv[i]) = clampWithDerivative(pr[i], pv[i], range);
+    /// Executes all added steppers.
+    void run(IScheduler& scheduler) {
+        const Size particleCnt = storage.getParticleCnt();
+        const Size granularity = scheduler.getRecommendedGranularity();
+        scheduler.parallelFor(0, particleCnt, granularity, [this](const Size n1, const Size n2) {
+            for (Function<void(Size, Size)>& kernel : kernels) {
+                kernel(n1, n2);
             }
         });
-    };
-
-    iteratePair<VisitorEnum::SECOND_ORDER>(storage1, storage2, processPair);
-}
+    }
+};
 
 //-----------------------------------------------------------------------------------------------------------
 // EulerExplicit implementation
@@ -244,23 +248,27 @@ void EulerExplicit::stepParticles(IScheduler& scheduler, ISolver& solver, Statis
     const Float dt = timeStep;
 
     // advance velocities
-    stepSecondOrder(*storage, scheduler, [dt](auto& UNUSED(r), auto& v, const auto& dv) INL { //
+    FusedStep kick(*storage);
+    kick.addSecondOrder([dt](auto& UNUSED(r), auto& v, const auto& dv) INL { //
         using Type = typename std::decay_t<decltype(v)>;
         v += Type(dv * dt);
     });
+    kick.run(scheduler);
+
     // find positions and velocities after collision (at the beginning of the time step
     solver.collide(*storage, stats, timeStep);
-    // advance positions
-    stepSecondOrder(*storage, scheduler, [dt](auto& r, auto& v, const auto& UNUSED(dv)) INL { //
+
+    // advance positions and simply advance first order quanties
+    FusedStep drift(*storage);
+    drift.addSecondOrder([dt](auto& r, auto& v, const auto& UNUSED(dv)) INL { //
         using Type = typename std::decay_t<decltype(v)>;
         r += Type(v * dt);
     });
-
-    // simply advance first order quanties
-    stepFirstOrder(*storage, scheduler, [dt](auto& x, const auto& dx) INL { //
+    drift.addFirstOrder([dt](auto& x, const auto& dx) INL { //
         using Type = typename std::decay_t<decltype(x)>;
         x += Type(dx * dt);
     });
+    drift.run(scheduler);
 
     SPH_ASSERT(storage->isValid());
 }
@@ -288,15 +296,17 @@ void PredictorCorrector::makePredictions(IScheduler& scheduler) {
     const Float dt = timeStep;
     const Float dt2 = 0.5_f * sqr(dt);
     /// \todo this is currently incompatible with NBodySolver, because we advance positions by 0.5 adt^2 ...
-    stepSecondOrder(*storage, scheduler, [dt, dt2](auto& r, auto& v, const auto& dv) INL {
+    FusedStep step(*storage);
+    step.addSecondOrder([dt, dt2](auto& r, auto& v, const auto& dv) INL {
         using Type = typename std::decay_t<decltype(v)>;
         r += Type(v * dt + dv * dt2);
         v += Type(dv * dt);
     });
-    stepFirstOrder(*storage, scheduler, [dt](auto& x, const auto& dx) INL { //
+    step.addFirstOrder([dt](auto& x, const auto& dx) INL { //
         using Type = typename std::decay_t<decltype(x)>;
         x += Type(dx * dt);
     });
+    step.run(scheduler);
 }
 
 void PredictorCorrector::makeCorrections(IScheduler& scheduler) {
@@ -306,19 +316,17 @@ void PredictorCorrector::makeCorrections(IScheduler& scheduler) {
     constexpr Float a = 1._f / 3._f;
     constexpr Float b = 0.5_f;
 
-    stepSecondOrder(*storage,
-        *predictions,
-        scheduler,
-        [a, b, dt, dt2](auto& pr, auto& pv, const auto& pdv, const auto& cdv) {
-            using Type = typename std::decay_t<decltype(pr)>;
-            pr -= Type(a * (cdv - pdv) * dt2);
-            pv -= Type(b * (cdv - pdv) * dt);
-        });
-
-    stepFirstOrder(*storage, *predictions, scheduler, [dt](auto& px, const auto& pdx, const auto& cdx) {
+    FusedStep step(*storage);
+    step.addSecondOrder(*predictions, [a, b, dt, dt2](auto& pr, auto& pv, const auto& pdv, const auto& cdv) {
+        using Type = typename std::decay_t<decltype(pr)>;
+        pr -= Type(a * (cdv - pdv) * dt2);
+        pv -= Type(b * (cdv - pdv) * dt);
+    });
+    step.addFirstOrder(*predictions, [dt](auto& px, const auto& pdx, const auto& cdx) {
         using Type = typename std::decay_t<decltype(px)>;
         px -= Type(0.5_f * (cdx - pdx) * dt);
     });
+    step.run(scheduler);
 }
 
 void PredictorCorrector::stepParticles(IScheduler& scheduler, ISolver& solver, Statistics& stats) {
@@ -355,37 +363,41 @@ void LeapFrog::stepParticles(IScheduler& scheduler, ISolver& solver, Statistics&
     // move positions by half a timestep (drift)
     const Float dt = timeStep;
     solver.collide(*storage, stats, 0.5_f * dt);
-    stepSecondOrder(*storage, scheduler, [dt](auto& r, const auto& v, const auto& UNUSED(dv)) INL { //
+    FusedStep drift1(*storage);
+    drift1.addSecondOrder([dt](auto& r, const auto& v, const auto& UNUSED(dv)) INL { //
         using Type = typename std::decay_t<decltype(v)>;
         r += Type(v * 0.5_f * dt);
     });
+    drift1.run(scheduler);
 
     // compute the derivatives
     storage->zeroHighestDerivatives(scheduler);
     solver.integrate(*storage, stats);
 
+    FusedStep kick(*storage);
     // integrate first-order quantities as in Euler
     /// \todo this is not LeapFrog !
-    stepFirstOrder(*storage, scheduler, [dt](auto& x, const auto& dx) INL { //
+    kick.addFirstOrder([dt](auto& x, const auto& dx) INL { //
         using Type = typename std::decay_t<decltype(x)>;
         x += Type(dx * dt);
     });
-
-
     // move velocities by full timestep (kick)
-    stepSecondOrder(*storage, scheduler, [dt](auto& UNUSED(r), auto& v, const auto& dv) INL { //
+    kick.addSecondOrder([dt](auto& UNUSED(r), auto& v, const auto& dv) INL { //
         using Type = typename std::decay_t<decltype(v)>;
         v += Type(dv * dt);
     });
+    kick.run(scheduler);
 
     // evaluate collisions
     solver.collide(*storage, stats, 0.5_f * dt);
 
     // move positions by another half timestep (drift)
-    stepSecondOrder(*storage, scheduler, [dt](auto& r, auto& v, const auto& UNUSED(dv)) INL { //
+    FusedStep drift2(*storage);
+    drift2.addSecondOrder([dt](auto& r, auto& v, const auto& UNUSED(dv)) INL { //
         using Type = typename std::decay_t<decltype(v)>;
         r += Type(v * 0.5_f * dt);
     });
+    drift2.run(scheduler);
 
     SPH_ASSERT(storage->isValid());
 }
@@ -483,6 +495,201 @@ void RungeKutta::stepParticles(IScheduler& scheduler, ISolver& solver, Statistic
         });
 }
 
+//-----------------------------------------------------------------------------------------------------------
+// LowStorageRungeKutta implementation
+//-----------------------------------------------------------------------------------------------------------
+
+/// Creates registers for all evolved quantities of the storage, see \ref LowStorageRungeKutta.
+static void addMissingRegisters(const Storage& storage, Storage& registers) {
+    const Size particleCnt = storage.getParticleCnt();
+    iterate<VisitorEnum::FIRST_ORDER>(storage, [&](const QuantityId id, const auto& x, const auto&) {
+        using Type = typename std::decay_t<decltype(x)>::Type;
+        if (!registers.has(id)) {
+            Array<Type> q(particleCnt);
+            q.fill(Type(0._f));
+            registers.insert<Type>(id, OrderEnum::ZERO, std::move(q));
+        }
+    });
+    iterate<VisitorEnum::SECOND_ORDER>(
+        storage, [&](const QuantityId id, const auto& r, const auto&, const auto&) {
+            using Type = typename std::decay_t<decltype(r)>::Type;
+            if (!registers.has(id)) {
+                Array<Type> q(particleCnt);
+                q.fill(Type(0._f));
+                registers.insert<Type>(id, OrderEnum::FIRST, std::move(q));
+            }
+        });
+}
+
+/// \brief Updates all evolved quantities of the storage, together with their registers.
+///
+/// The stepper is called with values and derivatives of first-order quantities and the corresponding
+/// register, or with values, 1st derivatives and 2nd derivatives of second-order quantities and the two
+/// registers. Values are clamped to the allowed range of the material after the update.
+template <typename TFirstOrder, typename TSecondOrder>
+static void stepWithRegisters(Storage& storage,
+    Storage& registers,
+    IScheduler& scheduler,
+    const TFirstOrder& firstOrderStepper,
+    const TSecondOrder& secondOrderStepper) {
+    addMissingRegisters(storage, registers);
+    SPH_ASSERT(registers.getParticleCnt() == storage.getParticleCnt());
+
+    FusedStep step(storage);
+    iterate<VisitorEnum::FIRST_ORDER>(storage, [&](const QuantityId id, auto& x, auto& dx) {
+        using Type = typename std::decay_t<decltype(x)>::Type;
+        Array<Type>& q = registers.getValue<Type>(id);
+        step.add(id, x, dx, [&x, &dx, &q, firstOrderStepper](const Size i) INL {
+            firstOrderStepper(x[i], asConst(dx[i]), q[i]);
+        });
+    });
+    iterate<VisitorEnum::SECOND_ORDER>(storage, [&](const QuantityId id, auto& r, auto& v, auto& dv) {
+        using Type = typename std::decay_t<decltype(r)>::Type;
+        Array<Type>& qr = registers.getValue<Type>(id);
+        Array<Type>& qv = registers.getDt<Type>(id);
+        step.add(id, r, v, [&r, &v, &dv, &qr, &qv, secondOrderStepper](const Size i) INL {
+            secondOrderStepper(r[i], v[i], asConst(dv[i]), qr[i], qv[i]);
+        });
+    });
+    step.run(scheduler);
+}
+
+LowStorageRungeKutta::LowStorageRungeKutta(const SharedPtr<Storage>& storage, const RunSettings& settings)
+    : ITimeStepping(storage, settings) {
+    SPH_ASSERT(storage->getQuantityCnt() > 0); // quantities must already been emplaced
+
+    const TimesteppingEnum id = settings.get<TimesteppingEnum>(RunSettingsId::TIMESTEPPING_INTEGRATOR);
+    switch (id) {
+    case TimesteppingEnum::LOW_STORAGE_RK3:
+        // Williamson (1980)
+        A = { 0._f, -5._f / 9._f, -153._f / 128._f };
+        B = { 1._f / 3._f, 15._f / 16._f, 8._f / 15._f };
+        break;
+    case TimesteppingEnum::LOW_STORAGE_RK4:
+        // Carpenter & Kennedy (1994), solution 3
+        A = {
+            0._f,
+            -567301805773._f / 1357537059087._f,
+            -2404267990393._f / 2016746695238._f,
+            -3550918686646._f / 2091501179385._f,
+            -1275806237668._f / 842570457699._f,
+        };
+        B = {
+            1432997174477._f / 9575080441755._f,
+            5161836677717._f / 13612068292357._f,
+            1720146321549._f / 2090206949498._f,
+            3134564353537._f / 4481467310338._f,
+            2277821191437._f / 14882151754819._f,
+        };
+        break;
+    default:
+        throw InvalidSetup("Timestepping " + EnumMap::toString(id) + " is not a low-storage scheme");
+    }
+    SPH_ASSERT(A.size() == B.size() && A[0] == 0._f);
+
+    registers = makeShared<Storage>();
+    addMissingRegisters(*storage, *registers);
+    storage->addDependent(registers);
+
+    // clear derivatives before using them in step method
+    storage->zeroHighestDerivatives(SEQUENTIAL);
+}
+
+LowStorageRungeKutta::~LowStorageRungeKutta() = default;
+
+void LowStorageRungeKutta::advanceStage(IScheduler& scheduler, const Float a, const Float b) {
+    const Float dt = timeStep;
+    stepWithRegisters(
+        *storage,
+        *registers,
+        scheduler,
+        [a, b, dt](auto& x, const auto& dx, auto& q) INL {
+            using Type = typename std::decay_t<decltype(x)>;
+            // the register may contain garbage in the first stage, so it must not be multiplied by zero
+            q = (a == 0._f) ? Type(dx * dt) : Type(a * q + dx * dt);
+            x += Type(b * q);
+        },
+        [a, b, dt](auto& r, auto& v, const auto& dv, auto& qr, auto& qv) INL {
+            using Type = typename std::decay_t<decltype(r)>;
+            qr = (a == 0._f) ? Type(v * dt) : Type(a * qr + v * dt);
+            qv = (a == 0._f) ? Type(dv * dt) : Type(a * qv + dv * dt);
+            r += Type(b * qr);
+            v += Type(b * qv);
+        });
+}
+
+void LowStorageRungeKutta::stepParticles(IScheduler& scheduler, ISolver& solver, Statistics& stats) {
+    VERBOSE_LOG
+
+    for (Size stage = 0; stage < A.size(); ++stage) {
+        storage->zeroHighestDerivatives(scheduler);
+        solver.integrate(*storage, stats);
+
+        PROFILE_SCOPE("LowStorageRungeKutta::step")
+        this->advanceStage(scheduler, A[stage], B[stage]);
+    }
+
+    SPH_ASSERT(storage->isValid());
+}
+
+//-----------------------------------------------------------------------------------------------------------
+// SspRungeKutta implementation
+//-----------------------------------------------------------------------------------------------------------
+
+SspRungeKutta::SspRungeKutta(const SharedPtr<Storage>& storage, const RunSettings& settings)
+    : ITimeStepping(storage, settings) {
+    SPH_ASSERT(storage->getQuantityCnt() > 0); // quantities must already been emplaced
+
+    initial = makeShared<Storage>();
+    addMissingRegisters(*storage, *initial);
+    storage->addDependent(initial);
+
+    // clear derivatives before using them in step method
+    storage->zeroHighestDerivatives(SEQUENTIAL);
+}
+
+SspRungeKutta::~SspRungeKutta() = default;
+
+void SspRungeKutta::advanceStage(IScheduler& scheduler, const Float a, const bool saveInitial) {
+    const Float dt = timeStep;
+    stepWithRegisters(
+        *storage,
+        *initial,
+        scheduler,
+        [a, dt, saveInitial](auto& x, const auto& dx, auto& x0) INL {
+            using Type = typename std::decay_t<decltype(x)>;
+            if (saveInitial) {
+                x0 = x;
+            }
+            x = Type(a * x0 + (1._f - a) * (x + dx * dt));
+        },
+        [a, dt, saveInitial](auto& r, auto& v, const auto& dv, auto& r0, auto& v0) INL {
+            using Type = typename std::decay_t<decltype(r)>;
+            if (saveInitial) {
+                r0 = r;
+                v0 = v;
+            }
+            r = Type(a * r0 + (1._f - a) * (r + v * dt));
+            v = Type(a * v0 + (1._f - a) * (v + dv * dt));
+        });
+}
+
+void SspRungeKutta::stepParticles(IScheduler& scheduler, ISolver& solver, Statistics& stats) {
+    VERBOSE_LOG
+
+    // Shu & Osher (1988)
+    constexpr Float a[] = { 0._f, 0.75_f, 1._f / 3._f };
+    for (Size stage = 0; stage < 3; ++stage) {
+        storage->zeroHighestDerivatives(scheduler);
+        solver.integrate(*storage, stats);
+
+        PROFILE_SCOPE("SspRungeKutta::step")
+        this->advanceStage(scheduler, a[stage], stage == 0);
+    }
+
+    SPH_ASSERT(storage->isValid());
+}
+
 //-----------------------------------------------------------------------------------------------------------
 // ModifiedMidpointMethod implementation
 //-----------------------------------------------------------------------------------------------------------
@@ -501,23 +708,21 @@ void ModifiedMidpointMethod::stepParticles(IScheduler& scheduler, ISolver& solve
 
     solver.collide(*storage, stats, h);
     // do first (half)step using current derivatives, save values to mid
-    stepPairSecondOrder(*mid,
-        *storage,
-        scheduler,
+    FusedStep first(*mid);
+    first.addPairSecondOrder(*storage,
         [h](auto& pr, auto& pv, const auto&, const auto& cr, const auto& cv, const auto& cdv) INL {
             using Type = typename std::decay_t<decltype(cv)>;
             pv = Type(cv + h * cdv);
             pr = Type(cr + h * cv);
             SPH_ASSERT(isReal(pv) && isReal(pr));
         });
-    stepPairFirstOrder(*mid,
-        *storage,
-        scheduler,
+    first.addPairFirstOrder(*storage,
         [h](auto& px, const auto& UNUSED(pdx), const auto& cx, const auto& cdx) INL { //
             using Type = typename std::decay_t<decltype(cx)>;
             px = Type(cx + h * cdx);
             SPH_ASSERT(isReal(px));
         });
+    first.run(scheduler);
 
     mid->zeroHighestDerivatives(scheduler);
     // evaluate the derivatives, using the advanced values
@@ -528,9 +733,8 @@ void ModifiedMidpointMethod::stepParticles(IScheduler& scheduler, ISolver& solve
     // do (n-1) steps, keeping mid half-step ahead of the storage
     for (Size iter = 0; iter < n - 1; ++iter) {
         solver.collide(*storage, stats, 2._f * h);
-        stepPairSecondOrder(*storage,
-            *mid,
-            scheduler,
+        FusedStep step(*storage);
+        step.addPairSecondOrder(*mid,
             [h](auto& pr,
                 auto& pv,
                 const auto& UNUSED(pdv),
@@ -542,14 +746,13 @@ void ModifiedMidpointMethod::stepParticles(IScheduler& scheduler, ISolver& solve
                 pr += Type(2._f * h * cv);
                 SPH_ASSERT(isReal(pv) && isReal(pr));
             });
-        stepPairFirstOrder(*storage,
-            *mid,
-            scheduler,
+        step.addPairFirstOrder(*mid,
             [h](auto& px, const auto& UNUSED(pdx), const auto& UNUSED(cx), const auto& cdx) INL { //
                 using Type = typename std::decay_t<decltype(px)>;
                 px += Type(2._f * h * cdx);
                 SPH_ASSERT(isReal(px));
             });
+        step.run(scheduler);
         storage->swap(*mid, VisitorEnum::ALL_BUFFERS);
         mid->zeroHighestDerivatives(scheduler);
         solver.integrate(*mid, stats);
@@ -557,23 +760,21 @@ void ModifiedMidpointMethod::stepParticles(IScheduler& scheduler, ISolver& solve
 
     // last step
     solver.collide(*storage, stats, h);
-    stepPairSecondOrder(*storage,
-        *mid,
-        scheduler,
+    FusedStep last(*storage);
+    last.addPairSecondOrder(*mid,
         [h](auto& pr, auto& pv, const auto& UNUSED(pdv), auto& cr, const auto& cv, const auto& cdv) INL {
             using Type = typename std::decay_t<decltype(pr)>;
             pv = Type(0.5_f * (pv + cv + h * cdv));
             pr = Type(0.5_f * (pr + cr + h * cv));
             SPH_ASSERT(isReal(pv) && isReal(pr));
         });
-    stepPairFirstOrder(*storage,
-        *mid,
-        scheduler,
+    last.addPairFirstOrder(*mid,
         [h](auto& px, const auto& UNUSED(pdx), const auto& cx, const auto& cdx) INL {
             using Type = typename std::decay_t<decltype(px)>;
             px = Type(0.5_f * (px + cx + h * cdx));
             SPH_ASSERT(isReal(px));
         });
+    last.run(scheduler);
 }
 
 //-----------------------------------------------------------------------------------------------------------
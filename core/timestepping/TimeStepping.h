@@ -145,6 +145,59 @@ protected:
 };
 
 
+/// \brief Explicit Runge-Kutta timestepping with 2N-storage.
+///
+/// Unlike \ref RungeKutta, which needs four complete copies of the storage, the low-storage scheme keeps
+/// only a single auxiliary register for each evolved state array (values of first-order quantities, values
+/// and first derivatives of second-order quantities). Each stage evaluates the derivatives directly in the
+/// main storage and then updates the register and the state as
+/// \f[ q_i = A_i q_{i-1} + \Delta t f(u_{i-1}), \qquad u_i = u_{i-1} + B_i q_i. \f]
+/// The scheme is selected by \ref RunSettingsId::TIMESTEPPING_INTEGRATOR; supported are the 3rd-order
+/// scheme of Williamson (1980) and the 4th-order scheme of Carpenter & Kennedy (1994).
+class LowStorageRungeKutta : public ITimeStepping {
+private:
+    /// Auxiliary storage holding the registers. First-order quantities are stored as zero-order
+    /// quantities, second-order quantities as first-order quantities (register of values and register of
+    /// first derivatives). Must be kept synchronized with the main storage.
+    SharedPtr<Storage> registers;
+
+    /// Coefficients of the scheme; A[0] is always zero
+    Array<Float> A;
+    Array<Float> B;
+
+public:
+    LowStorageRungeKutta(const SharedPtr<Storage>& storage, const RunSettings& settings);
+
+    ~LowStorageRungeKutta() override;
+
+protected:
+    virtual void stepParticles(IScheduler& scheduler, ISolver& solver, Statistics& stats) override;
+
+    void advanceStage(IScheduler& scheduler, const Float a, const Float b);
+};
+
+/// \brief Strong stability preserving Runge-Kutta timestepping of 3rd order.
+///
+/// Uses the Shu-Osher form of the scheme, where each stage is a convex combination of the state at the
+/// beginning of the timestep and a forward Euler step. Only the initial state needs to be stored in an
+/// auxiliary register, the memory requirements are thus the same as for \ref LowStorageRungeKutta.
+class SspRungeKutta : public ITimeStepping {
+private:
+    /// Auxiliary storage holding the state at the beginning of the timestep, using the same layout as
+    /// registers in \ref LowStorageRungeKutta.
+    SharedPtr<Storage> initial;
+
+public:
+    SspRungeKutta(const SharedPtr<Storage>& storage, const RunSettings& settings);
+
+    ~SspRungeKutta() override;
+
+protected:
+    virtual void stepParticles(IScheduler& scheduler, ISolver& solver, Statistics& stats) override;
+
+    void advanceStage(IScheduler& scheduler, const Float a, const bool saveInitial);
+};
+
 class ModifiedMidpointMethod : public ITimeStepping {
 private:
     SharedPtr<Storage> mid;
@@ -33,6 +33,43 @@ static void benchmarkTimestepping(const Size N, Benchmark::Context& context) {
 #endif
 }
 
+namespace {
+/// Solver with no computation, used to measure the overhead of the timestepping itself.
+class NullSolver : public ISolver {
+public:
+    virtual void integrate(Storage& UNUSED(storage), Statistics& UNUSED(stats)) override {}
+
+    virtual void create(Storage& UNUSED(storage), IMaterial& UNUSED(material)) const override {}
+};
+} // namespace
+
+template <typename Timestepping>
+static void benchmarkUpdate(const Size N, Benchmark::Context& context) {
+    Tbb& tbb = *Tbb::getGlobalInstance();
+    SharedPtr<Storage> storage = makeShared<Storage>(Tests::getSolidStorage(N));
+    RunSettings settings;
+    settings.set(RunSettingsId::TIMESTEPPING_CRITERION, EMPTY_FLAGS);
+    Timestepping timestep(storage, settings);
+
+    NullSolver solver;
+    Statistics stats;
+    while (context.running()) {
+        timestep.step(tbb, solver, stats);
+    }
+}
+
+BENCHMARK("EulerExplicit update N=1e6", "[timestepping]", Benchmark::Context& context) {
+    benchmarkUpdate<EulerExplicit>(1000000, context);
+}
+
+BENCHMARK("LeapFrog update N=1e6", "[timestepping]", Benchmark::Context& context) {
+    benchmarkUpdate<LeapFrog>(1000000, context);
+}
+
+BENCHMARK("PredictorCorrector update N=1e6", "[timestepping]", Benchmark::Context& context) {
+    benchmarkUpdate<PredictorCorrector>(1000000, context);
+}
+
 BENCHMARK("EulerExplicit N=1e5", "[timestepping]", Benchmark::Context& context) {
     benchmarkTimestepping<EulerExplicit>(100000, context);
 }
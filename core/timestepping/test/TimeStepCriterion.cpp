@@ -151,4 +151,64 @@ TEST_CASE("Acceleration Criterion", "[timestepping]") {
     REQUIRE(step.id == CriterionId::MAXIMAL_VALUE);
 }
 
+static void testFusedCriterion(const Float power) {
+    RunSettings settings;
+    settings.set(RunSettingsId::TIMESTEPPING_CRITERION, TimeStepCriterionEnum::ALL);
+    settings.set(RunSettingsId::TIMESTEPPING_MEAN_POWER, power);
+    ThreadPool& pool = *ThreadPool::getGlobalInstance();
+    Storage storage = getStorage();
+    storage.insert<Float>(QuantityId::VELOCITY_DIVERGENCE, OrderEnum::ZERO, 0._f);
+
+    ArrayView<Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    ArrayView<Float> divv = storage.getValue<Float>(QuantityId::VELOCITY_DIVERGENCE);
+    for (Size i = 0; i < r.size(); ++i) {
+        dv[i] = Vector(0.01_f * i, 0._f, 0._f);
+        divv[i] = 0.005_f * Float(i % 7);
+    }
+
+    Array<AutoPtr<ITimeStepCriterion>> criteria;
+    criteria.push(makeAuto<CourantCriterion>(settings));
+    criteria.push(makeAuto<DerivativeCriterion>(settings));
+    criteria.push(makeAuto<AccelerationCriterion>(settings));
+    criteria.push(makeAuto<DivergenceCriterion>(settings));
+
+    for (Float maxStep : { INFTY, 1._f, 1.e-3_f }) {
+        Array<TimeStep> expectedDts(r.size());
+        expectedDts.fill(TimeStep{ INFTY, CriterionId::INITIAL_VALUE });
+        TimeStep expected{ INFTY, CriterionId::INITIAL_VALUE };
+        Statistics expectedStats;
+        for (AutoPtr<ITimeStepCriterion>& criterion : criteria) {
+            const TimeStep step = criterion->compute(pool, storage, maxStep, expectedStats, expectedDts);
+            if (step.value < expected.value) {
+                expected = step;
+            }
+        }
+
+        FusedCriterion fused(settings);
+        Array<TimeStep> dts(r.size());
+        dts.fill(TimeStep{ INFTY, CriterionId::INITIAL_VALUE });
+        Statistics stats;
+        const TimeStep step = fused.compute(pool, storage, maxStep, stats, dts);
+        REQUIRE(step.value == approx(expected.value));
+        REQUIRE(step.id == expected.id);
+        REQUIRE(stats.get<QuantityId>(StatisticsId::LIMITING_QUANTITY) ==
+                expectedStats.get<QuantityId>(StatisticsId::LIMITING_QUANTITY));
+
+        bool dtsMatch = true;
+        for (Size i = 0; i < r.size(); ++i) {
+            dtsMatch &= dts[i].value == expectedDts[i].value && dts[i].id == expectedDts[i].id;
+        }
+        REQUIRE(dtsMatch);
+    }
+}
+
+TEST_CASE("Fused Criterion minimum", "[timestepping]") {
+    testFusedCriterion(-INFTY);
+}
+
+TEST_CASE("Fused Criterion mean", "[timestepping]") {
+    testFusedCriterion(-5._f);
+}
+
 /// \todo test multicriterion
@@ -3,6 +3,7 @@
 #include "quantities/Quantity.h"
 #include "quantities/Storage.h"
 #include "sph/Materials.h"
+#include "system/Factory.h"
 #include "system/Settings.h"
 #include "system/Statistics.h"
 #include "tests/Approx.h"
@@ -303,6 +304,58 @@ TEST_CASE("ModifiedMidpoint", "[timestepping]") {
     }
 }
 
+TEST_CASE("LowStorageRungeKutta", "[timestepping]") {
+    RunSettings settings;
+    TestContext context;
+    settings.set(RunSettingsId::TIMESTEPPING_INTEGRATOR, TimesteppingEnum::LOW_STORAGE_RK3);
+    context.callsPerStep = 3;
+    testAll<LowStorageRungeKutta>(settings, context);
+
+    settings.set(RunSettingsId::TIMESTEPPING_INTEGRATOR, TimesteppingEnum::LOW_STORAGE_RK4);
+    context.callsPerStep = 5;
+    testAll<LowStorageRungeKutta>(settings, context);
+
+    settings.set(RunSettingsId::TIMESTEPPING_INTEGRATOR, TimesteppingEnum::EULER_EXPLICIT);
+    SharedPtr<Storage> storage = makeShared<Storage>(Tests::getGassStorage(10));
+    REQUIRE_THROWS_AS(LowStorageRungeKutta(storage, settings), InvalidSetup);
+}
+
+TEST_CASE("SspRungeKutta", "[timestepping]") {
+    RunSettings settings;
+    TestContext context;
+    context.callsPerStep = 3;
+    testAll<SspRungeKutta>(settings, context);
+}
+
+static Float getOscillatorError(const TimesteppingEnum id, const Float dt) {
+    SharedPtr<Storage> storage = makeShared<Storage>(getMaterial(MaterialEnum::BASALT));
+    storage->insert<Vector>(
+        QuantityId::POSITION, OrderEnum::SECOND, Array<Vector>{ Vector(1._f, 0._f, 0._f) });
+    RunSettings settings;
+    settings.set(RunSettingsId::TIMESTEPPING_INTEGRATOR, id);
+    settings.set(RunSettingsId::TIMESTEPPING_INITIAL_TIMESTEP, dt);
+    settings.set(RunSettingsId::TIMESTEPPING_CRITERION, EMPTY_FLAGS);
+    AutoPtr<ITimeStepping> timestepping = Factory::getTimeStepping(settings, storage);
+    HarmonicOscillator solver;
+    Statistics stats;
+    // integrate over a single period
+    const Size stepCnt = Size(std::round(solver.period / dt));
+    for (Size i = 0; i < stepCnt; ++i) {
+        timestepping->step(SEQUENTIAL, solver, stats);
+    }
+    return getLength(storage->getValue<Vector>(QuantityId::POSITION)[0] - Vector(1._f, 0._f, 0._f));
+}
+
+TEST_CASE("LowStorageRungeKutta order", "[timestepping]") {
+    auto getOrder = [](const TimesteppingEnum id) {
+        return std::log2(getOscillatorError(id, 0.02_f) / getOscillatorError(id, 0.01_f));
+    };
+    // the schemes can have higher order for linear problems, so we only check the lower bound
+    REQUIRE(getOrder(TimesteppingEnum::LOW_STORAGE_RK3) > 2.9_f);
+    REQUIRE(getOrder(TimesteppingEnum::LOW_STORAGE_RK4) > 3.9_f);
+    REQUIRE(getOrder(TimesteppingEnum::SSP_RK3) > 2.9_f);
+}
+
 /// \todo test timestepping of other quantities (first order and sanity check that zero-order quantities
 /// remain unchanged).
 
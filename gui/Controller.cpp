@@ -11,6 +11,7 @@
 #include "gui/windows/RunPage.h"
 #include "run/Node.h"
 #include "run/jobs/IoJobs.h"
+#include "system/Factory.h"
 #include "system/Profiler.h"
 #include "system/Statistics.h"
 #include "system/Timer.h"
@@ -24,6 +25,16 @@
 
 NAMESPACE_SPH_BEGIN
 
+struct Controller::Vis::Frame {
+    /// Copy of the quantities needed to render the frame
+    Storage storage;
+
+    Statistics stats;
+
+    /// Colorizer used to select the copied quantities
+    SharedPtr<IColorizer> colorizer;
+};
+
 Controller::Controller(wxWindow* parent)
     : project(Project::getInstance()) {
 
@@ -50,6 +61,7 @@ Controller::Vis::Vis() {
     needsRefresh = false;
     refreshPending = false;
     redrawOnNextTimeStep = false;
+    pickIndexValid = false;
 }
 
 void Controller::Vis::initialize(const Project& project) {
@@ -299,12 +311,6 @@ void Controller::onTimeStep(const Storage& storage, Statistics& stats) {
         this->redraw(storage, stats);
         vis.timer->restart();
         vis.redrawOnNextTimeStep = false;
-
-        executeOnMainThread([this] {
-            // update particle probe - has to be done after we redraw the image as it initializes
-            // the colorizer
-            this->setSelectedParticle(vis.selectedParticle);
-        });
     }
 
     // pause if we are supposed to
@@ -460,10 +466,14 @@ Optional<Size> Controller::getIntersectedParticle(const Pixel position, const fl
     if (!ray) {
         return NOTHING;
     }
+    /// \todo This is really weird, we are duplicating code of ParticleRenderer in a function that
+    /// really makes only sense with ParticleRenderer. Needs refactoring.
+    SharedPtr<const Array<Vector>> positions = this->updatePickIndex();
+    if (!positions) {
+        return NOTHING;
+    }
 
-    const float cutoff = camera->getCutoff().valueOr(0.f);
     const Vector rayDir = getNormalized(ray->target - ray->origin);
-    const Vector camDir = camera->getFrame().row(2);
 
     struct {
         float t = -std::numeric_limits<float>::lowest();
@@ -471,36 +481,28 @@ Optional<Size> Controller::getIntersectedParticle(const Pixel position, const fl
         bool wasHitOutside = true;
     } first;
 
-    for (Size i = 0; i < vis.positions.size(); ++i) {
-        Optional<ProjectedPoint> p = camera->project(vis.positions[i]);
-        if (!p) {
-            // particle not visible by the camera
-            continue;
-        }
-        if (cutoff != 0._f && abs(dot(camDir, vis.positions[i])) > cutoff) {
-            // particle cut off by projection
-            /// \todo This is really weird, we are duplicating code of ParticleRenderer in a function that
-            /// really makes only sense with ParticleRenderer. Needs refactoring.
-            continue;
-        }
-
-        const Vector r = vis.positions[i] - ray->origin;
-        const float t = float(dot(r, rayDir));
-        const Vector projected = r - t * rayDir;
-        /// \todo this radius computation is actually renderer-specific ...
-        const float radiusSqr = float(sqr(vis.positions[i][H] * radius));
-        const float distanceSqr = float(getSqrLength(projected));
-        if (distanceSqr < radiusSqr * sqr(1._f + toleranceEps)) {
-            const bool wasHitOutside = distanceSqr > radiusSqr;
-            // hit candidate, check if it's closer or current candidate was hit outside the actual radius
-            if (t < first.t || (first.wasHitOutside && !wasHitOutside)) {
-                // update the current candidate
-                first.idx = i;
-                first.t = t;
-                first.wasHitOutside = wasHitOutside;
+    // only particles projected close to the cursor can be hit; the precise check is done in 3D
+    const float radiusScale = radius * (1.f + toleranceEps);
+    const Array<Vector>& r0 = *positions;
+    vis.pickIndex.findNearby(
+        Coords(position), radiusScale, 1.f, [&](const Size i, const Coords&, const float) {
+            const Vector r = r0[i] - ray->origin;
+            const float t = float(dot(r, rayDir));
+            const Vector projected = r - t * rayDir;
+            /// \todo this radius computation is actually renderer-specific ...
+            const float radiusSqr = float(sqr(r0[i][H] * radius));
+            const float distanceSqr = float(getSqrLength(projected));
+            if (distanceSqr < radiusSqr * sqr(1._f + toleranceEps)) {
+                const bool wasHitOutside = distanceSqr > radiusSqr;
+                // hit candidate, check if it's closer or current candidate was hit outside the actual radius
+                if (t < first.t || (first.wasHitOutside && !wasHitOutside)) {
+                    // update the current candidate
+                    first.idx = i;
+                    first.t = t;
+                    first.wasHitOutside = wasHitOutside;
+                }
             }
-        }
-    }
+        });
     if (int(first.idx) == -1) { /// \todo wait, -INFTY != -inf ?? // (first.t == -INFTY) {
         // not a single candidate found
         return NOTHING;
@@ -512,6 +514,12 @@ Optional<Size> Controller::getIntersectedParticle(const Pixel position, const fl
 void Controller::setColorizer(const SharedPtr<IColorizer>& newColorizer) {
     CHECK_FUNCTION(CheckFunction::MAIN_THREAD);
     vis.colorizer = newColorizer;
+    {
+        // pending frame has been created for the previous colorizer and might not contain the quantities
+        // needed by the new one
+        std::unique_lock<std::mutex> frameLock(vis.frameMutex);
+        vis.pendingFrame.reset();
+    }
     Palette palette;
     if (project.getPalette(vis.colorizer->name(), palette)) {
         vis.colorizer->setPalette(palette);
@@ -532,6 +540,11 @@ void Controller::setRenderer(AutoPtr<IRenderer>&& newRenderer) {
         SPH_ASSERT(sph.run);
         std::unique_lock<std::mutex> renderLock(vis.renderThreadMutex);
         vis.renderer = std::move(renderer);
+        {
+            // pending frame might not contain the quantities needed by the new renderer
+            std::unique_lock<std::mutex> frameLock(vis.frameMutex);
+            vis.pendingFrame.reset();
+        }
         vis.colorizer->initialize(storage, RefEnum::STRONG);
         vis.renderer->initialize(storage, *vis.colorizer, *vis.camera);
         vis.refresh();
@@ -557,7 +570,12 @@ void Controller::setSelectedParticle(const Optional<Size>& particleIdx) {
         Optional<Particle> particle = vis.colorizer->getParticle(particleIdx.value());
         if (particle) {
             // add position to the particle data
-            particle->addValue(QuantityId::POSITION, vis.positions[particleIdx.value()]);
+            std::unique_lock<std::mutex> pickLock(vis.pickMutex);
+            SharedPtr<const Array<Vector>> positions = vis.positions;
+            pickLock.unlock();
+            if (positions && particleIdx.value() < positions->size()) {
+                particle->addValue(QuantityId::POSITION, (*positions)[particleIdx.value()]);
+            }
             page->setSelectedParticle(particle.value(), color);
             return;
         }
@@ -574,6 +592,44 @@ void Controller::setPaletteOverride(const Palette palette) {
     this->tryRedraw();
 }
 
+Array<Size> Controller::getParticlesInRegion(ArrayView<const Pixel> polygon) {
+    CHECK_FUNCTION(CheckFunction::MAIN_THREAD);
+
+    if (!vis.colorizer->isInitialized() || polygon.size() < 2) {
+        return {};
+    }
+    if (!this->updatePickIndex()) {
+        return {};
+    }
+
+    if (polygon.size() == 2) {
+        return vis.pickIndex.findInRect(Coords(polygon[0]), Coords(polygon[1]));
+    }
+    Array<Coords> coords;
+    for (const Pixel& p : polygon) {
+        coords.push(Coords(p));
+    }
+    return vis.pickIndex.findInPolygon(coords);
+}
+
+SharedPtr<const Array<Vector>> Controller::updatePickIndex() {
+    CHECK_FUNCTION(CheckFunction::MAIN_THREAD);
+
+    // the lock prevents the render thread from replacing the positions while the index is built
+    std::unique_lock<std::mutex> pickLock(vis.pickMutex);
+    if (!vis.pickIndexValid && vis.positions) {
+        // camera or particles changed since the last query, rebuild the index
+        std::unique_lock<std::mutex> cameraLock(vis.cameraMutex);
+        AutoPtr<ICamera> camera = vis.camera->clone();
+        cameraLock.unlock();
+        vis.pickIndex.build(*Factory::getScheduler(), *vis.positions, *camera);
+
+        // only mark the index as valid once it is built
+        vis.pickIndexValid = true;
+    }
+    return vis.positions;
+}
+
 Optional<Size> Controller::getSelectedParticle() const {
     return vis.selectedParticle;
 }
@@ -586,16 +642,50 @@ const Storage& Controller::getStorage() const {
 void Controller::redraw(const Storage& storage, const Statistics& stats) {
     CHECK_FUNCTION(CheckFunction::NO_THROW);
 
+    // we create a local copy as vis.colorizer might be changed in setColorizer before the frame is rendered
+    SharedPtr<IColorizer> colorizer = vis.colorizer;
+
+    if (storage.getUserData()) {
+        // user data cannot be cloned, initialize the view directly from the storage
+        vis.renderer->cancelRender();
+        std::unique_lock<std::mutex> renderLock(vis.renderThreadMutex);
+        this->initializeView(storage, stats, colorizer);
+        vis.refresh();
+        return;
+    }
+
+    SharedPtr<Vis::Frame> frame = makeShared<Vis::Frame>();
+    Array<QuantityId> ids{ QuantityId::POSITION };
+    if (colorizer->addRequiredQuantities(ids) && vis.renderer->addRequiredQuantities(ids)) {
+        frame->storage = storage.clone(VisitorEnum::ALL_BUFFERS, ids);
+    } else {
+        frame->storage = storage.clone(VisitorEnum::ALL_BUFFERS);
+    }
+    frame->stats = stats;
+    frame->colorizer = colorizer;
+    {
+        std::unique_lock<std::mutex> frameLock(vis.frameMutex);
+        vis.pendingFrame = std::move(frame);
+    }
+
+    // the render in progress shows a stale frame, interrupt it
     vis.renderer->cancelRender();
-    std::unique_lock<std::mutex> renderLock(vis.renderThreadMutex);
+    vis.refresh();
+}
 
+void Controller::initializeView(const Storage& storage,
+    const Statistics& stats,
+    const SharedPtr<IColorizer>& colorizer) {
     vis.stats = makeAuto<Statistics>(stats);
-    vis.positions = copyable(storage.getValue<Vector>(QuantityId::POSITION));
+    {
+        SharedPtr<Array<Vector>> positions =
+            makeShared<Array<Vector>>(storage.getValue<Vector>(QuantityId::POSITION).clone());
+        std::unique_lock<std::mutex> pickLock(vis.pickMutex);
+        vis.positions = std::move(positions);
+        vis.pickIndexValid = false;
+    }
 
-    // initialize the currently selected colorizer; we create a local copy as vis.colorizer might be changed
-    // in setColorizer before renderer->initialize is called
     SPH_ASSERT(vis.isInitialized());
-    SharedPtr<IColorizer> colorizer = vis.colorizer;
     colorizer->initialize(storage, RefEnum::STRONG);
 
     // setup camera
@@ -611,8 +701,10 @@ void Controller::redraw(const Storage& storage, const Statistics& stats) {
     // update the renderer with new data
     vis.renderer->initialize(storage, *colorizer, *camera);
 
-    // notify the render thread that new data are available
-    vis.refresh();
+    executeOnMainThread([this] {
+        // update particle probe - has to be done after the colorizer is initialized
+        this->setSelectedParticle(vis.selectedParticle);
+    });
 }
 
 bool Controller::tryRedraw() {
@@ -644,17 +736,24 @@ void Controller::redrawOnNextTimeStep() {
 void Controller::refresh(AutoPtr<ICamera>&& camera) {
     // invalidate camera, render will be restarted on next timestep
     vis.renderer->cancelRender();
-    std::unique_lock<std::mutex> lock(vis.cameraMutex);
-    vis.camera = std::move(camera);
-    vis.refresh();
-
-    // save the current fov to settings
-    /// \todo generalize
-    if (const Optional<float> wtp = vis.camera->getWorldToPixel()) {
-        const Pixel imageSize = vis.camera->getSize();
-        const Float fov = imageSize.y / wtp.value();
-        project.getGuiSettings().set(GuiSettingsId::CAMERA_ORTHO_FOV, fov);
+    {
+        std::unique_lock<std::mutex> lock(vis.cameraMutex);
+        vis.camera = std::move(camera);
+
+        // save the current fov to settings
+        /// \todo generalize
+        if (const Optional<float> wtp = vis.camera->getWorldToPixel()) {
+            const Pixel imageSize = vis.camera->getSize();
+            const Float fov = imageSize.y / wtp.value();
+            project.getGuiSettings().set(GuiSettingsId::CAMERA_ORTHO_FOV, fov);
+        }
     }
+    {
+        // invalidated after the camera is replaced, so that the index cannot be rebuilt for the old camera
+        std::unique_lock<std::mutex> pickLock(vis.pickMutex);
+        vis.pickIndexValid = false;
+    }
+    vis.refresh();
 }
 
 void Controller::refresh() {
@@ -754,6 +853,16 @@ void Controller::startRenderThread() {
             });
             vis.needsRefresh = false;
 
+            {
+                // take the latest frame published by the run thread; older frames have been already dropped
+                std::unique_lock<std::mutex> frameLock(vis.frameMutex);
+                SharedPtr<Vis::Frame> frame = std::move(vis.pendingFrame);
+                frameLock.unlock();
+                if (frame && status != RunStatus::QUITTING) {
+                    this->initializeView(frame->storage, frame->stats, frame->colorizer);
+                }
+            }
+
             if (!vis.isInitialized() || status == RunStatus::QUITTING) {
                 // no simulation running, go back to sleep
                 continue;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gui/Settings.h"
+#include "gui/objects/ScreenIndex.h"
 #include "gui/windows/WeakRef.h"
 #include "io/Path.h"
 #include "objects/wrappers/Locking.h"
@@ -79,8 +80,19 @@ private:
 
     /// \brief Components used to render particles into the window.
     struct Vis {
-        /// Cached positions of particles for visualization.
-        Array<Vector> positions;
+        /// \brief Cached positions of particles for visualization.
+        ///
+        /// Replaced by the render thread when it initializes the view, guarded by pickMutex. The array itself
+        /// is never modified, so it can be read without the lock once the pointer is copied.
+        SharedPtr<const Array<Vector>> positions;
+
+        /// \brief Screen-space index of cached positions, used to pick particles.
+        ///
+        /// Built lazily on the main thread; invalidated when the positions or the camera change. The index
+        /// and the validity flag are guarded by pickMutex.
+        ScreenParticleIndex pickIndex;
+        bool pickIndexValid;
+        std::mutex pickMutex;
 
         /// Copy of statistics when the colorizer was initialized
         AutoPtr<Statistics> stats;
@@ -117,6 +129,17 @@ private:
         /// Flag used to avoid queuing multiple renders
         mutable std::atomic_bool refreshPending;
 
+        /// Snapshot of the run published by the run thread for the render thread.
+        struct Frame;
+
+        /// \brief Latest frame not yet taken by the render thread.
+        ///
+        /// The run thread builds a new frame while the render thread renders the previous one, so at most
+        /// three frames exist at once. A frame replaced before the render thread takes it is dropped. Guarded
+        /// by frameMutex, which is held only while swapping the pointer.
+        SharedPtr<Frame> pendingFrame;
+        std::mutex frameMutex;
+
         /// Thread used for rendering.
         std::thread renderThread;
 
@@ -186,6 +209,12 @@ public:
     ///                     be under the point of they are closer than (displayedRadius * (1+toleranceEps)).
     Optional<Size> getIntersectedParticle(const Pixel position, const float toleranceEps);
 
+    /// \brief Returns all particles projected inside given region of the image.
+    ///
+    /// \param polygon Vertices of the region in image coordinates. Two vertices are interpreted as opposite
+    ///                corners of a rectangle, more vertices define a (possibly non-convex) lasso polygon.
+    Array<Size> getParticlesInRegion(ArrayView<const Pixel> polygon);
+
     Optional<Size> getSelectedParticle() const;
 
     const Storage& getStorage() const;
@@ -316,9 +345,22 @@ private:
 
     /// \brief Redraws the particles.
     ///
-    /// Can be called from any thread. Function blocks until the particles are redrawn.
+    /// Can be called from any thread. The function copies the quantities needed by the current colorizer and
+    /// renderer and passes them to the render thread; it does not wait for the render to finish.
     void redraw(const Storage& storage, const Statistics& stats);
 
+    /// \brief Builds the pick index if it has been invalidated.
+    ///
+    /// Must be called from main thread. Returns the positions used to build the index.
+    SharedPtr<const Array<Vector>> updatePickIndex();
+
+    /// \brief Initializes the colorizer and the renderer with given data.
+    ///
+    /// Must be called with renderThreadMutex locked.
+    void initializeView(const Storage& storage,
+        const Statistics& stats,
+        const SharedPtr<IColorizer>& colorizer);
+
     // main thread call if page exists
     void safePageCall(Function<void(RunPage*)> func);
 
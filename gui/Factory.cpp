@@ -77,7 +77,7 @@ AutoPtr<IRenderer> Factory::getRenderer(SharedPtr<IScheduler> scheduler, const G
         renderer = makeAuto<NullRenderer>();
         break;
     case RendererEnum::PARTICLE:
-        renderer = makeAuto<ParticleRenderer>(settings);
+        renderer = makeAuto<ParticleRenderer>(scheduler, settings);
         break;
     case RendererEnum::MESH:
         renderer = makeAuto<MeshRenderer>(scheduler, settings);
@@ -182,6 +182,8 @@ AutoPtr<IColorizer> Factory::getColorizer(const GuiSettings& settings, const Ext
         switch (getMetadata(quantity).expectedType) {
         case ValueEnum::INDEX:
             return makeAuto<TypedColorizer<Size>>(quantity, std::move(palette));
+        case ValueEnum::GLOBAL_INDEX:
+            return makeAuto<TypedColorizer<GlobalSize>>(quantity, std::move(palette));
         case ValueEnum::SCALAR:
             return makeAuto<TypedColorizer<Float>>(quantity, std::move(palette));
         case ValueEnum::VECTOR:
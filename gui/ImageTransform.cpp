@@ -1,4 +1,5 @@
 #include "gui/ImageTransform.h"
+#include "objects/containers/StaticArray.h"
 #include "thread/ThreadLocal.h"
 
 NAMESPACE_SPH_BEGIN
@@ -23,35 +24,59 @@ Rgba interpolate(const Bitmap<Rgba>& bitmap, const float x, const float y) {
 }
 
 Bitmap<Rgba> resize(const Bitmap<Rgba>& input, const Pixel size) {
+    return resize(SEQUENTIAL, input, size);
+}
+
+Bitmap<Rgba> downsample(IScheduler& scheduler, const Bitmap<Rgba>& input) {
+    const Pixel inputSize = input.size();
+    Bitmap<Rgba> half(Pixel((inputSize.x + 1) / 2, (inputSize.y + 1) / 2));
+    parallelFor(scheduler, 0, half.size().y, 1, [&](const int y) {
+        const int y1 = 2 * y;
+        const int y2 = min(y1 + 1, inputSize.y - 1);
+        for (int x = 0; x < half.size().x; ++x) {
+            const int x1 = 2 * x;
+            const int x2 = min(x1 + 1, inputSize.x - 1);
+            // for odd sizes, the last row and column are averaged with themselves
+            half(x, y) = (input(x1, y1) + input(x2, y1) + input(x1, y2) + input(x2, y2)) / 4.f;
+        }
+    });
+    return half;
+}
+
+Bitmap<Rgba> resize(IScheduler& scheduler, const Bitmap<Rgba>& input, const Pixel size) {
     const float scaleX = float(input.size().x) / size.x;
     const float scaleY = float(input.size().y) / size.y;
     if (min(scaleX, scaleY) > 2) {
         // first do area-based scaling to 1/2 (and possibly recursively more)
         Bitmap<Rgba> half(input.size() / 2);
-        for (int y = 0; y < half.size().y; ++y) {
+        parallelFor(scheduler, 0, half.size().y, 1, [&](const int y) {
             for (int x = 0; x < half.size().x; ++x) {
                 const int x1 = 2 * x;
                 const int y1 = 2 * y;
                 half(x, y) =
                     (input(x1, y1) + input(x1 + 1, y1) + input(x1, y1 + 1) + input(x1 + 1, y1 + 1)) / 4.f;
             }
-        }
-        return resize(half, size);
+        });
+        return resize(scheduler, half, size);
     } else {
         Bitmap<Rgba> resized(size);
-        for (int y = 0; y < size.y; ++y) {
+        parallelFor(scheduler, 0, size.y, 1, [&](const int y) {
             for (int x = 0; x < size.x; ++x) {
                 resized(x, y) = interpolate(input, scaleX * x, scaleY * y);
             }
-        }
+        });
         return resized;
     }
 }
 
 Bitmap<float> detectEdges(const Bitmap<Rgba>& input) {
+    return detectEdges(SEQUENTIAL, input);
+}
+
+Bitmap<float> detectEdges(IScheduler& scheduler, const Bitmap<Rgba>& input) {
     Bitmap<float> disc(input.size());
     Rectangle rect(Pixel(0, 0), input.size() - Pixel(1, 1));
-    for (int y = 0; y < input.size().y; ++y) {
+    parallelFor(scheduler, 0, input.size().y, 1, [&](const int y) {
         for (int x = 0; x < input.size().x; ++x) {
             Rectangle patch = rect.intersect(Rectangle::window(Pixel(x, y), 1));
             const float intensity2 = input(x, y).intensity();
@@ -64,40 +89,8 @@ Bitmap<float> detectEdges(const Bitmap<Rgba>& input) {
             }
             disc(x, y) = maxDiff;
         }
-    }
-    return disc;
-}
-
-template <typename TFilter>
-Bitmap<Rgba> filter(IScheduler& scheduler,
-    const Bitmap<Rgba>& input,
-    const Size radius,
-    const TFilter& func) {
-    Bitmap<Rgba> result(input.size());
-    Rectangle rect(Pixel(0, 0), input.size() - Pixel(1, 1));
-    parallelFor(scheduler, 0, input.size().y, 1, [&](const Size y) {
-        for (int x = 0; x < input.size().x; ++x) {
-            Rgba sum = Rgba::black();
-            float weight = 0.f;
-            Rectangle window = rect.intersect(Rectangle::window(Pixel(x, y), radius));
-            for (int y1 : window.rowRange()) {
-                for (int x1 : window.colRange()) {
-                    const float w = func(Pixel(x, y), Pixel(x1, y1));
-                    SPH_ASSERT(isReal(w));
-                    sum += input(x1, y1) * w;
-                    weight += w;
-                }
-            }
-            if (weight > 0) {
-                SPH_ASSERT(isReal(sum.r()) && isReal(sum.g()) && isReal(sum.b()));
-                SPH_ASSERT(weight > 0.f, weight);
-                result(x, y) = sum / weight;
-            } else {
-                result(x, y) = Rgba::black();
-            }
-        }
     });
-    return result;
+    return disc;
 }
 
 Bitmap<Rgba> gaussianBlur(IScheduler& scheduler, const Bitmap<Rgba>& input, const int radius) {
@@ -186,59 +179,229 @@ Bitmap<Rgba> gaussianBlur(IScheduler& scheduler, const Bitmap<Rgba>& input, cons
     return blurred;
 }
 
+/// \brief Returns radii of three box filters approximating the Gaussian filter with given sigma.
+///
+/// See Kovesi: Fast Almost-Gaussian Filtering (2010).
+static StaticArray<int, 3> getBoxRadii(const float sigma) {
+    constexpr int n = 3;
+    const float idealWidth = sqrt(12.f * sqr(sigma) / n + 1.f);
+    int lower = int(idealWidth);
+    if (lower % 2 == 0) {
+        lower--;
+    }
+    const int upper = lower + 2;
+    const float idealCnt = (12.f * sqr(sigma) - n * sqr(lower) - 4 * n * lower - 3 * n) / (-4.f * lower - 4.f);
+    const int lowerCnt = int(std::round(idealCnt));
+    StaticArray<int, 3> radii;
+    for (int i = 0; i < n; ++i) {
+        radii[i] = ((i < lowerCnt ? lower : upper) - 1) / 2;
+    }
+    return radii;
+}
+
+/// \brief Applies the box filter to a line of pixels, using a running sum.
+static void boxBlur(ArrayView<const Rgba> in, ArrayView<Rgba> out, const int radius) {
+    SPH_ASSERT(in.size() == out.size());
+    const int n = in.size();
+    const float norm = 1.f / (2 * radius + 1);
+    Rgba sum = in[0] * float(radius + 1);
+    for (int i = 1; i <= radius; ++i) {
+        sum += in[min(i, n - 1)];
+    }
+    for (int i = 0; i < n; ++i) {
+        out[i] = sum * norm;
+        sum += in[min(i + radius + 1, n - 1)] - in[max(i - radius, 0)];
+    }
+}
+
+/// \brief Applies all box filters to a line of pixels, the result is stored back into the line.
+static void boxBlurCascade(ArrayView<Rgba> line, ArrayView<Rgba> buffer, const StaticArray<int, 3>& radii) {
+    boxBlur(line, buffer, radii[0]);
+    boxBlur(buffer, line, radii[1]);
+    boxBlur(line, buffer, radii[2]);
+    std::copy(buffer.begin(), buffer.end(), line.begin());
+}
+
+Bitmap<Rgba> fastGaussianBlur(IScheduler& scheduler, const Bitmap<Rgba>& input, const int radius) {
+    const StaticArray<int, 3> radii = getBoxRadii(radius / 4.f);
+    const Pixel size = input.size();
+    Bitmap<Rgba> blurred = input.clone();
+
+    // horizontal blur; rows are stored contiguously, so they can be processed in place
+    ThreadLocal<Array<Rgba>> rowBuffers(scheduler, size.x);
+    parallelFor(scheduler, rowBuffers, 0, size.y, 1, [&](const int y, Array<Rgba>& buffer) {
+        ArrayView<Rgba> row(blurred.data() + uint64_t(y) * size.x, size.x);
+        boxBlurCascade(row, buffer, radii);
+    });
+
+    // vertical blur
+    ThreadLocal<Array<Rgba>> columnBuffers(scheduler, 2 * size.y);
+    parallelFor(scheduler, columnBuffers, 0, size.x, 1, [&](const int x, Array<Rgba>& buffer) {
+        ArrayView<Rgba> column(&buffer[0], size.y);
+        ArrayView<Rgba> temp(&buffer[size.y], size.y);
+        for (int y = 0; y < size.y; ++y) {
+            column[y] = blurred(x, y);
+        }
+        boxBlurCascade(column, temp, radii);
+        for (int y = 0; y < size.y; ++y) {
+            blurred(x, y) = column[y];
+        }
+    });
+    return blurred;
+}
+
+/// Minimal radius of the blur used by the bloom effect; larger radii are handled by downsampling the image.
+constexpr int MIN_BLOOM_RADIUS = 8;
+
 Bitmap<Rgba> bloomEffect(IScheduler& scheduler,
     const Bitmap<Rgba>& input,
     const int radius,
     const float magnitude,
     const float intensityThreshold) {
-    Bitmap<Rgba> brightPixels =
-        transform(input, [intensityThreshold](const Pixel UNUSED(p), const Rgba& color) {
-            const float intensity = color.intensity();
-            if (intensity > intensityThreshold) {
-                return color;
-            } else {
-                return Rgba::black();
-            }
-        });
-    Bitmap<Rgba> bloom = gaussianBlur(scheduler, brightPixels, radius);
-    for (int y = 0; y < input.size().y; ++y) {
-        for (int x = 0; x < input.size().x; ++x) {
-            const Rgba& in = input(x, y);
-            Rgba& b = bloom(x, y);
-            b = in + b * magnitude;
-            SPH_ASSERT(isReal(b), b.r(), b.g(), b.b());
+    const Pixel size = input.size();
+    Bitmap<Rgba> brightPixels(size);
+    parallelFor(scheduler, 0, size.y, 1, [&](const int y) {
+        for (int x = 0; x < size.x; ++x) {
+            const Rgba& color = input(x, y);
+            brightPixels(x, y) = color.intensity() > intensityThreshold ? color : Rgba::black();
         }
+    });
+
+    // the bloom is smooth, so we can halve the resolution (and the radius) until the radius is small, the
+    // blur is then computed at the coarsest level of the pyramid; each level averages all pixels of the
+    // previous one, so that isolated bright pixels are not lost
+    int levelRadius = radius;
+    while (levelRadius > 2 * MIN_BLOOM_RADIUS && min(brightPixels.size().x, brightPixels.size().y) > 4) {
+        brightPixels = downsample(scheduler, brightPixels);
+        levelRadius /= 2;
     }
-    return bloom;
+    Bitmap<Rgba> bloom = fastGaussianBlur(scheduler, brightPixels, levelRadius);
+
+    // upsample and add to the input
+    Bitmap<Rgba> result(size);
+    const float scaleX = float(bloom.size().x) / size.x;
+    const float scaleY = float(bloom.size().y) / size.y;
+    parallelFor(scheduler, 0, size.y, 1, [&](const int y) {
+        for (int x = 0; x < size.x; ++x) {
+            const Rgba b = interpolate(bloom, scaleX * (x + 0.5f) - 0.5f, scaleY * (y + 0.5f) - 0.5f);
+            result(x, y) = input(x, y) + b * magnitude;
+            SPH_ASSERT(isReal(result(x, y)), result(x, y).r(), result(x, y).g(), result(x, y).b());
+        }
+    });
+    return result;
+}
+
+/// \brief Sums values in a sliding window [i - r, i + r - 1], values outside of the line are considered zero.
+static void windowSum(ArrayView<const float> in, ArrayView<float> out, ArrayView<double> prefix, const int r) {
+    const int n = in.size();
+    prefix[0] = 0.;
+    for (int i = 0; i < n; ++i) {
+        prefix[i + 1] = prefix[i] + in[i];
+    }
+    for (int i = 0; i < n; ++i) {
+        out[i] = float(prefix[clamp(i + r, 0, n)] - prefix[clamp(i - r, 0, n)]);
+    }
+}
+
+/// \brief Returns the number of pixels in the interval [i - r, i + r - 1] and in [0, n - 2] and [d, n - 1 + d].
+INLINE int getOverlap(const int i, const int r, const int n, const int d) {
+    const int from = max(i - r, 0, d);
+    const int to = min(i + r - 1, n - 2, n - 1 + d);
+    return max(to - from + 1, 0);
 }
 
 Bitmap<Rgba> denoise(IScheduler& scheduler, const Bitmap<Rgba>& input, const DenoiserParams& params) {
-    Rectangle rect(Pixel(0, 0), input.size() - Pixel(1, 1));
+    // Non-local means filter. The patch distances are computed for each offset of the filter window at once;
+    // squared differences of pixels are summed over patches by a separable box filter, so the cost per pixel
+    // does not depend on the patch radius. As in the original per-pixel implementation, the windows and the
+    // patches are half-open, i.e. they contain offsets from -radius to radius - 1, and the pixels in the last
+    // row and column are only compared to other pixels, they are not used as neighbors.
+    const Pixel size = input.size();
+    const int filterRadius = params.filterRadius;
+    const int patchRadius = params.patchRadius;
     const float norm = 1.f / (2.f * sqr(params.sigma));
-    return filter(scheduler, input, params.filterRadius, [&](const Pixel& p1, const Pixel& p2) {
-        Rectangle patch = rect.intersect(Rectangle::window(p2, params.patchRadius));
-        float distSqr = 0.f;
-        int count = 0;
-        for (int y : patch.rowRange()) {
-            for (int x : patch.colRange()) {
-                const Pixel pp2(x, y);
-                const Pixel pp1(pp2 - p2 + p1);
-                if (!rect.contains(pp1)) {
-                    continue;
+
+    Bitmap<Rgba> sum(size);
+    sum.fill(Rgba::black());
+    Bitmap<float> weight(size);
+    weight.fill(0.f);
+    Bitmap<float> dist(size);
+
+    struct Buffers {
+        Array<float> in, out;
+        Array<double> prefix;
+
+        explicit Buffers(const Size n) {
+            in.resize(n);
+            out.resize(n);
+            prefix.resize(n + 1);
+        }
+    };
+    ThreadLocal<Buffers> buffers(scheduler, max(size.x, size.y));
+
+    for (int dy = -filterRadius; dy < filterRadius; ++dy) {
+        for (int dx = -filterRadius; dx < filterRadius; ++dx) {
+            // squared differences of pixels shifted by the offset, summed over rows of the patches
+            parallelFor(scheduler, buffers, 0, size.y, 1, [&](const int y, Buffers& tl) {
+                ArrayView<float> diffs(&tl.in[0], size.x);
+                for (int x = 0; x < size.x; ++x) {
+                    const int x1 = x - dx;
+                    const int y1 = y - dy;
+                    if (x == size.x - 1 || y == size.y - 1 || x1 < 0 || x1 >= size.x || y1 < 0 ||
+                        y1 >= size.y) {
+                        diffs[x] = 0.f;
+                        continue;
+                    }
+                    const Rgba v1 = input(x1, y1);
+                    const Rgba v2 = input(x, y);
+                    diffs[x] = sqr(v1.r() - v2.r()) + sqr(v1.g() - v2.g()) + sqr(v1.b() - v2.b());
+                }
+                ArrayView<float> row(&dist(0, y), size.x);
+                windowSum(diffs, row, tl.prefix, patchRadius);
+            });
+            // sum over columns of the patches
+            parallelFor(scheduler, buffers, 0, size.x, 1, [&](const int x, Buffers& tl) {
+                ArrayView<float> column(&tl.in[0], size.y);
+                ArrayView<float> summed(&tl.out[0], size.y);
+                for (int y = 0; y < size.y; ++y) {
+                    column[y] = dist(x, y);
                 }
-                SPH_ASSERT(rect.contains(pp2));
+                windowSum(column, summed, tl.prefix, patchRadius);
+                for (int y = 0; y < size.y; ++y) {
+                    dist(x, y) = summed[y];
+                }
+            });
+            // accumulate the weighted pixels
+            parallelFor(scheduler, 0, size.y, 1, [&](const int y) {
+                const int y2 = y + dy;
+                if (y2 < 0 || y2 >= size.y - 1) {
+                    return;
+                }
+                const int countY = getOverlap(y2, patchRadius, size.y, dy);
+                for (int x = 0; x < size.x; ++x) {
+                    const int x2 = x + dx;
+                    if (x2 < 0 || x2 >= size.x - 1) {
+                        continue;
+                    }
+                    const int count = countY * getOverlap(x2, patchRadius, size.x, dx);
+                    SPH_ASSERT(count > 0);
+                    const float distSqr = dist(x2, y2) / (3 * count);
+                    SPH_ASSERT(distSqr < LARGE, distSqr);
+                    const float w = exp(-min(distSqr * norm, 8.f));
+                    sum(x, y) += input(x2, y2) * w;
+                    weight(x, y) += w;
+                }
+            });
+        }
+    }
 
-                const Rgba v1 = input[pp1];
-                const Rgba v2 = input[pp2];
-                distSqr += sqr(v1.r() - v2.r()) + sqr(v1.g() - v2.g()) + sqr(v1.b() - v2.b());
-                count++;
-            }
+    Bitmap<Rgba> result(size);
+    parallelFor(scheduler, 0, size.y, 1, [&](const int y) {
+        for (int x = 0; x < size.x; ++x) {
+            result(x, y) = weight(x, y) > 0.f ? sum(x, y) / weight(x, y) : Rgba::black();
         }
-        SPH_ASSERT(count > 0);
-        SPH_ASSERT(distSqr < LARGE, distSqr);
-        distSqr /= 3 * count;
-        return exp(-min(distSqr * norm, 8.f));
     });
+    return result;
 }
 
 constexpr float DISCONTINUITY_WEIGHT = 1.e-3f;
@@ -247,20 +410,20 @@ Bitmap<Rgba> denoiseLowFrequency(IScheduler& scheduler,
     const Bitmap<Rgba>& input,
     const DenoiserParams& params,
     const Size levels) {
-    Bitmap<Rgba> small = resize(input, input.size() / 2);
+    Bitmap<Rgba> small = resize(scheduler, input, input.size() / 2);
     Bitmap<Rgba> denoised = denoise(scheduler, small, params);
     if (levels > 1) {
         DenoiserParams levelParams = params;
         levelParams.sigma *= 0.5f;
         denoised = denoiseLowFrequency(scheduler, denoised, levelParams, levels - 1);
     }
-    Bitmap<Rgba> smallUpscaled = resize(small, input.size());
-    Bitmap<Rgba> denoisedUpscaled = resize(denoised, input.size());
+    Bitmap<Rgba> smallUpscaled = resize(scheduler, small, input.size());
+    Bitmap<Rgba> denoisedUpscaled = resize(scheduler, denoised, input.size());
 
     // add high-frequency details
-    Bitmap<float> disc = detectEdges(smallUpscaled);
+    Bitmap<float> disc = detectEdges(scheduler, smallUpscaled);
     constexpr float norm = 1.f / DISCONTINUITY_WEIGHT;
-    for (int y = 0; y < input.size().y; ++y) {
+    parallelFor(scheduler, 0, input.size().y, 1, [&](const int y) {
         for (int x = 0; x < input.size().x; ++x) {
             const Pixel p(x, y);
             const Rgba c_0 = input[p];
@@ -269,7 +432,7 @@ Bitmap<Rgba> denoiseLowFrequency(IScheduler& scheduler,
             SPH_ASSERT(isReal(c_0) && isReal(c_f) && isReal(w));
             denoisedUpscaled[p] = lerp(c_0, c_f, w);
         }
-    }
+    });
     return denoisedUpscaled;
 }
 
@@ -20,10 +20,28 @@ Rgba interpolate(const Bitmap<Rgba>& bitmap, const float x, const float y);
 
 Bitmap<Rgba> resize(const Bitmap<Rgba>& input, const Pixel size);
 
+Bitmap<Rgba> resize(IScheduler& scheduler, const Bitmap<Rgba>& input, const Pixel size);
+
+/// \brief Halves the resolution of the image, each pixel is the average of 2x2 block of input pixels.
+///
+/// For odd dimensions, the size of the result is rounded up.
+Bitmap<Rgba> downsample(IScheduler& scheduler, const Bitmap<Rgba>& input);
+
 Bitmap<float> detectEdges(const Bitmap<Rgba>& input);
 
+Bitmap<float> detectEdges(IScheduler& scheduler, const Bitmap<Rgba>& input);
+
+/// \brief Blurs the image by a direct convolution with a Gaussian kernel.
+///
+/// The cost per pixel is proportional to the radius.
 Bitmap<Rgba> gaussianBlur(IScheduler& scheduler, const Bitmap<Rgba>& input, const int radius);
 
+/// \brief Approximates \ref gaussianBlur by three successive box filters.
+///
+/// The box filters are computed using running sums, so the cost per pixel does not depend on the radius.
+/// Pixels outside of the image are clamped to the edge.
+Bitmap<Rgba> fastGaussianBlur(IScheduler& scheduler, const Bitmap<Rgba>& input, const int radius);
+
 Bitmap<Rgba> bloomEffect(IScheduler& scheduler,
     const Bitmap<Rgba>& input,
     const int radius = 25,
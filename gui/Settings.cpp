@@ -56,6 +56,21 @@ static RegisterEnum<ColorMapEnum> sColorMap({
     { ColorMapEnum::FILMIC, "filmic", "Uses filmic color mapping" },
 });
 
+static RegisterEnum<VolumeMethodEnum> sVolumeMethod({
+    { VolumeMethodEnum::BVH,
+        "bvh",
+        "Finds all intersections of rays with particles. Exact, but slow for large particle counts." },
+    { VolumeMethodEnum::VOXEL_GRID,
+        "voxel_grid",
+        "Splats particles into a sparse voxel grid and ray-marches the grid. Faster for dense clouds of "
+        "particles, does not support the lensing effect." },
+});
+
+static RegisterEnum<VolumeQualityEnum> sVolumeQuality({
+    { VolumeQualityEnum::PREVIEW, "preview", "Coarse voxel grid, intended for interactive preview." },
+    { VolumeQualityEnum::STANDARD, "standard", "Compromise between the quality and the render time." },
+    { VolumeQualityEnum::MOVIE, "movie", "Fine voxel grid and short steps, intended for final renders." },
+});
 
 // clang-format off
 template<>
@@ -155,6 +170,10 @@ const Settings<GuiSettingsId>& getDefaultSettings() {
         "Absorption per unit length. Used by volumetric renderer." },
     { GuiSettingsId::VOLUME_SCATTERING,     "volume.scattering",    0._f,
         "Scattering coefficient per unit length. Used by volumetric renderer." },
+    { GuiSettingsId::VOLUME_METHOD,         "volume.method",        VolumeMethodEnum::BVH,
+        "Method used by volumetric renderer to evaluate the emission along rays." },
+    { GuiSettingsId::VOLUME_GRID_QUALITY,   "volume.grid_quality",  VolumeQualityEnum::STANDARD,
+        "Resolution and step of the voxel grid. Used if the voxel grid method is selected." },
     { GuiSettingsId::RENDER_GHOST_PARTICLES, "render_ghost_particles", true,
         "If true, ghost particles will be displayed as transparent circles, otherwise they are hidden." },
     { GuiSettingsId::BACKGROUND_COLOR,      "background_color",     Vector(0._f, 0._f, 0._f, 1._f),
@@ -88,6 +88,25 @@ enum class ColorMapEnum {
     FILMIC,
 };
 
+enum class VolumeMethodEnum {
+    /// Finds all intersections of rays with particles using bounding volume hierarchy
+    BVH,
+
+    /// Splats particles into a sparse voxel grid and ray-marches the grid
+    VOXEL_GRID,
+};
+
+enum class VolumeQualityEnum {
+    /// Coarse grid and long steps, intended for interactive preview
+    PREVIEW,
+
+    /// Compromise between quality and speed
+    STANDARD,
+
+    /// Fine grid and short steps, intended for rendering of movies
+    MOVIE,
+};
+
 enum class PaneEnum {
     RENDER_PARAMS = 1 << 0,
     PALETTE = 1 << 1,
@@ -213,6 +232,10 @@ enum class GuiSettingsId {
 
     VOLUME_SCATTERING,
 
+    VOLUME_METHOD,
+
+    VOLUME_GRID_QUALITY,
+
     CONTOUR_SPACING,
 
     CONTOUR_GRID_SIZE,
@@ -0,0 +1,67 @@
+#include "gui/ImageTransform.h"
+#include "bench/Session.h"
+#include "math/rng/Rng.h"
+#include "thread/Pool.h"
+
+using namespace Sph;
+
+static Bitmap<Rgba> getTestImage(const Pixel size) {
+    Bitmap<Rgba> image(size);
+    UniformRng rng;
+    for (int y = 0; y < size.y; ++y) {
+        for (int x = 0; x < size.x; ++x) {
+            // bright squares with noise, so that the bloom effect has something to do
+            const float base = ((x / 64 + y / 64) % 2) ? 0.9f : 0.1f;
+            image(x, y) = Rgba(base + 0.1f * float(rng()), base + 0.1f * float(rng()), base, 1.f);
+        }
+    }
+    return image;
+}
+
+template <typename TBlur>
+static void benchmarkBlur(Benchmark::Context& context, const int radius, const TBlur& blur) {
+    SharedPtr<ThreadPool> pool = ThreadPool::getGlobalInstance();
+    Bitmap<Rgba> image = getTestImage(Pixel(1920, 1080));
+    while (context.running()) {
+        Bitmap<Rgba> blurred = blur(*pool, image, radius);
+        Benchmark::doNotOptimize(blurred.data());
+        Benchmark::clobberMemory();
+    }
+}
+
+BENCHMARK("Gaussian blur r=10", "[image]", Benchmark::Context& context) {
+    benchmarkBlur(context, 10, gaussianBlur);
+}
+
+BENCHMARK("Gaussian blur r=100", "[image]", Benchmark::Context& context) {
+    benchmarkBlur(context, 100, gaussianBlur);
+}
+
+BENCHMARK("Fast gaussian blur r=10", "[image]", Benchmark::Context& context) {
+    benchmarkBlur(context, 10, fastGaussianBlur);
+}
+
+BENCHMARK("Fast gaussian blur r=100", "[image]", Benchmark::Context& context) {
+    benchmarkBlur(context, 100, fastGaussianBlur);
+}
+
+BENCHMARK("Bloom 4K", "[image]", Benchmark::Context& context) {
+    SharedPtr<ThreadPool> pool = ThreadPool::getGlobalInstance();
+    Bitmap<Rgba> image = getTestImage(Pixel(3840, 2160));
+    while (context.running()) {
+        // radius used by the renderer for the default bloom radius of 0.05 image width
+        Bitmap<Rgba> bloom = bloomEffect(*pool, image, 192);
+        Benchmark::doNotOptimize(bloom.data());
+        Benchmark::clobberMemory();
+    }
+}
+
+BENCHMARK("Denoise", "[image]", Benchmark::Context& context) {
+    SharedPtr<ThreadPool> pool = ThreadPool::getGlobalInstance();
+    Bitmap<Rgba> image = getTestImage(Pixel(800, 600));
+    while (context.running()) {
+        Bitmap<Rgba> denoised = denoiseLowFrequency(*pool, image, {});
+        Benchmark::doNotOptimize(denoised.data());
+        Benchmark::clobberMemory();
+    }
+}
@@ -36,11 +36,13 @@ SOURCES += \
     objects/Palette.cpp \
     objects/PaletteEntry.cpp \
     objects/RenderContext.cpp \
+    objects/ScreenIndex.cpp \
     renderers/ContourRenderer.cpp \
     renderers/IRenderer.cpp \
     renderers/MeshRenderer.cpp \
     renderers/ParticleRenderer.cpp \
     renderers/RayMarcher.cpp \
+    renderers/SparseGrid.cpp \
     renderers/VolumeRenderer.cpp \
     renderers/Spectrum.cpp \
     windows/BatchDialog.cpp \
@@ -92,6 +94,7 @@ HEADERS += \
     objects/PaletteEntry.h \
     objects/Point.h \
     objects/RenderContext.h \
+    objects/ScreenIndex.h \
     objects/SvgContext.h \
     renderers/Brdf.h \
     renderers/ContourRenderer.h \
@@ -101,6 +104,7 @@ HEADERS += \
     renderers/MeshRenderer.h \
     renderers/ParticleRenderer.h \
     renderers/RayMarcher.h \
+    renderers/SparseGrid.h \
     renderers/VolumeRenderer.h \
     renderers/Spectrum.h \
     windows/BatchDialog.h \
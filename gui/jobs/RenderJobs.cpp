@@ -149,6 +149,13 @@ VirtualSettings AnimationJob::getSettings() {
     rendererCat.connect<Float>("Medium scattering [km^-1]", gui, GuiSettingsId::VOLUME_SCATTERING)
         .setUnits(1.e-3_f)
         .setEnabler(volumeEnabler);
+    rendererCat.connect<EnumWrapper>("Volume method", gui, GuiSettingsId::VOLUME_METHOD)
+        .setEnabler(volumeEnabler);
+    rendererCat.connect<EnumWrapper>("Voxel grid quality", gui, GuiSettingsId::VOLUME_GRID_QUALITY)
+        .setEnabler([this, volumeEnabler] {
+            return volumeEnabler() &&
+                   gui.get<VolumeMethodEnum>(GuiSettingsId::VOLUME_METHOD) == VolumeMethodEnum::VOXEL_GRID;
+        });
     rendererCat.connect<Float>("Lensing magnitude", gui, GuiSettingsId::RAYTRACE_LENSING_MAGNITUDE);
     rendererCat.connect<bool>("Reduce noise", gui, GuiSettingsId::REDUCE_LOWFREQUENCY_NOISE)
         .setEnabler(volumeEnabler);
@@ -228,6 +235,12 @@ public:
         }
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::POSITION);
+        ids.push(QuantityId::MASS);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !acc.empty();
     }
@@ -236,6 +249,14 @@ public:
         return palette(acc[idx]);
     }
 
+    virtual void evalColors(IScheduler& scheduler,
+        ArrayView<const Size> idxs,
+        ArrayView<Rgba> colors) const override {
+        Detail::evalPaletteColors(scheduler, palette, idxs, colors, [this](const Size i) { //
+            return float(acc[i]);
+        });
+    }
+
     virtual Optional<Vector> evalVector(const Size UNUSED(idx)) const override {
         return NOTHING;
     }
@@ -310,6 +331,14 @@ void AnimationJob::evaluate(const RunSettings& global, IRunCallbacks& callbacks)
     RenderParams params = this->getRenderParams(gui);
     AutoPtr<IColorizer> colorizer = this->getColorizer(global);
 
+    // files of the sequence can be loaded partially, with quantities needed by the colorizer and the renderer;
+    // persistent indices are used by the camera tracker
+    Array<QuantityId> requiredIds{ QuantityId::POSITION, QuantityId::PERSISTENT_INDEX };
+    if (!colorizer->addRequiredQuantities(requiredIds) || !rendererPtr->addRequiredQuantities(requiredIds)) {
+        // load all quantities
+        requiredIds.clear();
+    }
+
     int firstIndex = 0;
     if (AnimationType(animationType) == AnimationType::FILE_SEQUENCE) {
         Optional<Size> sequenceFirstIndex = OutputFile::getDumpIdx(sequence.firstFile);
@@ -337,7 +366,7 @@ void AnimationJob::evaluate(const RunSettings& global, IRunCallbacks& callbacks)
 
         const Size iterationCnt = iterLimit * fileMap.size() * (extraFrames + 1);
         AnimationRenderOutput output(callbacks, *rendererPtr, iterationCnt);
-        AutoPtr<IInput> input = Factory::getInput(sequence.firstFile);
+        AutoPtr<IInput> input = Factory::getInput(sequence.firstFile, std::move(requiredIds));
         for (auto& element : fileMap) {
             Storage frame;
             Statistics stats;
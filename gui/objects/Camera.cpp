@@ -10,7 +10,7 @@ Pair<Vector> ParticleTracker::getTrackedPoint(const Storage& storage) const {
     const Quantity& pos = storage.getQuantity(QuantityId::POSITION);
     if (storage.has(QuantityId::PERSISTENT_INDEX)) {
         // use persistent indices if available
-        ArrayView<const Size> pi = storage.getValue<Size>(QuantityId::PERSISTENT_INDEX);
+        ArrayView<const GlobalSize> pi = storage.getValue<GlobalSize>(QuantityId::PERSISTENT_INDEX);
         auto iter = std::find(pi.begin(), pi.end(), index);
         if (iter != pi.end()) {
             const Size i = Size(iter - pi.begin());
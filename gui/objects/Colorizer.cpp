@@ -247,7 +247,7 @@ template class IdColorizerTemplate<IndexColorizer>;
 
 void ParticleIdColorizer::initialize(const Storage& storage, const RefEnum ref) {
     if (storage.has(QuantityId::PERSISTENT_INDEX)) {
-        persistentIdxs = makeArrayRef(storage.getValue<Size>(QuantityId::PERSISTENT_INDEX), ref);
+        persistentIdxs = makeArrayRef(storage.getValue<GlobalSize>(QuantityId::PERSISTENT_INDEX), ref);
     }
 }
 
@@ -45,12 +45,34 @@ public:
     ///            are copied and stored in the colorizer, or only references to the the storage are kept.
     virtual void initialize(const Storage& storage, const RefEnum ref) = 0;
 
+    /// \brief Adds the IDs of quantities needed by \ref initialize into the array.
+    ///
+    /// Allows to copy only the necessary quantities if the colorizer is initialized from a snapshot of the
+    /// storage. Returns false if the quantities cannot be determined; the colorizer has to be initialized
+    /// from the complete storage in such a case.
+    virtual bool addRequiredQuantities(Array<QuantityId>& UNUSED(ids)) const {
+        return false;
+    }
+
     /// \brief Checks if the colorizer has been initialized.
     virtual bool isInitialized() const = 0;
 
     /// \brief Returns the color of idx-th particle.
     virtual Rgba evalColor(const Size idx) const = 0;
 
+    /// \brief Returns the colors of multiple particles.
+    ///
+    /// Equivalent to calling \ref evalColor for each index, evaluated in parallel. Colorizers can override
+    /// the function to map the whole arrays at once, avoiding the virtual call for each particle.
+    /// \param idxs Indices of particles to colorize.
+    /// \param colors Output array of colors, must have the same size as the array of indices.
+    virtual void evalColors(IScheduler& scheduler, ArrayView<const Size> idxs, ArrayView<Rgba> colors) const {
+        SPH_ASSERT(idxs.size() == colors.size());
+        parallelFor(scheduler, 0, idxs.size(), [&](const Size i) { //
+            colors[i] = this->evalColor(idxs[i]);
+        });
+    }
+
     /// \brief Returns the scalar representation of the colorized quantity for idx-th particle.
     ///
     /// If there is no reasonable scalar representation (boundary particles, for example), returns NOTHING
@@ -127,6 +149,31 @@ template <>
 INLINE Optional<Vector> getColorizerVector(const Vector& value) {
     return value;
 }
+
+/// \brief Maps the scalar values of particles to colors using the lookup table of given palette.
+///
+/// Values are gathered and converted to colors in blocks, processed in parallel.
+/// \param getValue Functor returning the scalar value of the particle with given index.
+template <typename TFunctor>
+void evalPaletteColors(IScheduler& scheduler,
+    const Palette& palette,
+    ArrayView<const Size> idxs,
+    ArrayView<Rgba> colors,
+    const TFunctor& getValue) {
+    SPH_ASSERT(idxs.size() == colors.size());
+    constexpr Size BLOCK_SIZE = 1024;
+    const PaletteLut lut(palette);
+    const Size blockCnt = (idxs.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    parallelFor(scheduler, 0, blockCnt, 1, [&](const Size block) {
+        const Size from = block * BLOCK_SIZE;
+        const Size cnt = min(BLOCK_SIZE, idxs.size() - from);
+        float values[BLOCK_SIZE];
+        for (Size i = 0; i < cnt; ++i) {
+            values[i] = getValue(idxs[from + i]);
+        }
+        lut.map(ArrayView<const float>(values, cnt), colors.subset(from, cnt));
+    });
+}
 } // namespace Detail
 
 /// \brief Special colorizers that do not directly correspond to quantities.
@@ -186,6 +233,11 @@ public:
         values = makeArrayRef(storage.getValue<Type>(id), ref);
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(id);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !values.empty();
     }
@@ -194,6 +246,15 @@ public:
         return palette(this->evalScalar(idx).value());
     }
 
+    virtual void evalColors(IScheduler& scheduler,
+        ArrayView<const Size> idxs,
+        ArrayView<Rgba> colors) const override {
+        SPH_ASSERT(this->isInitialized());
+        Detail::evalPaletteColors(scheduler, palette, idxs, colors, [this](const Size i) { //
+            return Detail::getColorizerValue(values[i]);
+        });
+    }
+
     virtual Optional<float> evalScalar(const Size idx) const override {
         SPH_ASSERT(this->isInitialized());
         return Detail::getColorizerValue(values[idx]);
@@ -295,6 +356,11 @@ public:
         values = makeArrayRef(storage.getDt<Vector>(QuantityId::POSITION), ref);
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::POSITION);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !values.empty();
     }
@@ -348,6 +414,13 @@ public:
 
     virtual void initialize(const Storage& storage, const RefEnum ref) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        // material IDs are always copied into the snapshot
+        ids.push(QuantityId::POSITION);
+        ids.push(QuantityId::MASS);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !v.empty();
     }
@@ -407,6 +480,11 @@ public:
         }
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::DENSITY);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !rho.empty();
     }
@@ -452,6 +530,12 @@ public:
 
     virtual void initialize(const Storage& storage, const RefEnum ref) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::POSITION);
+        ids.push(QuantityId::MASS);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !m.empty();
     }
@@ -502,6 +586,12 @@ public:
         p = makeArrayRef(storage.getValue<Float>(QuantityId::PRESSURE), ref);
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::DEVIATORIC_STRESS);
+        ids.push(QuantityId::PRESSURE);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !s.empty() && !p.empty();
     }
@@ -558,6 +648,12 @@ public:
         v = makeArrayRef(storage.getDt<Vector>(QuantityId::POSITION), ref);
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::ENERGY);
+        ids.push(QuantityId::POSITION);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !u.empty();
     }
@@ -601,6 +697,13 @@ public:
     virtual bool hasData(const Storage& storage) const override;
 
     virtual void initialize(const Storage& storage, const RefEnum ref) override;
+
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        // temperature is computed from density and energy using the EoS of the materials
+        ids.push(QuantityId::DENSITY);
+        ids.push(QuantityId::ENERGY);
+        return true;
+    }
 };
 
 
@@ -615,6 +718,15 @@ public:
         return palette(float(1._f - values[idx]));
     }
 
+    virtual void evalColors(IScheduler& scheduler,
+        ArrayView<const Size> idxs,
+        ArrayView<Rgba> colors) const override {
+        SPH_ASSERT(this->isInitialized());
+        Detail::evalPaletteColors(scheduler, palette, idxs, colors, [this](const Size i) { //
+            return float(1._f - values[i]);
+        });
+    }
+
     virtual String name() const override {
         return "Yield reduction";
     }
@@ -633,6 +745,14 @@ public:
 
     virtual void initialize(const Storage& storage, const RefEnum ref) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::DEVIATORIC_STRESS);
+        ids.push(QuantityId::PRESSURE);
+        ids.push(QuantityId::EPS_MIN);
+        ids.push(QuantityId::DAMAGE);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !ratio.empty();
     }
@@ -681,6 +801,11 @@ public:
         u = makeArrayRef(storage.getValue<Float>(QuantityId::ENERGY), ref);
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::ENERGY);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !u.empty();
     }
@@ -721,11 +846,25 @@ public:
         values = makeArrayRef(storage.getValue<Vector>(QuantityId::POSITION), ref);
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::POSITION);
+        return true;
+    }
+
     virtual Rgba evalColor(const Size idx) const override {
         SPH_ASSERT(this->isInitialized());
         return palette(float(values[idx][H]));
     }
 
+    virtual void evalColors(IScheduler& scheduler,
+        ArrayView<const Size> idxs,
+        ArrayView<Rgba> colors) const override {
+        SPH_ASSERT(this->isInitialized());
+        Detail::evalPaletteColors(scheduler, palette, idxs, colors, [this](const Size i) { //
+            return float(values[i][H]);
+        });
+    }
+
     virtual Optional<Particle> getParticle(const Size idx) const override {
         return Particle(idx).addValue(QuantityId::SMOOTHING_LENGTH, values[idx][H]);
     }
@@ -753,6 +892,11 @@ public:
         uvws = makeArrayRef(storage.getValue<Vector>(QuantityId::UVW), ref);
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::UVW);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !uvws.empty();
     }
@@ -812,6 +956,15 @@ public:
 
     virtual void initialize(const Storage& storage, const RefEnum ref) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        if (detection == Detection::NORMAL_BASED) {
+            ids.push(QuantityId::SURFACE_NORMAL);
+        } else {
+            ids.push(QuantityId::NEIGHBOR_CNT);
+        }
+        return true;
+    }
+
     virtual bool isInitialized() const override;
 
     virtual Rgba evalColor(const Size idx) const override;
@@ -863,14 +1016,15 @@ public:
 
 class ParticleIdColorizer : public IdColorizerTemplate<ParticleIdColorizer> {
 private:
-    ArrayRef<const Size> persistentIdxs;
+    ArrayRef<const GlobalSize> persistentIdxs;
 
 public:
     using IdColorizerTemplate<ParticleIdColorizer>::IdColorizerTemplate;
 
     INLINE Optional<Size> evalId(const Size idx) const {
         if (!persistentIdxs.empty() && idx < persistentIdxs.size()) {
-            return persistentIdxs[idx];
+            // only used to seed the color, so the truncation is harmless
+            return Size(persistentIdxs[idx]);
         } else {
             return idx;
         }
@@ -882,6 +1036,12 @@ public:
 
     virtual void initialize(const Storage& storage, const RefEnum ref) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        // persistent indices are optional, the index in the storage is used if they are not present
+        ids.push(QuantityId::PERSISTENT_INDEX);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return true;
     }
@@ -942,6 +1102,15 @@ public:
 
     virtual void initialize(const Storage& storage, const RefEnum ref) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::POSITION);
+        ids.push(QuantityId::MASS);
+        if (connectivity.has(Post::ComponentFlag::SEPARATE_BY_FLAG)) {
+            ids.push(QuantityId::FLAG);
+        }
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !components.empty();
     }
@@ -1003,6 +1172,11 @@ public:
         idxs = makeArrayRef(storage.getValue<Size>(id), ref);
     }
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(id);
+        return true;
+    }
+
     virtual bool isInitialized() const override {
         return !idxs.empty();
     }
@@ -1036,6 +1210,12 @@ public:
 
     virtual void initialize(const Storage& storage, const RefEnum ref) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::TIME_STEP);
+        ids.push(QuantityId::TIME_STEP_CRITERION);
+        return true;
+    }
+
     virtual Optional<Particle> getParticle(const Size idx) const override;
 };
 
@@ -7,33 +7,34 @@
 
 NAMESPACE_SPH_BEGIN
 
-float Palette::paletteToLinear(const float value) const {
-    float palette;
+/// Transforms the value to the linearized scale of the palette
+INLINE static float paletteToLinear(const PaletteScale scale, const float value) {
     switch (scale) {
     case PaletteScale::LINEAR:
-        palette = value;
-        break;
+        return value;
     case PaletteScale::LOGARITHMIC:
         // we allow calling this function with zero or negative value, it should simply map to the lowest
         // value on the palette
         if (value < EPS) {
-            palette = -LARGE;
+            return -LARGE;
         } else {
-            palette = float(log10(value));
+            return float(log10(value));
         }
-        break;
     case PaletteScale::HYBRID:
         if (value > 1.f) {
-            palette = 1.f + float(log10(value));
+            return 1.f + float(log10(value));
         } else if (value < -1.f) {
-            palette = -1.f - float(log10(-value));
+            return -1.f - float(log10(-value));
         } else {
-            palette = value;
+            return value;
         }
-        break;
     default:
         NOT_IMPLEMENTED;
     }
+}
+
+float Palette::paletteToLinear(const float value) const {
+    const float palette = Sph::paletteToLinear(scale, value);
     SPH_ASSERT(isReal(palette), value);
     return palette;
 }
@@ -232,6 +233,58 @@ Outcome Palette::saveToFile(const Path& path, const Size lineCnt) const {
     return this->saveToStream(ofs, lineCnt);
 }
 
+PaletteLut::PaletteLut(const Palette& palette, const Size resolution)
+    : scale(palette.getScale()) {
+    SPH_ASSERT(resolution >= 2);
+    const Interval range = palette.getInterval();
+    from = Sph::paletteToLinear(scale, float(range.lower()));
+    const float to = Sph::paletteToLinear(scale, float(range.upper()));
+    factor = to > from ? float(resolution - 1) / (to - from) : 0.f;
+
+    colors.resize(resolution);
+    for (Size i = 0; i < resolution; ++i) {
+        colors[i] = palette(palette.relativeToRange(float(i) / (resolution - 1)));
+    }
+}
+
+Rgba PaletteLut::operator()(const float value) const {
+    const float last = float(colors.size() - 1);
+    const float pos = clamp((Sph::paletteToLinear(scale, value) - from) * factor, 0.f, last);
+    SPH_ASSERT(isReal(pos), value);
+    const Size idx = min(Size(pos), colors.size() - 2);
+    return colors[idx].blend(colors[idx + 1], pos - float(idx));
+}
+
+void PaletteLut::map(ArrayView<const float> values, ArrayView<Rgba> result) const {
+    SPH_ASSERT(values.size() == result.size());
+    constexpr Size BLOCK_SIZE = 256;
+    float positions[BLOCK_SIZE];
+    const float last = float(colors.size() - 1);
+    for (Size block = 0; block < values.size(); block += BLOCK_SIZE) {
+        const Size cnt = min(BLOCK_SIZE, values.size() - block);
+        const float* input = &values[block];
+        // keep the scale switch out of the loops
+        if (scale == PaletteScale::LINEAR) {
+            for (Size i = 0; i < cnt; ++i) {
+                positions[i] = (input[i] - from) * factor;
+            }
+        } else {
+            for (Size i = 0; i < cnt; ++i) {
+                positions[i] = (Sph::paletteToLinear(scale, input[i]) - from) * factor;
+            }
+        }
+        for (Size i = 0; i < cnt; ++i) {
+            positions[i] = clamp(positions[i], 0.f, last);
+        }
+        const Rgba* table = &colors[0];
+        Rgba* output = &result[block];
+        for (Size i = 0; i < cnt; ++i) {
+            const Size idx = min(Size(positions[i]), colors.size() - 2);
+            output[i] = table[idx].blend(table[idx + 1], positions[i] - float(idx));
+        }
+    }
+}
+
 void drawPalette(IRenderContext& context,
     const Pixel origin,
     const Pixel size,
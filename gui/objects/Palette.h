@@ -124,6 +124,37 @@ private:
     float paletteToLinear(const float value) const;
 };
 
+/// \brief Lookup table of palette colors, used to map many values to colors at once.
+///
+/// Colors are precomputed for equidistant points on the linearized scale of the palette, so that mapping a
+/// value only requires the transform given by \ref PaletteScale and the interpolation of two neighboring
+/// entries, instead of searching the control points of the palette. The table has to be recreated when
+/// the palette changes.
+class PaletteLut {
+private:
+    Array<Rgba> colors;
+
+    PaletteScale scale;
+
+    /// Range of the palette on linearized scale
+    float from;
+
+    /// Number of table entries per unit of the linearized scale
+    float factor;
+
+public:
+    explicit PaletteLut(const Palette& palette, const Size resolution = 1024);
+
+    /// \brief Returns the color mapped to given number.
+    Rgba operator()(const float value) const;
+
+    /// \brief Maps all values to colors.
+    ///
+    /// Values are processed in blocks, evaluating the scale transform for the whole block first, so that
+    /// the compiler can vectorize the loops.
+    void map(ArrayView<const float> values, ArrayView<Rgba> result) const;
+};
+
 /// \brief Draws the palette using provided render context
 void drawPalette(IRenderContext& context,
     const Pixel origin,
@@ -2,6 +2,7 @@
 #include "gui/objects/Colorizer.h"
 #include "io/Path.h"
 #include "post/Point.h"
+#include "system/Statistics.h"
 #include <fstream>
 
 NAMESPACE_SPH_BEGIN
@@ -106,25 +107,34 @@ void SelectedParticlePlot::plot(IDrawingContext& dc) const {
     }
 }
 
-class RelativeEnergyChange : public IIntegral<Float> {
+/// \brief Returns a sampler reading values of given statistic.
+///
+/// Vector values are converted to their length.
+template <typename TValue>
+static TemporalPlot::Sampler getStatisticSampler(const StatisticsId id) {
+    return [id](const Storage& UNUSED(storage), const Statistics& stats) -> Optional<Float> {
+        if (!stats.has(id)) {
+            return NOTHING;
+        }
+        return Dynamic(stats.get<TValue>(id)).getScalar();
+    };
+}
+
+class RelativeEnergyChange {
 private:
-    TotalEnergy energy;
-    mutable Optional<Float> E_0 = NOTHING;
+    Optional<Float> E_0 = NOTHING;
 
 public:
-    RelativeEnergyChange() = default;
-
-    virtual Float evaluate(const Storage& storage) const override {
-        const Float E = energy.evaluate(storage);
+    Optional<Float> operator()(const Storage& UNUSED(storage), const Statistics& stats) {
+        if (!stats.has(StatisticsId::TOTAL_ENERGY)) {
+            return NOTHING;
+        }
+        const Float E = stats.get<Float>(StatisticsId::TOTAL_ENERGY);
         if (!E_0 || E_0.value() == 0._f) {
             E_0 = E;
         }
         return E / E_0.value() - 1._f;
     }
-
-    virtual String getName() const override {
-        return "Relative energy change";
-    }
 };
 
 Array<PlotData> getPlotList(const GuiSettings& gui) {
@@ -139,9 +149,10 @@ Array<PlotData> getPlotList(const GuiSettings& gui) {
     IntegralWrapper integral;
     Flags<PlotEnum> flags = gui.getFlags<PlotEnum>(GuiSettingsId::PLOT_INTEGRALS);
 
+    // integrals are evaluated by the run page in a single pass and read from the statistics
     if (flags.has(PlotEnum::TOTAL_ENERGY)) {
-        integral = makeAuto<TotalEnergy>();
-        data.plot = makeLocking<TemporalPlot>(integral, params);
+        data.plot = makeLocking<TemporalPlot>(
+            "Total energy", getStatisticSampler<Float>(StatisticsId::TOTAL_ENERGY), params);
         data.color = Rgba(wxColour(240, 255, 80));
         list.push(data);
     }
@@ -149,37 +160,36 @@ Array<PlotData> getPlotList(const GuiSettings& gui) {
     if (flags.has(PlotEnum::RELATIVE_ENERGY_CHANGE)) {
         TemporalPlot::Params actParams = params;
         actParams.minRangeY = 0.001_f;
-        integral = makeAuto<RelativeEnergyChange>();
-        data.plot = makeLocking<TemporalPlot>(integral, actParams);
+        data.plot = makeLocking<TemporalPlot>("Relative energy change", RelativeEnergyChange(), actParams);
         data.color = Rgba(wxColour(240, 255, 80));
         list.push(data);
     }
 
     if (flags.has(PlotEnum::KINETIC_ENERGY)) {
-        integral = makeAuto<TotalKineticEnergy>();
-        data.plot = makeLocking<TemporalPlot>(integral, params);
+        data.plot = makeLocking<TemporalPlot>(
+            "Kinetic energy", getStatisticSampler<Float>(StatisticsId::KINETIC_ENERGY), params);
         data.color = Rgba(wxColour(200, 0, 0));
         list.push(data);
     }
 
     if (flags.has(PlotEnum::INTERNAL_ENERGY)) {
-        integral = makeAuto<TotalInternalEnergy>();
-        data.plot = makeLocking<TemporalPlot>(integral, params);
+        data.plot = makeLocking<TemporalPlot>(
+            "Internal energy", getStatisticSampler<Float>(StatisticsId::INTERNAL_ENERGY), params);
         data.color = Rgba(wxColour(255, 50, 50));
         list.push(data);
     }
 
     if (flags.has(PlotEnum::TOTAL_MOMENTUM)) {
-        integral = makeAuto<TotalMomentum>();
-        // params.minRangeY = 1.e6_f;
-        data.plot = makeLocking<TemporalPlot>(integral, params);
+        data.plot = makeLocking<TemporalPlot>(
+            "Total momentum", getStatisticSampler<Dynamic>(StatisticsId::TOTAL_MOMENTUM), params);
         data.color = Rgba(wxColour(100, 200, 0));
         list.push(data);
     }
 
     if (flags.has(PlotEnum::TOTAL_ANGULAR_MOMENTUM)) {
-        integral = makeAuto<TotalAngularMomentum>();
-        data.plot = makeLocking<TemporalPlot>(integral, params);
+        data.plot = makeLocking<TemporalPlot>("Total angular momentum",
+            getStatisticSampler<Dynamic>(StatisticsId::TOTAL_ANGULAR_MOMENTUM),
+            params);
         data.color = Rgba(wxColour(130, 80, 255));
         list.push(data);
     }
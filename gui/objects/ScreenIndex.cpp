@@ -0,0 +1,123 @@
+#include "gui/objects/ScreenIndex.h"
+#include "gui/objects/Camera.h"
+#include "thread/Scheduler.h"
+
+NAMESPACE_SPH_BEGIN
+
+/// Average number of particles in a cell of the index
+const float PARTICLES_PER_CELL = 4.f;
+
+/// Minimal size of the cell in pixels
+const float MIN_CELL_SIZE = 2.f;
+
+void ScreenParticleIndex::build(IScheduler& scheduler, ArrayView<const Vector> r, const ICamera& camera) {
+    entries.clear();
+    cellOffsets.clear();
+    cellRadii.clear();
+    maxRadius = 0.f;
+
+    // project the particles, invisible particles are marked by a negative radius
+    const float cutoff = camera.getCutoff().valueOr(0.f);
+    const Vector camDir = camera.getFrame().row(2);
+    Array<Entry> projected(r.size());
+    parallelFor(scheduler, 0, r.size(), [&](const Size i) {
+        projected[i].idx = i;
+        projected[i].radius = -1.f;
+        if (cutoff != 0.f && abs(dot(camDir, r[i])) > cutoff) {
+            return;
+        }
+        if (Optional<ProjectedPoint> p = camera.project(r[i])) {
+            projected[i].coords = p->coords;
+            projected[i].radius = p->radius;
+        }
+    });
+
+    Size visibleCnt = 0;
+    for (const Entry& entry : projected) {
+        if (entry.radius >= 0.f) {
+            ++visibleCnt;
+            maxRadius = max(maxRadius, entry.radius);
+        }
+    }
+    if (visibleCnt == 0) {
+        return;
+    }
+
+    const Pixel size = camera.getSize();
+    cellSize = max(sqrt(float(size.x) * float(size.y) * PARTICLES_PER_CELL / visibleCnt), MIN_CELL_SIZE);
+    dims[X] = max(int(ceil(size.x / cellSize)), 1);
+    dims[Y] = max(int(ceil(size.y / cellSize)), 1);
+
+    // counting sort of the visible particles by cells
+    Array<Size> cellIdxs(r.size());
+    cellOffsets.resizeAndSet(dims[X] * dims[Y] + 1, 0);
+    cellRadii.resizeAndSet(dims[X] * dims[Y], 0.f);
+    for (Size i = 0; i < projected.size(); ++i) {
+        if (projected[i].radius >= 0.f) {
+            const Coords& p = projected[i].coords;
+            cellIdxs[i] = Size(this->getCell(p.y, Y) * dims[X] + this->getCell(p.x, X));
+            ++cellOffsets[cellIdxs[i] + 1];
+            cellRadii[cellIdxs[i]] = max(cellRadii[cellIdxs[i]], projected[i].radius);
+        }
+    }
+    for (Size i = 1; i < cellOffsets.size(); ++i) {
+        cellOffsets[i] += cellOffsets[i - 1];
+    }
+    SPH_ASSERT(cellOffsets.back() == visibleCnt);
+
+    Array<Size> cursors = cellOffsets.clone();
+    entries.resize(visibleCnt);
+    for (Size i = 0; i < projected.size(); ++i) {
+        if (projected[i].radius >= 0.f) {
+            entries[cursors[cellIdxs[i]]++] = projected[i];
+        }
+    }
+}
+
+Array<Size> ScreenParticleIndex::findInRect(const Coords& from, const Coords& to) const {
+    const Coords lower(min(from.x, to.x), min(from.y, to.y));
+    const Coords upper(max(from.x, to.x), max(from.y, to.y));
+    Array<Size> result;
+    this->visitRect(lower, upper, [&](const Entry& entry) {
+        const Coords& p = entry.coords;
+        if (p.x >= lower.x && p.x <= upper.x && p.y >= lower.y && p.y <= upper.y) {
+            result.push(entry.idx);
+        }
+    });
+    return result;
+}
+
+/// Checks if the point lies inside the polygon, using the even-odd rule.
+static bool isInsidePolygon(ArrayView<const Coords> polygon, const Coords& p) {
+    bool inside = false;
+    for (Size i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        const Coords& a = polygon[i];
+        const Coords& b = polygon[j];
+        if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+Array<Size> ScreenParticleIndex::findInPolygon(ArrayView<const Coords> polygon) const {
+    Array<Size> result;
+    if (polygon.size() < 3) {
+        return result;
+    }
+    Coords lower = polygon[0];
+    Coords upper = polygon[0];
+    for (const Coords& p : polygon) {
+        lower = Coords(min(lower.x, p.x), min(lower.y, p.y));
+        upper = Coords(max(upper.x, p.x), max(upper.y, p.y));
+    }
+    // only cells in the bounding box of the polygon need to be checked
+    this->visitRect(lower, upper, [&](const Entry& entry) {
+        if (isInsidePolygon(polygon, entry.coords)) {
+            result.push(entry.idx);
+        }
+    });
+    return result;
+}
+
+NAMESPACE_SPH_END
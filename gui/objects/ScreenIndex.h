@@ -0,0 +1,158 @@
+#pragma once
+
+/// \file ScreenIndex.h
+/// \brief Screen-space index of projected particles
+/// \author Pavel Sevecek (sevecek at sirrah.troja.mff.cuni.cz)
+/// \date 2016-2021
+
+#include "gui/objects/Point.h"
+#include "objects/containers/Array.h"
+#include "objects/geometry/Vector.h"
+
+NAMESPACE_SPH_BEGIN
+
+class ICamera;
+class IScheduler;
+
+/// \brief Uniform 2D grid of particles projected into the image plane.
+///
+/// Allows to find particles under the cursor or inside a selected region without projecting all particles.
+/// Particles are binned by their projected centers; particles projected outside of the image are assigned to
+/// the nearest boundary cell, so that the queries remain conservative. Each cell also stores the maximal
+/// projected radius of its particles, so that a single large particle does not widen the search in all
+/// cells. The index has to be rebuilt every time the camera or the particle positions change.
+class ScreenParticleIndex {
+private:
+    struct Entry {
+        /// Index of the particle
+        Size idx;
+
+        /// Projected center of the particle
+        Coords coords;
+
+        /// Projected radius of the particle
+        float radius;
+    };
+
+    /// Entries sorted by cells
+    Array<Entry> entries;
+
+    /// Index of the first entry for each cell, the last element is the total number of entries
+    Array<Size> cellOffsets;
+
+    /// Maximal projected radius of particles in each cell
+    Array<float> cellRadii;
+
+    /// Number of cells in each dimension
+    int dims[2] = { 0, 0 };
+
+    /// Size of the cell in pixels
+    float cellSize = 1.f;
+
+    /// Maximal projected radius of the indexed particles
+    float maxRadius = 0.f;
+
+public:
+    /// \brief Projects the particles and builds the index.
+    ///
+    /// Particles not visible by the camera or cut off by the camera cutoff are excluded.
+    /// \param r Particle positions, H component is the radius of the particle.
+    /// \param camera Camera used to project the particles.
+    void build(IScheduler& scheduler, ArrayView<const Vector> r, const ICamera& camera);
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    /// \brief Returns the maximal projected radius of the indexed particles.
+    float getMaxRadius() const {
+        return maxRadius;
+    }
+
+    /// \brief Calls the functor for all particles with projected disks containing given point.
+    ///
+    /// \param radiusScale Multiplier of the projected radii of particles.
+    /// \param padding Distance in pixels added to the scaled radii.
+    /// \param functor Functor with signature void(const Size idx, const Coords& coords, const float radius).
+    template <typename TFunctor>
+    void findNearby(const Coords& point,
+        const float radiusScale,
+        const float padding,
+        TFunctor&& functor) const;
+
+    /// \brief Returns all particles with projected centers inside given rectangle.
+    Array<Size> findInRect(const Coords& from, const Coords& to) const;
+
+    /// \brief Returns all particles with projected centers inside given polygon.
+    ///
+    /// Polygon does not have to be convex; it is implicitly closed by connecting the last vertex with the
+    /// first one.
+    Array<Size> findInPolygon(ArrayView<const Coords> polygon) const;
+
+private:
+    INLINE int getCell(const float x, const int dim) const {
+        // clamp before the conversion, coordinates of distant particles can overflow int
+        return int(clamp(floor(x / cellSize), 0.f, float(dims[dim] - 1)));
+    }
+
+    template <typename TFunctor>
+    void visitRect(const Coords& from, const Coords& to, TFunctor&& functor) const;
+};
+
+template <typename TFunctor>
+void ScreenParticleIndex::visitRect(const Coords& from, const Coords& to, TFunctor&& functor) const {
+    if (entries.empty()) {
+        return;
+    }
+    const int x1 = this->getCell(min(from.x, to.x), X);
+    const int x2 = this->getCell(max(from.x, to.x), X);
+    const int y1 = this->getCell(min(from.y, to.y), Y);
+    const int y2 = this->getCell(max(from.y, to.y), Y);
+    for (int y = y1; y <= y2; ++y) {
+        for (int x = x1; x <= x2; ++x) {
+            const Size cellIdx = Size(y * dims[X] + x);
+            for (Size i = cellOffsets[cellIdx]; i < cellOffsets[cellIdx + 1]; ++i) {
+                functor(entries[i]);
+            }
+        }
+    }
+}
+
+template <typename TFunctor>
+void ScreenParticleIndex::findNearby(const Coords& point,
+    const float radiusScale,
+    const float padding,
+    TFunctor&& functor) const {
+    if (entries.empty()) {
+        return;
+    }
+    const float reach = maxRadius * radiusScale + padding;
+    const int x1 = this->getCell(point.x - reach, X);
+    const int x2 = this->getCell(point.x + reach, X);
+    const int y1 = this->getCell(point.y - reach, Y);
+    const int y2 = this->getCell(point.y + reach, Y);
+    for (int y = y1; y <= y2; ++y) {
+        for (int x = x1; x <= x2; ++x) {
+            const Size cellIdx = Size(y * dims[X] + x);
+            // boundary cells also contain particles projected outside of the image
+            const float lowerX = x == 0 ? -LARGE : x * cellSize;
+            const float upperX = x == dims[X] - 1 ? LARGE : (x + 1) * cellSize;
+            const float lowerY = y == 0 ? -LARGE : y * cellSize;
+            const float upperY = y == dims[Y] - 1 ? LARGE : (y + 1) * cellSize;
+            const float dx = max(lowerX - point.x, 0.f, point.x - upperX);
+            const float dy = max(lowerY - point.y, 0.f, point.y - upperY);
+            if (sqr(dx) + sqr(dy) > sqr(cellRadii[cellIdx] * radiusScale + padding)) {
+                // no particle in the cell is large enough to reach the point
+                continue;
+            }
+            for (Size i = cellOffsets[cellIdx]; i < cellOffsets[cellIdx + 1]; ++i) {
+                const Entry& entry = entries[i];
+                if (getLength(entry.coords - point) <= entry.radius * radiusScale + padding) {
+                    functor(entry.idx, entry.coords, entry.radius);
+                }
+            }
+        }
+    }
+}
+
+NAMESPACE_SPH_END
@@ -0,0 +1,178 @@
+#include "gui/objects/Colorizer.h"
+#include "catch.hpp"
+#include "gui/Factory.h"
+#include "quantities/Quantity.h"
+#include "tests/Setup.h"
+#include "thread/Pool.h"
+#include "timestepping/TimeStepCriterion.h"
+
+using namespace Sph;
+
+/// Storage containing all quantities used by the colorizers
+static Storage getColorizerStorage() {
+    Storage storage = Tests::getSolidStorage(1000);
+    ArrayView<Vector> r, v, dv;
+    tie(r, v, dv) = storage.getAll<Vector>(QuantityId::POSITION);
+    for (Size i = 0; i < r.size(); ++i) {
+        v[i] = Vector(r[i][Y], -r[i][X], 0.1_f * r[i][Z]);
+        dv[i] = -r[i];
+    }
+    ArrayView<Float> u = storage.getValue<Float>(QuantityId::ENERGY);
+    for (Size i = 0; i < u.size(); ++i) {
+        u[i] = 1.e3_f * (1._f + r[i][X]);
+    }
+
+    const Size n = storage.getParticleCnt();
+    Array<Size> flags(n), neighs(n), criteria(n);
+    Array<GlobalSize> persistentIdxs(n);
+    Array<Vector> uvws(n), normals(n);
+    for (Size i = 0; i < n; ++i) {
+        flags[i] = r[i][X] > 0._f ? 1 : 0;
+        neighs[i] = i % 60;
+        persistentIdxs[i] = n - i;
+        criteria[i] = Size(CriterionId::CFL_CONDITION);
+        uvws[i] = Vector(0.5_f + 0.5_f * r[i][X], 0.5_f + 0.5_f * r[i][Y], 0._f);
+        normals[i] = Vector(r[i][X], 0._f, 0._f);
+    }
+    storage.insert<Size>(QuantityId::FLAG, OrderEnum::ZERO, std::move(flags));
+    storage.insert<Size>(QuantityId::NEIGHBOR_CNT, OrderEnum::ZERO, std::move(neighs));
+    storage.insert<GlobalSize>(QuantityId::PERSISTENT_INDEX, OrderEnum::ZERO, std::move(persistentIdxs));
+    storage.insert<Size>(QuantityId::TIME_STEP_CRITERION, OrderEnum::ZERO, std::move(criteria));
+    storage.insert<Vector>(QuantityId::UVW, OrderEnum::ZERO, std::move(uvws));
+    storage.insert<Vector>(QuantityId::SURFACE_NORMAL, OrderEnum::ZERO, std::move(normals));
+    storage.insert<Float>(QuantityId::TIME_STEP, OrderEnum::ZERO, 0.1_f);
+    if (!storage.has(QuantityId::STRESS_REDUCING)) {
+        storage.insert<Float>(QuantityId::STRESS_REDUCING, OrderEnum::ZERO, 0.5_f);
+    }
+    return storage;
+}
+
+TEST_CASE("Colorizer required quantities", "[colorizer]") {
+    Storage storage = getColorizerStorage();
+    GuiSettings gui;
+    Array<ExtColorizerId> colorizerIds{
+        ColorizerId::VELOCITY,
+        ColorizerId::ACCELERATION,
+        ColorizerId::MOVEMENT_DIRECTION,
+        ColorizerId::COROTATING_VELOCITY,
+        ColorizerId::DENSITY_PERTURBATION,
+        ColorizerId::SUMMED_DENSITY,
+        ColorizerId::TOTAL_ENERGY,
+        ColorizerId::TEMPERATURE,
+        ColorizerId::TOTAL_STRESS,
+        ColorizerId::YIELD_REDUCTION,
+        ColorizerId::DAMAGE_ACTIVATION,
+        ColorizerId::RADIUS,
+        ColorizerId::BOUNDARY,
+        ColorizerId::UVW,
+        ColorizerId::PARTICLE_ID,
+        ColorizerId::COMPONENT_ID,
+        ColorizerId::BOUND_COMPONENT_ID,
+        ColorizerId::FLAG,
+        ColorizerId::MATERIAL_ID,
+        ColorizerId::TIME_STEP,
+        ColorizerId::BEAUTY,
+        QuantityId::DENSITY,
+        QuantityId::PRESSURE,
+        QuantityId::ENERGY,
+        QuantityId::DAMAGE,
+        QuantityId::MASS,
+    };
+
+    for (ExtColorizerId colorizerId : colorizerIds) {
+        AutoPtr<IColorizer> reference = Factory::getColorizer(gui, colorizerId);
+        if (!reference->hasData(storage)) {
+            continue;
+        }
+        reference->initialize(storage, RefEnum::STRONG);
+
+        // same as the frame created by the controller
+        AutoPtr<IColorizer> colorizer = Factory::getColorizer(gui, colorizerId);
+        Array<QuantityId> ids{ QuantityId::POSITION };
+        if (!colorizer->addRequiredQuantities(ids)) {
+            continue;
+        }
+        Storage snapshot = storage.clone(VisitorEnum::ALL_BUFFERS, ids);
+        INFO(colorizer->name());
+        REQUIRE(colorizer->hasData(snapshot));
+        REQUIRE_NOTHROW(colorizer->initialize(snapshot, RefEnum::STRONG));
+        REQUIRE(colorizer->isInitialized());
+
+        for (Size i = 0; i < storage.getParticleCnt(); ++i) {
+            REQUIRE(colorizer->evalColor(i) == reference->evalColor(i));
+        }
+    }
+}
+
+static bool isClose(const Rgba& c1, const Rgba& c2, const float eps) {
+    return abs(c1.r() - c2.r()) <= eps && abs(c1.g() - c2.g()) <= eps && abs(c1.b() - c2.b()) <= eps &&
+           abs(c1.a() - c2.a()) <= eps;
+}
+
+TEST_CASE("Colorizer evalColors", "[colorizer]") {
+    Storage storage = getColorizerStorage();
+    // make the radii and the yield reduction vary, so that their colors span the palette
+    ArrayView<Vector> r = storage.getValue<Vector>(QuantityId::POSITION);
+    ArrayView<Float> reduce = storage.getValue<Float>(QuantityId::STRESS_REDUCING);
+    for (Size i = 0; i < r.size(); ++i) {
+        r[i][H] = 0.01_f + getLength(r[i]);
+        reduce[i] = clamp(0.5_f + 0.5_f * r[i][X], 0._f, 1._f);
+    }
+    GuiSettings gui;
+    Array<ExtColorizerId> colorizerIds{
+        ColorizerId::VELOCITY,
+        ColorizerId::DENSITY_PERTURBATION,
+        ColorizerId::TEMPERATURE,
+        ColorizerId::YIELD_REDUCTION,
+        ColorizerId::RADIUS,
+        ColorizerId::TIME_STEP,
+        QuantityId::DENSITY,
+        QuantityId::ENERGY,
+        QuantityId::MASS,
+    };
+    ThreadPool pool(4);
+    Array<Size> idxs;
+    for (Size i = 0; i < storage.getParticleCnt(); i += 3) {
+        idxs.push(i);
+    }
+
+    for (ExtColorizerId colorizerId : colorizerIds) {
+        AutoPtr<IColorizer> colorizer = Factory::getColorizer(gui, colorizerId);
+        REQUIRE(colorizer->hasData(storage));
+        colorizer->initialize(storage, RefEnum::STRONG);
+        const Optional<Palette> palette = colorizer->getPalette();
+        REQUIRE(palette);
+
+        // use a range covering only a part of the values, so that some values are outside of the palette
+        Interval values;
+        for (Size i : idxs) {
+            if (const Optional<float> value = colorizer->evalScalar(i)) {
+                values.extend(value.value());
+            }
+        }
+        if (values.empty()) {
+            // colorizer does not provide the scalar values, use its default range
+            values = palette->getInterval();
+        } else if (values.size() == 0._f) {
+            // all values are the same, extend the range around the value
+            values.extend(values.lower() - max(abs(values.lower()), 1._f));
+            values.extend(values.upper() + max(abs(values.upper()), 1._f));
+        }
+        const Float lower = values.lower() + 0.2_f * values.size();
+        const Float upper = values.lower() + 0.8_f * values.size();
+        for (PaletteScale scale : { PaletteScale::LINEAR, PaletteScale::LOGARITHMIC, PaletteScale::HYBRID }) {
+            Interval range(lower, upper);
+            if (scale == PaletteScale::LOGARITHMIC) {
+                range = Interval(max(lower, 1.e-3_f * upper, 1.e-6_f), max(upper, 1._f));
+            }
+            colorizer->setPalette(Palette(palette->getPoints().clone(), range, scale));
+
+            Array<Rgba> colors(idxs.size());
+            colorizer->evalColors(pool, idxs, colors);
+            for (Size k = 0; k < idxs.size(); ++k) {
+                INFO(colorizer->name() << ", scale = " << int(scale) << ", index = " << idxs[k]);
+                REQUIRE(isClose(colors[k], colorizer->evalColor(idxs[k]), 0.01f));
+            }
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#include "gui/objects/Palette.h"
+#include "catch.hpp"
+
+using namespace Sph;
+
+static bool isClose(const Rgba& c1, const Rgba& c2, const float eps) {
+    return abs(c1.r() - c2.r()) <= eps && abs(c1.g() - c2.g()) <= eps && abs(c1.b() - c2.b()) <= eps &&
+           abs(c1.a() - c2.a()) <= eps;
+}
+
+static Palette getTestPalette(const Interval& range, const PaletteScale scale) {
+    return Palette({ { 0.f, Rgba(0.f, 0.f, 0.6f) },
+                       { 0.3f, Rgba(0.1f, 0.8f, 0.1f) },
+                       { 0.7f, Rgba(0.9f, 0.9f, 0.f) },
+                       { 1.f, Rgba(0.8f, 0.f, 0.f) } },
+        range,
+        scale);
+}
+
+TEST_CASE("PaletteLut", "[palette]") {
+    Array<Palette> palettes;
+    palettes.push(getTestPalette(Interval(-2.f, 5.f), PaletteScale::LINEAR));
+    palettes.push(getTestPalette(Interval(1.e-2f, 1.e4f), PaletteScale::LOGARITHMIC));
+    palettes.push(getTestPalette(Interval(-100.f, 1.e3f), PaletteScale::HYBRID));
+
+    for (const Palette& palette : palettes) {
+        const PaletteLut lut(palette);
+        const Interval range = palette.getInterval();
+
+        // sample the whole range and values outside of it, including zero and negative values
+        Array<float> values{ -1.e5f, -10.f, -1.f, 0.f, 1.e-5f, 1.e6f };
+        for (Size i = 0; i <= 1000; ++i) {
+            values.push(palette.relativeToRange(float(i) / 1000.f));
+        }
+        values.push(float(range.lower()) - 1.f);
+        values.push(float(range.upper()) + 1.f);
+
+        Array<Rgba> mapped(values.size());
+        lut.map(values, mapped);
+        for (Size i = 0; i < values.size(); ++i) {
+            INFO("value = " << values[i] << ", scale = " << int(palette.getScale()));
+            REQUIRE(isClose(lut(values[i]), palette(values[i]), 0.01f));
+            REQUIRE(isClose(mapped[i], lut(values[i]), 1.e-5f));
+        }
+
+        // values outside of the range are mapped to the boundary colors
+        REQUIRE(isClose(lut(-1.e5f), palette(float(range.lower())), 1.e-5f));
+        REQUIRE(isClose(lut(1.e6f), palette(float(range.upper())), 1.e-5f));
+    }
+}
@@ -0,0 +1,131 @@
+#include "gui/objects/ScreenIndex.h"
+#include "catch.hpp"
+#include "gui/objects/Camera.h"
+#include "math/rng/Rng.h"
+#include "thread/Scheduler.h"
+#include <algorithm>
+
+using namespace Sph;
+
+static OrthoCamera getCamera() {
+    CameraParams params;
+    params.imageSize = Pixel(400, 300);
+    params.position = Vector(0._f, 0._f, -5._f);
+    params.target = Vector(0._f);
+    // image height corresponds to 2 world units
+    params.ortho.fov = 2.f;
+    return OrthoCamera(params);
+}
+
+/// Small particles, some of them projected outside of the image, and one large particle
+static Array<Vector> getPositions() {
+    UniformRng rng;
+    Array<Vector> r;
+    for (Size i = 0; i < 1000; ++i) {
+        r.push(Vector(3._f * rng() - 1.5_f, 3._f * rng() - 1.5_f, 3._f * rng() - 1.5_f, 0.002_f));
+    }
+    r.push(Vector(0.8_f, 0.5_f, 0._f, 0.5_f));
+    return r;
+}
+
+static Array<Size> sorted(Array<Size>&& idxs) {
+    std::sort(idxs.begin(), idxs.end());
+    return std::move(idxs);
+}
+
+TEST_CASE("ScreenIndex findInRect", "[screenindex]") {
+    OrthoCamera camera = getCamera();
+    Array<Vector> r = getPositions();
+    ScreenParticleIndex index;
+    index.build(SEQUENTIAL, r, camera);
+    REQUIRE_FALSE(index.empty());
+
+    const Coords from(50.f, 280.f);
+    const Coords to(310.f, 40.f);
+    Array<Size> expected;
+    for (Size i = 0; i < r.size(); ++i) {
+        const Coords p = camera.project(r[i])->coords;
+        if (p.x >= from.x && p.x <= to.x && p.y >= to.y && p.y <= from.y) {
+            expected.push(i);
+        }
+    }
+    REQUIRE(expected.size() > 100);
+    REQUIRE(sorted(index.findInRect(from, to)) == expected);
+
+    // rectangle extending outside of the image
+    Array<Size> all = sorted(index.findInRect(Coords(-1.e4f, -1.e4f), Coords(1.e4f, 1.e4f)));
+    REQUIRE(all.size() == r.size());
+}
+
+TEST_CASE("ScreenIndex findInPolygon", "[screenindex]") {
+    OrthoCamera camera = getCamera();
+    Array<Vector> r = getPositions();
+    ScreenParticleIndex index;
+    index.build(SEQUENTIAL, r, camera);
+
+    // counter-clockwise triangle in image coordinates (y pointing down)
+    Array<Coords> polygon{ Coords(20.f, 20.f), Coords(380.f, 150.f), Coords(100.f, 290.f) };
+    Array<Size> expected;
+    for (Size i = 0; i < r.size(); ++i) {
+        const Coords p = camera.project(r[i])->coords;
+        bool inside = true;
+        for (Size j = 0; j < polygon.size(); ++j) {
+            const Coords e = polygon[(j + 1) % polygon.size()] - polygon[j];
+            const Coords d = p - polygon[j];
+            inside &= e.x * d.y - e.y * d.x > 0.f;
+        }
+        if (inside) {
+            expected.push(i);
+        }
+    }
+    REQUIRE(expected.size() > 100);
+    REQUIRE(sorted(index.findInPolygon(polygon)) == expected);
+
+    REQUIRE(index.findInPolygon(polygon.view().subset(0, 2)).empty());
+}
+
+TEST_CASE("ScreenIndex findNearby", "[screenindex]") {
+    OrthoCamera camera = getCamera();
+    Array<Vector> r = getPositions();
+    ScreenParticleIndex index;
+    index.build(SEQUENTIAL, r, camera);
+
+    const Size largeIdx = r.size() - 1;
+    const Coords center = camera.project(r[largeIdx])->coords;
+    const float radius = camera.project(r[largeIdx])->radius;
+    REQUIRE(radius > 50.f);
+
+    auto findNearby = [&](const Coords& point, const float radiusScale, const float padding) {
+        Array<Size> idxs;
+        index.findNearby(point, radiusScale, padding, [&](const Size i, const Coords&, const float) { //
+            idxs.push(i);
+        });
+        return sorted(std::move(idxs));
+    };
+
+    // points at the edge of the large particle, in cells distant from its center
+    for (Coords dir : { Coords(1.f, 0.f), Coords(0.f, 1.f), Coords(-0.6f, -0.8f) }) {
+        const Array<Size> found = findNearby(center + dir * 0.95f * radius, 1.f, 0.f);
+        REQUIRE(std::find(found.begin(), found.end(), largeIdx) != found.end());
+        const Array<Size> outside = findNearby(center + dir * 1.05f * radius, 1.f, 0.f);
+        REQUIRE(std::find(outside.begin(), outside.end(), largeIdx) == outside.end());
+    }
+
+    for (Coords point : { Coords(10.f, 10.f), Coords(200.f, 150.f), center, Coords(-30.f, 350.f) }) {
+        for (float padding : { 0.f, 1.f, 20.f }) {
+            Array<Size> expected;
+            for (Size i = 0; i < r.size(); ++i) {
+                const ProjectedPoint p = camera.project(r[i]).value();
+                if (getLength(p.coords - point) <= p.radius * 1.2f + padding) {
+                    expected.push(i);
+                }
+            }
+            REQUIRE(findNearby(point, 1.2f, padding) == expected);
+        }
+    }
+
+    // far from the large particle, only the small particles close to the point are found
+    const Array<Size> found = findNearby(Coords(20.f, 280.f), 1.f, 5.f);
+    REQUIRE(std::find(found.begin(), found.end(), largeIdx) == found.end());
+    REQUIRE(found.size() < 20);
+}
@@ -202,6 +202,14 @@ public:
     /// \param camera Camera used for rendering.
     virtual void initialize(const Storage& storage, const IColorizer& colorizer, const ICamera& camera) = 0;
 
+    /// \brief Adds the IDs of quantities needed by \ref initialize into the array.
+    ///
+    /// Has the same meaning as \ref IColorizer::addRequiredQuantities. Quantities needed by the colorizer do
+    /// not have to be included. Returns false if the renderer needs the complete storage.
+    virtual bool addRequiredQuantities(Array<QuantityId>& UNUSED(ids)) const {
+        return false;
+    }
+
     /// \brief Checks if the renderer has been initialized.
     virtual bool isInitialized() const = 0;
 
@@ -138,7 +138,8 @@ void drawAxis(IRenderContext& context, const Rgba& color, const Vector& axis, co
     context.drawText(origin + dir, TextAlign::TOP | TextAlign::HORIZONTAL_CENTER, label);
 }
 
-ParticleRenderer::ParticleRenderer(const GuiSettings& settings) {
+ParticleRenderer::ParticleRenderer(SharedPtr<IScheduler> scheduler, const GuiSettings& settings)
+    : scheduler(scheduler) {
     grid = float(settings.get<Float>(GuiSettingsId::VIEW_GRID_SIZE));
     shouldContinue = true;
 }
@@ -169,9 +170,6 @@ void ParticleRenderer::initialize(const Storage& storage,
             cached.idxs.push(i);
             cached.positions.push(r[i]);
 
-            const Rgba color = colorizer.evalColor(i);
-            cached.colors.push(color);
-
             if (hasVectorData) {
                 Optional<Vector> v = colorizer.evalVector(i);
                 SPH_ASSERT(v);
@@ -179,6 +177,8 @@ void ParticleRenderer::initialize(const Storage& storage,
             }
         }
     }
+    cached.colors.resize(cached.idxs.size());
+    colorizer.evalColors(*scheduler, cached.idxs, cached.colors);
 
     SharedPtr<IStorageUserData> data = storage.getUserData();
     if (RawPtr<GhostParticlesData> ghosts = dynamicCast<GhostParticlesData>(data.get())) {
@@ -234,11 +234,19 @@ bool ParticleRenderer::isInitialized() const {
 }
 
 void ParticleRenderer::setColorizer(const IColorizer& colorizer) {
+    // skip ghosts and attractors
+    Array<Size> slots;
+    Array<Size> idxs;
     for (Size i = 0; i < cached.idxs.size(); ++i) {
-        if (cached.idxs[i] == GHOST_INDEX || cached.idxs[i] == ATTRACTOR_INDEX) {
-            continue; // ghost or attractor
+        if (cached.idxs[i] != GHOST_INDEX && cached.idxs[i] != ATTRACTOR_INDEX) {
+            slots.push(i);
+            idxs.push(cached.idxs[i]);
         }
-        cached.colors[i] = colorizer.evalColor(cached.idxs[i]);
+    }
+    Array<Rgba> colors(idxs.size());
+    colorizer.evalColors(*scheduler, idxs, colors);
+    for (Size i = 0; i < slots.size(); ++i) {
+        cached.colors[slots[i]] = colors[i];
     }
 }
 
@@ -18,6 +18,8 @@ class IRenderContext;
 
 class ParticleRenderer : public IRenderer {
 private:
+    SharedPtr<IScheduler> scheduler;
+
     /// Grid size
     float grid;
 
@@ -45,12 +47,17 @@ private:
     mutable Timer lastRenderTimer;
 
 public:
-    explicit ParticleRenderer(const GuiSettings& settings);
+    ParticleRenderer(SharedPtr<IScheduler> scheduler, const GuiSettings& settings);
 
     virtual void initialize(const Storage& storage,
         const IColorizer& colorizer,
         const ICamera& camera) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::POSITION);
+        return true;
+    }
+
     virtual bool isInitialized() const override;
 
     virtual void setColorizer(const IColorizer& colorizer) override;
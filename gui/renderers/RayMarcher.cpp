@@ -126,11 +126,15 @@ bool RayMarcher::isInitialized() const {
 void RayMarcher::setColorizer(const IColorizer& colorizer) {
     cached.doEmission = typeid(colorizer) == typeid(BeautyColorizer);
     cached.colors.resize(cached.r.size());
-    for (Size i = 0; i < cached.r.size(); ++i) {
-        cached.colors[i] = colorizer.evalColor(i);
-        if (cached.doEmission) {
+    Array<Size> idxs(cached.r.size());
+    for (Size i = 0; i < idxs.size(); ++i) {
+        idxs[i] = i;
+    }
+    colorizer.evalColors(*scheduler, idxs, cached.colors);
+    if (cached.doEmission) {
+        parallelFor(*scheduler, 0, cached.r.size(), [this, &colorizer](const Size i) {
             cached.colors[i] = cached.colors[i] * colorizer.evalScalar(i).value();
-        }
+        });
     }
 }
 
@@ -100,6 +100,16 @@ public:
         const IColorizer& colorizer,
         const ICamera& camera) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::POSITION);
+        ids.push(QuantityId::UVW);
+        ids.push(QuantityId::FLAG);
+        ids.push(QuantityId::STRESS_REDUCING);
+        ids.push(QuantityId::MASS);
+        ids.push(QuantityId::DENSITY);
+        return true;
+    }
+
     virtual bool isInitialized() const override;
 
     virtual void setColorizer(const IColorizer& colorizer) override;
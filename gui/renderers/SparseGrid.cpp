@@ -0,0 +1,233 @@
+#include "gui/renderers/SparseGrid.h"
+#include "thread/Scheduler.h"
+#include "thread/ThreadLocal.h"
+#include <algorithm>
+
+NAMESPACE_SPH_BEGIN
+
+constexpr int SparseVoxelGrid::BRICK_SIZE;
+constexpr Size SparseVoxelGrid::NO_BRICK;
+
+/// Minimal radius of splatted particles in units of voxel size
+const Float MIN_SPLAT_RADIUS = 1.5_f;
+
+/// Fraction of particles on each side of the domain ignored when determining the voxel size
+const Float OUTLIER_FRACTION = 0.005_f;
+
+/// Maximal extent of the grid beyond the bounds of the bulk of particles, in units of their size
+const Float MAX_GRID_EXTENT = 2._f;
+
+namespace {
+
+struct BrickRef {
+    /// Flat index of the brick in the top level
+    Size brick;
+
+    /// Index of the particle intersecting the brick
+    Size particle;
+};
+
+/// \brief Returns the box containing all particles except for a given fraction of outliers on each side.
+///
+/// Otherwise a few distant particles (ejecta, escapers) would enlarge the voxels of the whole grid.
+Box getBulkBounds(ArrayView<const Vector> r) {
+    const Size outlierCnt = Size(OUTLIER_FRACTION * r.size());
+    Array<Float> coords(r.size());
+    Vector lower, upper;
+    for (int j = 0; j < 3; ++j) {
+        for (Size i = 0; i < r.size(); ++i) {
+            coords[i] = r[i][j] - r[i][H];
+        }
+        std::nth_element(coords.begin(), coords.begin() + outlierCnt, coords.end());
+        lower[j] = coords[outlierCnt];
+
+        for (Size i = 0; i < r.size(); ++i) {
+            coords[i] = r[i][j] + r[i][H];
+        }
+        std::nth_element(coords.begin(), coords.begin() + (r.size() - 1 - outlierCnt), coords.end());
+        upper[j] = coords[r.size() - 1 - outlierCnt];
+    }
+    return Box(lower, upper);
+}
+
+} // namespace
+
+void SparseVoxelGrid::build(IScheduler& scheduler,
+    ArrayView<const Vector> r,
+    ArrayView<const BasicVector<float>> values,
+    const Size resolution) {
+    SPH_ASSERT(r.size() == values.size());
+    brickIdxs.clear();
+    voxels.clear();
+    if (r.empty()) {
+        return;
+    }
+
+    Box bounds;
+    for (Size i = 0; i < r.size(); ++i) {
+        bounds.extend(r[i] + Vector(r[i][H]));
+        bounds.extend(r[i] - Vector(r[i][H]));
+    }
+    // voxel size is given by the bulk of particles; the grid is extended to include the outliers, but only
+    // up to a limited distance, farther particles are not splatted
+    const Box bulk = getBulkBounds(r);
+    voxelSize = maxElement(bulk.size()) / resolution;
+    if (voxelSize <= 0._f) {
+        voxelSize = maxElement(bounds.size()) / resolution;
+    }
+    SPH_ASSERT(voxelSize > 0._f);
+    const Vector maxExtent = Vector(maxElement(bulk.size()) * MAX_GRID_EXTENT);
+    bounds = bounds.intersect(Box(bulk.lower() - maxExtent, bulk.upper() + maxExtent));
+    // enlarge the box to fit the enlarged particles
+    const Float minRadius = MIN_SPLAT_RADIUS * voxelSize;
+    bounds.extend(bounds.lower() - Vector(minRadius));
+    bounds.extend(bounds.upper() + Vector(minRadius));
+
+    const Float brickSize = voxelSize * BRICK_SIZE;
+    for (int i = 0; i < 3; ++i) {
+        dims[i] = max(int(ceil(bounds.size()[i] / brickSize)), 1);
+    }
+    const Vector gridSize = Vector(Float(dims[X]), Float(dims[Y]), Float(dims[Z])) * brickSize;
+    box = Box(bounds.lower(), bounds.lower() + gridSize);
+    const Vector lower = box.lower();
+
+    auto getBrickRange = [&](const Vector& center, const Float radius, int from[3], int to[3]) {
+        for (int i = 0; i < 3; ++i) {
+            from[i] = clamp(int((center[i] - radius - lower[i]) / brickSize), 0, dims[i] - 1);
+            to[i] = clamp(int((center[i] + radius - lower[i]) / brickSize), 0, dims[i] - 1);
+        }
+    };
+
+    // find all bricks intersected by particles
+    ThreadLocal<Array<BrickRef>> refs(scheduler);
+    parallelFor(scheduler, refs, 0, r.size(), [&](const Size i, Array<BrickRef>& local) {
+        const Float radius = max(r[i][H], minRadius);
+        if (box.intersect(Box(r[i] - Vector(radius), r[i] + Vector(radius))) == Box::EMPTY()) {
+            // outlier outside of the grid
+            return;
+        }
+        int from[3], to[3];
+        getBrickRange(r[i], radius, from, to);
+        for (int z = from[Z]; z <= to[Z]; ++z) {
+            for (int y = from[Y]; y <= to[Y]; ++y) {
+                for (int x = from[X]; x <= to[X]; ++x) {
+                    local.push(BrickRef{ getBrickFlatIdx(x, y, z), i });
+                }
+            }
+        }
+    });
+
+    // allocate the bricks and sort the particles by bricks
+    brickIdxs.resizeAndSet(dims[X] * dims[Y] * dims[Z], NO_BRICK);
+    Array<Size> counts(brickIdxs.size());
+    counts.fill(0);
+    for (const Array<BrickRef>& local : refs) {
+        for (const BrickRef& ref : local) {
+            ++counts[ref.brick];
+        }
+    }
+    Array<Size> bricks;
+    Array<Size> offsets;
+    Size refCnt = 0;
+    for (Size i = 0; i < counts.size(); ++i) {
+        if (counts[i] > 0) {
+            brickIdxs[i] = bricks.size();
+            bricks.push(i);
+            offsets.push(refCnt);
+            refCnt += counts[i];
+        }
+    }
+    offsets.push(refCnt);
+
+    Array<Size> particles(refCnt);
+    Array<Size> cursors(bricks.size());
+    for (Size i = 0; i < bricks.size(); ++i) {
+        cursors[i] = offsets[i];
+    }
+    for (const Array<BrickRef>& local : refs) {
+        for (const BrickRef& ref : local) {
+            particles[cursors[brickIdxs[ref.brick]]++] = ref.particle;
+        }
+    }
+
+    // splat the particles, each brick is processed by a single thread
+    constexpr Size voxelsPerBrick = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+    voxels.resizeAndSet(bricks.size() * voxelsPerBrick, BasicVector<float>(0.f));
+    parallelFor(scheduler, 0, bricks.size(), 1, [&](const Size brickIdx) {
+        const Size flatIdx = bricks[brickIdx];
+        const int brick[3] = {
+            int(flatIdx % dims[X]),
+            int((flatIdx / dims[X]) % dims[Y]),
+            int(flatIdx / (dims[X] * dims[Y])),
+        };
+        BasicVector<float>* data = &voxels[brickIdx * voxelsPerBrick];
+
+        // sort the particles to make the summation order deterministic
+        Size* first = &particles[0] + offsets[brickIdx];
+        Size* last = &particles[0] + offsets[brickIdx + 1];
+        std::sort(first, last);
+
+        for (Size* iter = first; iter != last; ++iter) {
+            const Size i = *iter;
+            const Float radius = max(r[i][H], minRadius);
+            // conserve the integral of the enlarged particles
+            const BasicVector<float> value = values[i] * float(pow<3>(r[i][H] / radius));
+            int from[3], to[3];
+            for (int j = 0; j < 3; ++j) {
+                const int brickFrom = brick[j] * BRICK_SIZE;
+                from[j] = max(int(floor((r[i][j] - radius - lower[j]) / voxelSize)), brickFrom);
+                to[j] = min(int(ceil((r[i][j] + radius - lower[j]) / voxelSize)), brickFrom + BRICK_SIZE - 1);
+            }
+            const Float invRadiusSqr = 1._f / sqr(radius);
+            for (int z = from[Z]; z <= to[Z]; ++z) {
+                for (int y = from[Y]; y <= to[Y]; ++y) {
+                    for (int x = from[X]; x <= to[X]; ++x) {
+                        const Vector center = lower + Vector(x + 0.5_f, y + 0.5_f, z + 0.5_f) * voxelSize;
+                        const Float qSqr = getSqrLength(center - r[i]) * invRadiusSqr;
+                        if (qSqr >= 1._f) {
+                            continue;
+                        }
+                        const Size voxelIdx = getVoxelFlatIdx(
+                            x - brick[X] * BRICK_SIZE, y - brick[Y] * BRICK_SIZE, z - brick[Z] * BRICK_SIZE);
+                        data[voxelIdx] += value * float(sqr(1._f - qSqr));
+                    }
+                }
+            }
+        }
+    });
+}
+
+BasicVector<float> SparseVoxelGrid::sample(const Vector& pos) const {
+    const Vector idxs = (pos - box.lower()) / voxelSize;
+    const BasicVector<float>* voxel =
+        this->getVoxel(int(floor(idxs[X])), int(floor(idxs[Y])), int(floor(idxs[Z])));
+    return voxel ? *voxel : BasicVector<float>(0.f);
+}
+
+BasicVector<float> SparseVoxelGrid::sampleInterpolated(const Vector& pos) const {
+    // values are located at voxel centers
+    const Vector idxs = (pos - box.lower()) / voxelSize - Vector(0.5_f);
+    const int x0 = int(floor(idxs[X]));
+    const int y0 = int(floor(idxs[Y]));
+    const int z0 = int(floor(idxs[Z]));
+    const float fx = float(idxs[X] - x0);
+    const float fy = float(idxs[Y] - y0);
+    const float fz = float(idxs[Z] - z0);
+
+    BasicVector<float> result = BasicVector<float>(0.f);
+    for (int k = 0; k < 2; ++k) {
+        const float wz = k ? fz : 1.f - fz;
+        for (int j = 0; j < 2; ++j) {
+            const float wy = j ? fy : 1.f - fy;
+            for (int i = 0; i < 2; ++i) {
+                const float wx = i ? fx : 1.f - fx;
+                if (const BasicVector<float>* voxel = this->getVoxel(x0 + i, y0 + j, z0 + k)) {
+                    result += *voxel * (wx * wy * wz);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+NAMESPACE_SPH_END
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "objects/containers/Array.h"
+#include "objects/finders/Bvh.h"
+#include "objects/geometry/Box.h"
+
+NAMESPACE_SPH_BEGIN
+
+class IScheduler;
+
+/// \brief Sparse voxel grid holding the emission and the density of the medium.
+///
+/// Voxels are grouped into bricks of 8x8x8 voxels and only bricks intersecting at least one particle are
+/// allocated. The top level of the grid is a dense array of brick indices covering the bounding box of
+/// particles, so that empty regions of the domain cost only a single index. The voxel size is determined by
+/// the bulk of particles, ignoring 0.5% of outliers on each side, and the grid extends at most twice the
+/// size of the bulk beyond it; particles farther away are not splatted. Each voxel stores the sum of
+/// splatted particle values, weighted by the kernel (1-q^2)^2, where q is the distance from the particle
+/// center in units of the particle radius. Values are 4-component single-precision vectors; the volumetric
+/// renderer uses the first three components for the emitted color and the fourth one for the density.
+class SparseVoxelGrid {
+public:
+    /// Number of voxels of a brick in each dimension
+    static constexpr int BRICK_SIZE = 8;
+
+private:
+    static constexpr Size NO_BRICK = Size(-1);
+
+    /// Bounding box of the grid, aligned to bricks
+    Box box;
+
+    /// Size of a single voxel
+    Float voxelSize = 0._f;
+
+    /// Number of bricks in each dimension
+    int dims[3] = { 0, 0, 0 };
+
+    /// Index of the brick for each cell of the top level, or NO_BRICK if the brick is empty
+    Array<Size> brickIdxs;
+
+    /// Values of voxels of all allocated bricks, stored consecutively
+    Array<BasicVector<float>> voxels;
+
+public:
+    /// \brief Splats particles into the grid, replacing the previous content.
+    ///
+    /// Particles are splatted in parallel; each brick is filled by a single task and the particles are
+    /// accumulated in the order of their indices, so the result does not depend on the number of threads.
+    /// Particles smaller than the voxel are enlarged, keeping the integral of the splatted value.
+    /// \param r Particle positions, H component is the radius of the particle.
+    /// \param values Values of particles at their centers.
+    /// \param resolution Number of voxels along the largest dimension of the bounding box of the bulk.
+    void build(IScheduler& scheduler,
+        ArrayView<const Vector> r,
+        ArrayView<const BasicVector<float>> values,
+        const Size resolution);
+
+    bool empty() const {
+        return voxels.empty();
+    }
+
+    Float getVoxelSize() const {
+        return voxelSize;
+    }
+
+    /// \brief Returns the number of allocated bricks.
+    Size getBrickCnt() const {
+        return voxels.size() / (BRICK_SIZE * BRICK_SIZE * BRICK_SIZE);
+    }
+
+    /// \brief Returns the value of the voxel containing given point.
+    BasicVector<float> sample(const Vector& pos) const;
+
+    /// \brief Returns the value at given point, trilinearly interpolated from the neighboring voxels.
+    BasicVector<float> sampleInterpolated(const Vector& pos) const;
+
+    /// \brief Calls the functor for equidistant points along the ray, skipping empty bricks.
+    ///
+    /// The points are located at distances offset + k * step from the ray origin, where k is an integer,
+    /// so that the points do not depend on the traversed bricks. The ray is terminated once the functor
+    /// returns false.
+    /// \param ray Ray with normalized direction.
+    /// \param tMax Maximal distance of the points.
+    /// \param functor Functor with signature bool(const Vector& pos).
+    template <typename TFunctor>
+    void march(const Ray& ray,
+        const Float tMax,
+        const Float step,
+        const Float offset,
+        TFunctor&& functor) const;
+
+private:
+    INLINE const BasicVector<float>* getVoxel(const int x, const int y, const int z) const {
+        if (x < 0 || y < 0 || z < 0 || x >= dims[X] * BRICK_SIZE || y >= dims[Y] * BRICK_SIZE ||
+            z >= dims[Z] * BRICK_SIZE) {
+            return nullptr;
+        }
+        const Size brickIdx = brickIdxs[getBrickFlatIdx(x / BRICK_SIZE, y / BRICK_SIZE, z / BRICK_SIZE)];
+        if (brickIdx == NO_BRICK) {
+            return nullptr;
+        }
+        return &voxels[brickIdx * BRICK_SIZE * BRICK_SIZE * BRICK_SIZE +
+                       getVoxelFlatIdx(x % BRICK_SIZE, y % BRICK_SIZE, z % BRICK_SIZE)];
+    }
+
+    INLINE Size getBrickFlatIdx(const int x, const int y, const int z) const {
+        return Size((z * dims[Y] + y) * dims[X] + x);
+    }
+
+    INLINE static Size getVoxelFlatIdx(const int x, const int y, const int z) {
+        return Size((z * BRICK_SIZE + y) * BRICK_SIZE + x);
+    }
+};
+
+template <typename TFunctor>
+void SparseVoxelGrid::march(const Ray& ray,
+    const Float tMax,
+    const Float step,
+    const Float offset,
+    TFunctor&& functor) const {
+    if (this->empty()) {
+        return;
+    }
+    Interval segment;
+    if (!intersectBox(box, RaySegment(ray), segment)) {
+        return;
+    }
+    Float t = max(segment.lower(), 0._f);
+    const Float tEnd = min(segment.upper(), tMax);
+    if (t >= tEnd) {
+        return;
+    }
+
+    // 3D DDA over the bricks
+    const Float brickSize = voxelSize * BRICK_SIZE;
+    const Vector entry = ray.origin() + ray.direction() * t;
+    int idxs[3];
+    int steps[3];
+    Float tNext[3];
+    Float tDelta[3];
+    for (int i = 0; i < 3; ++i) {
+        idxs[i] = clamp(int((entry[i] - box.lower()[i]) / brickSize), 0, dims[i] - 1);
+        const Float dir = ray.direction()[i];
+        if (dir > 0._f) {
+            steps[i] = 1;
+            tNext[i] = t + (box.lower()[i] + (idxs[i] + 1) * brickSize - entry[i]) / dir;
+            tDelta[i] = brickSize / dir;
+        } else if (dir < 0._f) {
+            steps[i] = -1;
+            tNext[i] = t + (box.lower()[i] + idxs[i] * brickSize - entry[i]) / dir;
+            tDelta[i] = -brickSize / dir;
+        } else {
+            steps[i] = 0;
+            tNext[i] = INFTY;
+            tDelta[i] = INFTY;
+        }
+    }
+
+    while (t < tEnd) {
+        const int axis = tNext[X] < tNext[Y] ? (tNext[X] < tNext[Z] ? X : Z) : (tNext[Y] < tNext[Z] ? Y : Z);
+        const Float tExit = min(tNext[axis], tEnd);
+        if (brickIdxs[getBrickFlatIdx(idxs[X], idxs[Y], idxs[Z])] != NO_BRICK) {
+            for (Float k = ceil((t - offset) / step); offset + k * step < tExit; k += 1._f) {
+                if (!functor(ray.origin() + ray.direction() * (offset + k * step))) {
+                    return;
+                }
+            }
+        }
+        t = tExit;
+        idxs[axis] += steps[axis];
+        if (idxs[axis] < 0 || idxs[axis] >= dims[axis]) {
+            break;
+        }
+        tNext[axis] += tDelta[axis];
+    }
+}
+
+NAMESPACE_SPH_END
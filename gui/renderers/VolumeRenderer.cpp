@@ -9,7 +9,31 @@
 NAMESPACE_SPH_BEGIN
 
 VolumeRenderer::VolumeRenderer(SharedPtr<IScheduler> scheduler, const GuiSettings& settings)
-    : IRaytracer(scheduler, settings) {}
+    : IRaytracer(scheduler, settings) {
+    fixed.method = settings.get<VolumeMethodEnum>(GuiSettingsId::VOLUME_METHOD);
+    switch (settings.get<VolumeQualityEnum>(GuiSettingsId::VOLUME_GRID_QUALITY)) {
+    case VolumeQualityEnum::PREVIEW:
+        fixed.resolution = 128;
+        fixed.step = 1._f;
+        fixed.interpolate = false;
+        fixed.minTransmittance = 0.02f;
+        break;
+    case VolumeQualityEnum::STANDARD:
+        fixed.resolution = 256;
+        fixed.step = 0.5_f;
+        fixed.interpolate = true;
+        fixed.minTransmittance = 0.01f;
+        break;
+    case VolumeQualityEnum::MOVIE:
+        fixed.resolution = 512;
+        fixed.step = 0.25_f;
+        fixed.interpolate = true;
+        fixed.minTransmittance = 0.002f;
+        break;
+    default:
+        NOT_IMPLEMENTED;
+    }
+}
 
 VolumeRenderer::~VolumeRenderer() = default;
 
@@ -18,8 +42,6 @@ const float MIN_NEIGHS = 8;
 
 void VolumeRenderer::initialize(const Storage& storage, const IColorizer& colorizer, const ICamera& camera) {
     cached.r = storage.getValue<Vector>(QuantityId::POSITION).clone();
-    this->setColorizer(colorizer);
-
     cached.distention.resize(cached.r.size());
 
     KdTree<KdNode> tree;
@@ -69,6 +91,10 @@ void VolumeRenderer::initialize(const Storage& storage, const IColorizer& colori
         }
     }
 
+    // needs the distention and reference radii if the grid is used
+    this->setColorizer(colorizer);
+
+    cached.attractors.clear();
     cached.textures.clear();
     for (Size i = 0; i < storage.getAttractorCnt(); ++i) {
         const Attractor& a = storage.getAttractors()[i];
@@ -95,7 +121,9 @@ void VolumeRenderer::initialize(const Storage& storage, const IColorizer& colori
         spheres.push(sphere);
     }
 
-    bvh.build(std::move(spheres));
+    if (fixed.method == VolumeMethodEnum::BVH) {
+        bvh.build(std::move(spheres));
+    }
 
     cached.maxDistance = 0;
     for (const Attractor& a : storage.getAttractors()) {
@@ -116,12 +144,37 @@ bool VolumeRenderer::isInitialized() const {
 
 void VolumeRenderer::setColorizer(const IColorizer& colorizer) {
     cached.colors.resize(cached.r.size());
-    for (Size i = 0; i < cached.r.size(); ++i) {
-        cached.colors[i] = colorizer.evalColor(i);
+    Array<Size> idxs(cached.r.size());
+    for (Size i = 0; i < idxs.size(); ++i) {
+        idxs[i] = i;
+    }
+    colorizer.evalColors(*scheduler, idxs, cached.colors);
+    if (fixed.method == VolumeMethodEnum::VOXEL_GRID) {
+        this->buildGrid();
     }
 }
 
+void VolumeRenderer::buildGrid() {
+    Array<Vector> spheres(cached.r.size());
+    Array<BasicVector<float>> values(cached.r.size());
+    parallelFor(*scheduler, 0, cached.r.size(), [&](const Size i) {
+        const float distention = cached.distention[i];
+        const float radius = float(cached.r[i][H]) * distention;
+        spheres[i] = setH(cached.r[i], radius);
+        // The splatted kernel is normalized so that the emission along a ray through the particle center
+        // matches the emission computed by the BVH method, i.e. 2 * reference radius / distention^2.
+        const float density = 15.f * cached.referenceRadii[i] / (8.f * radius * sqr(distention));
+        const Rgba& color = cached.colors[i];
+        values[i] = BasicVector<float>(color.r(), color.g(), color.b(), 1.f) * density;
+    });
+    grid.build(*scheduler, spheres, values, fixed.resolution);
+}
+
 Rgba VolumeRenderer::shade(const RenderParams& params, const CameraRay& cameraRay, ThreadData& data) const {
+    if (fixed.method == VolumeMethodEnum::VOXEL_GRID) {
+        return this->shadeGrid(params, cameraRay, data);
+    }
+
     const Vector primaryDir = getNormalized(cameraRay.target - cameraRay.origin);
     const Ray primaryRay(cameraRay.origin, primaryDir);
 
@@ -170,6 +223,52 @@ Rgba VolumeRenderer::shade(const RenderParams& params, const CameraRay& cameraRa
     return result;
 }
 
+Rgba VolumeRenderer::shadeGrid(const RenderParams& params,
+    const CameraRay& cameraRay,
+    ThreadData& data) const {
+    const Vector dir = getNormalized(cameraRay.target - cameraRay.origin);
+    const Ray ray(cameraRay.origin, dir);
+
+    // visible attractors are solid, so we only need to march up to the closest one
+    Float tMax = INFTY;
+    Optional<Size> attractorIdx;
+    for (Size i = 0; i < cached.attractors.size(); ++i) {
+        const AttractorData& a = cached.attractors[i];
+        IntersectionInfo is;
+        if (a.visible && BvhSphere(a.position, a.radius).getIntersection(ray, is) && is.t < tMax) {
+            tMax = is.t;
+            attractorIdx = i;
+        }
+    }
+
+    // emission and absorption are integrated front-to-back, so that we can terminate the ray once the
+    // medium becomes opaque; the starting point is randomized to avoid banding
+    const Float step = fixed.step * grid.getVoxelSize();
+    const float emission = params.volume.emission * float(step);
+    const float absorption = params.volume.absorption * float(step);
+    BasicVector<float> result(0.f);
+    float transmittance = 1.f;
+    grid.march(ray, tMax, step, step * data.rng(), [&](const Vector& pos) {
+        const BasicVector<float> value = fixed.interpolate ? grid.sampleInterpolated(pos) : grid.sample(pos);
+        // color in the first three components, density in the fourth component
+        result += value * (emission * transmittance);
+        transmittance *= exp(-absorption * value[3]);
+        return transmittance > fixed.minTransmittance;
+    });
+
+    Rgba background;
+    if (attractorIdx) {
+        const Vector hit = ray.origin() + dir * tMax;
+        background = this->getAttractorColor(params, attractorIdx.value(), hit);
+    } else {
+        background = this->getEnviroColor(cameraRay);
+    }
+    return Rgba(result[0] + background.r() * transmittance,
+        result[1] + background.g() * transmittance,
+        result[2] + background.b() * transmittance,
+        min(result[3] + background.a(), 1.f));
+}
+
 Rgba VolumeRenderer::getAttractorColor(const RenderParams& params,
     const Size index,
     const Vector& hit) const {
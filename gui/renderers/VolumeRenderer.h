@@ -1,8 +1,10 @@
 #pragma once
 
+#include "gui/Settings.h"
 #include "gui/objects/Color.h"
 #include "gui/renderers/IRenderer.h"
 #include "gui/renderers/Lensing.h"
+#include "gui/renderers/SparseGrid.h"
 #include "objects/finders/Bvh.h"
 #include <atomic>
 
@@ -13,6 +15,27 @@ private:
     /// BVH for finding intersections of rays with particles
     Bvh<BvhSphere> bvh;
 
+    /// Voxel grid with splatted particles, used instead of BVH if selected
+    SparseVoxelGrid grid;
+
+    struct {
+        /// Method used to evaluate the emission along rays
+        VolumeMethodEnum method;
+
+        /// Number of voxels along the largest dimension of the grid
+        Size resolution;
+
+        /// Step of the ray marching in units of voxel size
+        Float step;
+
+        /// If true, voxel values are trilinearly interpolated
+        bool interpolate;
+
+        /// Ray marching is terminated once the transmittance drops below this value
+        float minTransmittance;
+
+    } fixed;
+
     struct {
         /// Particle positions
         Array<Vector> r;
@@ -65,6 +88,12 @@ public:
         const IColorizer& colorizer,
         const ICamera& camera) override;
 
+    virtual bool addRequiredQuantities(Array<QuantityId>& ids) const override {
+        ids.push(QuantityId::POSITION);
+        ids.push(QuantityId::MASS);
+        return true;
+    }
+
     virtual bool isInitialized() const override;
 
     virtual void setColorizer(const IColorizer& colorizer) override;
@@ -74,6 +103,10 @@ private:
         const CameraRay& cameraRay,
         ThreadData& data) const override;
 
+    Rgba shadeGrid(const RenderParams& params, const CameraRay& cameraRay, ThreadData& data) const;
+
+    void buildGrid();
+
     Rgba getAttractorColor(const RenderParams& params, const Size index, const Vector& hit) const;
 };
 
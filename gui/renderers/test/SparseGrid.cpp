@@ -0,0 +1,103 @@
+#include "gui/renderers/SparseGrid.h"
+#include "catch.hpp"
+#include "tests/Approx.h"
+#include "thread/Pool.h"
+
+using namespace Sph;
+
+/// Particles on a cubic lattice filling a sphere of unit radius
+static Array<Vector> getBall(const Float spacing) {
+    Array<Vector> r;
+    for (Float z = -1._f; z <= 1._f; z += spacing) {
+        for (Float y = -1._f; y <= 1._f; y += spacing) {
+            for (Float x = -1._f; x <= 1._f; x += spacing) {
+                if (sqr(x) + sqr(y) + sqr(z) <= 1._f) {
+                    r.push(Vector(x, y, z, spacing));
+                }
+            }
+        }
+    }
+    return r;
+}
+
+TEST_CASE("SparseVoxelGrid sample", "[sparsegrid]") {
+    Array<Vector> r{ Vector(0._f, 0._f, 0._f, 1._f) };
+    Array<BasicVector<float>> values{ BasicVector<float>(1.f, 2.f, 3.f, 4.f) };
+    SparseVoxelGrid grid;
+    grid.build(SEQUENTIAL, r, values, 16);
+    REQUIRE_FALSE(grid.empty());
+    REQUIRE(grid.getVoxelSize() == approx(2._f / 16));
+
+    const BasicVector<float> center = grid.sample(Vector(0._f));
+    REQUIRE(center[X] > 0.9f);
+    REQUIRE(center[H] == approx(4.f * center[X]));
+    REQUIRE(grid.sample(Vector(0.5_f, 0._f, 0._f))[X] < center[X]);
+    REQUIRE(grid.sample(Vector(1.2_f, 0._f, 0._f)) == BasicVector<float>(0.f));
+    REQUIRE(grid.sample(Vector(10._f, 0._f, 0._f)) == BasicVector<float>(0.f));
+    REQUIRE(grid.sampleInterpolated(Vector(0._f))[X] == approx(center[X], 0.1f));
+}
+
+TEST_CASE("SparseVoxelGrid deterministic", "[sparsegrid]") {
+    Array<Vector> r = getBall(0.1_f);
+    Array<BasicVector<float>> values(r.size());
+    for (Size i = 0; i < r.size(); ++i) {
+        values[i] = BasicVector<float>(float(i % 7), 1.f, 0.f, 1.f);
+    }
+    SparseVoxelGrid grid1, grid2;
+    grid1.build(SEQUENTIAL, r, values, 32);
+    ThreadPool pool(4);
+    grid2.build(pool, r, values, 32);
+    REQUIRE(grid1.getBrickCnt() == grid2.getBrickCnt());
+    for (Float x = -1._f; x <= 1._f; x += 0.03_f) {
+        const Vector pos(x, 0.5_f * x, 0.1_f);
+        REQUIRE(grid1.sample(pos) == grid2.sample(pos));
+    }
+}
+
+TEST_CASE("SparseVoxelGrid outliers", "[sparsegrid]") {
+    Array<Vector> r = getBall(0.1_f);
+    Array<BasicVector<float>> values(r.size());
+    values.fill(BasicVector<float>(1.f));
+    SparseVoxelGrid grid;
+    grid.build(SEQUENTIAL, r, values, 32);
+    const Float voxelSize = grid.getVoxelSize();
+    const Size brickCnt = grid.getBrickCnt();
+
+    // a distant particle does not change the resolution of the grid
+    r.push(Vector(1.e6_f, 0._f, 0._f, 0.1_f));
+    values.push(BasicVector<float>(1.f));
+    grid.build(SEQUENTIAL, r, values, 32);
+    REQUIRE(grid.getVoxelSize() == approx(voxelSize, 0.1_f));
+    REQUIRE(grid.getBrickCnt() == brickCnt);
+    REQUIRE(grid.sample(Vector(0._f))[X] > 0.f);
+}
+
+TEST_CASE("SparseVoxelGrid march", "[sparsegrid]") {
+    Array<Vector> r{ Vector(0._f, 0._f, 0._f, 1._f) };
+    Array<BasicVector<float>> values{ BasicVector<float>(1.f) };
+    SparseVoxelGrid grid;
+    grid.build(SEQUENTIAL, r, values, 16);
+
+    const Float step = 0.1_f;
+    Array<Float> ts;
+    const Ray ray(Vector(-5._f, 0._f, 0._f), Vector(1._f, 0._f, 0._f));
+    grid.march(ray, 100._f, step, 0._f, [&](const Vector& pos) {
+        ts.push(pos[X]);
+        return true;
+    });
+    REQUIRE_FALSE(ts.empty());
+    REQUIRE(ts.front() >= -2._f);
+    REQUIRE(ts.back() <= 2._f);
+    for (Size i = 1; i < ts.size(); ++i) {
+        REQUIRE(ts[i] - ts[i - 1] == approx(step));
+    }
+
+    // ray missing the grid
+    bool called = false;
+    const Ray missing(Vector(-5._f, 5._f, 0._f), Vector(1._f, 0._f, 0._f));
+    grid.march(missing, 100._f, step, 0._f, [&](const Vector&) {
+        called = true;
+        return true;
+    });
+    REQUIRE_FALSE(called);
+}
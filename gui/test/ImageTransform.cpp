@@ -0,0 +1,211 @@
+#include "gui/ImageTransform.h"
+#include "catch.hpp"
+#include "thread/Pool.h"
+
+using namespace Sph;
+
+static bool isClose(const Rgba& c1, const Rgba& c2, const float eps) {
+    return abs(c1.r() - c2.r()) <= eps && abs(c1.g() - c2.g()) <= eps && abs(c1.b() - c2.b()) <= eps;
+}
+
+/// Small image with both smooth gradients and sharp features
+static Bitmap<Rgba> getTestImage(const Pixel size) {
+    Bitmap<Rgba> image(size);
+    for (int y = 0; y < size.y; ++y) {
+        for (int x = 0; x < size.x; ++x) {
+            const float r = float(x) / size.x;
+            const float g = (x / 6 + y / 6) % 2 ? 0.8f : 0.2f;
+            const float b = 0.5f + 0.4f * float(std::sin(0.3 * x) * std::cos(0.5 * y));
+            image(x, y) = Rgba(r, g, b);
+        }
+    }
+    return image;
+}
+
+/// Adds deterministic noise to the image
+static Bitmap<Rgba> addNoise(const Bitmap<Rgba>& input, const float amplitude) {
+    Bitmap<Rgba> noisy = input.clone();
+    uint64_t seed = 1;
+    for (int y = 0; y < input.size().y; ++y) {
+        for (int x = 0; x < input.size().x; ++x) {
+            seed = (seed * 1103515245 + 12345) % 2147483648;
+            const float n = amplitude * (float(seed % 1000) / 500.f - 1.f);
+            noisy(x, y) += Rgba(n, -n, 0.5f * n, 0.f);
+        }
+    }
+    return noisy;
+}
+
+/// Non-local means filter evaluated directly for each pair of pixels, as implemented before the filter was
+/// rewritten using running sums.
+static Bitmap<Rgba> referenceDenoise(const Bitmap<Rgba>& input, const DenoiserParams& params) {
+    const Rectangle rect(Pixel(0, 0), input.size() - Pixel(1, 1));
+    const float norm = 1.f / (2.f * sqr(params.sigma));
+    Bitmap<Rgba> result(input.size());
+    for (int y = 0; y < input.size().y; ++y) {
+        for (int x = 0; x < input.size().x; ++x) {
+            const Pixel p1(x, y);
+            Rgba sum = Rgba::black();
+            float weight = 0.f;
+            const Rectangle window = rect.intersect(Rectangle::window(p1, params.filterRadius));
+            for (int y2 : window.rowRange()) {
+                for (int x2 : window.colRange()) {
+                    const Pixel p2(x2, y2);
+                    const Rectangle patch = rect.intersect(Rectangle::window(p2, params.patchRadius));
+                    float distSqr = 0.f;
+                    int count = 0;
+                    for (int py : patch.rowRange()) {
+                        for (int px : patch.colRange()) {
+                            const Pixel pp2(px, py);
+                            const Pixel pp1(pp2 - p2 + p1);
+                            if (!rect.contains(pp1)) {
+                                continue;
+                            }
+                            const Rgba v1 = input[pp1];
+                            const Rgba v2 = input[pp2];
+                            distSqr += sqr(v1.r() - v2.r()) + sqr(v1.g() - v2.g()) + sqr(v1.b() - v2.b());
+                            count++;
+                        }
+                    }
+                    distSqr /= 3 * count;
+                    const float w = exp(-min(distSqr * norm, 8.f));
+                    sum += input[p2] * w;
+                    weight += w;
+                }
+            }
+            result(x, y) = sum / weight;
+        }
+    }
+    return result;
+}
+
+static Bitmap<Rgba> referenceDenoiseLowFrequency(const Bitmap<Rgba>& input,
+    const DenoiserParams& params,
+    const Size levels) {
+    Bitmap<Rgba> small = resize(input, input.size() / 2);
+    Bitmap<Rgba> denoised = referenceDenoise(small, params);
+    if (levels > 1) {
+        DenoiserParams levelParams = params;
+        levelParams.sigma *= 0.5f;
+        denoised = referenceDenoiseLowFrequency(denoised, levelParams, levels - 1);
+    }
+    Bitmap<Rgba> smallUpscaled = resize(small, input.size());
+    Bitmap<Rgba> denoisedUpscaled = resize(denoised, input.size());
+    Bitmap<float> disc = detectEdges(smallUpscaled);
+    for (int y = 0; y < input.size().y; ++y) {
+        for (int x = 0; x < input.size().x; ++x) {
+            const Pixel p(x, y);
+            const Rgba c_f = denoisedUpscaled[p] + (input[p] - smallUpscaled[p]);
+            const float w = exp(-1.e3f * disc[p]);
+            denoisedUpscaled[p] = input[p].blend(c_f, w);
+        }
+    }
+    return denoisedUpscaled;
+}
+
+TEST_CASE("Fast gaussian blur", "[image]") {
+    ThreadPool pool(4);
+    const Bitmap<Rgba> image = getTestImage(Pixel(67, 53));
+    // the approximation by box filters is coarse for very small radii, the bloom effect uses radii >= 8
+    for (int radius : { 8, 12, 16 }) {
+        const Bitmap<Rgba> expected = gaussianBlur(pool, image, radius);
+        const Bitmap<Rgba> blurred = fastGaussianBlur(pool, image, radius);
+        REQUIRE(blurred.size() == image.size());
+        // the edges are handled differently, compare only the interior
+        for (int y = radius; y < image.size().y - radius; ++y) {
+            for (int x = radius; x < image.size().x - radius; ++x) {
+                INFO("radius = " << radius << ", pixel = " << x << ", " << y);
+                REQUIRE(isClose(blurred(x, y), expected(x, y), 0.03f));
+            }
+        }
+    }
+
+    // constant image is preserved, including the edges
+    Bitmap<Rgba> constant(Pixel(20, 15));
+    constant.fill(Rgba(0.3f, 0.6f, 0.9f));
+    const Bitmap<Rgba> blurred = fastGaussianBlur(pool, constant, 8);
+    for (int y = 0; y < constant.size().y; ++y) {
+        for (int x = 0; x < constant.size().x; ++x) {
+            REQUIRE(isClose(blurred(x, y), constant(x, y), 1.e-5f));
+        }
+    }
+}
+
+TEST_CASE("Bloom effect", "[image]") {
+    ThreadPool pool(4);
+    Bitmap<Rgba> image(Pixel(128, 96));
+    image.fill(Rgba(0.2f));
+
+    // no pixel above the threshold, the image is unchanged
+    Bitmap<Rgba> result = bloomEffect(pool, image, 40, 1.f, 0.75f);
+    for (int y = 0; y < image.size().y; ++y) {
+        for (int x = 0; x < image.size().x; ++x) {
+            REQUIRE(result(x, y) == image(x, y));
+        }
+    }
+
+    // single bright pixel is not lost by downsampling and spreads symmetrically around it
+    const Pixel center(64, 48);
+    image(center.x, center.y) = Rgba(1.f);
+    image(center.x - 1, center.y) = Rgba(1.f);
+    image(center.x, center.y - 1) = Rgba(1.f);
+    image(center.x - 1, center.y - 1) = Rgba(1.f);
+    result = bloomEffect(pool, image, 40, 1.f, 0.75f);
+    const float glow = result(center.x + 8, center.y - 1).r() - 0.2f;
+    REQUIRE(glow > 1.e-4f);
+    REQUIRE(result(center.x - 9, center.y - 1).r() - 0.2f == Approx(glow).epsilon(0.1f));
+    REQUIRE(result(center.x + 24, center.y - 1).r() - 0.2f < glow);
+    for (int y = 0; y < image.size().y; ++y) {
+        for (int x = 0; x < image.size().x; ++x) {
+            REQUIRE(result(x, y).r() >= image(x, y).r());
+        }
+    }
+
+    // without downsampling, the bloom is the blurred image of bright pixels
+    Bitmap<Rgba> bright(image.size());
+    bright.fill(Rgba::black());
+    bright(center.x, center.y) = Rgba(1.f);
+    result = bloomEffect(pool, bright, 8, 0.5f, 0.75f);
+    const Bitmap<Rgba> blurred = fastGaussianBlur(pool, bright, 8);
+    for (int y = 0; y < image.size().y; ++y) {
+        for (int x = 0; x < image.size().x; ++x) {
+            REQUIRE(isClose(result(x, y), bright(x, y) + blurred(x, y) * 0.5f, 1.e-5f));
+        }
+    }
+}
+
+TEST_CASE("Denoise", "[image]") {
+    ThreadPool pool(4);
+    const Bitmap<Rgba> image = addNoise(getTestImage(Pixel(37, 29)), 0.05f);
+    DenoiserParams params;
+    params.filterRadius = 3;
+    params.patchRadius = 2;
+    params.sigma = 0.05f;
+    const Bitmap<Rgba> expected = referenceDenoise(image, params);
+    const Bitmap<Rgba> denoised = denoise(pool, image, params);
+    REQUIRE(denoised.size() == image.size());
+    for (int y = 0; y < image.size().y; ++y) {
+        for (int x = 0; x < image.size().x; ++x) {
+            INFO("pixel = " << x << ", " << y);
+            REQUIRE(isClose(denoised(x, y), expected(x, y), 1.e-4f));
+        }
+    }
+}
+
+TEST_CASE("Denoise low frequency", "[image]") {
+    ThreadPool pool(4);
+    const Bitmap<Rgba> image = addNoise(getTestImage(Pixel(64, 48)), 0.05f);
+    DenoiserParams params;
+    params.filterRadius = 3;
+    params.patchRadius = 1;
+    params.sigma = 0.05f;
+    const Bitmap<Rgba> expected = referenceDenoiseLowFrequency(image, params, 2);
+    const Bitmap<Rgba> denoised = denoiseLowFrequency(pool, image, params, 2);
+    REQUIRE(denoised.size() == image.size());
+    for (int y = 0; y < image.size().y; ++y) {
+        for (int x = 0; x < image.size().x; ++x) {
+            INFO("pixel = " << x << ", " << y);
+            REQUIRE(isClose(denoised(x, y), expected(x, y), 1.e-4f));
+        }
+    }
+}
@@ -337,15 +337,6 @@ static Optional<Float> getPeriod(const Storage& storage) {
     }
 }
 
-static Size getMoons(ArrayView<const Float> m,
-    ArrayView<const Vector> r,
-    ArrayView<const Vector> v,
-    const Size idx,
-    const Float limit,
-    const Float radius) {
-    return Post::findMoonCount(m, r, v, idx, radius, limit);
-}
-
 void GridPage::update(const Storage& storage, const Config& config) {
     if (thread.joinable()) {
         wxMessageBox("Computation in progress", "Fail", wxOK | wxCENTRE);
@@ -385,6 +376,17 @@ void GridPage::updateAsync(const Storage& storage,
 
     ComponentGetter getter(storage);
 
+    Array<Size> moonCounts;
+    if (checks.has(CheckFlag::MOONS)) {
+        SharedPtr<IScheduler> scheduler = Factory::getScheduler(RunSettings::getDefaults());
+        moonCounts = Post::findMoonCounts(*scheduler,
+            getter.getMasses(),
+            getter.getPositions(),
+            getter.getVelocities(),
+            config.radiiLimit,
+            config.moonLimit);
+    }
+
     Storage lr;
     for (Size i = 0; i < fragmentCnt; ++i) {
         const Storage fragment = getter.getComponent(i);
@@ -481,12 +483,7 @@ void GridPage::updateAsync(const Storage& storage,
         }
 
         if (checks.has(CheckFlag::MOONS)) {
-            ArrayView<const Float> masses = getter.getMasses();
-            ArrayView<const Vector> positions = getter.getPositions();
-            ArrayView<const Vector> velocities = getter.getVelocities();
-            const Size count =
-                getMoons(masses, positions, velocities, i, config.moonLimit, config.radiiLimit);
-            this->updateCell(i, colIdx++, count);
+            this->updateCell(i, colIdx++, moonCounts[i]);
         }
 
         executeOnMainThread([this] { grid->AutoSize(); });
@@ -78,6 +78,7 @@ NodeManager::NodeManager(NodeEditor* editor, SharedPtr<INodeManagerCallbacks> ca
         .set(RunSettingsId::RUN_RNG_SEED, 1234)
         .set(RunSettingsId::RUN_THREAD_CNT, 0)
         .set(RunSettingsId::RUN_THREAD_GRANULARITY, 1000)
+        .set(RunSettingsId::RUN_THREAD_PINNING, false)
         .set(RunSettingsId::FINDER_LEAF_SIZE, 25)
         .set(RunSettingsId::FINDER_MAX_PARALLEL_DEPTH, 50)
         .set(RunSettingsId::RUN_AUTHOR, L"Pavel \u0160eve\u010Dek"_s)
@@ -563,6 +564,7 @@ VirtualSettings NodeManager::getGlobalSettings() {
     VirtualSettings::Category& parallelCat = settings.addCategory("Parallelization");
     parallelCat.connect<int>("Number of threads", globals, RunSettingsId::RUN_THREAD_CNT);
     parallelCat.connect<int>("Particle granularity", globals, RunSettingsId::RUN_THREAD_GRANULARITY);
+    parallelCat.connect<bool>("Pin threads", globals, RunSettingsId::RUN_THREAD_PINNING);
     parallelCat.connect<int>("K-d tree leaf size", globals, RunSettingsId::FINDER_LEAF_SIZE);
     parallelCat.connect<int>("Max parallel depth", globals, RunSettingsId::FINDER_MAX_PARALLEL_DEPTH);
 
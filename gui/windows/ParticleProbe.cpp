@@ -130,6 +130,10 @@ void ParticleProbe::onPaint(wxPaintEvent& UNUSED(evt)) {
             drawTextWithSubscripts(dc, label + L" = " + toString(data.value.get<Size>()), offset);
             offset.y += config.lineSkip;
             break;
+        case DynamicId::GLOBAL_SIZE:
+            drawTextWithSubscripts(dc, label + L" = " + toString(data.value.get<GlobalSize>()), offset);
+            offset.y += config.lineSkip;
+            break;
         case DynamicId::VECTOR: {
             const Vector vector = data.value;
             this->printVector(dc, vector, label, offset);
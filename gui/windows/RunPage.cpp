@@ -19,7 +19,9 @@
 #include "io/FileSystem.h"
 #include "io/LogWriter.h"
 #include "io/Logger.h"
+#include "physics/Integrals.h"
 #include "sph/Diagnostics.h"
+#include "system/Factory.h"
 #include "thread/CheckFunction.h"
 #include "thread/Pool.h"
 #include "timestepping/TimeStepCriterion.h"
@@ -76,6 +78,7 @@ RunPage::RunPage(wxWindow* window, Controller* parent, GuiSettings& settings)
     , controller(parent)
     , gui(settings) {
     manager = makeAuto<wxAuiManager>(this);
+    plotWorker = makeAuto<ThreadPool>(1);
 
     wxPanel* visBar = createVisBar();
     pane = alignedNew<OrthoPane>(this, parent, settings);
@@ -163,6 +166,9 @@ RunPage::RunPage(wxWindow* window, Controller* parent, GuiSettings& settings)
 }
 
 RunPage::~RunPage() {
+    if (plotTask) {
+        plotTask->wait();
+    }
     manager->UnInit();
     manager = nullptr;
 }
@@ -564,7 +570,8 @@ wxPanel* RunPage::createVisBar() {
 
     particleButton->Bind(wxEVT_RADIOBUTTON, [=](wxCommandEvent& UNUSED(evt)) {
         CHECK_FUNCTION(CheckFunction::MAIN_THREAD);
-        controller->setRenderer(makeAuto<ParticleRenderer>(gui));
+        SharedPtr<IScheduler> scheduler = Factory::getScheduler(RunSettings::getDefaults());
+        controller->setRenderer(makeAuto<ParticleRenderer>(scheduler, gui));
         enableControls(0);
     });
     /*meshButton->Bind(wxEVT_RADIOBUTTON, [=](wxCommandEvent& UNUSED(evt)) {
@@ -581,8 +588,8 @@ wxPanel* RunPage::createVisBar() {
     });*/
     surfaceButton->Bind(wxEVT_RADIOBUTTON, [=](wxCommandEvent& UNUSED(evt)) {
         CHECK_FUNCTION(CheckFunction::MAIN_THREAD);
+        SharedPtr<IScheduler> scheduler = Factory::getScheduler(RunSettings::getDefaults());
         try {
-            SharedPtr<IScheduler> scheduler = Factory::getScheduler(RunSettings::getDefaults());
             controller->setRenderer(makeAuto<RayMarcher>(scheduler, gui));
             enableControls(1);
         } catch (const std::exception& e) {
@@ -590,7 +597,7 @@ wxPanel* RunPage::createVisBar() {
 
             // switch to particle renderer (fallback option)
             particleButton->SetValue(true);
-            controller->setRenderer(makeAuto<ParticleRenderer>(gui));
+            controller->setRenderer(makeAuto<ParticleRenderer>(scheduler, gui));
             enableControls(0);
         }
     });
@@ -933,6 +940,10 @@ void RunPage::runStarted(const Storage& storage, const Path& path) {
         timelineBar->update(path);
     }
 
+    if (plotTask) {
+        plotTask->wait();
+    }
+    lastPlotTime = -INFTY;
     for (auto plot : plots) {
         plot->clear();
     }
@@ -965,16 +976,65 @@ void RunPage::onTimeStep(const Storage& storage, const Statistics& stats) {
 
     if (storage.has(QuantityId::MASS) && stats.has(StatisticsId::RUN_TIME)) {
         // skip plots if we don't have mass, for simplicity; this can be generalized if needed
-        for (auto plot : plots) {
-            plot->onTimeStep(storage, stats);
-        }
+        this->updatePlots(storage, stats);
+    }
+}
+
+void RunPage::updatePlots(const Storage& storage, const Statistics& stats) {
+    // this is called from run thread (NOT main thread)
+    const Float t = stats.get<Float>(StatisticsId::RUN_TIME);
+    if (t - lastPlotTime < gui.get<Float>(GuiSettingsId::PLOT_INITIAL_PERIOD)) {
+        return;
+    }
+    if (plotTask && !plotTask->completed()) {
+        // plots are still being updated, skip this step rather than blocking the run
+        return;
+    }
+    lastPlotTime = t;
 
+    // evaluate all integrals in a single parallel pass, the temporal plots read them from the statistics
+    SharedPtr<IScheduler> scheduler = Factory::getScheduler(RunSettings::getDefaults());
+    Statistics plotStats = stats;
+    IntegralsEvaluator evaluator(IntegralFlag::MOMENTUM | IntegralFlag::ANGULAR_MOMENTUM |
+                                 IntegralFlag::KINETIC_ENERGY | IntegralFlag::INTERNAL_ENERGY);
+    evaluator.evaluate(*scheduler, storage, plotStats);
+
+    auto refreshViews = [this] {
         executeOnMainThread([this] {
             for (auto view : plotViews) {
                 view->Refresh();
             }
         });
+    };
+
+    if (storage.getUserData()) {
+        // cannot make a snapshot of the storage, update the plots synchronously
+        for (auto plot : plots) {
+            plot->onTimeStep(storage, plotStats);
+        }
+        refreshViews();
+        return;
+    }
+
+    // the run continues with the storage, so the plots are updated from its snapshot; copy only the
+    // quantities needed by the plots, unless some plot (e.g. SFD) requires the complete storage
+    Array<QuantityId> ids;
+    bool allKnown = true;
+    for (auto plot : plots) {
+        allKnown &= plot->addRequiredQuantities(ids);
+    }
+    SharedPtr<Storage> snapshot;
+    if (allKnown) {
+        snapshot = makeShared<Storage>(storage.clone(VisitorEnum::STATE_VALUES, ids));
+    } else {
+        snapshot = makeShared<Storage>(storage.clone(VisitorEnum::STATE_VALUES));
     }
+    plotTask = plotWorker->submit([this, snapshot, plotStats, refreshViews] {
+        for (auto plot : plots) {
+            plot->onTimeStep(*snapshot, plotStats);
+        }
+        refreshViews();
+    });
 }
 
 void RunPage::onRunEnd() {
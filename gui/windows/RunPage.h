@@ -37,6 +37,8 @@ class SelectedParticlePlot;
 class TimeLine;
 class ProgressPanel;
 class PaletteSimpleWidget;
+class ThreadPool;
+class ITask;
 
 /// \brief Main frame of the application.
 ///
@@ -79,6 +81,16 @@ private:
     /// Colorizers corresponding to the items in combobox
     Array<ColorizerData> colorizerList;
 
+    /// Task updating the plots, or nullptr if no update has been started yet
+    SharedPtr<ITask> plotTask;
+
+    /// Run time of the last plot update
+    Float lastPlotTime = -INFTY;
+
+    /// Worker thread updating the plots, so that the plots do not stall the run. Declared last, so that the
+    /// running update is finished before other members are destroyed.
+    AutoPtr<ThreadPool> plotWorker;
+
 public:
     RunPage(wxWindow* window, Controller* controller, GuiSettings& guiSettings);
 
@@ -132,6 +144,12 @@ private:
     wxWindow* createRaymarcherBox(wxPanel* parent);
     wxWindow* createVolumeBox(wxPanel* parent);
 
+    /// \brief Updates the plots with the current state of the run.
+    ///
+    /// Integrals are evaluated on the calling thread, the plots themselves are then updated asynchronously
+    /// from a snapshot of the storage. Updates are skipped while the previous one is still running.
+    void updatePlots(const Storage& storage, const Statistics& stats);
+
     void makeStatsText(const Size particleCnt, const Size pointCnt, const Statistics& stats);
 
     void setColorizer(const Size idx);
@@ -1,4 +1,5 @@
 #include "windows/TimeLine.h"
+#include "io/Sequence.h"
 #include "windows/Icons.data.h"
 #include <wx/bmpbuttn.h>
 #include <wx/dcbuffer.h>
@@ -10,11 +11,25 @@ std::map<int, Path> getSequenceFiles(const Path& inputPath) {
         throw Exception("Sequence for empty path");
     }
 
-    const Expected<Path> absolutePath = FileSystem::getAbsolutePath(inputPath);
+    // frames of sequence files are addressed by virtual paths, resolve the path of the file itself
+    const Path filePath = SequenceInput::parseFramePath(inputPath).get<0>();
+    const Expected<Path> absolutePath = FileSystem::getAbsolutePath(filePath);
     if (!absolutePath) {
         throw Exception("Cannot resolve absolute path of file '" + inputPath.string() + "'");
     }
 
+    if (getIoEnum(filePath.extension().string()) == IoEnum::SEQUENCE_FILE) {
+        const Expected<Array<Float>> times = SequenceInput::getFrameTimes(absolutePath.value());
+        if (!times || times->empty()) {
+            throw Exception("Cannot open file '" + inputPath.string() + "'");
+        }
+        std::map<int, Path> fileMap;
+        for (Size index = 0; index < times->size(); ++index) {
+            fileMap[index] = SequenceInput::getFramePath(absolutePath.value(), index);
+        }
+        return fileMap;
+    }
+
     Optional<OutputFile> deducedFile = OutputFile::getMaskFromPath(absolutePath.value());
     if (!deducedFile) {
         // just a single file, not part of a sequence (e.g. frag_final.ssf)
@@ -99,7 +99,8 @@ int pkdgravToMoons(const Path& filePath, const Float limit) {
 
 int ssfToSfd(const Post::HistogramSource source, const Path& filePath, const Path& sfdPath) {
     std::cout << "Processing SPH file ... " << std::endl;
-    AutoPtr<IInput> input = Factory::getInput(filePath);
+    // equivalent radii are computed from masses, components are found using positions and radii
+    AutoPtr<IInput> input = Factory::getInput(filePath, { QuantityId::POSITION, QuantityId::MASS });
     Storage storage;
     Statistics stats;
     Outcome outcome = input->load(filePath, storage, stats);
@@ -123,7 +124,7 @@ int ssfToOmega(const Path& filePath,
     const Path& omegaDPath,
     const Path& omegaDirPath) {
     std::cout << "Processing SPH file ... " << std::endl;
-    BinaryInput input;
+    BinaryInput input({ QuantityId::POSITION, QuantityId::MASS, QuantityId::ANGULAR_FREQUENCY });
     Storage storage;
     Statistics stats;
     Outcome outcome = input.load(filePath, storage, stats);
@@ -231,7 +232,7 @@ int ssfToVelocity(const Path& filePath, const Path& outPath) {
 
 void ssfToVelDir(const Path& filePath, const Path& outPath) {
     std::cout << "Processing SPH file ... " << std::endl;
-    BinaryInput input;
+    BinaryInput input({ QuantityId::POSITION, QuantityId::MASS });
     Storage storage;
     Statistics stats;
     Outcome outcome = input.load(filePath, storage, stats);
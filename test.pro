@@ -4,7 +4,13 @@ TEMPLATE = subdirs
 
 CONFIG += ordered
 
-SUBDIRS = core \
-          test
+SUBDIRS = core
+
+CONFIG(use_gui) {
+    # also builds tests of the GUI objects
+    SUBDIRS += gui
+}
+
+SUBDIRS += test
 
 test.depends = core
@@ -1,5 +1,5 @@
 TEMPLATE = app
-CONFIG += c++14 thread silent
+CONFIG += c++14 thread silent object_parallel_to_source
 CONFIG -= app_bundle
 CONFIG -= qt
 
@@ -15,10 +15,34 @@ PRE_TARGETDEPS += ../core/libcore.a
 
 include(../core/sharedCore.pro)
 
-INCLUDEPATH += ../core $$PREFIX/include/catch2
+INCLUDEPATH += .. ../core $$PREFIX/include/catch2
+
+CONFIG(use_gui) {
+    # tests of the GUI objects, requires the GUI library and wxWidgets
+    DEPENDPATH += ../gui
+    PRE_TARGETDEPS += ../gui/libgui.a
+    LIBS = ../gui/libgui.a $$LIBS # must be used before libcore
+    include(../gui/sharedGui.pro)
+    INCLUDEPATH += $$PREFIX/include/wx-3.0
+
+    SOURCES += \
+        ../gui/objects/test/Colorizer.cpp \
+        ../gui/objects/test/Palette.cpp \
+        ../gui/objects/test/ScreenIndex.cpp \
+        ../gui/renderers/test/SparseGrid.cpp \
+        ../gui/test/ImageTransform.cpp
+}
+
+CONFIG(use_bench) {
+    # tests of the benchmark utilities; the benchmark is an application, so its sources are compiled here
+    SOURCES += \
+        ../bench/Robust.cpp \
+        ../bench/test/Robust.cpp
+}
 
 SOURCES += \
     ../core/common/test/Traits.cpp \
+    ../core/gravity/test/AggregateSolver.cpp \
     ../core/gravity/test/BarnesHut.cpp \
     ../core/gravity/test/BruteForceGravity.cpp \
     ../core/gravity/test/Moments.cpp \
@@ -28,6 +52,7 @@ SOURCES += \
     ../core/io/test/Logger.cpp \
     ../core/io/test/Output.cpp \
     ../core/io/test/Path.cpp \
+    ../core/io/test/Sequence.cpp \
     ../core/io/test/Serializer.cpp \
     ../core/math/rng/test/Rng.cpp \
     ../core/math/rng/test/VectorRng.cpp \
@@ -100,6 +125,7 @@ SOURCES += \
     ../core/post/test/TwoBody.cpp \
     ../core/post/test/MarchingCubes.cpp \
     ../core/post/test/MeshFile.cpp \
+    ../core/post/test/Plot.cpp \
     ../core/post/test/Point.cpp \
     ../core/post/test/StatisticTests.cpp \
     ../core/quantities/test/IMaterial.cpp \
@@ -125,6 +151,7 @@ SOURCES += \
     ../core/sph/equations/test/Potentials.cpp \
     ../core/sph/equations/test/XSph.cpp \
     ../core/sph/initial/test/Distribution.cpp \
+    ../core/sph/initial/test/Galaxy.cpp \
     ../core/sph/initial/test/Initial.cpp \
     ../core/sph/initial/test/Stellar.cpp \
     ../core/sph/kernel/test/GravityKernel.cpp \
@@ -162,6 +189,7 @@ SOURCES += \
     ../core/sph/solvers/test/EnergyConservingSolver.cpp \
     ../core/gravity/test/CachedGravity.cpp \
     ../core/run/test/IRun.cpp \
+    ../core/run/test/InSituAnalysis.cpp \
     ../core/system/test/Crashpad.cpp \
     ../core/objects/finders/test/PeriodicFinder.cpp \
     ../core/run/test/Node.cpp